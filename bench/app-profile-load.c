@@ -0,0 +1,366 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2013 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * app-profile-load.c - writes a profile directory of several megabytes of
+ * commented application profile files, loads it with
+ * nv_app_profile_config_load() and checks that every rule and profile was
+ * loaded, with hex and octal values converted; reports the load time and
+ * peak resident set size; then checks nv_app_profile_file_syntax_to_json()
+ * against a copy of the splicing conversion it replaced, and times both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "app-profiles.h"
+#include "common-utils.h"
+#include "msg.h"
+
+/* size of the generated profile directory */
+#define PROFILE_FILES 32
+#define RULES_PER_FILE 2000
+#define PROFILES_PER_FILE 500
+
+/* number of times the directory is loaded for the timings */
+#define TIMING_ROUNDS 3
+
+
+
+/*
+ * The conversion as it was before it was made single pass: every comment
+ * and literal rewritten duplicates the whole tail of the text.
+ */
+
+static void splice_string(char **s, size_t b, size_t e, const char *replace)
+{
+    char *tail = strdup(*s + e);
+    *s = realloc(*s, b + strlen(replace) + strlen(tail) + 1);
+    if (!*s) {
+        return;
+    }
+    sprintf(*s + b, "%s%s", replace, tail);
+    free(tail);
+}
+
+#define HEX_DIGITS "0123456789abcdefABCDEF"
+
+static char *splice_syntax_to_json(const char *orig_s)
+{
+    char *s = strdup(orig_s);
+    int quoted = FALSE;
+    char *tok, *endptr, *old_substr, *new_substr;
+    size_t start, end, size;
+    unsigned long long val;
+
+    tok = s;
+    while ((tok = strpbrk(tok, "\\\"#" HEX_DIGITS))) {
+        switch (*tok) {
+        case '\"':
+            quoted = !quoted;
+            tok++;
+            break;
+        case '\\':
+            tok++;
+            if (*tok) {
+                tok++;
+            }
+            break;
+        case '#':
+            if (!quoted) {
+                char *end_tok = nvstrchrnul(tok, '\n');
+                start = tok - s;
+                end = end_tok - s;
+                splice_string(&s, start, end, "");
+                tok = s + start;
+            } else {
+                tok++;
+            }
+            break;
+        default:
+            size = strspn(tok, "Xx." HEX_DIGITS);
+            if ((tok[0] == '0') &&
+                (tok[1] == 'x' || tok[1] == 'X' || isdigit(tok[1])) &&
+                !quoted) {
+                old_substr = nvstrndup(tok, size);
+                errno = 0;
+                val = strtoull(old_substr, &endptr, 0);
+                if (errno || (endptr - old_substr != strlen(old_substr))) {
+                    tok += size;
+                } else {
+                    new_substr = nvasprintf("%llu", val);
+                    start = tok - s;
+                    end = tok - s + size;
+                    splice_string(&s, start, end, new_substr);
+                    free(new_substr);
+                    tok = s + start;
+                }
+                free(old_substr);
+            } else {
+                tok += size;
+            }
+            break;
+        }
+    }
+
+    return s;
+}
+
+
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static long peak_rss_kib(void)
+{
+    struct rusage usage;
+
+    return (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : 0;
+}
+
+/*
+ * The text of one profile file, in the syntax users write: comments, blank
+ * lines, and integer setting values in hex and octal.  The first setting
+ * of every profile is 0x1f, and its second 017.
+ */
+static char *make_profile_file(int file)
+{
+    size_t len = 0, size = 1 << 16;
+    char *text = nvalloc(size);
+    int i;
+
+#define APPEND(...)                                                       \
+    do {                                                                  \
+        char *s = nvasprintf(__VA_ARGS__);                                \
+        size_t n = strlen(s);                                             \
+        if (len + n + 1 > size) {                                         \
+            size = (len + n + 1) * 2;                                     \
+            text = nvrealloc(text, size);                                 \
+        }                                                                 \
+        memcpy(text + len, s, n + 1);                                     \
+        len += n;                                                         \
+        nvfree(s);                                                        \
+    } while (0)
+
+    APPEND("# Generated application profiles, file %d\n{\n", file);
+    APPEND("    \"rules\" : [\n");
+    for (i = 0; i < RULES_PER_FILE; i++) {
+        if (i % 16 == 0) {
+            APPEND("\n        # Rules %d to %d\n", i, i + 15);
+        }
+        APPEND("        { \"pattern\" : { \"feature\" : \"%s\", "
+               "\"matches\" : \"app%d_%d\" }, \"profile\" : \"f%d_p%d\" }%s\n",
+               (i % 3) ? "procname" : "dso", file, i, file,
+               i % PROFILES_PER_FILE, (i + 1 < RULES_PER_FILE) ? "," : "");
+    }
+    APPEND("    ],\n    \"profiles\" : [\n");
+    for (i = 0; i < PROFILES_PER_FILE; i++) {
+        APPEND("        # Profile %d, with \"#\" in a string\n", i);
+        APPEND("        { \"name\" : \"f%d_p%d\", \"settings\" : [ "
+               "{ \"key\" : \"GLFSAAMode\", \"value\" : 0x1f }, "
+               "{ \"k\" : \"GLLogMaxAniso\", \"v\" : 017 }, "
+               "{ \"key\" : \"GLShaderCacheTag\", \"value\" : \"#%x\" } ] }%s\n",
+               file, i, i, (i + 1 < PROFILES_PER_FILE) ? "," : "");
+    }
+    APPEND("    ]\n}\n");
+
+#undef APPEND
+
+    return text;
+}
+
+static size_t write_profile_dir(const char *dir)
+{
+    size_t total = 0;
+    int file;
+
+    for (file = 0; file < PROFILE_FILES; file++) {
+        char *path = nvasprintf("%s/bench-%02d", dir, file);
+        char *text = make_profile_file(file);
+        FILE *fp = fopen(path, "w");
+
+        if (fp) {
+            fputs(text, fp);
+            fclose(fp);
+        }
+        total += strlen(text);
+
+        nvfree(text);
+        nvfree(path);
+    }
+
+    return total;
+}
+
+static void remove_profile_dir(const char *dir)
+{
+    int file;
+
+    for (file = 0; file < PROFILE_FILES; file++) {
+        char *path = nvasprintf("%s/bench-%02d", dir, file);
+        unlink(path);
+        nvfree(path);
+    }
+    rmdir(dir);
+}
+
+
+
+/*
+ * Checks that every generated rule and profile was loaded, and that the
+ * literals of every profile were converted.  Returns the number of
+ * differences.
+ */
+static int check_config(AppProfileConfig *config)
+{
+    AppProfileConfigProfileIter *iter;
+    size_t profiles = 0;
+    int ret = 0;
+
+    if (nv_app_profile_config_count_rules(config) !=
+        PROFILE_FILES * RULES_PER_FILE) {
+        ret++;
+    }
+
+    for (iter = nv_app_profile_config_profile_iter(config); iter;
+         iter = nv_app_profile_config_profile_iter_next(iter)) {
+        json_t *settings =
+            json_object_get(nv_app_profile_config_profile_iter_val(iter),
+                            "settings");
+
+        if ((json_array_size(settings) != 3) ||
+            (json_integer_value(json_object_get(json_array_get(settings, 0),
+                                                "value")) != 0x1f) ||
+            (json_integer_value(json_object_get(json_array_get(settings, 1),
+                                                "value")) != 017)) {
+            ret++;
+        }
+        profiles++;
+    }
+
+    if (profiles != PROFILE_FILES * PROFILES_PER_FILE) {
+        ret++;
+    }
+
+    printf("Loaded %zu rule(s) and %zu profile(s): %d difference(s).\n",
+           nv_app_profile_config_count_rules(config), profiles, ret);
+
+    return ret;
+}
+
+static int check_syntax_to_json(void)
+{
+    char *text = make_profile_file(0);
+    char *spliced, *converted;
+    double start, splice_ms, convert_ms;
+    int ret;
+
+    start = now_ms();
+    spliced = splice_syntax_to_json(text);
+    splice_ms = now_ms() - start;
+
+    start = now_ms();
+    converted = nv_app_profile_file_syntax_to_json(text);
+    convert_ms = now_ms() - start;
+
+    ret = (strcmp(spliced, converted) != 0);
+
+    printf("Syntax conversion of one %zu KiB file: splicing %.2f ms, "
+           "single pass %.2f ms (%.1fx), %d difference(s).\n",
+           strlen(text) / 1024, splice_ms, convert_ms,
+           convert_ms > 0.0 ? splice_ms / convert_ms : 0.0, ret);
+
+    free(spliced);
+    nvfree(converted);
+    nvfree(text);
+
+    return ret;
+}
+
+
+
+int main(void)
+{
+    const char *tmpdir = getenv("TMPDIR");
+    char *dir, *search_path[1];
+    AppProfileConfig *config;
+    double start, load_ms, best_ms = 0.0;
+    long rss_before, rss_after;
+    size_t total;
+    int round, differences;
+
+    dir = nvasprintf("%s/nvidia-settings-bench-XXXXXX",
+                     tmpdir ? tmpdir : "/tmp");
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "Unable to create '%s': %s.\n", dir, strerror(errno));
+        return 1;
+    }
+    search_path[0] = dir;
+
+    total = write_profile_dir(dir);
+
+    rss_before = peak_rss_kib();
+    start = now_ms();
+    config = nv_app_profile_config_load(NULL, search_path, 1);
+    load_ms = now_ms() - start;
+    rss_after = peak_rss_kib();
+
+    printf("Profile directory: %d file(s), %zu KiB.\n", PROFILE_FILES,
+           total / 1024);
+    printf("First load: %.2f ms, peak resident set size %ld KiB "
+           "(%ld KiB above the peak before loading).\n",
+           load_ms, rss_after, rss_after - rss_before);
+
+    differences = check_config(config);
+    nv_app_profile_config_free(config);
+
+    /* only the first load reports its own statistics */
+    nv_set_verbosity(NV_VERBOSITY_WARNING);
+
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        start = now_ms();
+        config = nv_app_profile_config_load(NULL, search_path, 1);
+        load_ms = now_ms() - start;
+        nv_app_profile_config_free(config);
+
+        if ((round == 0) || (load_ms < best_ms)) {
+            best_ms = load_ms;
+        }
+    }
+
+    printf("Best of %d loads: %.2f ms.\n", TIMING_ROUNDS, best_ms);
+
+    remove_profile_dir(dir);
+    nvfree(dir);
+
+    differences += check_syntax_to_json();
+
+    return differences ? 1 : 0;
+}
@@ -0,0 +1,281 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2004 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * attribute-config.c - parses a synthetic configuration file with
+ * thousands of attribute assignments through nv_parse_attribute_string(),
+ * and checks that every attributeTable[] lookup returns the entry a linear
+ * scan of the table, as done before the lookups were indexed, returns;
+ * then times the parse and both kinds of lookup.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "parse.h"
+#include "common-utils.h"
+#include "NvCtrlAttributes.h"
+
+/* number of assignments in the generated configuration */
+#define CONFIG_ASSIGNMENTS 20000
+
+/* number of times the configuration is parsed for the timings */
+#define TIMING_ROUNDS 20
+
+
+
+/*
+ * parse.c frees the target lists of parsed assignments with this; the
+ * assignments parsed here are never resolved to targets.
+ */
+void NvCtrlTargetListFree(CtrlTargetNode *head)
+{
+}
+
+
+
+/* The linear scans of attributeTable[] that the indices replaced */
+
+static const AttributeTableEntry *linear_entry(const int attr,
+                                               const CtrlAttributeType type)
+{
+    int i;
+
+    for (i = 0; i < attributeTableLen; i++) {
+        if ((attributeTable[i].attr == attr) &&
+            (attributeTable[i].type == type)) {
+            return attributeTable + i;
+        }
+    }
+
+    return NULL;
+}
+
+static const AttributeTableEntry *linear_entry_by_name(const char *name)
+{
+    int i;
+
+    for (i = 0; i < attributeTableLen; i++) {
+        if (nv_strcasecmp(name, attributeTable[i].name)) {
+            return attributeTable + i;
+        }
+    }
+
+    return NULL;
+}
+
+
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/*
+ * Configuration lines shaped like the ones nv_write_config_file() writes:
+ * an optional display name, a target specification and an assignment.
+ * The attribute names cycle through the table in a scattered order, and
+ * alternate in case, as they may in a hand edited file.  Binary data and
+ * string operations never appear in configuration files and are left out.
+ */
+
+typedef struct {
+    char **lines;
+    const AttributeTableEntry **entries;
+    int n;
+} Config;
+
+static void make_config(Config *config)
+{
+    static const char *targets[] = { "gpu", "screen", "dpy", "fan" };
+    int i, j;
+
+    config->lines = nvalloc(CONFIG_ASSIGNMENTS * sizeof(char *));
+    config->entries = nvalloc(CONFIG_ASSIGNMENTS * sizeof(*config->entries));
+    config->n = 0;
+
+    for (i = 0, j = 0; config->n < CONFIG_ASSIGNMENTS; i++) {
+        const AttributeTableEntry *a;
+        char *name;
+
+        j = (j + 97) % attributeTableLen;
+        a = attributeTable + j;
+
+        if ((a->type == CTRL_ATTRIBUTE_TYPE_BINARY_DATA) ||
+            (a->type == CTRL_ATTRIBUTE_TYPE_STRING_OPERATION)) {
+            continue;
+        }
+
+        name = nvstrdup(a->name);
+        if (i % 2) {
+            nvstrtoupper(name);
+        }
+
+        config->lines[config->n] =
+            nvasprintf("%s[%s:%d]/%s=%d", (i % 3) ? "" : "localhost:0",
+                       targets[i % ARRAY_LEN(targets)], i % 4, name, i % 2);
+        config->entries[config->n] = linear_entry_by_name(name);
+        config->n++;
+
+        nvfree(name);
+    }
+}
+
+static void free_config(Config *config)
+{
+    int i;
+
+    for (i = 0; i < config->n; i++) {
+        nvfree(config->lines[i]);
+    }
+    nvfree(config->lines);
+    nvfree(config->entries);
+}
+
+
+
+/*
+ * Parses every line of the configuration, and looks every table entry up
+ * by id, comparing the results with the linear scans.  Returns the number
+ * of differences.
+ */
+static int check_config(const Config *config)
+{
+    ParsedAttribute p;
+    int i, ret = 0, failed = 0;
+
+    memset(&p, 0, sizeof(p));
+
+    for (i = 0; i < config->n; i++) {
+        if (nv_parse_attribute_string(config->lines[i], NV_PARSER_ASSIGNMENT,
+                                      &p) != NV_PARSER_STATUS_SUCCESS) {
+            failed++;
+        } else if (p.attr_entry != config->entries[i]) {
+            ret++;
+        }
+        nv_parsed_attribute_clean(&p);
+    }
+
+    for (i = 0; i < attributeTableLen; i++) {
+        const AttributeTableEntry *a = attributeTable + i;
+        const AttributeTableEntry *linear = linear_entry(a->attr, a->type);
+
+        if ((nv_get_attribute_entry(a->attr, a->type) != linear) ||
+            (strcmp(nv_get_attribute_name(a->attr, a->type),
+                    linear->name) != 0)) {
+            ret++;
+        }
+    }
+
+    if (nv_get_attribute_entry(-1, CTRL_ATTRIBUTE_TYPE_INTEGER) ||
+        strcmp(nv_get_attribute_name(-1, CTRL_ATTRIBUTE_TYPE_INTEGER),
+               "Unknown") != 0) {
+        ret++;
+    }
+
+    printf("%d assignments, %d table entries: %d parse failure(s), "
+           "%d difference(s).\n", config->n, attributeTableLen, failed, ret);
+
+    return ret + failed;
+}
+
+static void time_config(const Config *config)
+{
+    ParsedAttribute p;
+    double start, parse_ms, linear_ms, indexed_ms;
+    int i, round, name_sum = 0, linear_sum = 0, indexed_sum = 0;
+
+    memset(&p, 0, sizeof(p));
+
+    start = now_ms();
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        for (i = 0; i < config->n; i++) {
+            nv_parse_attribute_string(config->lines[i], NV_PARSER_ASSIGNMENT,
+                                      &p);
+            nv_parsed_attribute_clean(&p);
+        }
+    }
+    parse_ms = now_ms() - start;
+
+    printf("Parse, %d passes: %.2f ms (%.2f us per assignment).\n",
+           TIMING_ROUNDS, parse_ms,
+           parse_ms * 1000.0 / (TIMING_ROUNDS * config->n));
+
+    /* the name lookup of the old parser, on its own */
+
+    start = now_ms();
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        for (i = 0; i < config->n; i++) {
+            name_sum += linear_entry_by_name(config->entries[i]->name)->attr;
+        }
+    }
+    linear_ms = now_ms() - start;
+
+    printf("Name lookups, %d passes: linear scan %.2f ms, which the parse "
+           "above no longer pays.\n",
+           TIMING_ROUNDS, linear_ms);
+
+    /* the id lookups made by ATTRIBUTE_NAME() and the GUI */
+
+    start = now_ms();
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        for (i = 0; i < config->n; i++) {
+            const AttributeTableEntry *a = config->entries[i];
+            linear_sum += linear_entry(a->attr, a->type)->attr;
+        }
+    }
+    linear_ms = now_ms() - start;
+
+    start = now_ms();
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        for (i = 0; i < config->n; i++) {
+            const AttributeTableEntry *a = config->entries[i];
+            indexed_sum += nv_get_attribute_entry(a->attr, a->type)->attr;
+        }
+    }
+    indexed_ms = now_ms() - start;
+
+    printf("Id lookups, %d passes: linear scan %.2f ms, index %.2f ms "
+           "(%.1fx)%s.\n", TIMING_ROUNDS, linear_ms, indexed_ms,
+           indexed_ms > 0.0 ? linear_ms / indexed_ms : 0.0,
+           ((name_sum != linear_sum) || (linear_sum != indexed_sum)) ?
+           ", RESULTS DIFFER" : "");
+}
+
+
+
+int main(void)
+{
+    Config config;
+    int differences;
+
+    make_config(&config);
+
+    differences = check_config(&config);
+    time_config(&config);
+
+    free_config(&config);
+
+    return differences ? 1 : 0;
+}
@@ -0,0 +1,275 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2004,2012 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * gamma-ramp.c - checks that NvCtrlUpdateGammaRamp() computes the same
+ * ramps, bit for bit, as the original routine that computed every entry
+ * on its own, over a sweep of ramp sizes and of contrast, brightness and
+ * gamma values; then times both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <time.h>
+
+#include "NvCtrlAttributes.h"
+#include "NvCtrlAttributesPrivate.h"
+
+#define MAX_RAMP_SIZE 65536
+
+/* number of steps over each of the contrast, brightness and gamma ranges */
+#define SWEEP_STEPS 11
+
+/* ramp size used for the timings, as used by most X servers */
+#define TIMING_RAMP_SIZE 1024
+
+
+
+/*
+ * The gamma ramp entry computation as it was before ramps were computed
+ * per channel.
+ */
+static unsigned short ComputeGammaRampValReference(int gammaRampSize,
+                                                   int i,
+                                                   float contrast,
+                                                   float brightness,
+                                                   float gamma)
+{
+    double j, half, scale;
+    int shift, val, num;
+
+    num = gammaRampSize - 1;
+    shift = 16 - (ffs(gammaRampSize) - 1);
+
+    scale = (double) num / 3.0; /* how much brightness and contrast
+                                   affect the value */
+    j = (double) i;
+
+    /* contrast */
+
+    contrast *= scale;
+
+    if (contrast > 0.0) {
+        half = ((double) num / 2.0) - 1.0;
+        j -= half;
+        j *= half / (half - contrast);
+        j += half;
+    } else {
+        half = (double) num / 2.0;
+        j -= half;
+        j *= (half + contrast) / half;
+        j += half;
+    }
+
+    /* brightness */
+
+    brightness *= scale;
+
+    j += brightness;
+    if (j > (double)num) {
+        j = (double)num;
+    }
+    if (j < 0.0) {
+        j = 0.0;
+    }
+
+    /* gamma */
+
+    gamma = 1.0 / (double) gamma;
+
+    if (gamma == 1.0) {
+        val = (int) j;
+    } else {
+        val = (int) (pow (j / (double)num, gamma) * (double)num + 0.5);
+    }
+
+    val <<= shift;
+    return (unsigned short) val;
+}
+
+static void UpdateGammaRampReference(const NvCtrlGammaInput *pGammaInput,
+                                     int gammaRampSize,
+                                     unsigned short *gammaRamp[3],
+                                     unsigned int bitmask)
+{
+    int i, ch;
+
+    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
+        if ((bitmask & (1 << ch)) == 0) {
+            continue;
+        }
+        for (i = 0; i < gammaRampSize; i++) {
+            gammaRamp[ch][i] =
+                ComputeGammaRampValReference(gammaRampSize,
+                                             i,
+                                             pGammaInput->contrast[ch],
+                                             pGammaInput->brightness[ch],
+                                             pGammaInput->gamma[ch]);
+        }
+    }
+}
+
+
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* The value of the 'step'th of SWEEP_STEPS points spread over [min, max] */
+static float sweep_value(float min, float max, int step)
+{
+    return min + (max - min) * step / (SWEEP_STEPS - 1);
+}
+
+/*
+ * Gamma is swept logarithmically, so that as many values fall on either
+ * side of 1.0.
+ */
+static float sweep_gamma(int step)
+{
+    return GAMMA_MIN * pow(GAMMA_MAX / GAMMA_MIN,
+                           (double) step / (SWEEP_STEPS - 1));
+}
+
+static void set_input(NvCtrlGammaInput *input, int c, int b, int g)
+{
+    int ch;
+
+    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
+        input->contrast[ch] = sweep_value(CONTRAST_MIN, CONTRAST_MAX, c);
+        input->brightness[ch] = sweep_value(BRIGHTNESS_MIN, BRIGHTNESS_MAX, b);
+        input->gamma[ch] = sweep_gamma(g);
+    }
+}
+
+
+
+/*
+ * Compares both computations for every power of two ramp size over the
+ * whole sweep; returns the number of ramps that differ.
+ */
+static int check_ramps(unsigned short *ramp[3], unsigned short *ref[3])
+{
+    NvCtrlGammaInput input;
+    int size, c, b, g, mismatches = 0, ramps = 0;
+
+    for (size = 2; size <= MAX_RAMP_SIZE; size *= 2) {
+        for (c = 0; c < SWEEP_STEPS; c++) {
+            for (b = 0; b < SWEEP_STEPS; b++) {
+                for (g = 0; g < SWEEP_STEPS; g++) {
+                    set_input(&input, c, b, g);
+
+                    NvCtrlUpdateGammaRamp(&input, size, ramp, RED_CHANNEL);
+                    UpdateGammaRampReference(&input, size, ref, RED_CHANNEL);
+                    ramps++;
+
+                    if (memcmp(ramp[0], ref[0],
+                               size * sizeof(unsigned short)) != 0) {
+                        if (mismatches++ < 10) {
+                            printf("  mismatch: size %d, contrast %f, "
+                                   "brightness %f, gamma %f\n",
+                                   size, input.contrast[0],
+                                   input.brightness[0], input.gamma[0]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    printf("Compared %d ramps: %d mismatch(es).\n", ramps, mismatches);
+
+    return mismatches;
+}
+
+/*
+ * Times both computations over the sweep with a single ramp size, for one
+ * channel and for all three channels sharing the same input.
+ */
+static void time_ramps(unsigned short *ramp[3], unsigned short *ref[3],
+                       unsigned int bitmask, const char *what)
+{
+    NvCtrlGammaInput input;
+    int c, b, g;
+    double start, new_ms, ref_ms;
+
+    start = now_ms();
+    for (c = 0; c < SWEEP_STEPS; c++) {
+        for (b = 0; b < SWEEP_STEPS; b++) {
+            for (g = 0; g < SWEEP_STEPS; g++) {
+                set_input(&input, c, b, g);
+                UpdateGammaRampReference(&input, TIMING_RAMP_SIZE, ref,
+                                         bitmask);
+            }
+        }
+    }
+    ref_ms = now_ms() - start;
+
+    start = now_ms();
+    for (c = 0; c < SWEEP_STEPS; c++) {
+        for (b = 0; b < SWEEP_STEPS; b++) {
+            for (g = 0; g < SWEEP_STEPS; g++) {
+                set_input(&input, c, b, g);
+                NvCtrlUpdateGammaRamp(&input, TIMING_RAMP_SIZE, ramp,
+                                      bitmask);
+            }
+        }
+    }
+    new_ms = now_ms() - start;
+
+    printf("%s, %d entries: per entry %.2f ms, per channel %.2f ms "
+           "(%.1fx).\n", what, TIMING_RAMP_SIZE, ref_ms, new_ms,
+           new_ms > 0.0 ? ref_ms / new_ms : 0.0);
+}
+
+
+
+int main(void)
+{
+    unsigned short *ramp[3], *ref[3];
+    int ch, mismatches;
+
+    for (ch = 0; ch < 3; ch++) {
+        ramp[ch] = malloc(MAX_RAMP_SIZE * sizeof(unsigned short));
+        ref[ch] = malloc(MAX_RAMP_SIZE * sizeof(unsigned short));
+        if (!ramp[ch] || !ref[ch]) {
+            fprintf(stderr, "Out of memory.\n");
+            return 1;
+        }
+    }
+
+    mismatches = check_ramps(ramp, ref);
+
+    time_ramps(ramp, ref, RED_CHANNEL, "One channel");
+    time_ramps(ramp, ref, ALL_CHANNELS, "All channels");
+
+    for (ch = 0; ch < 3; ch++) {
+        free(ramp[ch]);
+        free(ref[ch]);
+    }
+
+    return mismatches ? 1 : 0;
+}
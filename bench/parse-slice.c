@@ -0,0 +1,274 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2004 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * parse-slice.c - checks that parse_token_value_slices() hands its callback
+ * the same tokens and values as parse_token_value_pairs() gives as copies,
+ * and that the slice helpers agree with atoi() and nv_strcasecmp() on them;
+ * then times both tokenizers on large blobs of modeline and metamode
+ * token strings, as polled from the X server.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "parse.h"
+#include "common-utils.h"
+#include "NvCtrlAttributes.h"
+
+/* number of entries in each generated blob */
+#define BLOB_ENTRIES 4096
+
+/* number of times each blob is parsed for the timings */
+#define TIMING_ROUNDS 50
+
+
+
+/*
+ * parse.c frees the target lists of parsed assignments with this; no
+ * assignment is parsed here.
+ */
+void NvCtrlTargetListFree(CtrlTargetNode *head)
+{
+}
+
+
+
+/*
+ * Every token and value seen by either parser is appended to a log, so
+ * that both runs can be compared as a whole.
+ */
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t size;
+    int pairs;
+    int mismatches;  /* slice helpers disagreeing with the string ones */
+} TokenLog;
+
+static void log_append(TokenLog *log, const char *str, size_t len, char sep)
+{
+    if (log->len + len + 1 > log->size) {
+        log->size = (log->len + len + 1) * 2;
+        log->buf = nvrealloc(log->buf, log->size);
+    }
+    memcpy(log->buf + log->len, str, len);
+    log->len += len;
+    log->buf[log->len++] = sep;
+}
+
+static void log_pair(char *token, char *value, void *data)
+{
+    TokenLog *log = data;
+
+    log_append(log, token, strlen(token), '=');
+    log_append(log, value, strlen(value), ';');
+    log->pairs++;
+}
+
+static void log_slice_pair(ParseSlice token, ParseSlice value, void *data)
+{
+    TokenLog *log = data;
+    char *t = parse_slice_strdup(token);
+    char *v = parse_slice_strdup(value);
+
+    if ((parse_slice_atoi(value) != atoi(v)) ||
+        (parse_slice_strcasecmp(token, "source") !=
+         nv_strcasecmp(t, "source")) ||
+        (parse_slice_strcasecmp(value, v) != NV_TRUE)) {
+        log->mismatches++;
+    }
+
+    log_append(log, token.str, token.len, '=');
+    log_append(log, value.str, value.len, ';');
+    log->pairs++;
+
+    nvfree(t);
+    nvfree(v);
+}
+
+/* Callbacks for the timings, which only look at the tokens */
+
+static void count_pair(char *token, char *value, void *data)
+{
+    if (nv_strcasecmp(token, "id")) {
+        (*(int *)data) += atoi(value);
+    }
+}
+
+static void count_slice_pair(ParseSlice token, ParseSlice value, void *data)
+{
+    if (parse_slice_strcasecmp(token, "id")) {
+        (*(int *)data) += parse_slice_atoi(value);
+    }
+}
+
+
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/*
+ * Token strings shaped like the ones nvidia-settings parses: the tokens
+ * before "::" in the modeline and metamode lists, with the odd spacing and
+ * parenthesized values the syntax allows.
+ */
+static char **make_modeline_blob(void)
+{
+    char **blob = nvalloc(BLOB_ENTRIES * sizeof(char *));
+    int i;
+
+    for (i = 0; i < BLOB_ENTRIES; i++) {
+        blob[i] = nvasprintf("source=%s, xconfig-name=%dx%d_%d, "
+                             "id=%d",
+                             (i % 3) ? "edid" : "xconfig",
+                             640 + 8 * i, 480 + 4 * i, 60 + (i % 5), i);
+    }
+
+    return blob;
+}
+
+static char **make_metamode_blob(void)
+{
+    char **blob = nvalloc(BLOB_ENTRIES * sizeof(char *));
+    int i;
+
+    for (i = 0; i < BLOB_ENTRIES; i++) {
+        blob[i] = nvasprintf("id=%d, switchable=%s, source = %s , "
+                             "syncedWith=(DPY-%d, DPY-%d) ,x=%d,y= %d",
+                             50 + i, (i % 2) ? "yes" : "no",
+                             (i % 4) ? "nv-control" : "implicit",
+                             i % 8, (i + 1) % 8, 1920 * (i % 3), 0);
+    }
+
+    return blob;
+}
+
+static void free_blob(char **blob)
+{
+    int i;
+
+    for (i = 0; i < BLOB_ENTRIES; i++) {
+        nvfree(blob[i]);
+    }
+    nvfree(blob);
+}
+
+
+
+/*
+ * Parses every entry of the blob with both tokenizers, and compares what
+ * they saw.  Returns the number of differences.
+ */
+static int check_blob(char **blob, const char *what)
+{
+    TokenLog pairs, slices;
+    int i, ret = 0;
+
+    memset(&pairs, 0, sizeof(pairs));
+    memset(&slices, 0, sizeof(slices));
+
+    for (i = 0; i < BLOB_ENTRIES; i++) {
+        if (parse_token_value_pairs(blob[i], log_pair, &pairs) !=
+            parse_token_value_slices(blob[i], log_slice_pair, &slices)) {
+            ret++;
+        }
+    }
+
+    if ((pairs.len != slices.len) ||
+        (pairs.len && memcmp(pairs.buf, slices.buf, pairs.len) != 0)) {
+        ret++;
+    }
+    ret += slices.mismatches;
+
+    printf("%s: %d entries, %d token/value pairs, %d difference(s).\n",
+           what, BLOB_ENTRIES, pairs.pairs, ret);
+
+    nvfree(pairs.buf);
+    nvfree(slices.buf);
+
+    return ret;
+}
+
+static void time_blob(char **blob, const char *what)
+{
+    double start, pairs_ms, slices_ms;
+    int i, round, pairs_sum = 0, slices_sum = 0;
+
+    start = now_ms();
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        for (i = 0; i < BLOB_ENTRIES; i++) {
+            parse_token_value_pairs(blob[i], count_pair, &pairs_sum);
+        }
+    }
+    pairs_ms = now_ms() - start;
+
+    start = now_ms();
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        for (i = 0; i < BLOB_ENTRIES; i++) {
+            parse_token_value_slices(blob[i], count_slice_pair, &slices_sum);
+        }
+    }
+    slices_ms = now_ms() - start;
+
+    printf("%s, %d passes: copies %.2f ms, slices %.2f ms (%.1fx)%s.\n",
+           what, TIMING_ROUNDS, pairs_ms, slices_ms,
+           slices_ms > 0.0 ? pairs_ms / slices_ms : 0.0,
+           (pairs_sum != slices_sum) ? ", RESULTS DIFFER" : "");
+}
+
+
+
+int main(void)
+{
+    /* corner cases of the syntax */
+    static const char *edge_cases[] = {
+        "", "   ", "a", "a=", "=b", "a=1,", "a = 1 , b = 2",
+        "a=(1, 2), b=(3", "a=()", " id = 17 ,source= xconfig\t",
+        "a=1,,b=2", "a\t=\t(x , y )\n,b=\r",
+    };
+    char **modelines = make_modeline_blob();
+    char **metamodes = make_metamode_blob();
+    char **edges = nvalloc(BLOB_ENTRIES * sizeof(char *));
+    int i, differences = 0;
+
+    for (i = 0; i < BLOB_ENTRIES; i++) {
+        edges[i] = nvstrdup(edge_cases[i % ARRAY_LEN(edge_cases)]);
+    }
+
+    differences += check_blob(modelines, "Modelines");
+    differences += check_blob(metamodes, "MetaModes");
+    differences += check_blob(edges, "Corner cases");
+
+    time_blob(modelines, "Modelines");
+    time_blob(metamodes, "MetaModes");
+
+    free_blob(modelines);
+    free_blob(metamodes);
+    free_blob(edges);
+
+    return differences ? 1 : 0;
+}
@@ -0,0 +1,321 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * xconfig-parse.c - measures the throughput of the X configuration parser
+ * on a keyword heavy configuration.  Checks that the keywords are matched
+ * as xconfigNameCompare() matches them, by parsing the configuration once
+ * with the keywords as written by nvidia-xconfig and once with their case
+ * and '_' separators mangled; and that parses running on several threads
+ * at once, which share the keyword indices, all give the configuration
+ * parsed on a single thread.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "XF86Config-parser/xf86Parser.h"
+#include "common-utils.h"
+
+/* number of Monitor, Device and Screen sections */
+#define CONFIG_SECTIONS 300
+
+/* number of threads parsing at once, and parses per thread */
+#define PARSE_THREADS 4
+#define PARSES_PER_THREAD 5
+
+/* number of times the configuration is parsed for the timings */
+#define TIMING_ROUNDS 10
+
+
+
+/*
+ * The one entry point that users of the XF86Config-parser must provide;
+ * only errors are reported.
+ */
+
+void xconfigPrint(MsgType t, const char *msg)
+{
+    if (t == ParseErrorMsg || t == ValidationErrorMsg ||
+        t == InternalErrorMsg || t == ErrorMsg) {
+        fprintf(stderr, "%s\n", msg);
+    }
+}
+
+
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/*
+ * Writes a keyword, or, if 'mangle' is set, a spelling of it that differs
+ * in case and '_' separators, as hand edited files may.
+ */
+
+static void put_keyword(FILE *fp, const char *keyword, int mangle, int n)
+{
+    const char *c;
+
+    for (c = keyword; *c; c++) {
+        if (!mangle) {
+            fputc(*c, fp);
+        } else {
+            fputc(((c - keyword + n) % 2) ? toupper(*c) : tolower(*c), fp);
+            if ((c - keyword) % 3 == 1) {
+                fputc('_', fp);
+            }
+        }
+    }
+}
+
+/*
+ * A configuration where most lines start with a section keyword, with
+ * lines of the main keywords of the Monitor, Device and Screen sections.
+ */
+
+static char *make_config(int mangle, size_t *len)
+{
+    static const char *monitor[] = {
+        "VendorName \"Unknown\"", "ModelName \"DFP\"",
+        "HorizSync 28.0 - 33.0", "VertRefresh 43.0 - 72.0",
+        "Option \"DPMS\"", "Gamma 1.0",
+    };
+    static const char *device[] = {
+        "Driver \"nvidia\"", "VendorName \"NVIDIA Corporation\"",
+        "BoardName \"GPU\"", "Option \"Coolbits\" \"28\"",
+        "Option \"TripleBuffer\" \"True\"", "Screen 0",
+    };
+    static const char *screen[] = {
+        "DefaultDepth 24", "Option \"Stereo\" \"0\"",
+        "Option \"metamodes\" \"nvidia-auto-select +0+0\"",
+    };
+    char *text = NULL;
+    FILE *fp = open_memstream(&text, len);
+    int i, j, n = 0;
+
+#define PUT_LINE(indent, line)                                            \
+    do {                                                                  \
+        const char *sp = strchr(line, ' ');                               \
+        char *kw = strndup(line, sp - (line));                            \
+        fputs(indent, fp);                                                \
+        put_keyword(fp, kw, mangle, n++);                                 \
+        fprintf(fp, "%s\n", sp);                                          \
+        free(kw);                                                         \
+    } while (0)
+
+    fprintf(fp, "Section \"ServerLayout\"\n"
+                "    Identifier \"Layout0\"\n");
+    for (i = 0; i < CONFIG_SECTIONS; i++) {
+        fprintf(fp, "    Screen %d \"Screen%d\" 0 0\n", i, i);
+    }
+    fprintf(fp, "EndSection\n\n");
+
+    for (i = 0; i < CONFIG_SECTIONS; i++) {
+        fprintf(fp, "Section \"Monitor\"\n    Identifier \"Monitor%d\"\n", i);
+        for (j = 0; j < ARRAY_LEN(monitor); j++) {
+            PUT_LINE("    ", monitor[(i + j) % ARRAY_LEN(monitor)]);
+        }
+        fprintf(fp, "EndSection\n\n");
+
+        fprintf(fp, "Section \"Device\"\n    Identifier \"Device%d\"\n", i);
+        for (j = 0; j < ARRAY_LEN(device); j++) {
+            PUT_LINE("    ", device[(i + j) % ARRAY_LEN(device)]);
+        }
+        fprintf(fp, "EndSection\n\n");
+
+        fprintf(fp, "Section \"Screen\"\n    Identifier \"Screen%d\"\n"
+                    "    Device \"Device%d\"\n    Monitor \"Monitor%d\"\n",
+                i, i, i);
+        for (j = 0; j < ARRAY_LEN(screen); j++) {
+            PUT_LINE("    ", screen[j]);
+        }
+        fprintf(fp, "    SubSection \"Display\"\n");
+        PUT_LINE("        ", "Depth 24");
+        PUT_LINE("        ", "Modes \"1920x1080\" \"1280x1024\"");
+        PUT_LINE("        ", "Virtual 3840 2160");
+        fprintf(fp, "    EndSubSection\nEndSection\n\n");
+    }
+
+#undef PUT_LINE
+
+    fclose(fp);
+
+    return text;
+}
+
+/*
+ * Parses the configuration from memory, and returns it written back into a
+ * string, or NULL if it could not be parsed.
+ */
+
+static char *parse_config(const char *text, size_t len)
+{
+    XConfigPtr config = NULL;
+    char *out = NULL;
+    size_t out_len = 0;
+    FILE *fp;
+
+    if (xconfigReadConfigBuffer(text, len, "bench.conf", &config) !=
+        XCONFIG_RETURN_SUCCESS) {
+        return NULL;
+    }
+
+    fp = open_memstream(&out, &out_len);
+    xconfigWriteConfigStream(fp, config);
+    fclose(fp);
+
+    xconfigFreeConfig(&config);
+
+    return out;
+}
+
+
+
+typedef struct {
+    const char *text;
+    size_t len;
+    const char *expected;
+    int differences;
+} ParseThread;
+
+static void *parse_thread(void *arg)
+{
+    ParseThread *t = arg;
+    int i;
+
+    for (i = 0; i < PARSES_PER_THREAD; i++) {
+        char *out = parse_config(t->text, t->len);
+
+        if (!out || strcmp(out, t->expected) != 0) {
+            t->differences++;
+        }
+        free(out);
+    }
+
+    return NULL;
+}
+
+/*
+ * Parses the configuration on several threads at once, and returns the
+ * number of parses that differ from 'expected'.
+ */
+
+static int check_threads(const char *text, size_t len, const char *expected,
+                         double *elapsed_ms)
+{
+    ParseThread threads[PARSE_THREADS];
+    pthread_t ids[PARSE_THREADS];
+    double start;
+    int i, ret = 0;
+
+    start = now_ms();
+
+    for (i = 0; i < PARSE_THREADS; i++) {
+        threads[i].text = text;
+        threads[i].len = len;
+        threads[i].expected = expected;
+        threads[i].differences = 0;
+        if (pthread_create(&ids[i], NULL, parse_thread, &threads[i]) != 0) {
+            parse_thread(&threads[i]);
+            ids[i] = pthread_self();
+        }
+    }
+
+    for (i = 0; i < PARSE_THREADS; i++) {
+        if (!pthread_equal(ids[i], pthread_self())) {
+            pthread_join(ids[i], NULL);
+        }
+        ret += threads[i].differences;
+    }
+
+    *elapsed_ms = now_ms() - start;
+
+    return ret;
+}
+
+
+
+int main(void)
+{
+    char *text, *mangled, *expected, *out;
+    size_t len, mangled_len;
+    double start, elapsed, best_ms = 0.0, threads_ms;
+    int round, lines = 0, differences = 0, thread_differences;
+    const char *c;
+
+    text = make_config(0, &len);
+    mangled = make_config(1, &mangled_len);
+
+    for (c = text; *c; c++) {
+        lines += (*c == '\n');
+    }
+
+    expected = parse_config(text, len);
+    out = parse_config(mangled, mangled_len);
+
+    if (!expected || !out || strcmp(expected, out) != 0) {
+        differences++;
+    }
+
+    printf("Parsed %d lines (%zu KiB), and with mangled keywords: "
+           "%d difference(s).\n", lines, len / 1024, differences);
+
+    free(out);
+
+    if (!expected) {
+        return 1;
+    }
+
+    thread_differences = check_threads(text, len, expected, &threads_ms);
+    differences += thread_differences;
+
+    printf("%d threads, %d parses each: %.2f ms, %d difference(s).\n",
+           PARSE_THREADS, PARSES_PER_THREAD, threads_ms, thread_differences);
+
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        start = now_ms();
+        out = parse_config(text, len);
+        elapsed = now_ms() - start;
+        free(out);
+
+        if ((round == 0) || (elapsed < best_ms)) {
+            best_ms = elapsed;
+        }
+    }
+
+    printf("Best of %d parses and write backs: %.2f ms (%.0f lines/s, "
+           "%.1f MiB/s).\n", TIMING_ROUNDS, best_ms,
+           best_ms > 0.0 ? lines / (best_ms / 1000.0) : 0.0,
+           best_ms > 0.0 ? (len / 1048576.0) / (best_ms / 1000.0) : 0.0);
+
+    free(expected);
+    free(mangled);
+    free(text);
+
+    return differences ? 1 : 0;
+}
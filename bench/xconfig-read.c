@@ -0,0 +1,291 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * xconfig-read.c - writes a large generated X configuration file, parses
+ * it both from the file, as xconfigOpenConfigFile() and
+ * xconfigReadConfigFile() do, and from memory through a parse context, and
+ * checks that both give the same configuration once written back; also
+ * checks that a context is not created without a buffer; then times both
+ * ways of parsing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "XF86Config-parser/xf86Parser.h"
+
+/* number of GPUs, and so of Device, Monitor and Screen sections */
+#define CONFIG_GPUS 1000
+
+/* number of times the configuration is parsed for the timings */
+#define TIMING_ROUNDS 5
+
+
+
+/*
+ * The one entry point that users of the XF86Config-parser must provide;
+ * only errors are reported.
+ */
+
+void xconfigPrint(MsgType t, const char *msg)
+{
+    if (t == ParseErrorMsg || t == ValidationErrorMsg ||
+        t == InternalErrorMsg || t == ErrorMsg) {
+        fprintf(stderr, "%s\n", msg);
+    }
+}
+
+
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/*
+ * A configuration as written by nvidia-xconfig for a large number of GPUs,
+ * with comments, options and modelines in every section.
+ */
+
+static char *make_config(size_t *len)
+{
+    char *text = NULL;
+    FILE *fp = open_memstream(&text, len);
+    int i;
+
+    fprintf(fp, "# Generated X configuration, %d GPUs\n\n", CONFIG_GPUS);
+
+    fprintf(fp, "Section \"ServerLayout\"\n"
+                "    Identifier     \"Layout0\"\n");
+    for (i = 0; i < CONFIG_GPUS; i++) {
+        fprintf(fp, "    Screen      %d  \"Screen%d\" %d 0\n", i, i, i * 1920);
+    }
+    fprintf(fp, "    InputDevice    \"Keyboard0\" \"CoreKeyboard\"\n"
+                "    Option         \"Xinerama\" \"0\"\n"
+                "EndSection\n\n");
+
+    fprintf(fp, "Section \"InputDevice\"\n"
+                "    Identifier     \"Keyboard0\"\n"
+                "    Driver         \"keyboard\"\n"
+                "EndSection\n\n");
+
+    for (i = 0; i < CONFIG_GPUS; i++) {
+        fprintf(fp, "# GPU %d\n"
+                    "Section \"Monitor\"\n"
+                    "    Identifier     \"Monitor%d\"\n"
+                    "    VendorName     \"Unknown\"\n"
+                    "    ModelName      \"DFP-%d\"\n"
+                    "    HorizSync       28.0 - 33.0\n"
+                    "    VertRefresh     43.0 - 72.0\n"
+                    "    ModeLine       \"1920x1080_%d\" 148.50 1920 2008 2052 "
+                    "2200 1080 1084 1089 1125 +hsync +vsync\n"
+                    "    Option         \"DPMS\"\n"
+                    "EndSection\n\n", i, i, i, i);
+
+        fprintf(fp, "Section \"Device\"\n"
+                    "    Identifier     \"Device%d\"\n"
+                    "    Driver         \"nvidia\"\n"
+                    "    VendorName     \"NVIDIA Corporation\"\n"
+                    "    BusID          \"PCI:%d:0:0\"\n"
+                    "    Screen          0\n"
+                    "    Option         \"Coolbits\" \"%d\"\n"
+                    "    Option         \"TripleBuffer\" \"True\"\n"
+                    "    Option         \"Stereo\" \"0\"\n"
+                    "EndSection\n\n", i, i + 1, i % 32);
+
+        fprintf(fp, "Section \"Screen\"\n"
+                    "    Identifier     \"Screen%d\"\n"
+                    "    Device         \"Device%d\"\n"
+                    "    Monitor        \"Monitor%d\"\n"
+                    "    DefaultDepth    24\n"
+                    "    Option         \"metamodes\" \"DP-%d: nvidia-auto-"
+                    "select +0+0 {ForceCompositionPipeline=On}\"\n"
+                    "    Option         \"AllowIndirectGLXProtocol\" \"off\"\n"
+                    "    SubSection     \"Display\"\n"
+                    "        Depth       24\n"
+                    "        Modes      \"1920x1080_%d\" \"1280x1024\"\n"
+                    "    EndSubSection\n"
+                    "EndSection\n\n", i, i, i, i % 4, i);
+    }
+
+    fclose(fp);
+
+    return text;
+}
+
+/*
+ * Writes the parsed configuration back into a string, so that two parses
+ * can be compared.
+ */
+
+static char *write_config(XConfigPtr config)
+{
+    char *text = NULL;
+    size_t len = 0;
+    FILE *fp = open_memstream(&text, &len);
+
+    xconfigWriteConfigStream(fp, config);
+    fclose(fp);
+
+    return text;
+}
+
+
+
+static XConfigPtr read_file(const char *path)
+{
+    XConfigPtr config = NULL;
+
+    if (!xconfigOpenConfigFile(path, NULL)) {
+        return NULL;
+    }
+    if (xconfigReadConfigFile(&config) != XCONFIG_RETURN_SUCCESS) {
+        config = NULL;
+    }
+    xconfigCloseConfigFile();
+
+    return config;
+}
+
+static XConfigPtr read_buffer(const char *text, size_t len, const char *path)
+{
+    XConfigPtr config = NULL;
+
+    if (xconfigReadConfigBuffer(text, len, path, &config) !=
+        XCONFIG_RETURN_SUCCESS) {
+        return NULL;
+    }
+
+    return config;
+}
+
+
+
+/*
+ * Checks that parsing from the file and from memory give the same
+ * configuration, and that a NULL buffer is rejected.  Returns the number
+ * of differences.
+ */
+
+static int check_config(const char *text, size_t len, const char *path)
+{
+    XConfigPtr from_file, from_buffer, from_null = NULL;
+    char *file_text = NULL, *buffer_text = NULL;
+    int ret = 0;
+
+    from_file = read_file(path);
+    from_buffer = read_buffer(text, len, path);
+
+    if (!from_file || !from_buffer) {
+        ret++;
+    } else {
+        file_text = write_config(from_file);
+        buffer_text = write_config(from_buffer);
+        if (strcmp(file_text, buffer_text) != 0) {
+            ret++;
+        }
+    }
+
+    if (xconfigCreateParseContext(NULL, 0, path) ||
+        (xconfigReadConfigBuffer(NULL, 0, path, &from_null) !=
+         XCONFIG_RETURN_PARSE_ERROR) || from_null) {
+        ret++;
+    }
+
+    printf("Parsed %zu KiB from the file and from memory: written back, "
+           "%zu and %zu KiB; %d difference(s).\n", len / 1024,
+           file_text ? strlen(file_text) / 1024 : 0,
+           buffer_text ? strlen(buffer_text) / 1024 : 0, ret);
+
+    free(file_text);
+    free(buffer_text);
+    xconfigFreeConfig(&from_file);
+    xconfigFreeConfig(&from_buffer);
+
+    return ret;
+}
+
+static void time_config(const char *text, size_t len, const char *path)
+{
+    double start, elapsed, file_ms = 0.0, buffer_ms = 0.0;
+    XConfigPtr config;
+    int round;
+
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+        start = now_ms();
+        config = read_file(path);
+        elapsed = now_ms() - start;
+        xconfigFreeConfig(&config);
+        if ((round == 0) || (elapsed < file_ms)) {
+            file_ms = elapsed;
+        }
+
+        start = now_ms();
+        config = read_buffer(text, len, path);
+        elapsed = now_ms() - start;
+        xconfigFreeConfig(&config);
+        if ((round == 0) || (elapsed < buffer_ms)) {
+            buffer_ms = elapsed;
+        }
+    }
+
+    printf("Best of %d parses: file %.2f ms, memory %.2f ms "
+           "(%.1f MiB/s).\n", TIMING_ROUNDS, file_ms, buffer_ms,
+           buffer_ms > 0.0 ? (len / 1048576.0) / (buffer_ms / 1000.0) : 0.0);
+}
+
+
+
+int main(void)
+{
+    const char *tmpdir = getenv("TMPDIR");
+    char path[4096];
+    size_t len;
+    char *text;
+    FILE *fp;
+    int fd, differences;
+
+    snprintf(path, sizeof(path), "%s/nvidia-settings-bench-XXXXXX.conf",
+             tmpdir ? tmpdir : "/tmp");
+    fd = mkstemps(path, 5);
+    if (fd < 0 || !(fp = fdopen(fd, "w"))) {
+        fprintf(stderr, "Unable to create '%s': %s.\n", path, strerror(errno));
+        return 1;
+    }
+
+    text = make_config(&len);
+    fwrite(text, 1, len, fp);
+    fclose(fp);
+
+    differences = check_config(text, len, path);
+    time_config(text, len, path);
+
+    unlink(path);
+    free(text);
+
+    return differences ? 1 : 0;
+}
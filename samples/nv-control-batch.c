@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024 NVIDIA, Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * nv-control-batch.c - trivial sample NV-CONTROL client that demonstrates
+ * how to query many integer attributes with a single pipelined request
+ * batch, and compares the wall clock time against issuing one
+ * XNVCTRLQueryTargetAttribute() round trip per attribute.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <X11/Xlib.h>
+
+#include "NVCtrl.h"
+#include "NVCtrlLib.h"
+
+#include "nv-control-screen.h"
+
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec * 1000.0) + (ts.tv_nsec / 1000000.0);
+}
+
+
+int main(int argc, char *argv[])
+{
+    Display *dpy;
+    XNVCTRLAttributeQuery *queries;
+    int screen, i, iter, count, iterations, found = 0, mismatch = 0;
+    double start, serial_ms, batch_ms;
+
+    iterations = (argc > 1) ? atoi(argv[1]) : 10;
+    if (iterations <= 0) {
+        iterations = 1;
+    }
+
+    /*
+     * Open a display connection, and make sure the NV-CONTROL X
+     * extension is present on the screen we want to use.
+     */
+
+    dpy = XOpenDisplay(NULL);
+    if (!dpy) {
+        fprintf(stderr, "Cannot open display '%s'.\n", XDisplayName(NULL));
+        return 1;
+    }
+
+    screen = GetNvXScreen(dpy);
+
+    /*
+     * Build one query per integer attribute id against the X screen; the
+     * server reports the ones that do not apply as non-existent.
+     */
+
+    count = NV_CTRL_LAST_ATTRIBUTE + 1;
+    queries = calloc(count, sizeof(*queries));
+    if (!queries) {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }
+
+    for (i = 0; i < count; i++) {
+        queries[i].target_type = NV_CTRL_TARGET_TYPE_X_SCREEN;
+        queries[i].target_id = screen;
+        queries[i].display_mask = 0;
+        queries[i].attribute = i;
+    }
+
+    /* One round trip per attribute */
+
+    start = now_ms();
+    for (iter = 0; iter < iterations; iter++) {
+        for (i = 0; i < count; i++) {
+            int value;
+            XNVCTRLQueryTargetAttribute(dpy, NV_CTRL_TARGET_TYPE_X_SCREEN,
+                                        screen, 0, i, &value);
+        }
+    }
+    serial_ms = (now_ms() - start) / iterations;
+
+    /* One pipelined batch for all attributes */
+
+    start = now_ms();
+    for (iter = 0; iter < iterations; iter++) {
+        if (!XNVCTRLQueryTargetAttributesBatch(dpy, queries, count)) {
+            fprintf(stderr, "Failed to query the attribute batch.\n");
+            free(queries);
+            return 1;
+        }
+    }
+    batch_ms = (now_ms() - start) / iterations;
+
+    /* Make sure both paths agree on the results */
+
+    for (i = 0; i < count; i++) {
+        int value;
+        Bool exists = XNVCTRLQueryTargetAttribute(dpy,
+                                                  NV_CTRL_TARGET_TYPE_X_SCREEN,
+                                                  screen, 0, i, &value);
+        if (exists != queries[i].exists ||
+            (exists && value != (int) queries[i].value)) {
+            mismatch++;
+        }
+        if (queries[i].exists) {
+            found++;
+        }
+    }
+
+    printf("\n");
+    printf("Queried %d attributes (%d present) on X screen %d of '%s', "
+           "averaged over %d iteration(s):\n\n",
+           count, found, screen, XDisplayName(NULL), iterations);
+    printf("  one request per attribute: %10.3f ms\n", serial_ms);
+    printf("  pipelined batch:           %10.3f ms\n", batch_ms);
+    if (batch_ms > 0.0) {
+        printf("  speedup:                   %10.2fx\n", serial_ms / batch_ms);
+    }
+    if (mismatch) {
+        printf("\n  WARNING: %d attribute(s) differed between the two "
+               "methods.\n", mismatch);
+    }
+    printf("\n");
+
+    free(queries);
+    XCloseDisplay(dpy);
+
+    return mismatch ? 1 : 0;
+}
@@ -14,6 +14,7 @@ SAMPLES_EXTRA_DIST += nv-control-targets.c
 SAMPLES_EXTRA_DIST += nv-control-framelock.c
 SAMPLES_EXTRA_DIST += nv-control-warpblend.c
 SAMPLES_EXTRA_DIST += nv-control-warpblend.h
+SAMPLES_EXTRA_DIST += nv-control-batch.c
 SAMPLES_EXTRA_DIST += nv-control-screen.h
 SAMPLES_EXTRA_DIST += src.mk
 
@@ -76,6 +76,29 @@ typedef struct
 LexRec, *LexPtr;
 
 
+/*
+ * An index by name over an option list, for code that looks up, sets or
+ * removes many options in the same list; see xconfigOptionIndexInit().
+ */
+
+typedef struct
+{
+    XConfigOptionPtr *pHead;    /* the indexed list */
+    XConfigOptionPtr tail;      /* last option in the list */
+    XConfigOptionPtr *options;  /* indexed options; NULL once removed */
+    unsigned int *hashes;       /* xconfigNameHash() of each option name */
+    int *next;                  /* entry + 1 of the next entry in bucket */
+    int num_entries;
+    int max_entries;
+    int *buckets;               /* entry + 1 of the first entry in bucket */
+    int num_buckets;            /* power of two */
+    XConfigOptionPtr *removed;  /* removed options, still in the list */
+    int num_removed;
+    int max_removed;
+}
+XConfigOptionIndexRec, *XConfigOptionIndexPtr;
+
+
 #include "configProcs.h"
 #include <stdlib.h>
 
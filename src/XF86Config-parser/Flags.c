@@ -324,6 +324,284 @@ xconfigFindOption (XConfigOptionPtr list, const char *name)
     return (NULL);
 }
 
+/*
+ * xconfigOptionIndexInit() - index the option list *pHead by name, so
+ * that options can be looked up, set and removed without walking the
+ * list.  The options stay in the list, in order.  Options removed through
+ * the index stay linked (though they can no longer be found) until
+ * xconfigOptionIndexFinish(), which unlinks and frees them, and frees the
+ * index.  The list must not be modified other than through the index
+ * until then.
+ *
+ * Every option is indexed, including duplicates of a name.  Entries are
+ * numbered in list order, and each hash chain is kept in that order, so
+ * that a lookup finds the first option of that name still in the list, as
+ * xconfigFindOption() would; options removed through the index are
+ * unlinked from their chain.
+ *
+ * If the index cannot be allocated, the index functions fall back to
+ * walking the list.
+ */
+
+static void OptionIndexLink(XConfigOptionIndexPtr idx, int e)
+{
+    int *pe = &idx->buckets[idx->hashes[e] & (idx->num_buckets - 1)];
+
+    while (*pe) {
+        pe = &idx->next[*pe - 1];
+    }
+    idx->next[e] = 0;
+    *pe = e + 1;
+}
+
+static int OptionIndexGrow(XConfigOptionIndexPtr idx)
+{
+    XConfigOptionPtr *options;
+    unsigned int *hashes;
+    int *next, *buckets;
+    int max, num_buckets, e;
+
+    if (idx->num_entries < idx->max_entries) {
+        return 1;
+    }
+
+    max = idx->max_entries ? idx->max_entries * 2 : 16;
+
+    options = realloc(idx->options, max * sizeof(XConfigOptionPtr));
+    if (!options) return 0;
+    idx->options = options;
+
+    hashes = realloc(idx->hashes, max * sizeof(unsigned int));
+    if (!hashes) return 0;
+    idx->hashes = hashes;
+
+    next = realloc(idx->next, max * sizeof(int));
+    if (!next) return 0;
+    idx->next = next;
+
+    idx->max_entries = max;
+
+    /* Keep the buckets at least twice the number of entries */
+
+    num_buckets = idx->num_buckets ? idx->num_buckets : 32;
+    while (num_buckets < max * 2) {
+        num_buckets <<= 1;
+    }
+
+    if (num_buckets != idx->num_buckets) {
+        buckets = calloc(num_buckets, sizeof(int));
+        if (!buckets) return 0;
+        free(idx->buckets);
+        idx->buckets = buckets;
+        idx->num_buckets = num_buckets;
+
+        for (e = 0; e < idx->num_entries; e++) {
+            if (idx->options[e]) {
+                OptionIndexLink(idx, e);
+            }
+        }
+    }
+
+    return 1;
+}
+
+static void OptionIndexAdd(XConfigOptionIndexPtr idx, XConfigOptionPtr opt,
+                           unsigned int hash)
+{
+    int e = idx->num_entries++;
+
+    idx->options[e] = opt;
+    idx->hashes[e] = hash;
+    OptionIndexLink(idx, e);
+}
+
+void xconfigOptionIndexInit(XConfigOptionIndexPtr idx,
+                            XConfigOptionPtr *pHead)
+{
+    XConfigOptionPtr opt;
+
+    memset(idx, 0, sizeof(XConfigOptionIndexRec));
+    idx->pHead = pHead;
+
+    if (!OptionIndexGrow(idx)) {
+        xconfigOptionIndexFinish(idx);
+        return;
+    }
+
+    for (opt = *pHead; opt; opt = opt->next) {
+        idx->tail = opt;
+
+        if (!OptionIndexGrow(idx)) {
+            xconfigOptionIndexFinish(idx);
+            return;
+        }
+        OptionIndexAdd(idx, opt, xconfigNameHash(opt->name));
+    }
+}
+
+XConfigOptionPtr xconfigOptionIndexFind(XConfigOptionIndexPtr idx,
+                                        const char *name)
+{
+    unsigned int hash;
+    int e;
+
+    if (!idx->buckets) {
+        return xconfigFindOption(*idx->pHead, name);
+    }
+
+    hash = xconfigNameHash(name);
+
+    for (e = idx->buckets[hash & (idx->num_buckets - 1)];
+         e;
+         e = idx->next[e - 1]) {
+        if (idx->hashes[e - 1] == hash &&
+            xconfigNameCompare(idx->options[e - 1]->name, name) == 0) {
+            return idx->options[e - 1];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * xconfigOptionIndexSet() - like xconfigAddNewOption(): replaces the value
+ * of the named option if it is in the list, and otherwise appends a new
+ * option.  Returns the option, or NULL on allocation failure.
+ */
+
+XConfigOptionPtr xconfigOptionIndexSet(XConfigOptionIndexPtr idx,
+                                       const char *name, const char *val)
+{
+    XConfigOptionPtr opt;
+
+    if (!idx->buckets) {
+        xconfigAddNewOption(idx->pHead, name, val);
+        return xconfigFindOption(*idx->pHead, name);
+    }
+
+    opt = xconfigOptionIndexFind(idx, name);
+    if (opt) {
+        TEST_FREE(opt->name);
+        TEST_FREE(opt->val);
+        opt->name = xconfigStrdup(name);
+        opt->val = xconfigStrdup(val);
+        return opt;
+    }
+
+    if (!OptionIndexGrow(idx)) {
+        xconfigOptionIndexFinish(idx);
+        return xconfigOptionIndexSet(idx, name, val);
+    }
+
+    opt = xconfigNewOption(name, val);
+    if (!opt) {
+        return NULL;
+    }
+
+    if (idx->tail) {
+        idx->tail->next = opt;
+    } else {
+        *idx->pHead = opt;
+    }
+    idx->tail = opt;
+
+    OptionIndexAdd(idx, opt, xconfigNameHash(name));
+
+    return opt;
+}
+
+/*
+ * xconfigOptionIndexRemove() - removes an option found through the index.
+ * The option is unlinked and freed by xconfigOptionIndexFinish().
+ */
+
+void xconfigOptionIndexRemove(XConfigOptionIndexPtr idx,
+                              XConfigOptionPtr opt)
+{
+    unsigned int hash;
+    int *pe;
+
+    if (!idx->buckets) {
+        xconfigRemoveOption(idx->pHead, opt);
+        return;
+    }
+
+    if (idx->num_removed >= idx->max_removed) {
+        int max = idx->max_removed ? idx->max_removed * 2 : 16;
+        XConfigOptionPtr *removed =
+            realloc(idx->removed, max * sizeof(XConfigOptionPtr));
+
+        if (!removed) {
+            xconfigOptionIndexFinish(idx);
+            xconfigRemoveOption(idx->pHead, opt);
+            return;
+        }
+        idx->removed = removed;
+        idx->max_removed = max;
+    }
+
+    hash = xconfigNameHash(opt->name);
+
+    for (pe = &idx->buckets[hash & (idx->num_buckets - 1)];
+         *pe;
+         pe = &idx->next[*pe - 1]) {
+        if (idx->options[*pe - 1] == opt) {
+            idx->options[*pe - 1] = NULL;
+            *pe = idx->next[*pe - 1];
+            idx->removed[idx->num_removed++] = opt;
+            return;
+        }
+    }
+}
+
+static int ComparePointers(const void *a, const void *b)
+{
+    unsigned long pa = (unsigned long) *(XConfigOptionPtr const *) a;
+    unsigned long pb = (unsigned long) *(XConfigOptionPtr const *) b;
+
+    return (pa > pb) - (pa < pb);
+}
+
+void xconfigOptionIndexFinish(XConfigOptionIndexPtr idx)
+{
+    XConfigOptionPtr *pOpt;
+
+    if (idx->num_removed) {
+        qsort(idx->removed, idx->num_removed, sizeof(XConfigOptionPtr),
+              ComparePointers);
+
+        pOpt = idx->pHead;
+        while (*pOpt) {
+            XConfigOptionPtr opt = *pOpt;
+
+            if (bsearch(&opt, idx->removed, idx->num_removed,
+                        sizeof(XConfigOptionPtr), ComparePointers)) {
+                *pOpt = opt->next;
+                TEST_FREE(opt->name);
+                TEST_FREE(opt->val);
+                TEST_FREE(opt->comment);
+                free(opt);
+            } else {
+                pOpt = &opt->next;
+            }
+        }
+    }
+
+    free(idx->options);
+    free(idx->hashes);
+    free(idx->next);
+    free(idx->buckets);
+    free(idx->removed);
+
+    idx->options = NULL;
+    idx->hashes = NULL;
+    idx->next = NULL;
+    idx->buckets = NULL;
+    idx->removed = NULL;
+    idx->num_entries = idx->max_entries = idx->num_buckets = 0;
+    idx->num_removed = idx->max_removed = 0;
+}
+
 /*
  * this function searches the given option list for the named option. If
  * found and the option has a parameter, a pointer to the parameter is
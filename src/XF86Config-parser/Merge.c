@@ -124,52 +124,42 @@ static int xconfigOptionValuesDiffer(XConfigOptionPtr option0,
 
 
 /*
- * xconfigMergeOption() - Merge option "name" from option source
- * list "srcHead" to option destination list "dstHead".
+ * xconfigMergeOption() - Merge option "srcOption" from a source option
+ * list into the destination option list indexed by "dst".
  *
  * Merging here means:
  *
- * If the option is not in the source config, do nothing to the
- * destination.  Otherwise, either add or update the option in
- * the dest.  If the option is modified, and a comment is given,
- * then the old option will be commented out instead of being
- * simply removed/replaced.
+ * Either add or update the option in the dest.  If the option is
+ * modified, and a comment is given, then the old option will be
+ * commented out instead of being simply removed/replaced.
  */
-static void xconfigMergeOption(XConfigOptionPtr *dstHead,
-                               XConfigOptionPtr *srcHead,
-                               const char *name, char **comments)
+static void xconfigMergeOption(XConfigOptionIndexPtr dst,
+                               XConfigOptionPtr srcOption,
+                               char **comments)
 {
-    XConfigOptionPtr srcOption = xconfigFindOption(*srcHead, name);
-    XConfigOptionPtr dstOption = xconfigFindOption(*dstHead, name);
+    const char *name = xconfigOptionName(srcOption);
+    XConfigOptionPtr dstOption = xconfigOptionIndexFind(dst, name);
 
-    char *srcValue = NULL;
+    char *srcValue = xconfigOptionValue(srcOption);
 
-    if (!srcOption) {
-        /* Option does not exist in src, do nothing to dst. */
-        return;
-    }
-
-    srcValue = xconfigOptionValue(srcOption);
-
-    if (srcOption && !dstOption) {
+    if (!dstOption) {
 
         /* option exists in src but not in dst: add to dst */
-        xconfigAddNewOption(dstHead, name, srcValue);
+        xconfigOptionIndexSet(dst, name, srcValue);
 
-    } else if (srcOption && dstOption) {
+    } else {
 
         /*
          * option exists in src and in dst; if the option values are
          * different, replace the dst's option value with src's option
-         * value; note that xconfigAddNewOption() will remove the old
-         * option first, if necessary
+         * value
          */
 
         if (xconfigOptionValuesDiffer(srcOption, dstOption)) {
             if (comments) {
                 xconfigAddRemovedOptionComment(comments, dstOption);
             }
-            xconfigAddNewOption(dstHead, name, srcValue);
+            xconfigOptionIndexSet(dst, name, srcValue);
         }
     }
 
@@ -177,6 +167,29 @@ static void xconfigMergeOption(XConfigOptionPtr *dstHead,
 
 
 
+/*
+ * xconfigMergeOptionList() - Merge all the options in the source option
+ * list "srcHead" into the destination option list "dstHead".
+ */
+static void xconfigMergeOptionList(XConfigOptionPtr *dstHead,
+                                   XConfigOptionPtr srcHead,
+                                   char **comments)
+{
+    XConfigOptionIndexRec dst;
+    XConfigOptionPtr option;
+
+    xconfigOptionIndexInit(&dst, dstHead);
+
+    for (option = srcHead; option; option = option->next) {
+        xconfigMergeOption(&dst, option, comments);
+    }
+
+    xconfigOptionIndexFinish(&dst);
+
+} /* xconfigMergeOptionList() */
+
+
+
 /*
  * xconfigMergeFlags() - Updates the destination's list of server flag
  * options with the options found in the source config.
@@ -190,7 +203,6 @@ static void xconfigMergeOption(XConfigOptionPtr *dstHead,
 static int xconfigMergeFlags(XConfigPtr dstConfig, XConfigPtr srcConfig)
 {
     if (srcConfig->flags) {
-        XConfigOptionPtr option;
         
         /* Flag section was not found, create a new one */
         if (!dstConfig->flags) {
@@ -199,14 +211,9 @@ static int xconfigMergeFlags(XConfigPtr dstConfig, XConfigPtr srcConfig)
             if (!dstConfig->flags) return 0;
         }
         
-        option = srcConfig->flags->options;
-        while (option) {
-            xconfigMergeOption(&(dstConfig->flags->options),
-                               &(srcConfig->flags->options),
-                               xconfigOptionName(option),
+        xconfigMergeOptionList(&(dstConfig->flags->options),
+                               srcConfig->flags->options,
                                &(dstConfig->flags->comment));
-            option = option->next;
-        }
     }
     
     return 1;
@@ -394,6 +401,27 @@ static int xconfigMergeAllDevices(XConfigPtr dstConfig, XConfigPtr srcConfig)
 
 
 
+/*
+ * xconfigRemoveIndexedOption() - Like xconfigRemoveNamedOption(), for an
+ * option list indexed with xconfigOptionIndexInit().
+ *
+ */
+static void xconfigRemoveIndexedOption(XConfigOptionIndexPtr idx,
+                                       const char *name, char **comments)
+{
+    XConfigOptionPtr option = xconfigOptionIndexFind(idx, name);
+
+    if (option) {
+        if (comments) {
+            xconfigAddRemovedOptionComment(comments, option);
+        }
+        xconfigOptionIndexRemove(idx, option);
+    }
+
+} /* xconfigRemoveIndexedOption() */
+
+
+
 /*
  * xconfigMergeDriverOptions() - Update the (Screen) driver options
  * of the destination config with information from the source config.
@@ -407,6 +435,39 @@ static int xconfigMergeDriverOptions(XConfigScreenPtr dstScreen,
 {
     XConfigOptionPtr option;
     XConfigDisplayPtr display;
+    XConfigOptionIndexRec deviceOptions, monitorOptions, screenOptions;
+    XConfigOptionIndexPtr displayOptions;
+    int i, num_displays = 0;
+
+    if (!srcScreen->options) {
+        return 1;
+    }
+
+    /*
+     * Index each of the destination option lists, so that merging is
+     * linear in the number of options rather than quadratic.
+     */
+
+    for (display = dstScreen->displays; display; display = display->next) {
+        num_displays++;
+    }
+
+    displayOptions = calloc(num_displays + 1, sizeof(XConfigOptionIndexRec));
+    if (!displayOptions) return 0;
+
+    if (dstScreen->device) {
+        xconfigOptionIndexInit(&deviceOptions, &(dstScreen->device->options));
+    }
+    if (dstScreen->monitor) {
+        xconfigOptionIndexInit(&monitorOptions,
+                               &(dstScreen->monitor->options));
+    }
+    for (display = dstScreen->displays, i = 0;
+         display;
+         display = display->next, i++) {
+        xconfigOptionIndexInit(&displayOptions[i], &(display->options));
+    }
+    xconfigOptionIndexInit(&screenOptions, &(dstScreen->options));
 
     option = srcScreen->options;
     while (option) {
@@ -415,41 +476,55 @@ static int xconfigMergeDriverOptions(XConfigScreenPtr dstScreen,
         /* Remove the option from all non-screen option lists */
         
         if (dstScreen->device) {
-            xconfigRemoveNamedOption(&(dstScreen->device->options), name,
-                                     &(dstScreen->device->comment));
+            xconfigRemoveIndexedOption(&deviceOptions, name,
+                                       &(dstScreen->device->comment));
         }
         if (dstScreen->monitor) {
-            xconfigRemoveNamedOption(&(dstScreen->monitor->options), name,
-                                     &(dstScreen->monitor->comment));
+            xconfigRemoveIndexedOption(&monitorOptions, name,
+                                       &(dstScreen->monitor->comment));
         }       
-        for (display = dstScreen->displays; display; display = display->next) {
-            xconfigRemoveNamedOption(&(display->options), name,
-                                     &(display->comment));
+        for (display = dstScreen->displays, i = 0;
+             display;
+             display = display->next, i++) {
+            xconfigRemoveIndexedOption(&displayOptions[i], name,
+                                       &(display->comment));
         }
 
         /* Update/Add the option to the screen's option list */
         {
             // XXX Only add a comment if the value changed.
             XConfigOptionPtr old =
-                xconfigFindOption(dstScreen->options, name);
+                xconfigOptionIndexFind(&screenOptions, name);
 
             if (old && xconfigOptionValuesDiffer(option, old)) {
-                xconfigRemoveNamedOption(&(dstScreen->options), name,
-                                         &(dstScreen->comment));
+                xconfigRemoveIndexedOption(&screenOptions, name,
+                                           &(dstScreen->comment));
             } else {
-                xconfigRemoveNamedOption(&(dstScreen->options), name,
-                                         NULL);
+                xconfigRemoveIndexedOption(&screenOptions, name, NULL);
             }
         }
 
         /* Add the option to the screen->options list */
 
-        xconfigAddNewOption(&dstScreen->options,
-                            name, xconfigOptionValue(option));
+        xconfigOptionIndexSet(&screenOptions,
+                              name, xconfigOptionValue(option));
         
         option = option->next;
     }
 
+    if (dstScreen->device) {
+        xconfigOptionIndexFinish(&deviceOptions);
+    }
+    if (dstScreen->monitor) {
+        xconfigOptionIndexFinish(&monitorOptions);
+    }
+    for (i = 0; i < num_displays; i++) {
+        xconfigOptionIndexFinish(&displayOptions[i]);
+    }
+    xconfigOptionIndexFinish(&screenOptions);
+
+    free(displayOptions);
+
     return 1;
 
 } /* xconfigMergeDriverOptions() */
@@ -694,16 +769,9 @@ static int xconfigMergeLayout(XConfigPtr dstConfig, XConfigPtr srcConfig)
     /* Merge the options */
     
     if (srcLayout->options) {
-        XConfigOptionPtr srcOption;
-
-        srcOption = srcLayout->options;
-        while (srcOption) {
-            xconfigMergeOption(&(dstLayout->options),
-                               &(srcLayout->options),
-                               xconfigOptionName(srcOption),
+        xconfigMergeOptionList(&(dstLayout->options),
+                               srcLayout->options,
                                &(dstLayout->comment));
-            srcOption = srcOption->next;
-        }
     }
 
     return 1;
@@ -721,7 +789,6 @@ static int xconfigMergeLayout(XConfigPtr dstConfig, XConfigPtr srcConfig)
 static int  xconfigMergeExtensions(XConfigPtr dstConfig, XConfigPtr srcConfig)
 {
    if (srcConfig->extensions) {
-        XConfigOptionPtr option;
 
         /* Extension section was not found, create a new one */
         if (!dstConfig->extensions) {
@@ -730,14 +797,9 @@ static int  xconfigMergeExtensions(XConfigPtr dstConfig, XConfigPtr srcConfig)
             if (!dstConfig->extensions) return 0;
         }
 
-        option = srcConfig->extensions->options;
-        while (option) {
-            xconfigMergeOption(&(dstConfig->extensions->options),
-                               &(srcConfig->extensions->options),
-                               xconfigOptionName(option),
+        xconfigMergeOptionList(&(dstConfig->extensions->options),
+                               srcConfig->extensions->options,
                                &(dstConfig->extensions->comment));
-            option = option->next;
-        }
     }
 
     return 1;
@@ -59,6 +59,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <stdarg.h>
+#include <pthread.h>
 
 #if !defined(X_NOT_POSIX)
 #if defined(_POSIX_SOURCE)
@@ -86,13 +87,20 @@
 
 #define CONFIG_BUF_LEN     1024
 
-static int StringToToken (char *, XConfigSymTabRec *);
+/* number of symbol tables that can be indexed; must be a power of two */
+#define SYMTAB_INDEX_SLOTS 64
+
+static int StringToToken (const char *, XConfigSymTabRec *);
 
 static FILE *configFile = NULL;
+static const char *configMem = NULL; /* in-memory config, if not a file */
+static int configMemLen = 0;
+static int configMemPos = 0;
 static const char **builtinConfig = NULL;
 static int builtinIndex = 0;
 static int configPos = 0;            /* current readers position */
 static char *configBuf, *configRBuf; /* buffer for lines */
+static int configBufLen = CONFIG_BUF_LEN;
 static int pushToken = LOCK_TOKEN;
 static int eol_seen = 0;             /* private state to handle comments */
 LexRec val;
@@ -102,6 +110,43 @@ char *configSection = NULL;   /* name of current section being parsed */
 char *configPath;             /* path to config file */
 
 
+/*
+ * XConfigParseContextRec --
+ *
+ *  The state of a parse.  The parse in progress keeps its state in the
+ *  variables above, which the section parsers use directly; a context
+ *  holds that state for a parse that is not in progress.  Parsing from a
+ *  context swaps its state in for the duration of the parse, so that any
+ *  number of configs may be parsed without disturbing each other or the
+ *  file opened by xconfigOpenConfigFile().
+ *
+ *  Since the state in use is global, parses from contexts are serialized
+ *  by parseContextLock.  The file opened by xconfigOpenConfigFile() is
+ *  parsed from the same variables without the lock, and so must not be
+ *  parsed while another thread parses a context.
+ */
+
+struct _XConfigParseContextRec {
+    FILE *configFile;
+    const char *configMem;
+    int configMemLen;
+    int configMemPos;
+    const char **builtinConfig;
+    int builtinIndex;
+    int configPos;
+    char *configBuf, *configRBuf;
+    int configBufLen;
+    int pushToken;
+    int eol_seen;
+    LexRec val;
+    int configLineNo;
+    char *configSection;
+    char *configPath;
+};
+
+static pthread_mutex_t parseContextLock = PTHREAD_MUTEX_INITIALIZER;
+
+
 
 
 static int xconfigIsAlpha(char c)
@@ -177,11 +222,43 @@ static unsigned int xconfigStrToUL (char *str)
 }
 
 
+/*
+ * xconfigReadChars --
+ *
+ *  fgets(3) from either the configFile FILE stream or the in-memory
+ *  config.
+ */
+
+static char *xconfigReadChars(char *s, int size)
+{
+    int i = 0;
+
+    if (configFile) {
+        return fgets(s, size, configFile);
+    }
+
+    if (configMemPos >= configMemLen || size < 2) {
+        return NULL;
+    }
+
+    while ((i < size - 1) && (configMemPos < configMemLen)) {
+        s[i] = configMem[configMemPos++];
+        if (s[i++] == '\n') {
+            break;
+        }
+    }
+    s[i] = '\0';
+
+    return s;
+}
+
+
 /*
  * xconfigGetNextLine --
  *
- *  read from the configFile FILE stream until we encounter a new
- *  line; this is effectively just a big wrapper for fgets(3).
+ *  read from the configFile FILE stream (or the in-memory config)
+ *  until we encounter a new line; this is effectively just a big
+ *  wrapper for fgets(3).
  *
  *  xconfigGetToken() assumes that we will read up to the next
  *  newline; we need to grow configBuf and configRBuf as needed to
@@ -190,7 +267,6 @@ static unsigned int xconfigStrToUL (char *str)
 
 static char *xconfigGetNextLine(void)
 {
-    static int configBufLen = CONFIG_BUF_LEN;
     char *tmpConfigBuf, *tmpConfigRBuf;
     int c, i, pos = 0, eolFound = 0;
     char *ret = NULL;
@@ -237,9 +313,13 @@ static char *xconfigGetNextLine(void)
     /* read in another block of chars */
     
     do {
-        ret = fgets(configBuf + pos, configBufLen - pos - 1, configFile);
+        ret = xconfigReadChars(configBuf + pos, configBufLen - pos - 1);
         
-        if (!ret) break;
+        if (!ret) {
+            /* the last line may not end with a newline */
+            if (pos > 0) ret = configBuf;
+            break;
+        }
         
         /* search for EOL in the new block of chars */
         
@@ -332,7 +412,7 @@ again:
         if (!c)
         {
             char *ret;
-            if (configFile)
+            if (configFile || configMem)
                 ret = xconfigGetNextLine();
             else {
                 if (builtinConfig[builtinIndex] == NULL)
@@ -488,14 +568,7 @@ again:
      * Joop, at last we have to lookup the token ...
      */
     if (tab)
-    {
-        i = 0;
-        while (tab[i].token != -1)
-            if (xconfigNameCompare (configRBuf, tab[i].name) == 0)
-                return (tab[i].token);
-            else
-                i++;
-    }
+        return StringToToken (configRBuf, tab);
 
     return (ERROR_TOKEN);        /* Error catcher */
 }
@@ -905,6 +978,7 @@ const char *xconfigOpenConfigFile(const char *cmdline, const char *projroot)
 
     configBuf = malloc(CONFIG_BUF_LEN);
     configRBuf = malloc(CONFIG_BUF_LEN);
+    configBufLen = CONFIG_BUF_LEN;
     configBuf[0] = '\0';
 
     return configPath;
@@ -935,6 +1009,155 @@ char *xconfigGetConfigFileName(void)
 }
 
 
+/*
+ * Swap the state of the parse in progress with the one held by 'ctx'.
+ */
+
+#define SWAP_STATE(type, field) \
+    do {                        \
+        type tmp = ctx->field;  \
+        ctx->field = field;     \
+        field = tmp;            \
+    } while (0)
+
+static void SwapParseContext(XConfigParseContextPtr ctx)
+{
+    SWAP_STATE(FILE *, configFile);
+    SWAP_STATE(const char *, configMem);
+    SWAP_STATE(int, configMemLen);
+    SWAP_STATE(int, configMemPos);
+    SWAP_STATE(const char **, builtinConfig);
+    SWAP_STATE(int, builtinIndex);
+    SWAP_STATE(int, configPos);
+    SWAP_STATE(char *, configBuf);
+    SWAP_STATE(char *, configRBuf);
+    SWAP_STATE(int, configBufLen);
+    SWAP_STATE(int, pushToken);
+    SWAP_STATE(int, eol_seen);
+    SWAP_STATE(LexRec, val);
+    SWAP_STATE(int, configLineNo);
+    SWAP_STATE(char *, configSection);
+    SWAP_STATE(char *, configPath);
+}
+
+#undef SWAP_STATE
+
+
+/*
+ * xconfigCreateParseContext --
+ *
+ *  Create a context to parse the 'len' bytes of config at 'buf'.  The
+ *  buffer (which may be mmap(2)ed, and need not be NUL terminated) is
+ *  not copied and must remain valid until the context is freed.
+ *  'filename' names the config in error messages and in the parsed
+ *  XConfigRec.  Returns NULL if 'buf' is NULL, or on allocation failure.
+ */
+
+XConfigParseContextPtr xconfigCreateParseContext(const char *buf, int len,
+                                                 const char *filename)
+{
+    XConfigParseContextPtr ctx;
+
+    /*
+     * A context without a buffer would be read as the builtin config,
+     * which it does not have.
+     */
+    if (!buf || len < 0) {
+        return NULL;
+    }
+
+    ctx = calloc(1, sizeof(XConfigParseContextRec));
+    if (!ctx) {
+        return NULL;
+    }
+
+    ctx->configMem = buf;
+    ctx->configMemLen = len;
+    ctx->configBufLen = CONFIG_BUF_LEN;
+    ctx->pushToken = LOCK_TOKEN;
+    ctx->configPath = strdup(filename ? filename : "");
+    ctx->configBuf = malloc(CONFIG_BUF_LEN);
+    ctx->configRBuf = malloc(CONFIG_BUF_LEN);
+
+    if (!ctx->configPath || !ctx->configBuf || !ctx->configRBuf) {
+        xconfigFreeParseContext(ctx);
+        return NULL;
+    }
+
+    ctx->configBuf[0] = '\0';
+
+    return ctx;
+}
+
+
+/*
+ * xconfigReadConfigFromContext --
+ *
+ *  Parse the config of the given context, as xconfigReadConfigFile().
+ *  May be called from any thread; parses from contexts are serialized,
+ *  as they all use the state of the parse in progress (see
+ *  XConfigParseContextRec).
+ */
+
+XConfigError xconfigReadConfigFromContext(XConfigParseContextPtr ctx,
+                                          XConfigPtr *configPtr)
+{
+    XConfigError ret;
+
+    pthread_mutex_lock(&parseContextLock);
+
+    SwapParseContext(ctx);
+    ret = xconfigReadConfigFile(configPtr);
+    SwapParseContext(ctx);
+
+    pthread_mutex_unlock(&parseContextLock);
+
+    return ret;
+}
+
+
+void xconfigFreeParseContext(XConfigParseContextPtr ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    free(ctx->configBuf);
+    free(ctx->configRBuf);
+    free(ctx->configSection);
+    free(ctx->configPath);
+    free(ctx);
+}
+
+
+/*
+ * xconfigReadConfigBuffer --
+ *
+ *  Parse the 'len' bytes of config at 'buf', as xconfigReadConfigFile()
+ *  would if they were the contents of the file 'filename'.
+ */
+
+XConfigError xconfigReadConfigBuffer(const char *buf, int len,
+                                     const char *filename,
+                                     XConfigPtr *configPtr)
+{
+    XConfigParseContextPtr ctx;
+    XConfigError ret;
+
+    *configPtr = NULL;
+
+    ctx = xconfigCreateParseContext(buf, len, filename);
+    if (!ctx) {
+        return XCONFIG_RETURN_PARSE_ERROR;
+    }
+
+    ret = xconfigReadConfigFromContext(ctx, configPtr);
+    xconfigFreeParseContext(ctx);
+
+    return ret;
+}
+
+
 void
 xconfigSetSection (char *section)
 {
@@ -1003,15 +1226,252 @@ xconfigGetStringToken (XConfigSymTabRec * tab)
     return StringToToken (val.str, tab);
 }
 
+/*
+ * Symbol table indices --
+ *
+ *  Looking up a keyword used to walk the section's symbol table,
+ *  normalizing both names with xconfigNameCompare() for every entry.
+ *  Instead, the first lookup in a table builds a hash index over the
+ *  normalized names of its entries (lowercased, with '_', ' ' and '\t'
+ *  removed), and later lookups hash the normalized keyword once and
+ *  compare it only against the entries in its bucket.
+ *
+ *  The symbol tables are static, so the indices are kept, keyed by the
+ *  table's address, for the life of the process.  If an index cannot be
+ *  built, lookups in that table fall back to the linear search.
+ *
+ *  Parses may run on several threads (see XConfigParseContextRec), so the
+ *  indices are found, and each built exactly once, under symTabIndexLock.
+ *  pthread_once() would do for a single index, but cannot be handed the
+ *  table to index.  Once built, an index is never modified, and may be
+ *  used without the lock.
+ */
+
+typedef struct {
+    XConfigSymTabRec *tab;
+    int num_buckets;       /* power of two */
+    int *buckets;          /* index + 1 of the first entry in each bucket */
+    int *next;             /* index + 1 of the next entry in the bucket */
+    unsigned int *hashes;  /* hash of each entry's normalized name */
+    char **keys;           /* normalized name of each entry */
+} SymTabIndexRec, *SymTabIndexPtr;
+
+static pthread_mutex_t symTabIndexLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The fields below are protected by symTabIndexLock */
+
+static SymTabIndexPtr symTabIndices[SYMTAB_INDEX_SLOTS];
+static int numSymTabIndices = 0;
+static SymTabIndexPtr lastSymTabIndex = NULL;
+
+static int xconfigIsIgnored(char c)
+{
+    return (c == '_' || c == ' ' || c == '\t');
+}
+
+/*
+ * Hash a name as xconfigNameCompare() sees it; if norm is non-NULL, also
+ * write out the normalized name.
+ */
+
+static unsigned int
+NormalizeName (const char *str, char *norm)
+{
+    unsigned int hash = 2166136261u;
+
+    for (; str && *str; str++) {
+        char c;
+
+        if (xconfigIsIgnored(*str))
+            continue;
+        c = xconfigToLower(*str);
+        hash = (hash ^ (unsigned char) c) * 16777619u;
+        if (norm)
+            *norm++ = c;
+    }
+    if (norm)
+        *norm = '\0';
+
+    return hash;
+}
+
+/*
+ * Hash a name such that names that xconfigNameCompare() considers equal
+ * hash to the same value.
+ */
+
+unsigned int
+xconfigNameHash (const char *str)
+{
+    return NormalizeName (str, NULL);
+}
+
+/*
+ * Compare a normalized name against a name that has not been normalized.
+ */
+
+static int
+NormalizedNameMatches (const char *key, const char *str)
+{
+    for (;; str++) {
+        if (xconfigIsIgnored(*str))
+            continue;
+        if (*key != xconfigToLower(*str))
+            return 0;
+        if (*key == '\0')
+            return 1;
+        key++;
+    }
+}
+
+static void
+FreeSymTabIndex (SymTabIndexPtr index)
+{
+    if (!index)
+        return;
+
+    free (index->buckets);
+    free (index->next);
+    free (index->hashes);
+    if (index->keys)
+        free (index->keys[0]);
+    free (index->keys);
+    free (index);
+}
+
+static SymTabIndexPtr
+BuildSymTabIndex (XConfigSymTabRec * tab)
+{
+    SymTabIndexPtr index;
+    int i, n, len;
+    char *key;
+
+    for (n = 0, len = 0; tab[n].token != -1; n++)
+        len += strlen (tab[n].name) + 1;
+
+    index = calloc (1, sizeof (SymTabIndexRec));
+    if (!index)
+        return NULL;
+
+    index->tab = tab;
+    index->num_buckets = 8;
+    while (index->num_buckets < n * 2)
+        index->num_buckets <<= 1;
+
+    index->buckets = calloc (index->num_buckets, sizeof (int));
+    index->next = calloc (n + 1, sizeof (int));
+    index->hashes = calloc (n + 1, sizeof (unsigned int));
+    index->keys = calloc (n + 1, sizeof (char *));
+    key = malloc (len + 1);
+    if (index->keys)
+        index->keys[0] = key;
+
+    if (!index->buckets || !index->next || !index->hashes ||
+        !index->keys || !key) {
+        FreeSymTabIndex (index);
+        return NULL;
+    }
+
+    for (i = 0; i < n; i++) {
+        index->keys[i] = key;
+        index->hashes[i] = NormalizeName (tab[i].name, key);
+        key += strlen (key) + 1;
+    }
+
+    /*
+     * Link the entries in reverse, so that each bucket lists them in
+     * table order and the first of any duplicate names wins, as it did
+     * with the linear search.
+     */
+
+    for (i = n - 1; i >= 0; i--) {
+        int b = index->hashes[i] & (index->num_buckets - 1);
+
+        index->next[i] = index->buckets[b];
+        index->buckets[b] = i + 1;
+    }
+
+    return index;
+}
+
+/*
+ * Return the index for the given symbol table, building it if this is
+ * the first lookup in that table.  Returns NULL if the index could not
+ * be built.  Called with symTabIndexLock held.
+ */
+
+static SymTabIndexPtr
+GetSymTabIndexLocked (XConfigSymTabRec * tab)
+{
+    unsigned int slot;
+
+    if (lastSymTabIndex && lastSymTabIndex->tab == tab)
+        return lastSymTabIndex;
+
+    slot = (unsigned int) (((unsigned long) tab) >> 4);
+    for (;;) {
+        slot &= (SYMTAB_INDEX_SLOTS - 1);
+        if (!symTabIndices[slot])
+            break;
+        if (symTabIndices[slot]->tab == tab) {
+            lastSymTabIndex = symTabIndices[slot];
+            return lastSymTabIndex;
+        }
+        slot++;
+    }
+
+    /* Keep a free slot so that the probe above always terminates */
+
+    if (numSymTabIndices >= SYMTAB_INDEX_SLOTS - 1)
+        return NULL;
+
+    symTabIndices[slot] = BuildSymTabIndex (tab);
+    if (!symTabIndices[slot])
+        return NULL;
+
+    numSymTabIndices++;
+    lastSymTabIndex = symTabIndices[slot];
+
+    return lastSymTabIndex;
+}
+
+static SymTabIndexPtr
+GetSymTabIndex (XConfigSymTabRec * tab)
+{
+    SymTabIndexPtr index;
+
+    pthread_mutex_lock (&symTabIndexLock);
+    index = GetSymTabIndexLocked (tab);
+    pthread_mutex_unlock (&symTabIndexLock);
+
+    return index;
+}
+
 static int
-StringToToken (char *str, XConfigSymTabRec * tab)
+StringToToken (const char *str, XConfigSymTabRec * tab)
 {
+    SymTabIndexPtr index;
+    unsigned int hash;
     int i;
 
-    for (i = 0; tab[i].token != -1; i++)
+    index = GetSymTabIndex (tab);
+    if (!index)
+    {
+        for (i = 0; tab[i].token != -1; i++)
+        {
+            if (!xconfigNameCompare (tab[i].name, str))
+                return tab[i].token;
+        }
+        return (ERROR_TOKEN);
+    }
+
+    hash = NormalizeName (str, NULL);
+    for (i = index->buckets[hash & (index->num_buckets - 1)];
+         i; i = index->next[i - 1])
     {
-        if (!xconfigNameCompare (tab[i].name, str))
-            return tab[i].token;
+        if (index->hashes[i - 1] == hash &&
+            NormalizedNameMatches (index->keys[i - 1], str))
+            return tab[i - 1].token;
     }
     return (ERROR_TOKEN);
 }
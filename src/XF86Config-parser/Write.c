@@ -70,7 +70,7 @@
 int xconfigWriteConfigFile (const char *filename, XConfigPtr cptr)
 {
     FILE *cf;
-    char *locale;
+    int ret;
     
     if ((cf = fopen(filename, "w")) == NULL)
     {
@@ -79,6 +79,22 @@ int xconfigWriteConfigFile (const char *filename, XConfigPtr cptr)
         return FALSE;
     }
 
+    ret = xconfigWriteConfigStream(cf, cptr);
+
+    fclose(cf);
+
+    return ret;
+}
+
+/*
+ * xconfigWriteConfigStream() - write the config to the given stream, which
+ * may be a file or, e.g., an open_memstream(3) buffer.
+ */
+
+int xconfigWriteConfigStream (FILE *cf, XConfigPtr cptr)
+{
+    char *locale;
+
     /*
      * read the current locale and then set the standard "C" locale,
      * so that the X configuration writer does not use locale-specific
@@ -132,8 +148,6 @@ int xconfigWriteConfigFile (const char *filename, XConfigPtr cptr)
 
     xconfigPrintExtensionsSection (cf, cptr->extensions);
 
-    fclose(cf);
-
     /* restore the original locale */
 
     if (locale) {
@@ -42,6 +42,15 @@ void xconfigPrintFileSection(FILE *cf, XConfigFilesPtr ptr);
 /* Flags.c */
 XConfigFlagsPtr xconfigParseFlagsSection(void);
 void xconfigPrintServerFlagsSection(FILE *f, XConfigFlagsPtr flags);
+void xconfigOptionIndexInit(XConfigOptionIndexPtr idx,
+                            XConfigOptionPtr *pHead);
+XConfigOptionPtr xconfigOptionIndexFind(XConfigOptionIndexPtr idx,
+                                        const char *name);
+XConfigOptionPtr xconfigOptionIndexSet(XConfigOptionIndexPtr idx,
+                                       const char *name, const char *val);
+void xconfigOptionIndexRemove(XConfigOptionIndexPtr idx,
+                              XConfigOptionPtr opt);
+void xconfigOptionIndexFinish(XConfigOptionIndexPtr idx);
 
 /* Input.c */
 XConfigInputPtr xconfigParseInputSection(void);
@@ -105,6 +114,7 @@ void xconfigUnGetToken(int token);
 char *xconfigTokenString(void);
 void xconfigSetSection(char *section);
 int xconfigGetStringToken(XConfigSymTabRec *tab);
+unsigned int xconfigNameHash(const char *str);
 char *xconfigGetConfigFileName(void);
 
 /* Write.c */
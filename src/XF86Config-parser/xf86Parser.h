@@ -636,6 +636,26 @@ int xconfigSanitizeConfig(XConfigPtr p, const char *screenName,
                           GenerateOptions *gop);
 void xconfigCloseConfigFile(void);
 int xconfigWriteConfigFile(const char *, XConfigPtr);
+int xconfigWriteConfigStream(FILE *, XConfigPtr);
+
+/*
+ * Functions for parsing XConfig files held in memory; each parse has its
+ * own context, independent of the file opened by xconfigOpenConfigFile().
+ * Parses from contexts may be started from any thread, but run one at a
+ * time; the file opened by xconfigOpenConfigFile() must not be parsed
+ * concurrently with them.
+ */
+typedef struct _XConfigParseContextRec XConfigParseContextRec;
+typedef XConfigParseContextRec *XConfigParseContextPtr;
+
+XConfigParseContextPtr xconfigCreateParseContext(const char *buf, int len,
+                                                 const char *filename);
+XConfigError xconfigReadConfigFromContext(XConfigParseContextPtr ctx,
+                                          XConfigPtr *configPtr);
+void xconfigFreeParseContext(XConfigParseContextPtr ctx);
+XConfigError xconfigReadConfigBuffer(const char *buf, int len,
+                                     const char *filename,
+                                     XConfigPtr *configPtr);
 
 void xconfigFreeConfig(XConfigPtr *p);
 
@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <unistd.h>
 #include <errno.h>
 #include <dirent.h>
@@ -58,52 +59,106 @@
 # define NV_JSON_OBJECT_FOREACH(object, key, value) json_object_foreach(object, key, value)
 #endif
 
+/*
+ * Read the whole file in (normally with a single read sized by fstat()),
+ * and return its non-empty lines, each one preceded by a newline.  A NUL
+ * byte in the file is treated as a line terminator.
+ */
 static char *slurp(FILE *fp)
 {
-    int eof = FALSE;
-    char *text = strdup("");
-    char *new_text;
+    struct stat stat_buf;
+    size_t size = 0, len = 0, n;
+    char *raw, *text, *out;
+    const char *line, *end, *raw_end;
+
+    if ((fstat(fileno(fp), &stat_buf) == 0) && S_ISREG(stat_buf.st_mode)) {
+        size = stat_buf.st_size;
+    }
+
+    // One spare byte, so that EOF is seen without growing the buffer
+    size = (size ? size : 4096) + 1;
+    raw = nvalloc(size);
+
+    while ((n = fread(raw + len, 1, size - len, fp)) > 0) {
+        len += n;
+        if (len == size) {
+            size *= 2;
+            raw = nvrealloc(raw, size);
+        }
+    }
 
-    while (text && !eof) {
-        char *line = fget_next_line(fp, &eof);
+    if (ferror(fp)) {
+        nvfree(raw);
+        return NULL;
+    }
 
-        if (line && *line != '\0' && *line != '\n') {
-            new_text = nvstrcat(text, "\n", line, NULL);
-            free(text);
-            text = new_text;
+    /*
+     * Every kept line costs its length plus one leading newline, and every
+     * line but the last is followed by a terminator in the input, so the
+     * output never needs more than len + 2 bytes.
+     */
+    text = nvalloc(len + 2);
+    out = text;
+    raw_end = raw + len;
+
+    for (line = raw; line < raw_end; line = end + 1) {
+        end = line;
+        while ((end < raw_end) && (*end != '\n') && (*end != '\0')) {
+            end++;
+        }
+        if (end > line) {
+            *out++ = '\n';
+            memcpy(out, line, end - line);
+            out += end - line;
         }
-        free(line);
     }
+    *out = '\0';
+
+    nvfree(raw);
 
     return text;
 }
 
-static void splice_string(char **s, size_t b, size_t e, const char *replace)
+/*
+ * Append 'n' bytes of 'src' to the growing NUL-terminated buffer 'buf',
+ * which currently holds 'len' bytes in an allocation of 'size' bytes.
+ */
+static void text_append(char **buf, size_t *len, size_t *size,
+                        const char *src, size_t n)
 {
-    char *tail = strdup(*s + e);
-    *s = realloc(*s, b + strlen(replace) + strlen(tail) + 1);
-    if (!*s) {
-        return;
+    if (*len + n + 1 > *size) {
+        while (*len + n + 1 > *size) {
+            *size *= 2;
+        }
+        *buf = nvrealloc(*buf, *size);
     }
-    sprintf(*s + b, "%s%s", replace, tail);
-    free(tail);
+    memcpy(*buf + *len, src, n);
+    *len += n;
+    (*buf)[*len] = '\0';
 }
 
 #define HEX_DIGITS "0123456789abcdefABCDEF"
 
+/*
+ * Convert app profile file syntax to JSON in a single pass: comments are
+ * dropped and hex and octal literals outside of strings are rewritten as
+ * decimal.  Unchanged runs of the input are copied to the output buffer
+ * in one piece.
+ */
 char *nv_app_profile_file_syntax_to_json(const char *orig_s)
 {
-    char *s = strdup(orig_s);
-
     int quoted = FALSE;
-    char *tok;
-    size_t start, end, size;
+    const char *tok, *copied;
+    char *out, *endptr;
+    char num[32];
+    size_t out_len = 0, out_size, size;
     unsigned long long val;
-    char *old_substr = NULL;
-    char *endptr;
-    char *new_substr = NULL;
 
-    tok = s;
+    out_size = strlen(orig_s) + 1;
+    out = nvalloc(out_size);
+    out[0] = '\0';
+
+    copied = tok = orig_s;
     while ((tok = strpbrk(tok, "\\\"#" HEX_DIGITS))) {
         switch (*tok) {
         case '\"':
@@ -121,14 +176,9 @@ char *nv_app_profile_file_syntax_to_json(const char *orig_s)
         case '#':
             // Comment
             if (!quoted) {
-                char *end_tok = nvstrchrnul(tok, '\n');
-                start = tok - s;
-                end = end_tok - s;
-                splice_string(&s, start, end, "");
-                if (!s) {
-                    goto fail;
-                }
-                tok = s + start;
+                text_append(&out, &out_len, &out_size, copied, tok - copied);
+                tok += strcspn(tok, "\n");
+                copied = tok;
             } else {
                 tok++;
             }
@@ -142,33 +192,19 @@ char *nv_app_profile_file_syntax_to_json(const char *orig_s)
             if ((tok[0] == '0') &&
                 (tok[1] == 'x' || tok[1] == 'X' || isdigit(tok[1])) &&
                 !quoted) {
-                old_substr = nvstrndup(tok, size);
-                if (!old_substr) {
-                    goto fail;
-                }
                 errno = 0;
-                val = strtoull(old_substr, &endptr, 0);
-                if (errno || (endptr - old_substr != strlen(old_substr))) {
-                    // Invalid conversion, skip this string
-                    tok += size;
-                    free(old_substr); old_substr = NULL;
-                } else {
-                    new_substr = nvasprintf("%llu", val);
-                    if (!new_substr) {
-                        goto fail;
-                    } else {
-                        start = tok - s;
-                        end = tok - s + size;
-                        splice_string(&s, start, end, new_substr);
-                        free(new_substr); new_substr = NULL;
-                        free(old_substr); old_substr = NULL;
-                        tok = s + start;
-                    }
+                val = strtoull(tok, &endptr, 0);
+                if (!errno && ((size_t) (endptr - tok) == size)) {
+                    text_append(&out, &out_len, &out_size,
+                                copied, tok - copied);
+                    snprintf(num, sizeof(num), "%llu", val);
+                    text_append(&out, &out_len, &out_size, num, strlen(num));
+                    copied = tok + size;
                 }
-            } else {
-                // Not hex or octal; let the JSON parser deal with it
-                tok += size;
+                // Otherwise this is an invalid conversion; skip the string
             }
+            // Not hex or octal; let the JSON parser deal with it
+            tok += size;
             break;
         default:
             assert(!"Unhandled character");
@@ -176,15 +212,9 @@ char *nv_app_profile_file_syntax_to_json(const char *orig_s)
         }
     }
 
-    assert(!new_substr);
-    assert(!old_substr);
-    return s;
+    text_append(&out, &out_len, &out_size, copied, strlen(copied));
 
-fail:
-    free(old_substr);
-    free(new_substr);
-    free(s);
-    return NULL;
+    return out;
 }
 
 static int open_and_stat(const char *filename, const char *perms, FILE **fp, struct stat *stat_buf)
@@ -206,6 +236,158 @@ static int open_and_stat(const char *filename, const char *perms, FILE **fp, str
     return ret;
 }
 
+static void app_profile_config_init_rule_index(AppProfileConfig *config)
+{
+    config->rule_index_valid = FALSE;
+    config->rule_index_len = 0;
+    config->rule_index_file = NULL;
+    config->rule_index_pos = NULL;
+    config->rule_index_before = NULL;
+}
+
+static void app_profile_config_invalidate_rule_index(AppProfileConfig *config)
+{
+    config->rule_index_valid = FALSE;
+}
+
+static void app_profile_config_free_rule_index(AppProfileConfig *config)
+{
+    free(config->rule_index_file);
+    free(config->rule_index_pos);
+    free(config->rule_index_before);
+    app_profile_config_init_rule_index(config);
+}
+
+static void app_profile_config_build_rule_index(AppProfileConfig *config)
+{
+    size_t i, j, num_files, num_rules, total = 0;
+    json_t *file, *rules;
+    json_int_t id;
+
+    if (config->rule_index_valid) {
+        return;
+    }
+
+    num_files = json_array_size(config->parsed_files);
+
+    config->rule_index_len = config->next_free_rule_id;
+    config->rule_index_file = nvrealloc(config->rule_index_file,
+                                        sizeof(int) *
+                                        (config->rule_index_len + 1));
+    config->rule_index_pos = nvrealloc(config->rule_index_pos,
+                                       sizeof(size_t) *
+                                       (config->rule_index_len + 1));
+    config->rule_index_before = nvrealloc(config->rule_index_before,
+                                          sizeof(size_t) * (num_files + 1));
+
+    for (i = 0; i < config->rule_index_len; i++) {
+        config->rule_index_file[i] = -1;
+    }
+
+    for (i = 0; i < num_files; i++) {
+        file = json_array_get(config->parsed_files, i);
+        rules = json_object_get(file, "rules");
+        num_rules = json_array_size(rules);
+
+        config->rule_index_before[i] = total;
+        total += num_rules;
+
+        for (j = 0; j < num_rules; j++) {
+            id = json_integer_value(json_object_get(json_array_get(rules, j),
+                                                    "id"));
+            if ((id >= 0) && (id < config->rule_index_len)) {
+                config->rule_index_file[id] = i;
+                config->rule_index_pos[id] = j;
+            }
+        }
+    }
+    config->rule_index_before[num_files] = total;
+
+    config->rule_index_valid = TRUE;
+}
+
+/*
+ * Look up the rule with the given id through the rule index.  Returns the
+ * rule, and its file and position within the file's rules array, or NULL
+ * if there is no such rule.
+ */
+static json_t *app_profile_config_lookup_rule(AppProfileConfig *config,
+                                              int id,
+                                              size_t *file_idx,
+                                              size_t *rule_idx)
+{
+    json_t *file;
+
+    app_profile_config_build_rule_index(config);
+
+    if ((id < 0) || (id >= config->rule_index_len) ||
+        (config->rule_index_file[id] < 0)) {
+        return NULL;
+    }
+
+    if (file_idx) {
+        *file_idx = config->rule_index_file[id];
+    }
+    if (rule_idx) {
+        *rule_idx = config->rule_index_pos[id];
+    }
+
+    file = json_array_get(config->parsed_files, config->rule_index_file[id]);
+
+    return json_array_get(json_object_get(file, "rules"),
+                          config->rule_index_pos[id]);
+}
+
+/*
+ * Return the file at the given index in parsed_files, after replacing it with
+ * a copy owned by this configuration if it may be shared with other
+ * configurations (see nv_app_profile_config_dup()). This must be called
+ * before modifying a file or any of its rules or profiles.
+ */
+static json_t *app_profile_config_own_file_at(AppProfileConfig *config,
+                                              size_t idx)
+{
+    json_t *file, *file_copy;
+    const char *filename;
+
+    file = json_array_get(config->parsed_files, idx);
+    filename = json_string_value(json_object_get(file, "filename"));
+
+    if (json_object_get(config->owned_files, filename)) {
+        return file;
+    }
+
+    json_object_set_new(config->owned_files, filename, json_true());
+
+    file_copy = json_deep_copy(file);
+    json_array_set_new(config->parsed_files, idx, file_copy);
+
+    return file_copy;
+}
+
+/*
+ * Look up the file with the given filename and make sure this configuration
+ * owns it, as above. Returns NULL if there is no such file.
+ */
+static json_t *app_profile_config_own_file(AppProfileConfig *config,
+                                           const char *filename)
+{
+    size_t i, size;
+    json_t *json_file, *json_filename;
+
+    size = json_array_size(config->parsed_files);
+
+    for (i = 0; i < size; i++) {
+        json_file = json_array_get(config->parsed_files, i);
+        json_filename = json_object_get(json_file, "filename");
+        if (!strcmp(json_string_value(json_filename), filename)) {
+            return app_profile_config_own_file_at(config, i);
+        }
+    }
+
+    return NULL;
+}
+
 static json_t *app_profile_config_insert_file_object(AppProfileConfig *config, json_t *new_file)
 {
     json_t *json_filename, *json_new_filename;
@@ -273,20 +455,24 @@ static json_t *app_profile_config_insert_file_object(AppProfileConfig *config, j
     json_object_set_new(order, "major", json_integer(new_file_major));
     json_object_set_new(order, "minor", json_integer(new_file_minor));
 
-    // Add the new file
+    // Add the new file, which is always owned by this configuration
     json_array_insert(config->parsed_files, i, new_file);
+    json_object_set_new(config->owned_files, new_filename, json_true());
+    app_profile_config_invalidate_rule_index(config);
 
     // Bump up minor for files after this one with the same major
     num_files = json_array_size(config->parsed_files);
 
-    for ( ; i < num_files; i++) {
+    for (i++; i < num_files; i++) {
         file = json_array_get(config->parsed_files, i);
         file_order = json_object_get(file, "order");
-        file_order_major = json_integer_value(json_object_get(order, "major"));
-        file_order_minor = json_integer_value(json_object_get(order, "minor"));
+        file_order_major = json_integer_value(json_object_get(file_order, "major"));
+        file_order_minor = json_integer_value(json_object_get(file_order, "minor"));
         if (file_order_major > new_file_major) {
             break;
         }
+        file = app_profile_config_own_file_at(config, i);
+        file_order = json_object_get(file, "order");
         json_object_set_new(file_order, "minor", json_integer(file_order_minor+1));
     }
 
@@ -426,8 +612,8 @@ static json_t *json_settings_parse(json_t *old_settings, const char *filename)
             return NULL;
         }
         new_setting = json_object();
-        json_object_set(new_setting, "key", json_key);
-        json_object_set(new_setting, "value", json_value);
+        json_object_set_new(new_setting, "key", json_copy(json_key));
+        json_object_set_new(new_setting, "value", json_copy(json_value));
         json_array_append_new(new_settings, new_setting);
     }
 
@@ -547,12 +733,142 @@ done:
     return key_docs;
 }
 
+/*
+ * Bump allocator for the parse trees returned by json_loads() while loading
+ * app profile files.  Those trees are only read, to build the configuration's
+ * own representation of each file, and are then thrown away whole; serving
+ * them from a few large chunks replaces thousands of small malloc()/free()
+ * pairs per file.  Values allocated here must never be freed with
+ * json_decref() or shared with the configuration: copy them instead.
+ *
+ * The arena is reset after each file, rather than kept until the
+ * configuration is freed: the configuration is edited and freed with
+ * json_decref() through jansson's default allocation functions, so none of
+ * it can live in the arena.  For the same reason, the configuration cannot
+ * be built directly while parsing; jansson has no streaming parser either.
+ */
+#define APP_PROFILE_ARENA_CHUNK_SIZE (64 * 1024)
+#define APP_PROFILE_ARENA_ALIGN 16
+
+typedef struct AppProfileArenaChunkRec {
+    struct AppProfileArenaChunkRec *next;
+    size_t size;
+    size_t used;
+} AppProfileArenaChunk;
+
+typedef struct AppProfileArenaRec {
+    AppProfileArenaChunk *chunks;
+    size_t num_allocs;   /* jansson allocations served from the arena */
+    size_t num_chunks;   /* chunks obtained with malloc() */
+    size_t held_size;    /* total size of the chunks currently held */
+    size_t peak_size;    /* largest held_size so far */
+} AppProfileArena;
+
+// json_set_alloc_funcs() takes no context pointer; see
+// app_profile_arena_json_loads() for why this needs no lock
+static AppProfileArena *current_arena;
+
+#define APP_PROFILE_ARENA_HEADER_SIZE \
+    ((sizeof(AppProfileArenaChunk) + APP_PROFILE_ARENA_ALIGN - 1) & \
+     ~(size_t)(APP_PROFILE_ARENA_ALIGN - 1))
+
+static void *app_profile_arena_malloc(size_t size)
+{
+    AppProfileArena *arena = current_arena;
+    AppProfileArenaChunk *chunk = arena->chunks;
+
+    size = (size + APP_PROFILE_ARENA_ALIGN - 1) &
+           ~(size_t)(APP_PROFILE_ARENA_ALIGN - 1);
+
+    if (!chunk || (chunk->size - chunk->used < size)) {
+        size_t chunk_size = APP_PROFILE_ARENA_CHUNK_SIZE;
+
+        if (size > chunk_size - APP_PROFILE_ARENA_HEADER_SIZE) {
+            chunk_size = size + APP_PROFILE_ARENA_HEADER_SIZE;
+        }
+
+        chunk = malloc(chunk_size);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->size = chunk_size;
+        chunk->used = APP_PROFILE_ARENA_HEADER_SIZE;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->num_chunks++;
+
+        arena->held_size += chunk_size;
+        if (arena->held_size > arena->peak_size) {
+            arena->peak_size = arena->held_size;
+        }
+    }
+
+    arena->num_allocs++;
+    chunk->used += size;
+
+    return (char *)chunk + chunk->used - size;
+}
+
+static void app_profile_arena_free(void *ptr)
+{
+    // Released along with the rest of the arena
+}
+
+/*
+ * Release everything allocated from the arena.  The allocation counters are
+ * kept, so that they cover all of the files parsed with the arena.
+ */
+static void app_profile_arena_reset(AppProfileArena *arena)
+{
+    AppProfileArenaChunk *chunk, *next;
+
+    for (chunk = arena->chunks; chunk; chunk = next) {
+        next = chunk->next;
+        free(chunk);
+    }
+    arena->chunks = NULL;
+    arena->held_size = 0;
+}
+
+/*
+ * json_loads() into the arena.  Any other jansson allocation functions in use
+ * are restored before returning.
+ *
+ * The allocation functions are global to jansson, so while json_loads()
+ * runs, every jansson allocation in the process is served from the arena,
+ * and every jansson free is ignored.  This must therefore only be called
+ * while no other thread uses jansson: nvidia-settings loads profiles on
+ * its main thread, and none of its other threads (frame lock polling, NVML
+ * events) use jansson.  A lock around the swap would not help, as the
+ * other threads' jansson calls would not take it.
+ */
+static json_t *app_profile_arena_json_loads(AppProfileArena *arena,
+                                            const char *input,
+                                            json_error_t *error)
+{
+    json_malloc_t saved_malloc;
+    json_free_t saved_free;
+    json_t *json;
+
+    json_get_alloc_funcs(&saved_malloc, &saved_free);
+    current_arena = arena;
+    json_set_alloc_funcs(app_profile_arena_malloc, app_profile_arena_free);
+
+    json = json_loads(input, 0, error);
+
+    json_set_alloc_funcs(saved_malloc, saved_free);
+    current_arena = NULL;
+
+    return json;
+}
+
 /*
  * Load app profile settings from an already-open file. This operation is
  * atomic: either all of the settings from the file are added to the
  * configuration, or none are.
  */
 static void app_profile_config_load_file(AppProfileConfig *config,
+                                         AppProfileArena *arena,
                                          const char *filename,
                                          struct stat *stat_buf,
                                          FILE *fp)
@@ -597,8 +913,8 @@ static void app_profile_config_load_file(AppProfileConfig *config,
     new_json_profiles = json_object();
     new_json_rules = json_array();
 
-    // Parse the resulting JSON
-    orig_file = json_loads(json_text, 0, &error);
+    // Parse the resulting JSON; everything kept from it below is copied
+    orig_file = app_profile_arena_json_loads(arena, json_text, &error);
 
     if (!orig_file) {
         nv_error_msg("App profile parse error in %s: %s on %s, line %d\n",
@@ -699,12 +1015,12 @@ static void app_profile_config_load_file(AppProfileConfig *config,
                     json_decref(new_json_pattern);
                     goto done;
                 }
-                json_object_set(new_json_pattern, "feature", orig_json_feature);
-                json_object_set(new_json_pattern, "matches", orig_json_matches);
+                json_object_set_new(new_json_pattern, "feature", json_copy(orig_json_feature));
+                json_object_set_new(new_json_pattern, "matches", json_copy(orig_json_matches));
             } else if (json_is_string(orig_json_pattern)) {
                 // procname
                 json_object_set_new(new_json_pattern, "feature", json_string("procname"));
-                json_object_set(new_json_pattern, "matches", orig_json_pattern);
+                json_object_set_new(new_json_pattern, "matches", json_copy(orig_json_pattern));
             } else {
                 json_decref(new_json_rule);
                 json_decref(new_json_pattern);
@@ -813,7 +1129,7 @@ static void app_profile_config_load_file(AppProfileConfig *config,
     config->next_free_rule_id = next_free_rule_id;
 
 done:
-    json_decref(orig_file);
+    app_profile_arena_reset(arena);
     json_decref(new_file);
     json_decref(new_json_rules);
     json_decref(new_json_profiles);
@@ -823,6 +1139,7 @@ done:
 
 // Load app profile settings from a directory
 static void app_profile_config_load_files_from_directory(AppProfileConfig *config,
+                                                         AppProfileArena *arena,
                                                          const char *dirname)
 {
     FILE *fp;
@@ -858,6 +1175,7 @@ static void app_profile_config_load_files_from_directory(AppProfileConfig *confi
         }
 
         app_profile_config_load_file(config,
+                                     arena,
                                      full_path,
                                      &stat_buf,
                                      fp);
@@ -923,6 +1241,9 @@ AppProfileConfig *nv_app_profile_config_load(const char *global_config_file,
                                              size_t search_path_count)
 {
     size_t i;
+    uint64_t start = nv_get_monotonic_time_us();
+    struct rusage usage;
+    AppProfileArena arena = { NULL, 0, 0, 0, 0 };
     AppProfileConfig *config = malloc(sizeof(AppProfileConfig));
 
     if (!config) {
@@ -931,8 +1252,10 @@ AppProfileConfig *nv_app_profile_config_load(const char *global_config_file,
 
     // Initialize the config
     config->next_free_rule_id = 0;
+    app_profile_config_init_rule_index(config);
 
     config->parsed_files = json_array();
+    config->owned_files = json_object();
     config->profile_locations = json_object();
     config->rule_locations = json_object();
 
@@ -965,15 +1288,28 @@ AppProfileConfig *nv_app_profile_config_load(const char *global_config_file,
         if (S_ISDIR(stat_buf.st_mode)) {
             // Parse files in the directory
             fclose(fp);
-            app_profile_config_load_files_from_directory(config, filename);
+            app_profile_config_load_files_from_directory(config, &arena, filename);
         } else {
             // Load the individual file
-            app_profile_config_load_file(config, filename, &stat_buf, fp);
+            app_profile_config_load_file(config, &arena, filename, &stat_buf, fp);
             fclose(fp);
             continue;
         }
     }
 
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        nv_info_msg(NULL, "Loaded %zu application profile file(s) with %zu "
+                    "rule(s) in %.2f ms (peak resident set size %ld KiB).",
+                    json_array_size(config->parsed_files),
+                    nv_app_profile_config_count_rules(config),
+                    (nv_get_monotonic_time_us() - start) / 1000.0,
+                    usage.ru_maxrss);
+        nv_info_msg(NULL, "Parsed with %zu allocation(s) from %zu arena "
+                    "chunk(s) (at most %zu KiB held at once).",
+                    arena.num_allocs, arena.num_chunks,
+                    arena.peak_size / 1024);
+    }
+
     return config;
 }
 
@@ -1223,10 +1559,21 @@ AppProfileConfig *nv_app_profile_config_dup(AppProfileConfig *config)
     AppProfileConfig *new_config;
 
     new_config = malloc(sizeof(AppProfileConfig));
-    new_config->parsed_files = json_deep_copy(config->parsed_files);
-    new_config->profile_locations = json_deep_copy(config->profile_locations);
-    new_config->rule_locations = json_deep_copy(config->rule_locations);
+
+    /*
+     * Share the file objects between both configurations: each of them
+     * copies a file before modifying it. The location tables only map names
+     * to filename strings, which are replaced rather than modified, so a
+     * shallow copy is sufficient for them too.
+     */
+    new_config->parsed_files = json_copy(config->parsed_files);
+    new_config->owned_files = json_object();
+    json_object_clear(config->owned_files);
+
+    new_config->profile_locations = json_copy(config->profile_locations);
+    new_config->rule_locations = json_copy(config->rule_locations);
     new_config->next_free_rule_id = config->next_free_rule_id;
+    app_profile_config_init_rule_index(new_config);
 
     new_config->global_config_file =
         config->global_config_file ? strdup(config->global_config_file) : NULL;
@@ -1267,8 +1614,10 @@ void nv_app_profile_config_free(AppProfileConfig *config)
     size_t i;
     json_decref(config->global_options);
     json_decref(config->parsed_files);
+    json_decref(config->owned_files);
     json_decref(config->profile_locations);
     json_decref(config->rule_locations);
+    app_profile_config_free_rule_index(config);
 
     for (i = 0; i < config->search_path_count; i++) {
         free(config->search_path[i]);
@@ -1310,6 +1659,7 @@ static void app_profile_config_delete_file(AppProfileConfig *config, const char
         json_filename = json_object_get(json_file, "filename");
         if (!strcmp(json_string_value(json_filename), filename)) {
             json_array_remove(config->parsed_files, i);
+            app_profile_config_invalidate_rule_index(config);
             return;
         }
     }
@@ -1471,6 +1821,12 @@ json_t *nv_app_profile_config_validate(AppProfileConfig *new_config,
         app_profile_config_get_per_file_config(new_config, filename, &new_file, &new_rules, &new_profiles);
         app_profile_config_get_per_file_config(old_config, filename, &old_file, &old_rules, &old_profiles);
 
+        // A file that is still shared between both configurations has not
+        // been modified in either of them since they were duplicated
+        if (new_file == old_file) {
+            continue;
+        }
+
         // Simply compare the JSON objects
         if (!json_equal(old_rules, new_rules) || !json_equal(old_profiles, new_profiles)) {
             json_object_set_new(changed_files, filename, json_true());
@@ -1537,20 +1893,20 @@ int nv_app_profile_config_update_profile(AppProfileConfig *config,
 
     if (old_filename) {
         // Existing profile
-        old_file = app_profile_config_lookup_file(config, old_filename);
+        old_file = app_profile_config_own_file(config, old_filename);
         assert(old_file);
     }
 
     // If there is an existing profile with a differing filename, delete it first
     if (old_filename && (strcmp(filename, old_filename) != 0)) {
-        file = app_profile_config_lookup_file(config, old_filename);
+        file = old_file;
         file_profiles = json_object_get(file, "profiles");
         if (file) {
             json_object_del(file_profiles, profile_name);
         }
     }
 
-    file = app_profile_config_lookup_file(config, filename);
+    file = app_profile_config_own_file(config, filename);
     if (!file) {
         file = app_profile_config_new_file(config, filename);
     }
@@ -1573,7 +1929,7 @@ void nv_app_profile_config_delete_profile(AppProfileConfig *config,
     const char *filename = json_string_value(json_object_get(config->profile_locations, profile_name));
 
     if (filename) {
-        file = app_profile_config_lookup_file(config, filename);
+        file = app_profile_config_own_file(config, filename);
         if (file) {
             json_object_del(json_object_get(file, "profiles"), profile_name);
         }
@@ -1595,7 +1951,7 @@ int nv_app_profile_config_create_rule(AppProfileConfig *config,
     json_t *new_rule_copy;
     int new_id;
 
-    file = app_profile_config_lookup_file(config, filename);
+    file = app_profile_config_own_file(config, filename);
     if (!file) {
         file = app_profile_config_new_file(config, filename);
     }
@@ -1613,22 +1969,9 @@ int nv_app_profile_config_create_rule(AppProfileConfig *config,
     json_object_set(config->rule_locations, key, json_string(filename));
     free(key);
 
-    return new_id;
-}
-
-static int lookup_rule_index_in_array(json_t *rules, int id)
-{
-    json_t *rule, *rule_id;
-    size_t i, size;
-    for (i = 0, size = json_array_size(rules); i < size; i++) {
-        rule = json_array_get(rules, i);
-        rule_id = json_object_get(rule, "id");
-        if (json_integer_value(rule_id) == id) {
-            return i;
-        }
-    }
+    app_profile_config_invalidate_rule_index(config);
 
-    return -1;
+    return new_id;
 }
 
 int nv_app_profile_config_update_rule(AppProfileConfig *config,
@@ -1641,21 +1984,21 @@ int nv_app_profile_config_update_rule(AppProfileConfig *config,
     json_t *new_rule_copy;
     const char *old_filename;
     char *key;
-    int idx;
+    size_t idx;
     int rule_moved;
 
     key = rule_id_to_key_string(id);
     old_filename = json_string_value(json_object_get(config->rule_locations, key));
     assert(old_filename);
 
-    old_file = app_profile_config_lookup_file(config, old_filename);
+    old_file = app_profile_config_own_file(config, old_filename);
     assert(old_file);
 
     old_file_rules = json_object_get(old_file, "rules");
 
     if (filename && (strcmp(filename, old_filename) != 0)) {
         // If the rule has a new file, delete the rule and re-add it
-        new_file = app_profile_config_lookup_file(config, filename);
+        new_file = app_profile_config_own_file(config, filename);
         rule_moved = TRUE;
         if (!new_file) {
             new_file = app_profile_config_new_file(config, filename);
@@ -1663,8 +2006,7 @@ int nv_app_profile_config_update_rule(AppProfileConfig *config,
 
         new_file_rules = json_object_get(new_file, "rules");
 
-        idx = lookup_rule_index_in_array(old_file_rules, id);
-        if (idx != -1) {
+        if (app_profile_config_lookup_rule(config, id, NULL, &idx)) {
             json_array_remove(old_file_rules, idx);
         }
         json_array_insert(new_file_rules, 0, new_rule);
@@ -1675,8 +2017,7 @@ int nv_app_profile_config_update_rule(AppProfileConfig *config,
     } else {
         // Otherwise, just edit the existing rule
         rule_moved = FALSE;
-        idx = lookup_rule_index_in_array(old_file_rules, id);
-        if (idx != -1) {
+        if (app_profile_config_lookup_rule(config, id, NULL, &idx)) {
             json_array_set(old_file_rules, idx, new_rule);
             new_rule_copy = json_array_get(old_file_rules, idx);
             json_object_set_new(new_rule_copy, "id", json_integer(id));
@@ -1685,6 +2026,8 @@ int nv_app_profile_config_update_rule(AppProfileConfig *config,
 
     free(key);
 
+    app_profile_config_invalidate_rule_index(config);
+
     app_profile_config_prune_empty_file(config, old_file);
 
     return rule_moved;
@@ -1696,25 +2039,26 @@ void nv_app_profile_config_delete_rule(AppProfileConfig *config, int id)
     json_t *file, *file_rules;
     const char *filename;
     char *key;
-    int idx;
+    size_t idx;
 
     key = rule_id_to_key_string(id);
 
     filename = json_string_value(json_object_get(config->rule_locations, key));
     assert(filename);
 
-    file = app_profile_config_lookup_file(config, filename);
+    file = app_profile_config_own_file(config, filename);
     assert(file);
 
     file_rules = json_object_get(file, "rules");
 
-    idx = lookup_rule_index_in_array(file_rules, id);
-    if (idx != -1) {
+    if (app_profile_config_lookup_rule(config, id, NULL, &idx)) {
         json_array_remove(file_rules, idx);
     }
 
     json_object_del(config->rule_locations, key);
     free(key);
+
+    app_profile_config_invalidate_rule_index(config);
 }
 
 size_t nv_app_profile_config_count_rules(AppProfileConfig *config)
@@ -1722,24 +2066,6 @@ size_t nv_app_profile_config_count_rules(AppProfileConfig *config)
     return json_object_size(config->rule_locations);
 }
 
-static size_t app_profile_config_count_rules_before(AppProfileConfig *config, const char *filename)
-{
-    size_t i, size;
-    size_t num_rules = 0;
-    json_t *cur_file, *cur_filename;
-
-    for (i = 0, size = json_array_size(config->parsed_files); i < size; i++) {
-        cur_file = json_array_get(config->parsed_files, i);
-        cur_filename = json_object_get(cur_file, "filename");
-        if (!strcmp(filename, json_string_value(cur_filename))) {
-            break;
-        }
-        num_rules += json_array_size(json_object_get(cur_file, "rules"));
-    }
-
-    return num_rules;
-}
-
 static void app_profile_config_insert_rule(AppProfileConfig *config,
                                            json_t *rule,
                                            size_t new_pri,
@@ -1751,6 +2077,7 @@ static void app_profile_config_insert_rule(AppProfileConfig *config,
     const char *filename;
     json_t *file, *file_rules;
     json_t *target[2];
+    size_t target_idx[2];
     size_t rules_before_target[2];
 
     for (i = 0, j = 0, size = json_array_size(config->parsed_files); i < size; i++) {
@@ -1760,6 +2087,7 @@ static void app_profile_config_insert_rule(AppProfileConfig *config,
             (num_rules + json_array_size(file_rules) >= new_pri)) {
             // Potential target file for this rule
             rules_before_target[j] = num_rules;
+            target_idx[j] = i;
             target[j++] = file;
             if (j >= 2) {
                 break;
@@ -1779,6 +2107,7 @@ static void app_profile_config_insert_rule(AppProfileConfig *config,
     }
     i = (i == j) ? 0 : i;
 
+    target[i] = app_profile_config_own_file_at(config, target_idx[i]);
     file_rules = json_object_get(target[i], "rules");
     json_array_insert_new(file_rules, new_pri - rules_before_target[i], rule);
     // Update the hashtable to point to the new file
@@ -1786,31 +2115,20 @@ static void app_profile_config_insert_rule(AppProfileConfig *config,
     filename = json_string_value(json_object_get(target[i], "filename"));
     json_object_set_new(config->rule_locations, key, json_string(filename));
     free(key);
+
+    app_profile_config_invalidate_rule_index(config);
 }
 
 size_t nv_app_profile_config_get_rule_priority(AppProfileConfig *config,
                                                int id)
 {
-    json_t *file, *file_rules;
-    const char *filename;
-    int idx;
-    char *key;
-
-    key = rule_id_to_key_string(id);
-
-    filename = json_string_value(json_object_get(config->rule_locations, key));
-    assert(filename);
-
-    file = app_profile_config_lookup_file(config, filename);
-    assert(file);
-
-    file_rules = json_object_get(file, "rules");
-
-    idx = lookup_rule_index_in_array(file_rules, id);
+    size_t file_idx, rule_idx;
+    json_t *rule;
 
-    free(key);
+    rule = app_profile_config_lookup_rule(config, id, &file_idx, &rule_idx);
+    assert(rule);
 
-    return app_profile_config_count_rules_before(config, filename) + idx;
+    return config->rule_index_before[file_idx] + rule_idx;
 }
 
 static void app_profile_config_set_abs_rule_priority_internal(AppProfileConfig *config,
@@ -1822,7 +2140,7 @@ static void app_profile_config_set_abs_rule_priority_internal(AppProfileConfig *
     json_t *rule, *rule_copy;
     json_t *file, *file_rules;
     const char *filename;
-    int idx;
+    size_t idx;
     char *key;
 
     if (new_pri == current_pri) {
@@ -1836,16 +2154,16 @@ static void app_profile_config_set_abs_rule_priority_internal(AppProfileConfig *
     filename = json_string_value(json_object_get(config->rule_locations, key));
     assert(filename);
 
-    file = app_profile_config_lookup_file(config, filename);
+    file = app_profile_config_own_file(config, filename);
     assert(file);
 
     file_rules = json_object_get(file, "rules");
-    idx = lookup_rule_index_in_array(file_rules, id);
-    assert(idx >= 0);
-    rule = json_array_get(file_rules, idx);
+    rule = app_profile_config_lookup_rule(config, id, NULL, &idx);
+    assert(rule);
 
     rule_copy = json_deep_copy(rule);
     json_array_remove(file_rules, idx);
+    app_profile_config_invalidate_rule_index(config);
 
     app_profile_config_insert_rule(config, rule_copy, new_pri, filename);
 
@@ -1897,31 +2215,7 @@ const json_t *nv_app_profile_config_get_profile(AppProfileConfig *config,
 const json_t *nv_app_profile_config_get_rule(AppProfileConfig *config,
                                              int id)
 {
-    char *key = rule_id_to_key_string(id);
-    json_t *file, *rule, *filename;
-    json_t *file_rules;
-    int idx;
-
-    filename = json_object_get(config->rule_locations, key);
-
-    if (!filename) {
-        free(key);
-        return NULL;
-    }
-
-    file = app_profile_config_lookup_file(config, json_string_value(filename));
-    file_rules = json_object_get(file, "rules");
-
-    idx = lookup_rule_index_in_array(file_rules, id);
-    if (idx != -1) {
-        rule = json_array_get(file_rules, idx);
-    } else {
-        assert(0);
-        rule = NULL;
-    }
-
-    free(key);
-    return rule;
+    return app_profile_config_lookup_rule(config, id, NULL, NULL);
 }
 
 struct AppProfileConfigProfileIterRec {
@@ -2204,6 +2498,17 @@ int nv_app_profile_config_check_valid_source_file(AppProfileConfig *config,
     return TRUE;
 }
 
+static void app_profile_config_mark_file_dirty(AppProfileConfig *config,
+                                               size_t idx)
+{
+    json_t *file = json_array_get(config->parsed_files, idx);
+
+    if (!json_is_true(json_object_get(file, "dirty"))) {
+        file = app_profile_config_own_file_at(config, idx);
+        json_object_set_new(file, "dirty", json_true());
+    }
+}
+
 int nv_app_profile_config_check_backing_files(AppProfileConfig *config)
 {
     json_t *file;
@@ -2224,12 +2529,12 @@ int nv_app_profile_config_check_backing_files(AppProfileConfig *config)
                 fclose(fp);
                 saved_atime = (time_t)json_integer_value(json_object_get(file, "atime"));
                 if (stat_buf.st_mtime > saved_atime) {
-                    json_object_set_new(file, "dirty", json_true());
+                    app_profile_config_mark_file_dirty(config, i);
                     changed = TRUE;
                 }
             } else {
                 // I/O errors: assume something changed
-                json_object_set_new(file, "dirty", json_true());
+                app_profile_config_mark_file_dirty(config, i);
                 changed = TRUE;
             }
         }
@@ -2305,6 +2610,9 @@ int nv_app_profile_config_profile_name_change_fixup(AppProfileConfig *config,
             assert(json_is_string(rule_profile));
             rule_profile_str = json_string_value(rule_profile);
             if (!strcmp(rule_profile_str, orig_name)) {
+                file = app_profile_config_own_file_at(config, i);
+                rules = json_object_get(file, "rules");
+                rule = json_array_get(rules, j);
                 json_object_set_new(rule, "profile", json_string(new_name));
                 fixed_up = TRUE;
             }
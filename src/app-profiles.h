@@ -93,6 +93,15 @@ typedef struct AppProfileConfigRec {
      */
     json_t *parsed_files;
 
+    /*
+     * File objects in parsed_files are shared with duplicates of this
+     * configuration (see nv_app_profile_config_dup()), and each configuration
+     * replaces a file with its own copy before first modifying it. JSON
+     * object whose keys are the filenames of the files that this
+     * configuration has its own copy of.
+     */
+    json_t *owned_files;
+
     /*
      * We maintain secondary hashtables of profile and rule locations stored as
      * JSON objects for quicker lookup of individual profiles and rules. This is
@@ -103,6 +112,20 @@ typedef struct AppProfileConfigRec {
     json_t *rule_locations;
     size_t next_free_rule_id;
 
+    /*
+     * Index of rule positions, derived from parsed_files and rebuilt on the
+     * first lookup after any change to the rules or to the list of files.
+     * For each rule id below rule_index_len, rule_index_file is the index of
+     * its file in parsed_files (or -1 if the id is unused) and rule_index_pos
+     * the index of the rule in that file's rules array.  rule_index_before
+     * holds, for each file, the number of rules in all files before it.
+     */
+    int rule_index_valid;
+    size_t rule_index_len;
+    int *rule_index_file;
+    size_t *rule_index_pos;
+    size_t *rule_index_before;
+
     /*
      * Copy of the global configuration filename
      */
@@ -131,6 +154,8 @@ int nv_app_profile_config_save_updates(AppProfileConfig *config,
 
 /*
  * Load an application profile configuration from disk, using a list of files specified by search_path.
+ * This temporarily replaces jansson's allocation functions, so it must not
+ * be called while another thread may be using jansson.
  */
 AppProfileConfig *nv_app_profile_config_load(const char *global_config_file,
                                              char **search_path,
@@ -143,7 +168,8 @@ json_t *nv_app_profile_key_documentation_load(const char *key_docs_file);
 
 /*
  * Duplicate the configuration; the copy can then be edited and compared against
- * the original.
+ * the original. The files of the configuration are shared between the original
+ * and the copy, until either of them modifies a file.
  */
 AppProfileConfig *nv_app_profile_config_dup(AppProfileConfig *old_config);
 
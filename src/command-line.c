@@ -215,11 +215,12 @@ Options *parse_command_line(int argc, char *argv[],
     Options *op;
     int n, c;
     char *strval;
-    int boolval;
+    int boolval, intval;
 
     op = nvalloc(sizeof(Options));
     op->config = DEFAULT_RC_FILE;
     op->write_config = NV_TRUE;
+    op->monitor_interval = DEFAULT_MONITOR_INTERVAL;
 
     /*
      * initialize the controlled display to the gui display name
@@ -229,7 +230,7 @@ Options *parse_command_line(int argc, char *argv[],
     while (1) {
         c = nvgetopt(argc, argv, __options, &strval,
                      &boolval,  /* boolval */
-                     NULL,  /* intval */
+                     &intval,  /* intval */
                      NULL,  /* doubleval */
                      NULL); /* disable_val */
 
@@ -289,6 +290,32 @@ Options *parse_command_line(int argc, char *argv[],
             op->queries[n] = strval;
             op->num_queries++;
             break;
+        case MONITOR_OPTION:
+            n = op->num_monitors;
+            op->monitors = nvrealloc(op->monitors, sizeof(char *) * (n+1));
+            op->monitors[n] = strval;
+            op->num_monitors++;
+            break;
+        case INTERVAL_OPTION:
+            if (intval <= 0) {
+                nv_error_msg("Invalid monitor interval %d; the interval must "
+                             "be a positive number of milliseconds.", intval);
+                exit(1);
+            }
+            op->monitor_interval = intval;
+            break;
+        case OUTPUT_OPTION:
+            if (nv_strcasecmp(strval, "json") == NV_TRUE) {
+                op->output_json = NV_TRUE;
+            } else if (nv_strcasecmp(strval, "text") == NV_TRUE) {
+                op->output_json = NV_FALSE;
+            } else {
+                nv_error_msg("Invalid output format '%s'.  Please run "
+                             "`%s --help` for usage information.\n",
+                             strval, argv[0]);
+                exit(1);
+            }
+            break;
         case CONFIG_FILE_OPTION: op->config = strval; break;
         case 'g': print_glxinfo(NULL, systems); exit(0); break;
         case 'E': print_eglinfo(NULL, systems); exit(0); break;
@@ -300,6 +327,7 @@ Options *parse_command_line(int argc, char *argv[],
         case 'w': op->write_config = boolval; break;
         case 'i': op->use_gtk2 = NV_TRUE; break;
         case 'I': op->gtk_lib_path = strval; break;
+        case STARTUP_PROFILE_OPTION: op->startup_profile = NV_TRUE; break;
         default:
             nv_error_msg("Invalid commandline, please run `%s --help` "
                          "for usage information.\n", argv[0]);
@@ -30,6 +30,12 @@ struct _CtrlSystemList;
 #define DEFAULT_RC_FILE "~/.nvidia-settings-rc"
 #define CONFIG_FILE_OPTION 1
 #define DISPLAY_OPTION 2
+#define MONITOR_OPTION 3
+#define INTERVAL_OPTION 4
+#define OUTPUT_OPTION 5
+#define STARTUP_PROFILE_OPTION 6
+
+#define DEFAULT_MONITOR_INTERVAL 1000 /* milliseconds */
 
 /*
  * Options structure -- stores the parameters specified on the
@@ -70,6 +76,21 @@ typedef struct {
                           * Number of query strings in the query
                           * array.
                           */
+
+    char **monitors;     /*
+                          * Dynamically allocated array of attribute
+                          * lists to sample periodically (--monitor).
+                          */
+
+    int num_monitors;    /*
+                          * Number of attribute lists in the monitors
+                          * array.
+                          */
+
+    int monitor_interval; /*
+                           * Time between two --monitor samples, in
+                           * milliseconds.
+                           */
     
     int only_load;       /*
                           * If true, just read the configuration file,
@@ -92,6 +113,11 @@ typedef struct {
                           * when started.
                           */
 
+    int startup_profile; /*
+                          * If true, print the time spent building each
+                          * page of the GUI.
+                          */
+
     int list_targets;    /*
                           * If true, list resolved targets of operations
                           * (from query/assign or rc file) and exit.
@@ -102,6 +128,12 @@ typedef struct {
                           * operations.
                           */
 
+    int output_json;     /*
+                          * If true, print the results of query and
+                          * monitor operations as JSON rather than as
+                          * text (--output=json).
+                          */
+
     int dpy_string;      /*
                           * If true, output the display device mask as a list
                           * of display device names instead of a number.
@@ -31,6 +31,7 @@
 #include <fcntl.h>
 #include <ctype.h>
 #include <pwd.h>
+#include <time.h>
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -443,6 +444,23 @@ char *nvstrchrnul(char *s, int c)
     return result;
 }
 
+/*
+ * nv_get_monotonic_time_us() - return a monotonic timestamp in microseconds,
+ * suitable for measuring elapsed time.
+ */
+
+uint64_t nv_get_monotonic_time_us(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+
 /****************************************************************************/
 /* file helper functions */
 /****************************************************************************/
@@ -67,6 +67,8 @@ void nvfree(void *s);
 char *tilde_expansion(const char *str);
 char *nv_prepend_to_string_list(char *list, const char *item, const char *delim);
 
+uint64_t nv_get_monotonic_time_us(void);
+
 char *fget_next_line(FILE *fp, int *eof);
 
 int nv_open(const char *pathname, int flags, mode_t mode);
@@ -217,6 +217,50 @@ int nv_read_config_file(const Options *op, const char *file,
 
 
 
+/*
+ * query_writable_attributes() - fill 'queries' (indexed like
+ * attributeTable[]) with the current value of every writable integer
+ * attribute of target 't' whose permissions include all target types in
+ * 'required_targets' and none of those in 'excluded_targets'.  The values
+ * are fetched as one batch; entries that were not queried have a NULL
+ * ctrl_target.
+ */
+
+static void query_writable_attributes(CtrlTarget *t,
+                                      unsigned int required_targets,
+                                      unsigned int excluded_targets,
+                                      CtrlAttributeQuery *queries)
+{
+    int entry;
+
+    memset(queries, 0, attributeTableLen * sizeof(CtrlAttributeQuery));
+
+    for (entry = 0; entry < attributeTableLen; entry++) {
+        const AttributeTableEntry *a = &attributeTable[entry];
+        CtrlAttributePerms perms;
+        ReturnStatus status;
+
+        if (a->flags.no_config_write ||
+            (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER)) {
+            continue;
+        }
+
+        status = NvCtrlGetAttributePerms(t, a->type, a->attr, &perms);
+        if (status != NvCtrlSuccess || !(perms.write) ||
+            ((perms.valid_targets & required_targets) != required_targets) ||
+            (perms.valid_targets & excluded_targets)) {
+            continue;
+        }
+
+        queries[entry].ctrl_target = t;
+        queries[entry].attr = a->attr;
+    }
+
+    NvCtrlGetAttributesBatch(queries, attributeTableLen);
+}
+
+
+
 /*
  * nv_write_config_file() - write a configuration file to the
  * specified filename.
@@ -235,7 +279,7 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
     FILE *stream;
     time_t now;
     ReturnStatus status;
-    CtrlAttributePerms perms;
+    CtrlAttributeQuery *queries;
     CtrlTargetNode *node;
     CtrlTarget *t;
     char *prefix, scratch[4];
@@ -294,6 +338,8 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
      * followed by attributes for display target types.
      */
 
+    queries = nvalloc(attributeTableLen * sizeof(CtrlAttributeQuery));
+
     for (node = system->targets[X_SCREEN_TARGET]; node; node = node->next) {
 
         t = node->t;
@@ -316,6 +362,15 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
             prefix = scratch;
         }
 
+        /*
+         * Ignore display attributes (they are written later on) and only
+         * write attributes that can be written for an X screen target
+         */
+
+        query_writable_attributes(t, CTRL_TARGET_PERM_BIT(X_SCREEN_TARGET),
+                                  CTRL_TARGET_PERM_BIT(DISPLAY_TARGET),
+                                  queries);
+
         /* loop over all the entries in the table */
 
         for (entry = 0; entry < attributeTableLen; entry++) {
@@ -355,29 +410,14 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
                 continue;
             }
 
-            /* Only write out integer attributes, string attributes
-             * aren't written here.
-             */
-            if (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER) {
-                continue;
-            }
-
-            /*
-             * Ignore display attributes (they are written later on) and only
-             * write attributes that can be written for an X screen target
-             */
+            /* Only write out the integer attributes queried above */
 
-            status = NvCtrlGetAttributePerms(t, a->type, a->attr, &perms);
-            if (status != NvCtrlSuccess || !(perms.write) ||
-                !(perms.valid_targets & CTRL_TARGET_PERM_BIT(X_SCREEN_TARGET)) ||
-                (perms.valid_targets & CTRL_TARGET_PERM_BIT(DISPLAY_TARGET))) {
+            if (!queries[entry].ctrl_target ||
+                (queries[entry].status != NvCtrlSuccess)) {
                 continue;
             }
 
-            status = NvCtrlGetAttribute(t, a->attr, &val);
-            if (status != NvCtrlSuccess) {
-                continue;
-            }
+            val = queries[entry].val;
 
             if (a->f.int_flags.is_display_id) {
                 const char *name = NvCtrlGetDisplayConfigName(system, val);
@@ -423,6 +463,11 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
 
         prefix = create_display_device_target_string(t, conf);
 
+        /* Make sure this is a display and writable attribute */
+
+        query_writable_attributes(t, CTRL_TARGET_PERM_BIT(DISPLAY_TARGET), 0,
+                                  queries);
+
         /* loop over all the entries in the table */
 
         for (entry = 0; entry < attributeTableLen; entry++) {
@@ -455,25 +500,13 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
                 continue;
             }
 
-            /* Only write out integer attributes, string attributes
-             * aren't written here.
-             */
-            if (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER) {
-                continue;
-            }
-
-            /* Make sure this is a display and writable attribute */
-
-            status = NvCtrlGetAttributePerms(t, a->type, a->attr, &perms);
-            if (status != NvCtrlSuccess || !(perms.write) ||
-                !(perms.valid_targets & CTRL_TARGET_PERM_BIT(DISPLAY_TARGET))) {
-                continue;
-            }
+            /* Only write out the integer attributes queried above */
 
-            status = NvCtrlGetAttribute(t, a->attr, &val);
-            if (status == NvCtrlSuccess) {
+            if (queries[entry].ctrl_target &&
+                (queries[entry].status == NvCtrlSuccess)) {
                 fprintf(stream, "%s%c%s=%d\n", prefix,
-                        DISPLAY_NAME_SEPARATOR, a->name, val);
+                        DISPLAY_NAME_SEPARATOR, a->name,
+                        (int) queries[entry].val);
             }
         }
 
@@ -503,49 +536,33 @@ int nv_write_config_file(const char *filename, const CtrlSystem *system,
         target_str = nvasprintf("[gpu:%d]", NvCtrlGetTargetId(t));
         nvstrtoupper(target_str);
 
+        /*
+         * Only write attributes that can be written for a GPU target
+         */
+
+        query_writable_attributes(t, CTRL_TARGET_PERM_BIT(GPU_TARGET), 0,
+                                  queries);
+
         /* loop over all the entries in the table */
 
         for (entry = 0; entry < attributeTableLen; entry++) {
             const AttributeTableEntry *a = &attributeTable[entry];
 
-            /*
-             * skip all attributes that are not supposed to be written
-             * to the config file
-             */
-
-            if (a->flags.no_config_write) {
-                continue;
-            }
-
-            /* Only write out integer attributes, string attributes
-             * aren't written here.
-             */
-            if (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER) {
-                continue;
-            }
-
-            /*
-             * Only write attributes that can be written for a GPU target
-             */
-
-            status = NvCtrlGetAttributePerms(t, a->type, a->attr, &perms);
-            if (status != NvCtrlSuccess || !(perms.write) ||
-                !(perms.valid_targets & CTRL_TARGET_PERM_BIT(GPU_TARGET)))  {
-                continue;
-            }
-
-            status = NvCtrlGetAttribute(t, a->attr, &val);
-            if (status != NvCtrlSuccess) {
+            if (!queries[entry].ctrl_target ||
+                (queries[entry].status != NvCtrlSuccess)) {
                 continue;
             }
 
             fprintf(stream, "%s%c%s=%d\n", target_str,
-                    DISPLAY_NAME_SEPARATOR, a->name, val);
+                    DISPLAY_NAME_SEPARATOR, a->name,
+                    (int) queries[entry].val);
         }
 
         free(target_str);
     }
 
+    nvfree(queries);
+
     /*
      * loop the ParsedAttribute list, writing the attributes to file.
      * note that we ignore conf->include_display_name_in_config_file
@@ -631,14 +648,16 @@ static ParsedAttributeWrapper *parse_config_file(char *buf, const char *file,
                                                  const int length,
                                                  ConfigProperties *conf)
 {
-    int line, has_data, current_tmp_len, len, n, ret;
+    int line, has_data, current_tmp_len, len, n, n_alloc, ret;
     char *cur, *c, *comment, *tmp;
+    uint64_t start = nv_get_monotonic_time_us();
     ParsedAttributeWrapper *w;
     
     cur = buf;
     line = 1;
     current_tmp_len = 0;
     n = 0;
+    n_alloc = 0;
     w = NULL;
     tmp = NULL;
 
@@ -677,7 +696,12 @@ static ParsedAttributeWrapper *parse_config_file(char *buf, const char *file,
 
             if (!parse_config_property(file, tmp, conf)) {
                 
-                w = nvrealloc(w, sizeof(ParsedAttributeWrapper) * (n+1));
+                /* leave room for the end of array marker */
+
+                if ((n + 2) > n_alloc) {
+                    n_alloc = n_alloc ? (n_alloc * 2) : 64;
+                    w = nvrealloc(w, sizeof(ParsedAttributeWrapper) * n_alloc);
+                }
             
                 ret = nv_parse_attribute_string(tmp,
                                                 NV_PARSER_ASSIGNMENT,
@@ -702,8 +726,14 @@ static ParsedAttributeWrapper *parse_config_file(char *buf, const char *file,
     free(tmp);
     /* mark the end of the array */
 
-    w = nvrealloc(w, sizeof(ParsedAttributeWrapper) * (n+1));
+    if (!w) {
+        w = nvalloc(sizeof(ParsedAttributeWrapper));
+    }
     w[n].line = -1;
+
+    nv_info_msg(NULL, "Parsed %d attribute assignment(s) from %d line(s) of "
+                "'%s' in %.2f ms.", n, line - 1, file,
+                (nv_get_monotonic_time_us() - start) / 1000.0);
     
     return w;
 
@@ -842,6 +872,7 @@ ConfigPropertiesTableEntry configPropertyTable[] = {
       CONFIG_PROPERTIES_INCLUDE_DISPLAY_NAME_IN_CONFIG_FILE },
     { "UpdateRulesOnProfileNameChange",
       CONFIG_PROPERTIES_UPDATE_RULES_ON_PROFILE_NAME_CHANGE },
+    { "PrefetchPages", CONFIG_PROPERTIES_PREFETCH_PAGES },
     { NULL, 0 }
 };
 
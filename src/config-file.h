@@ -35,6 +35,7 @@
 #define CONFIG_PROPERTIES_SLIDER_TEXT_ENTRIES                 (1<<2)
 #define CONFIG_PROPERTIES_INCLUDE_DISPLAY_NAME_IN_CONFIG_FILE (1<<3)
 #define CONFIG_PROPERTIES_UPDATE_RULES_ON_PROFILE_NAME_CHANGE (1<<4)
+#define CONFIG_PROPERTIES_PREFETCH_PAGES                      (1<<5)
 
 typedef struct _TimerConfigProperty {
     char *description;
@@ -20,6 +20,7 @@
 #include <gtk/gtk.h>
 
 #include "NvCtrlAttributes.h"
+#include "msg.h"
 
 #include "rgb_xpm.h"
 #include "red_xpm.h"
@@ -81,6 +82,12 @@ get_attribute_channel_value (CtkColorCorrection *, gint, gint);
 static void
 flush_attribute_channel_values (CtkColorCorrection *, gint, gint);
 
+static void
+queue_attribute_channel_values (CtkColorCorrection *, gint, gint);
+
+static void
+cancel_pending_flush (CtkColorCorrection *);
+
 static void
 ctk_color_correction_class_init(CtkColorCorrectionClass *, gpointer);
 
@@ -105,6 +112,12 @@ enum {
 
 static guint signals[LAST_SIGNAL] = { 0 };
 
+/*
+ * Without a frame clock (GTK+ 2), pending slider changes are pushed from a
+ * timeout of about one frame at 60Hz.
+ */
+#define COLOR_CORRECTION_FLUSH_INTERVAL 16 /* ms */
+
 #define RED        RED_CHANNEL_INDEX
 #define GREEN      GREEN_CHANNEL_INDEX
 #define BLUE       BLUE_CHANNEL_INDEX
@@ -186,6 +199,21 @@ static void ctk_color_correction_finalize(GObject *object)
     CtkColorCorrection *ctk_color_correction = CTK_COLOR_CORRECTION(object);
     CtrlTarget *ctrl_target = ctk_color_correction->ctrl_target;
 
+    /*
+     * Pending slider changes were not confirmed yet: they are dropped, and
+     * the settings reverted below.
+     */
+    cancel_pending_flush(ctk_color_correction);
+
+    /* Statistics are only printed with --verbose=all */
+    if (ctk_color_correction->num_saved_flushes &&
+        (nv_get_verbosity() >= NV_VERBOSITY_ALL)) {
+        nv_info_msg(NULL, "Color correction of %s: %u slider change(s) "
+                    "merged into an already pending update.",
+                    ctrl_target->name,
+                    ctk_color_correction->num_saved_flushes);
+    }
+
     if (ctk_color_correction->confirm_timer) {
         /*
          * This situation comes, if user perform VT-switching
@@ -805,8 +833,6 @@ static void adjustment_value_changed(
     channel = GPOINTER_TO_INT(user_data);
 
     value = gtk_adjustment_get_value(adjustment);
-    
-    ctk_color_correction->num_expected_updates++;
 
     /* start timer for confirming changes */
     ctk_color_correction->confirm_countdown =
@@ -857,7 +883,7 @@ static void adjustment_value_changed(
     set_color_state(ctk_color_correction, attribute_idx, channel,
                     value, FALSE);
     
-    flush_attribute_channel_values(ctk_color_correction, attribute, channel);
+    queue_attribute_channel_values(ctk_color_correction, attribute, channel);
     
     ctk_config_statusbar_message(ctk_color_correction->ctk_config,
                                  "Set %s%s to %f.",
@@ -906,6 +932,109 @@ static gfloat get_attribute_channel_value(CtkColorCorrection
     return ctk_color_correction->cur_slider_val[attribute_idx][channel_idx];
 }
 
+/** cancel_pending_flush() ************************************
+ *
+ * Removes the tick callback (or timeout) of slider changes queued by
+ * queue_attribute_channel_values(), and forgets those changes.
+ *
+ **/
+
+static void cancel_pending_flush(CtkColorCorrection *ctk_color_correction)
+{
+    if (ctk_color_correction->pending_flush) {
+#ifdef CTK_GTK3
+        gtk_widget_remove_tick_callback(GTK_WIDGET(ctk_color_correction),
+                                        ctk_color_correction->pending_flush);
+#else
+        g_source_remove(ctk_color_correction->pending_flush);
+#endif
+        ctk_color_correction->pending_flush = 0;
+    }
+
+    ctk_color_correction->pending_attributes = 0;
+}
+
+
+
+static void flush_pending_attribute_channel_values(
+    CtkColorCorrection *ctk_color_correction
+)
+{
+    gint attributes = ctk_color_correction->pending_attributes;
+
+    ctk_color_correction->pending_flush = 0;
+    ctk_color_correction->pending_attributes = 0;
+
+    if (attributes) {
+        ctk_color_correction->num_expected_updates++;
+        flush_attribute_channel_values(ctk_color_correction, attributes, 0);
+    }
+}
+
+
+
+#ifdef CTK_GTK3
+static gboolean flush_pending_tick(GtkWidget *widget,
+                                   GdkFrameClock *frame_clock,
+                                   gpointer user_data)
+{
+    flush_pending_attribute_channel_values(CTK_COLOR_CORRECTION(user_data));
+    return G_SOURCE_REMOVE;
+}
+#else
+static gboolean flush_pending_timeout(gpointer user_data)
+{
+    flush_pending_attribute_channel_values(CTK_COLOR_CORRECTION(user_data));
+    return FALSE;
+}
+#endif
+
+
+
+/** queue_attribute_channel_values() **************************
+ *
+ * Queues pushing the current values of the given attributes and channels
+ * to the X server.  Every slider motion event changes the values, but only
+ * the latest ones matter: they are pushed once, on the next frame.
+ *
+ **/
+
+static void queue_attribute_channel_values(
+    CtkColorCorrection *ctk_color_correction,
+    gint attribute,
+    gint channel
+)
+{
+    if (ctk_color_correction->pending_flush) {
+        ctk_color_correction->pending_attributes |= attribute | channel;
+        ctk_color_correction->num_saved_flushes++;
+        return;
+    }
+
+    ctk_color_correction->pending_attributes = attribute | channel;
+
+#ifdef CTK_GTK3
+    /* Tick callbacks only run while the page is shown */
+    if (!gtk_widget_get_mapped(GTK_WIDGET(ctk_color_correction))) {
+        flush_pending_attribute_channel_values(ctk_color_correction);
+        return;
+    }
+
+    ctk_color_correction->pending_flush =
+        gtk_widget_add_tick_callback(GTK_WIDGET(ctk_color_correction),
+                                     flush_pending_tick,
+                                     (gpointer) ctk_color_correction,
+                                     NULL);
+#else
+    ctk_color_correction->pending_flush =
+        g_timeout_add(COLOR_CORRECTION_FLUSH_INTERVAL,
+                      flush_pending_timeout,
+                      (gpointer) ctk_color_correction);
+#endif
+}
+
+
+
 static void flush_attribute_channel_values(
     CtkColorCorrection *ctk_color_correction,
     gint attribute,
@@ -914,6 +1043,13 @@ static void flush_attribute_channel_values(
 {
     CtrlTarget *ctrl_target = ctk_color_correction->ctrl_target;
 
+    /*
+     * The values are pushed as a whole: pending slider changes go along
+     * with these.
+     */
+    attribute |= ctk_color_correction->pending_attributes;
+    cancel_pending_flush(ctk_color_correction);
+
     NvCtrlSetColorAttributes(ctrl_target,
                              ctk_color_correction->cur_slider_val[CONTRAST],
                              ctk_color_correction->cur_slider_val[BRIGHTNESS],
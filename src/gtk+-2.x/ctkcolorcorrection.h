@@ -71,6 +71,16 @@ struct _CtkColorCorrection
     gfloat prev_slider_val[3][4]; // as [attribute][channel]
     guint enabled_display_devices;
     int num_expected_updates;
+
+    /*
+     * Slider changes are coalesced and pushed at most once per frame:
+     * pending_flush is the tick callback (or timeout) doing the push, and
+     * pending_attributes what it pushes.  num_saved_flushes counts the
+     * pushes avoided that way; it is reported when the page is destroyed.
+     */
+    guint pending_flush;
+    gint pending_attributes;
+    guint num_saved_flushes;
 };
 
 struct _CtkColorCorrectionClass
@@ -28,6 +28,7 @@
 #include "ctkwindow.h"
 #include "ctkutils.h"
 #include "ctkbanner.h"
+#include "ctkevent.h"
 
 #include <stdarg.h>
 #include <stdlib.h>
@@ -58,6 +59,18 @@ static const char *__x_display_names_help =
 "It is normally recommended to leave this option "
 "unchecked.";
 
+static const char *__event_stats_help =
+"The 'Event Statistics' section reports how many NV-CONTROL events "
+"nvidia-settings has received, the current event rate, how many "
+"attribute updates were superseded by a later value received in the "
+"same batch of events, how many times pages were notified of an event "
+"(and how many pages were skipped because they do not track the changed "
+"attribute), and the average time spent per event and the longest time "
+"spent on a single batch of events.  This information is refreshed "
+"while the page is shown.";
+
+#define DEFAULT_UPDATE_EVENT_STATS_TIME_INTERVAL 1000
+
 static const char *__save_current_config_help =
 "When nvidia-settings exits, it saves the current X server "
 "configuration to a configuration file (\"~/.nvidia-settings-rc\", "
@@ -70,6 +83,14 @@ static const char *__update_rules_on_profile_name_change_help =
 "that refer to that profile to also be updated to refer to the new "
 "profile name.";
 
+static const char *__prefetch_pages_help =
+"Most pages of nvidia-settings are only built the first time they are "
+"selected, so that the nvidia-settings window appears quickly.  If this "
+"option is enabled, the remaining pages are built in the background once "
+"the window is shown, so that selecting them later does not wait on the "
+"X server or the GPU.  This option takes effect the next time "
+"nvidia-settings is started.";
+
 static void ctk_config_class_init(CtkConfigClass *ctk_config_class, gpointer);
 
 static void display_status_bar_toggled(GtkWidget *, gpointer);
@@ -77,9 +98,12 @@ static void slider_text_entries_toggled(GtkWidget *, gpointer);
 static void display_name_toggled(GtkWidget *widget, gpointer user_data);
 static void update_rules_on_profile_name_change_toggled(GtkWidget *widget,
                                                         gpointer user_data);
+static void prefetch_pages_toggled(GtkWidget *widget, gpointer user_data);
 
 static void save_rc_clicked(GtkWidget *widget, gpointer user_data);
 
+static gboolean update_event_stats(gpointer user_data);
+
 static GtkWidget *create_timer_list(CtkConfig *);
 
 static guint signals[1];
@@ -186,6 +210,12 @@ GtkWidget* ctk_config_new(ConfigProperties *conf, CtrlSystem *pCtrlSystem)
             G_CALLBACK(update_rules_on_profile_name_change_toggled),
             __update_rules_on_profile_name_change_help
         },
+        {
+            "Build Pages in the Background",
+            CONFIG_PROPERTIES_PREFETCH_PAGES,
+            G_CALLBACK(prefetch_pages_toggled),
+            __prefetch_pages_help
+        },
 
     };
 
@@ -254,6 +284,28 @@ GtkWidget* ctk_config_new(ConfigProperties *conf, CtrlSystem *pCtrlSystem)
     }
 
     ctk_config->help_data = g_list_reverse(ctk_config->help_data);
+
+    /* "Event Statistics" */
+
+    hbox = gtk_hbox_new (FALSE, 5);
+    gtk_box_pack_start(GTK_BOX(ctk_config), hbox, FALSE, FALSE, 0);
+
+    label = gtk_label_new("Event Statistics");
+    gtk_box_pack_start(GTK_BOX(hbox), label, FALSE, FALSE, 0);
+
+    hseparator = gtk_hseparator_new();
+    gtk_box_pack_start(GTK_BOX(hbox), hseparator, TRUE, TRUE, 0);
+
+    hbox = gtk_hbox_new(FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(ctk_config), hbox, FALSE, FALSE, 0);
+
+    ctk_config->event_stats_label = gtk_label_new(NULL);
+    gtk_label_set_justify(GTK_LABEL(ctk_config->event_stats_label),
+                          GTK_JUSTIFY_LEFT);
+    gtk_box_pack_start(GTK_BOX(hbox), ctk_config->event_stats_label,
+                       FALSE, FALSE, 0);
+
+    update_event_stats(ctk_config);
     
     /* timer list */
     
@@ -485,6 +537,97 @@ static void update_rules_on_profile_name_change_toggled(GtkWidget *widget,
                                  active ? "enabled" : "disabled");
 }
 
+static void prefetch_pages_toggled(GtkWidget *widget, gpointer user_data)
+{
+    CtkConfig *ctk_config = CTK_CONFIG(user_data);
+    gboolean active = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+
+    if (active) {
+        ctk_config->conf->booleans |= CONFIG_PROPERTIES_PREFETCH_PAGES;
+    } else {
+        ctk_config->conf->booleans &= ~CONFIG_PROPERTIES_PREFETCH_PAGES;
+    }
+
+    ctk_config_statusbar_message(ctk_config,
+                                 "Building pages in the background is %s.",
+                                 active ? "enabled" : "disabled");
+}
+
+
+/*
+ * update_event_stats() - refresh the "Event Statistics" section from the
+ * CtkEvent dispatch counters.
+ */
+
+static gboolean update_event_stats(gpointer user_data)
+{
+    CtkConfig *ctk_config = CTK_CONFIG(user_data);
+    CtkEventStats stats;
+    gchar *str;
+
+    ctk_event_get_stats(&stats);
+
+    str = g_strdup_printf("Events received: %" G_GUINT64_FORMAT
+                          " (%.1f per second), superseded: %"
+                          G_GUINT64_FORMAT "\n"
+                          "Pages notified: %" G_GUINT64_FORMAT
+                          ", skipped: %" G_GUINT64_FORMAT "\n"
+                          "Dispatch time: %.3f ms per event, "
+                          "%.3f ms longest batch",
+                          stats.events, stats.events_per_second,
+                          stats.collapsed, stats.emitted, stats.filtered,
+                          stats.events ?
+                              (stats.total_latency_us / 1000.0) /
+                              stats.events : 0.0,
+                          stats.max_latency_us / 1000.0);
+
+    gtk_label_set_text(GTK_LABEL(ctk_config->event_stats_label), str);
+    g_free(str);
+
+    return TRUE;
+
+} /* update_event_stats() */
+
+
+
+/*
+ * ctk_config_page_select() - start refreshing the event statistics when
+ * the nvidia-settings Configuration page is shown.  The refresh timer is
+ * not one of the Active Timers: it only ever runs while this page is
+ * shown, and listing it would keep the Active Timers table visible, with
+ * the timer enabled, when no attribute is being polled.
+ */
+
+void ctk_config_page_select(GtkWidget *widget)
+{
+    CtkConfig *ctk_config = CTK_CONFIG(widget);
+
+    update_event_stats(ctk_config);
+
+    if (!ctk_config->event_stats_timer) {
+        ctk_config->event_stats_timer =
+            g_timeout_add(DEFAULT_UPDATE_EVENT_STATS_TIME_INTERVAL,
+                          update_event_stats, ctk_config);
+    }
+}
+
+
+
+/*
+ * ctk_config_page_unselect() - stop refreshing the event statistics when
+ * the nvidia-settings Configuration page is hidden.
+ */
+
+void ctk_config_page_unselect(GtkWidget *widget)
+{
+    CtkConfig *ctk_config = CTK_CONFIG(widget);
+
+    if (ctk_config->event_stats_timer) {
+        g_source_remove(ctk_config->event_stats_timer);
+        ctk_config->event_stats_timer = 0;
+    }
+}
+
 
 gboolean ctk_config_slider_text_entry_shown(CtkConfig *ctk_config)
 {
@@ -518,6 +661,9 @@ GtkTextBuffer *ctk_config_create_help(CtkConfig *ctk_config, GtkTextTagTable *ta
                   "consecutive polls (in milliseconds).  The Active "
                   "Timers table is only visible when timers are active.");
 
+    ctk_help_heading(b, &i, "Event Statistics");
+    ctk_help_para(b, &i, "%s", __event_stats_help);
+
     ctk_help_heading(b, &i, "Save Current Configuration");
     ctk_help_para(b, &i, "%s", __save_current_config_help);
 
@@ -95,6 +95,8 @@ struct _CtkConfig
     GtkWidget *timer_list;
     GtkWidget *timer_list_box;
     GtkWidget *button_save_rc;
+    GtkWidget *event_stats_label;
+    guint event_stats_timer;
     gchar *rc_filename;
     gboolean timer_list_visible;
     CtrlSystem *pCtrlSystem;
@@ -123,6 +125,9 @@ void ctk_config_stop_timer(CtkConfig *, GSourceFunc, gpointer);
 
 gboolean ctk_config_slider_text_entry_shown(CtkConfig *);
 
+void ctk_config_page_select(GtkWidget *);
+void ctk_config_page_unselect(GtkWidget *);
+
 void ctk_config_set_tooltip_and_add_help_data(CtkConfig *config,
                                               GtkWidget *widget,
                                               GList **help_data_list,
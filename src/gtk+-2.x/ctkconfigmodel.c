@@ -0,0 +1,442 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2013 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+// Read-only list model over an array of fixed size records.  Unlike a
+// GtkListStore, no per-cell strings are kept: the view asks for the cells it
+// draws, and those are formatted from the record when requested.
+
+#include <gtk/gtk.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "ctkconfigmodel.h"
+#include "ctkutils.h"
+
+static GObjectClass *parent_class = NULL;
+
+// Forward declarations
+GType ctk_config_model_get_type(void);
+static void config_model_class_init(CtkConfigModelClass *klass, gpointer);
+static void config_model_init(CtkConfigModel *config_model, gpointer);
+static void config_model_finalize(GObject *object);
+static void config_model_tree_model_init(GtkTreeModelIface *iface, gpointer);
+static GtkTreeModelFlags config_model_get_flags(GtkTreeModel *tree_model);
+static gint config_model_get_n_columns(GtkTreeModel *tree_model);
+static GType config_model_get_column_type(GtkTreeModel *tree_model, gint index);
+static gboolean config_model_get_iter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path);
+static GtkTreePath *config_model_get_path(GtkTreeModel *tree_model, GtkTreeIter *iter);
+static void config_model_get_value(GtkTreeModel *tree_model,
+                                   GtkTreeIter *iter,
+                                   gint column,
+                                   GValue *value);
+static gboolean config_model_iter_next(GtkTreeModel *tree_model,
+                                       GtkTreeIter *iter);
+static gboolean config_model_iter_children(GtkTreeModel *tree_model,
+                                           GtkTreeIter *iter,
+                                           GtkTreeIter *parent);
+static gboolean config_model_iter_has_child(GtkTreeModel *tree_model,
+                                            GtkTreeIter *iter);
+static gint config_model_iter_n_children(GtkTreeModel *tree_model,
+                                         GtkTreeIter *iter);
+static gboolean config_model_iter_nth_child(GtkTreeModel *tree_model,
+                                            GtkTreeIter  *iter,
+                                            GtkTreeIter  *parent,
+                                            gint         n);
+static gboolean config_model_iter_parent(GtkTreeModel *tree_model,
+                                         GtkTreeIter *iter,
+                                         GtkTreeIter *child);
+
+
+GType ctk_config_model_get_type(void)
+{
+    static GType config_model_type = 0;
+    if (!config_model_type) {
+        static const GTypeInfo config_model_info = {
+            sizeof (CtkConfigModelClass),
+            NULL, /* base_init */
+            NULL, /* base_finalize */
+            (GClassInitFunc) config_model_class_init, /* constructor */
+            NULL, /* class_finalize */
+            NULL, /* class_data */
+            sizeof (CtkConfigModel),
+            0,    /* n_preallocs */
+            (GInstanceInitFunc) config_model_init, /* instance_init */
+            NULL  /* value_table */
+        };
+        static const GInterfaceInfo tree_model_info =
+        {
+            (GInterfaceInitFunc) config_model_tree_model_init, /* interface_init */
+            NULL, /* interface_finalize */
+            NULL  /* interface_data */
+        };
+
+        config_model_type =
+            g_type_register_static(G_TYPE_OBJECT, "CtkConfigModel",
+                                   &config_model_info, 0);
+
+        g_type_add_interface_static(config_model_type, GTK_TYPE_TREE_MODEL, &tree_model_info);
+    }
+
+    return config_model_type;
+}
+
+static void config_model_class_init(CtkConfigModelClass *klass,
+                                    gpointer class_data)
+{
+    GObjectClass *object_class;
+
+    parent_class = (GObjectClass *)g_type_class_peek_parent(klass);
+    object_class = (GObjectClass *)klass;
+
+    object_class->finalize = config_model_finalize;
+}
+
+static void config_model_init(CtkConfigModel *config_model, gpointer g_class)
+{
+    config_model->stamp = g_random_int(); // random int to catch iterator type mismatches
+    config_model->records = NULL;
+    config_model->record_size = 0;
+    config_model->num_records = 0;
+    config_model->n_columns = 0;
+    config_model->format = NULL;
+}
+
+static void config_model_finalize(GObject *object)
+{
+    CtkConfigModel *config_model = CTK_CONFIG_MODEL(object);
+    free(config_model->records);
+    parent_class->finalize(object);
+}
+
+static void config_model_tree_model_init(GtkTreeModelIface *iface,
+                                         gpointer iface_data)
+{
+    iface->get_flags       = config_model_get_flags;
+    iface->get_n_columns   = config_model_get_n_columns;
+    iface->get_column_type = config_model_get_column_type;
+    iface->get_iter        = config_model_get_iter;
+    iface->get_path        = config_model_get_path;
+    iface->get_value       = config_model_get_value;
+    iface->iter_next       = config_model_iter_next;
+    iface->iter_children   = config_model_iter_children;
+    iface->iter_has_child  = config_model_iter_has_child;
+    iface->iter_n_children = config_model_iter_n_children;
+    iface->iter_nth_child  = config_model_iter_nth_child;
+    iface->iter_parent     = config_model_iter_parent;
+}
+
+static GtkTreeModelFlags config_model_get_flags(GtkTreeModel *tree_model)
+{
+    // Iterators only hold the row index, and rows never change
+    return GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+static gint config_model_get_n_columns(GtkTreeModel *tree_model)
+{
+    return CTK_CONFIG_MODEL(tree_model)->n_columns;
+}
+
+static GType config_model_get_column_type(GtkTreeModel *tree_model, gint index)
+{
+    assert(index >= 0 && index < CTK_CONFIG_MODEL(tree_model)->n_columns);
+    return G_TYPE_STRING;
+}
+
+static gboolean config_model_get_iter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path)
+{
+    CtkConfigModel *config_model;
+    gint depth, *indices;
+    intptr_t n;
+
+    assert(path);
+    config_model = CTK_CONFIG_MODEL(tree_model);
+
+    indices = gtk_tree_path_get_indices(path);
+    depth   = gtk_tree_path_get_depth(path);
+
+    assert(depth == 1);
+    (void)(depth);
+
+    n = indices[0];
+
+    if (n >= config_model->num_records || n < 0) {
+        return FALSE;
+    }
+
+    iter->stamp = config_model->stamp;
+
+    iter->user_data = (gpointer)n;
+    iter->user_data2 = NULL; // unused
+    iter->user_data3 = NULL; // unused
+
+    return TRUE;
+}
+
+static GtkTreePath *config_model_get_path(GtkTreeModel *tree_model, GtkTreeIter *iter)
+{
+    GtkTreePath *path;
+    intptr_t n;
+
+    g_return_val_if_fail(iter, NULL);
+
+    n = (intptr_t)iter->user_data;
+
+    path = gtk_tree_path_new();
+    gtk_tree_path_append_index(path, n);
+
+    return path;
+}
+
+static void config_model_get_value(GtkTreeModel *tree_model,
+                                   GtkTreeIter *iter,
+                                   gint column,
+                                   GValue *value)
+{
+    CtkConfigModel *config_model;
+    gconstpointer record;
+    gchar buf[CTK_CONFIG_MODEL_CELL_LEN];
+    gchar *str;
+    intptr_t n;
+
+    g_value_init(value, config_model_get_column_type(tree_model, column));
+    config_model = CTK_CONFIG_MODEL(tree_model);
+
+    n = (intptr_t)iter->user_data;
+    assert(n >= 0 && n < config_model->num_records);
+
+    record = (const gchar *)config_model->records +
+             n * config_model->record_size;
+
+    buf[0] = '\0';
+    str = config_model->format(record, n, column, buf);
+
+    if (str) {
+        g_value_set_string(value, str);
+        free(str);
+    } else {
+        g_value_set_string(value, buf);
+    }
+}
+
+static gboolean config_model_iter_next(GtkTreeModel *tree_model,
+                                       GtkTreeIter *iter)
+{
+    CtkConfigModel *config_model;
+    intptr_t n;
+
+    config_model = CTK_CONFIG_MODEL(tree_model);
+
+    if (!iter) {
+        return FALSE;
+    }
+
+    n = (intptr_t)iter->user_data;
+    n++;
+
+    if (n >= config_model->num_records) {
+        return FALSE;
+    }
+
+    iter->user_data = (gpointer)n;
+
+    return TRUE;
+}
+
+static gboolean config_model_iter_children(GtkTreeModel *tree_model,
+                                           GtkTreeIter *iter,
+                                           GtkTreeIter *parent)
+{
+    CtkConfigModel *config_model = CTK_CONFIG_MODEL(tree_model);
+
+    if (parent) {
+        return FALSE;
+    }
+
+    // (parent == NULL) => return first record
+
+    if (!config_model->num_records) {
+        return FALSE;
+    }
+
+    iter->stamp = config_model->stamp;
+    iter->user_data = (gpointer)0;
+    iter->user_data2 = NULL;
+    iter->user_data3 = NULL;
+
+    return TRUE;
+}
+
+static gboolean config_model_iter_has_child(GtkTreeModel *tree_model,
+                                            GtkTreeIter *iter)
+{
+    return FALSE;
+}
+
+static gint config_model_iter_n_children(GtkTreeModel *tree_model,
+                                         GtkTreeIter *iter)
+{
+    CtkConfigModel *config_model = CTK_CONFIG_MODEL(tree_model);
+
+    return iter ? 0 : config_model->num_records;
+}
+
+static gboolean
+config_model_iter_nth_child(GtkTreeModel *tree_model,
+                            GtkTreeIter  *iter,
+                            GtkTreeIter  *parent,
+                            gint         n)
+{
+    CtkConfigModel *config_model = CTK_CONFIG_MODEL(tree_model);
+
+    if (parent || (n < 0) || (n >= config_model->num_records)) {
+        return FALSE;
+    }
+
+    iter->stamp = config_model->stamp;
+    iter->user_data = (gpointer)(intptr_t)n;
+    iter->user_data2 = NULL;
+    iter->user_data3 = NULL;
+
+    return TRUE;
+}
+
+static gboolean
+config_model_iter_parent(GtkTreeModel *tree_model,
+                         GtkTreeIter *iter,
+                         GtkTreeIter *child)
+{
+    return FALSE;
+}
+
+/*
+ * ctk_config_model_new() - create a model presenting 'num_records' records
+ * of 'record_size' bytes each, with 'n_columns' string columns formatted by
+ * 'format'.  The model takes ownership of 'records', which must have been
+ * allocated with malloc().
+ */
+CtkConfigModel *ctk_config_model_new(gpointer records,
+                                     gsize record_size,
+                                     gint num_records,
+                                     gint n_columns,
+                                     CtkConfigModelFormatFunc format)
+{
+    CtkConfigModel *config_model;
+
+    assert(format);
+
+    config_model = CTK_CONFIG_MODEL(g_object_new(CTK_TYPE_CONFIG_MODEL, NULL));
+
+    config_model->records = records;
+    config_model->record_size = record_size;
+    config_model->num_records = records ? num_records : 0;
+    config_model->n_columns = n_columns;
+    config_model->format = format;
+
+    return config_model;
+}
+
+// Width added to the widest text of a column, for the cell and header padding
+#define FIXED_COLUMN_PADDING 16
+
+// Height added to the tallest cell, for the vertical padding of the cells
+#define FIXED_ROW_PADDING 4
+
+/*
+ * ctk_config_model_set_fixed_sizing() - switch 'view', whose model is
+ * 'config_model' and whose columns display the model columns in order, to
+ * fixed height mode.  Otherwise, the view measures every row of the model,
+ * and so formats every cell, when it is realized.
+ *
+ * The columns are given a fixed width, that of the widest of their title
+ * and of their cells in the first 'sample_rows' rows (or all the rows, if
+ * negative), and may be resized.  The rows all get the height of the
+ * tallest of these cells: 'sample_rows' must cover every row unless all the
+ * cells are one line high.
+ */
+void ctk_config_model_set_fixed_sizing(CtkConfigModel *config_model,
+                                       GtkTreeView *view,
+                                       gint sample_rows)
+{
+    PangoLayout *layout;
+    GList *columns, *l;
+    gint column, row, num_rows, width, height, max_width, max_height = 0;
+
+    layout = gtk_widget_create_pango_layout(GTK_WIDGET(view), NULL);
+    columns = gtk_tree_view_get_columns(view);
+
+    num_rows = config_model->num_records;
+    if (sample_rows >= 0) {
+        num_rows = MIN(num_rows, sample_rows);
+    }
+
+    for (l = columns, column = 0; l; l = l->next, column++) {
+        GtkTreeViewColumn *col = GTK_TREE_VIEW_COLUMN(l->data);
+        const gchar *title = gtk_tree_view_column_get_title(col);
+
+        pango_layout_set_text(layout, title ? title : "", -1);
+        pango_layout_get_pixel_size(layout, &max_width, &height);
+        max_height = MAX(max_height, height);
+
+        for (row = 0; row < num_rows && column < config_model->n_columns;
+             row++) {
+            gconstpointer record = (const gchar *)config_model->records +
+                                   row * config_model->record_size;
+            gchar buf[CTK_CONFIG_MODEL_CELL_LEN];
+            gchar *str;
+
+            buf[0] = '\0';
+            str = config_model->format(record, row, column, buf);
+
+            pango_layout_set_text(layout, str ? str : buf, -1);
+            pango_layout_get_pixel_size(layout, &width, &height);
+            max_width = MAX(max_width, width);
+            max_height = MAX(max_height, height);
+
+            free(str);
+        }
+
+        gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width(col,
+                                             max_width + FIXED_COLUMN_PADDING);
+        gtk_tree_view_column_set_resizable(col, TRUE);
+    }
+
+    // Fixed height mode takes the height of every row from the first one
+    for (l = columns; l; l = l->next) {
+#ifdef CTK_GTK3
+        GList *renderers =
+            gtk_cell_layout_get_cells(GTK_CELL_LAYOUT(l->data));
+#else
+        GList *renderers =
+            gtk_tree_view_column_get_cell_renderers(GTK_TREE_VIEW_COLUMN(l->data));
+#endif
+        GList *r;
+
+        for (r = renderers; r; r = r->next) {
+            gtk_cell_renderer_set_fixed_size(GTK_CELL_RENDERER(r->data), -1,
+                                             max_height + FIXED_ROW_PADDING);
+        }
+        g_list_free(renderers);
+    }
+
+    g_list_free(columns);
+    g_object_unref(layout);
+
+    gtk_tree_view_set_fixed_height_mode(view, TRUE);
+}
@@ -0,0 +1,94 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2013 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+// Read-only list model over an array of fixed size records (such as the
+// GLXFBConfigAttr and EGLConfigAttr tables), whose cells are all strings
+// formatted on demand by a callback.
+
+#ifndef __CTK_CONFIG_MODEL_H__
+#define __CTK_CONFIG_MODEL_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define CTK_TYPE_CONFIG_MODEL (ctk_config_model_get_type())
+
+#define CTK_CONFIG_MODEL(obj) \
+    (G_TYPE_CHECK_INSTANCE_CAST ((obj), CTK_TYPE_CONFIG_MODEL, CtkConfigModel))
+
+#define CTK_CONFIG_MODEL_CLASS(klass) \
+    (G_TYPE_CHECK_CLASS_CAST ((klass), CTK_TYPE_CONFIG_MODEL, CtkConfigModelClass))
+
+#define CTK_IS_CONFIG_MODEL(obj) \
+    (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CTK_TYPE_CONFIG_MODEL))
+
+#define CTK_IS_CONFIG_MODEL_CLASS(klass) \
+    (G_TYPE_CHECK_CLASS_TYPE ((klass), CTK_TYPE_CONFIG_MODEL))
+
+#define CTK_CONFIG_MODEL_GET_CLASS(obj) \
+    (G_TYPE_INSTANCE_GET_CLASS ((obj), CTK_TYPE_CONFIG_MODEL, CtkConfigModelClass))
+
+// Largest cell that CtkConfigModelFormatFunc may write, including the NUL
+#define CTK_CONFIG_MODEL_CELL_LEN 16
+
+// Formats the given column of the record at index 'row' into 'buf', which
+// holds CTK_CONFIG_MODEL_CELL_LEN bytes, and returns NULL.  Cells that do not
+// fit may instead be returned as a string allocated with malloc(), which the
+// model frees.
+typedef gchar *(*CtkConfigModelFormatFunc)(gconstpointer record,
+                                           gint row,
+                                           gint column,
+                                           gchar *buf);
+
+typedef struct _CtkConfigModel CtkConfigModel;
+typedef struct _CtkConfigModelClass CtkConfigModelClass;
+
+struct _CtkConfigModel
+{
+    GObject parent;
+    gint stamp;
+
+    // The records, owned by the model and released with free()
+    gpointer records;
+    gsize record_size;
+    gint num_records;
+
+    gint n_columns;
+    CtkConfigModelFormatFunc format;
+};
+
+struct _CtkConfigModelClass
+{
+    GObjectClass parent_class;
+};
+
+GType ctk_config_model_get_type (void) G_GNUC_CONST;
+CtkConfigModel *ctk_config_model_new (gpointer records,
+                                      gsize record_size,
+                                      gint num_records,
+                                      gint n_columns,
+                                      CtkConfigModelFormatFunc format);
+void ctk_config_model_set_fixed_sizing (CtkConfigModel *config_model,
+                                        GtkTreeView *view,
+                                        gint sample_rows);
+
+G_END_DECLS
+
+#endif
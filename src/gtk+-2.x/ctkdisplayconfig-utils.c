@@ -23,7 +23,6 @@
 #include <errno.h>
 
 #include <fcntl.h>
-#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <pwd.h>
@@ -58,47 +57,47 @@ static Bool screen_check_metamodes(nvScreenPtr screen);
  * given.
  *
  **/
-void apply_modeline_token(char *token, char *value, void *data)
+void apply_modeline_token(ParseSlice token, ParseSlice value, void *data)
 {
     nvModeLinePtr modeline = (nvModeLinePtr) data;
 
-    if (!modeline || !token || !strlen(token)) {
+    if (!modeline || !token.len) {
         return;
     }
 
     /* Modeline source */
-    if (!strcasecmp("source", token)) {
-        if (!value || !strlen(value)) {
+    if (parse_slice_strcasecmp(token, "source")) {
+        if (!value.len) {
             nv_warning_msg("Modeline 'source' token requires a value!");
-        } else if (!strcasecmp("xserver", value)) {
+        } else if (parse_slice_strcasecmp(value, "xserver")) {
             modeline->source |=  MODELINE_SOURCE_XSERVER;
-        } else if (!strcasecmp("xconfig", value)) {
+        } else if (parse_slice_strcasecmp(value, "xconfig")) {
             modeline->source |=  MODELINE_SOURCE_XCONFIG;
-        } else if (!strcasecmp("builtin", value)) {
+        } else if (parse_slice_strcasecmp(value, "builtin")) {
             modeline->source |=  MODELINE_SOURCE_BUILTIN;
-        } else if (!strcasecmp("vesa", value)) {
+        } else if (parse_slice_strcasecmp(value, "vesa")) {
             modeline->source |=  MODELINE_SOURCE_VESA;
-        } else if (!strcasecmp("edid", value)) {
+        } else if (parse_slice_strcasecmp(value, "edid")) {
             modeline->source |=  MODELINE_SOURCE_EDID;
-        } else if (!strcasecmp("nv-control", value)) {
+        } else if (parse_slice_strcasecmp(value, "nv-control")) {
             modeline->source |=  MODELINE_SOURCE_NVCONTROL;
         }
 
     /* X config name */
-    } else if (!strcasecmp("xconfig-name", token)) {
-        if (!value || !strlen(value)) {
+    } else if (parse_slice_strcasecmp(token, "xconfig-name")) {
+        if (!value.len) {
             nv_warning_msg("Modeline 'xconfig-name' token requires a value!");
         } else {
             if (modeline->xconfig_name) {
                 free(modeline->xconfig_name);
             }
-            modeline->xconfig_name = g_strdup(value);
+            modeline->xconfig_name = parse_slice_strdup(value);
         }
 
     /* Unknown token */
     } else {
-        nv_warning_msg("Unknown modeline token value pair: %s=%s",
-                       token, value);
+        nv_warning_msg("Unknown modeline token value pair: %.*s=%.*s",
+                       token.len, token.str, value.len, value.str);
     }
 
 } /* apply_modeline_token() */
@@ -111,42 +110,42 @@ void apply_modeline_token(char *token, char *value, void *data)
  * given.
  *
  **/
-void apply_metamode_token(char *token, char *value, void *data)
+void apply_metamode_token(ParseSlice token, ParseSlice value, void *data)
 {
     nvMetaModePtr metamode = (nvMetaModePtr) data;
 
-    if (!metamode || !token || !strlen(token)) {
+    if (!metamode || !token.len) {
         return;
     }
 
     /* Metamode ID */
-    if (!strcasecmp("id", token)) {
-        if (!value || !strlen(value)) {
+    if (parse_slice_strcasecmp(token, "id")) {
+        if (!value.len) {
             nv_warning_msg("MetaMode 'id' token requires a value!");
         } else {
-            metamode->id = atoi(value);
+            metamode->id = parse_slice_atoi(value);
         }
 
     /* Source */
-    } else if (!strcasecmp("source", token)) {
-        if (!value || !strlen(value)) {
+    } else if (parse_slice_strcasecmp(token, "source")) {
+        if (!value.len) {
             nv_warning_msg("MetaMode 'source' token requires a value!");
-        } else if (!strcasecmp("xconfig", value)) {
+        } else if (parse_slice_strcasecmp(value, "xconfig")) {
             metamode->source = METAMODE_SOURCE_XCONFIG;
-        } else if (!strcasecmp("implicit", value)) {
+        } else if (parse_slice_strcasecmp(value, "implicit")) {
             metamode->source = METAMODE_SOURCE_IMPLICIT;
-        } else if (!strcasecmp("nv-control", value)) {
+        } else if (parse_slice_strcasecmp(value, "nv-control")) {
             metamode->source = METAMODE_SOURCE_NVCONTROL;
-        } else if (!strcasecmp("randr", value)) {
+        } else if (parse_slice_strcasecmp(value, "randr")) {
             metamode->source = METAMODE_SOURCE_RANDR;
         }
 
     /* Switchable */
-    } else if (!strcasecmp("switchable", token)) {
-        if (!value || !strlen(value)) {
+    } else if (parse_slice_strcasecmp(token, "switchable")) {
+        if (!value.len) {
             nv_warning_msg("MetaMode 'switchable' token requires a value!");
         } else {
-            if (!strcasecmp(value, "yes")) {
+            if (parse_slice_strcasecmp(value, "yes")) {
                 metamode->switchable = TRUE;
             } else {
                 metamode->switchable = FALSE;
@@ -186,25 +185,25 @@ void apply_monitor_token(char *token, char *value, void *data)
  * position and width/height data.
  *
  **/
-void apply_screen_info_token(char *token, char *value, void *data)
+void apply_screen_info_token(ParseSlice token, ParseSlice value, void *data)
 {
     GdkRectangle *screen_info = (GdkRectangle *)data;
 
-    if (!screen_info || !token || !strlen(token)) {
+    if (!screen_info || !token.len) {
         return;
     }
 
-    if (!strcasecmp("x", token)) {
-        screen_info->x = atoi(value);
+    if (parse_slice_strcasecmp(token, "x")) {
+        screen_info->x = parse_slice_atoi(value);
 
-    } else if (!strcasecmp("y", token)) {
-        screen_info->y = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "y")) {
+        screen_info->y = parse_slice_atoi(value);
 
-    } else if (!strcasecmp("width", token)) {
-        screen_info->width = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "width")) {
+        screen_info->width = parse_slice_atoi(value);
 
-    } else if (!strcasecmp("height", token)) {
-        screen_info->height = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "height")) {
+        screen_info->height = parse_slice_atoi(value);
     }
 }
 
@@ -249,8 +248,8 @@ static nvModeLinePtr modeline_parse(nvDisplayPtr display,
         tokens = strdup(str);
         tokens[ tmp-str ] = '\0';
         str = tmp +2;
-        parse_token_value_pairs(tokens, apply_modeline_token,
-                                (void *)modeline);
+        parse_token_value_slices(tokens, apply_modeline_token,
+                                 (void *)modeline);
         free(tokens);
     }
 
@@ -725,13 +724,7 @@ nvModePtr mode_parse(nvDisplayPtr display, const char *mode_str)
 
 
     /* Find the display's modeline that matches the given mode name */
-    modeline = display->modelines;
-    while (modeline) {
-        if (!strcmp(mode_name, modeline->data.identifier)) {
-            break;
-        }
-        modeline = modeline->next;
-    }
+    modeline = display_find_modeline_by_name(display, mode_name);
 
     /* If we can't find a matching modeline, set the NULL mode. */
     if (!modeline) {
@@ -1408,6 +1401,61 @@ void modeline_free(nvModeLinePtr m)
 
 
 
+/** hash_string_nocase() *********************************
+ *
+ * Helper function that folds the string 'str' into 'hash', ignoring
+ * case.
+ *
+ **/
+static unsigned int hash_string_nocase(unsigned int hash, const char *str)
+{
+    for (; str && *str; str++) {
+        hash = (hash * 31) + g_ascii_tolower(*str);
+    }
+    return hash;
+}
+
+
+
+/** modeline_name_hash() *********************************
+ *
+ * Helper function that hashes a modeline name.  Names are compared
+ * ignoring case, so they are hashed in lower case.
+ *
+ **/
+static unsigned int modeline_name_hash(const char *name)
+{
+    return hash_string_nocase(5381, name);
+}
+
+
+
+/** modeline_timings_hash() ******************************
+ *
+ * Helper function that hashes the fields of a modeline compared by
+ * modelines_match().  The clock is compared ignoring case, so it is
+ * hashed in lower case.
+ *
+ **/
+static unsigned int modeline_timings_hash(const nvModeLinePtr m)
+{
+    const int fields[] = {
+        m->data.hdisplay, m->data.hsyncstart, m->data.hsyncend,
+        m->data.htotal, m->data.vdisplay, m->data.vsyncstart,
+        m->data.vsyncend, m->data.vtotal, m->data.vscan,
+        m->data.flags, m->data.hskew,
+    };
+    unsigned int hash = modeline_name_hash(m->data.identifier);
+    int i;
+
+    for (i = 0; i < (int)ARRAY_LEN(fields); i++) {
+        hash = (hash * 31) + fields[i];
+    }
+    return hash_string_nocase(hash, m->data.clock);
+}
+
+
+
 /** modelines_match() *************************************
  *
  * Helper function that returns True or False based on whether
@@ -1484,10 +1532,17 @@ Bool viewports_out_match(const GdkRectangle viewPortOut1,
 Bool display_has_modeline(nvDisplayPtr display,
                           nvModeLinePtr modeline)
 {
-    nvModeLinePtr m;
+    const nvModeLineIndex *index = &display->modeline_index;
+    int i;
 
-    for (m = display->modelines; m; m = m->next) {
-         if (modelines_match(m, modeline)) {
+    if (!modeline || !index->num_buckets) {
+        return FALSE;
+    }
+
+    i = index->timings_buckets[modeline_timings_hash(modeline) %
+                               index->num_buckets];
+    for (; i; i = index->timings_next[i - 1]) {
+        if (modelines_match(index->modelines[i - 1], modeline)) {
             return TRUE;
         }
     }
@@ -1498,6 +1553,161 @@ Bool display_has_modeline(nvDisplayPtr display,
 
 
 
+/** display_find_modeline_by_name() **********************************
+ *
+ * Returns the first of the display's modelines with the given name
+ * (identifier), or NULL if there is none.
+ *
+ **/
+nvModeLinePtr display_find_modeline_by_name(nvDisplayPtr display,
+                                            const char *name)
+{
+    const nvModeLineIndex *index = &display->modeline_index;
+    int i;
+
+    if (!name || !index->num_buckets) {
+        return NULL;
+    }
+
+    i = index->name_buckets[modeline_name_hash(name) % index->num_buckets];
+    for (; i; i = index->name_next[i - 1]) {
+        nvModeLinePtr m = index->modelines[i - 1];
+
+        if (m->data.identifier && !strcmp(name, m->data.identifier)) {
+            return m;
+        }
+    }
+
+    return NULL;
+
+} /* display_find_modeline_by_name() */
+
+
+
+/** display_get_modelines_by_resolution() ****************************
+ *
+ * Points 'modelines' to the display's modelines of the given
+ * resolution, in list order, and returns how many there are.
+ *
+ **/
+int display_get_modelines_by_resolution(nvDisplayPtr display,
+                                        int width, int height,
+                                        nvModeLinePtr **modelines)
+{
+    const nvModeLineIndex *index = &display->modeline_index;
+    int lo = 0, hi = index->num_modelines;
+    int first;
+
+    /* Find the first modeline of the resolution */
+    while (lo < hi) {
+        const nvModeLinePtr m = index->by_resolution[(lo + hi) / 2];
+
+        if (m->data.hdisplay < width ||
+            (m->data.hdisplay == width && m->data.vdisplay < height)) {
+            lo = (lo + hi) / 2 + 1;
+        } else {
+            hi = (lo + hi) / 2;
+        }
+    }
+    first = lo;
+
+    while (lo < index->num_modelines &&
+           index->by_resolution[lo]->data.hdisplay == width &&
+           index->by_resolution[lo]->data.vdisplay == height) {
+        lo++;
+    }
+
+    *modelines = index->by_resolution + first;
+    return lo - first;
+
+} /* display_get_modelines_by_resolution() */
+
+
+
+/** display_index_modelines() ****************************************
+ *
+ * Builds the lookup tables over the display's modelines.  Modelines
+ * are only added and removed as a whole, so the tables are built once
+ * all of them are loaded.
+ *
+ **/
+typedef struct {
+    nvModeLinePtr modeline;
+    int order;
+} ModeLineOrder;
+
+static int modeline_order_compare(const void *a, const void *b)
+{
+    const ModeLineOrder *m1 = a;
+    const ModeLineOrder *m2 = b;
+
+    if (m1->modeline->data.hdisplay != m2->modeline->data.hdisplay) {
+        return m1->modeline->data.hdisplay - m2->modeline->data.hdisplay;
+    }
+    if (m1->modeline->data.vdisplay != m2->modeline->data.vdisplay) {
+        return m1->modeline->data.vdisplay - m2->modeline->data.vdisplay;
+    }
+    return m1->order - m2->order;
+}
+
+static void display_index_modelines(nvDisplayPtr display)
+{
+    nvModeLineIndex *index = &display->modeline_index;
+    ModeLineOrder *order;
+    nvModeLinePtr m;
+    int i;
+
+    index->num_modelines = display->num_modelines;
+    if (!index->num_modelines) {
+        return;
+    }
+
+    index->modelines =
+        nvalloc(index->num_modelines * sizeof(nvModeLinePtr));
+    index->by_resolution =
+        nvalloc(index->num_modelines * sizeof(nvModeLinePtr));
+    order = nvalloc(index->num_modelines * sizeof(ModeLineOrder));
+
+    index->num_buckets = index->num_modelines * 2;
+    index->timings_buckets = nvalloc(index->num_buckets * sizeof(int));
+    index->name_buckets = nvalloc(index->num_buckets * sizeof(int));
+    index->timings_next = nvalloc(index->num_modelines * sizeof(int));
+    index->name_next = nvalloc(index->num_modelines * sizeof(int));
+
+    /* Insert in reverse list order, so that buckets are in list order */
+    for (i = 0, m = display->modelines; m; i++, m = m->next) {
+        index->modelines[i] = m;
+        order[i].modeline = m;
+        order[i].order = i;
+    }
+
+    for (i = index->num_modelines - 1; i >= 0; i--) {
+        unsigned int bucket;
+
+        m = index->modelines[i];
+
+        bucket = modeline_timings_hash(m) % index->num_buckets;
+        index->timings_next[i] = index->timings_buckets[bucket];
+        index->timings_buckets[bucket] = i + 1;
+
+        bucket = modeline_name_hash(m->data.identifier) % index->num_buckets;
+        index->name_next[i] = index->name_buckets[bucket];
+        index->name_buckets[bucket] = i + 1;
+    }
+
+    qsort(order, index->num_modelines, sizeof(ModeLineOrder),
+          modeline_order_compare);
+
+    for (i = 0; i < index->num_modelines; i++) {
+        index->by_resolution[i] = order[i].modeline;
+    }
+
+    free(order);
+
+} /* display_index_modelines() */
+
+
+
 /** display_remove_modelines() ***************************************
  *
  * Clears the display device's modeline list.
@@ -1505,9 +1715,19 @@ Bool display_has_modeline(nvDisplayPtr display,
  **/
 static void display_remove_modelines(nvDisplayPtr display)
 {
+    nvModeLineIndex *index;
     nvModeLinePtr modeline;
 
     if (display) {
+        index = &display->modeline_index;
+        free(index->modelines);
+        free(index->by_resolution);
+        free(index->timings_buckets);
+        free(index->timings_next);
+        free(index->name_buckets);
+        free(index->name_next);
+        memset(index, 0, sizeof(*index));
+
         while (display->modelines) {
             modeline = display->modelines;
             display->modelines = display->modelines->next;
@@ -1528,7 +1748,7 @@ static void display_remove_modelines(nvDisplayPtr display)
 Bool display_add_modelines_from_server(nvDisplayPtr display, nvGpuPtr gpu,
                                        gchar **err_str)
 {
-    nvModeLinePtr modeline;
+    nvModeLinePtr modeline, last = NULL;
     char *modeline_strs = NULL;
     char *str;
     int len;
@@ -1594,8 +1814,12 @@ Bool display_add_modelines_from_server(nvDisplayPtr display, nvGpuPtr gpu,
         }
 
         /* Add the modeline at the end of the display's modeline list */
-        xconfigAddListItem((GenericListPtr *)(&display->modelines),
-                           (GenericListPtr)modeline);
+        if (last) {
+            last->next = modeline;
+        } else {
+            display->modelines = modeline;
+        }
+        last = modeline;
         display->num_modelines++;
 
         /* Get next modeline string */
@@ -1603,6 +1827,9 @@ Bool display_add_modelines_from_server(nvDisplayPtr display, nvGpuPtr gpu,
     }
 
     free(modeline_strs);
+
+    display_index_modelines(display);
+
     return TRUE;
 
 
@@ -2160,7 +2387,8 @@ static Bool screen_add_metamode(nvScreenPtr screen, const char *metamode_str,
         if (!tokens) goto fail;
 
         tokens[tokens_end-metamode_str] = '\0';
-        parse_token_value_pairs(tokens, apply_metamode_token, (void *)metamode);
+        parse_token_value_slices(tokens, apply_metamode_token,
+                                 (void *)metamode);
 
         free(tokens);
         metamode_modes = tokens_end + 2;
@@ -3697,8 +3925,8 @@ static Bool layout_add_screen_from_server(nvLayoutPtr layout,
         screen_parsed_info.width = -1;
         screen_parsed_info.height = -1;
 
-        parse_token_value_pairs(screen_info, apply_screen_info_token,
-                                &screen_parsed_info);
+        parse_token_value_slices(screen_info, apply_screen_info_token,
+                                 &screen_parsed_info);
 
         if (screen_parsed_info.width >= 0 &&
             screen_parsed_info.height >= 0) {
@@ -4201,10 +4429,12 @@ static void update_xconfig_save_buffer(SaveXConfDlg *dlg)
     XConfigPtr xconfGen = NULL;
     XConfigError xconfErr;
 
-    char *tmp_filename = NULL;
-    int tmp_fd;
     struct stat st;
-    void *buf;
+    gchar *contents = NULL;
+    gsize contents_len;
+    char *buf = NULL;
+    size_t buf_len;
+    FILE *stream;
     GtkTextIter buf_start, buf_end;
 
     gboolean merge;
@@ -4232,7 +4462,6 @@ static void update_xconfig_save_buffer(SaveXConfDlg *dlg)
     if (filename && (stat(filename, &st) == 0)) {
         const char *non_regular_file_type_description =
             get_non_regular_file_type_description(st.st_mode);
-        const char *test_filename;
 
         /* Make sure this is a regular file */
         if (non_regular_file_type_description) {
@@ -4247,17 +4476,14 @@ static void update_xconfig_save_buffer(SaveXConfDlg *dlg)
             goto fail;
         }
 
-        /* Must be able to open the file */
-        test_filename = xconfigOpenConfigFile(filename, NULL);
-        if (!test_filename || strcmp(test_filename, filename)) {
-            xconfigCloseConfigFile();
-
-        } else {
+        /* Must be able to read the file */
+        if (g_file_get_contents(filename, &contents, &contents_len, NULL)) {
             GenerateOptions gop;
 
             /* Must be able to parse the file as an X config file */
-            xconfErr = xconfigReadConfigFile(&xconfCur);
-            xconfigCloseConfigFile();
+            xconfErr = xconfigReadConfigBuffer(contents, contents_len,
+                                               filename, &xconfCur);
+            g_free(contents);
             if ((xconfErr != XCONFIG_RETURN_SUCCESS) || !xconfCur) {
                 /* If we failed to parse the config file, we should not
                  * allow a merge.
@@ -4350,35 +4576,19 @@ static void update_xconfig_save_buffer(SaveXConfDlg *dlg)
     update_banner(xconfGen);
 
 
-    /* Setup the X config file preview buffer by writing to a temp file */
-    tmp_filename = g_strdup_printf("/tmp/.xconfig.tmp.XXXXXX");
-    tmp_fd = mkstemp(tmp_filename);
-    if (!tmp_fd) {
-        err_msg = g_strdup_printf("Failed to create temp X config file '%s' "
-                                  "for preview.",
-                                  tmp_filename);
+    /* Setup the X config file preview buffer by writing to memory */
+    stream = open_memstream(&buf, &buf_len);
+    if (!stream) {
+        err_msg = g_strdup_printf("Failed to create X config file preview "
+                                  "(%s).", strerror(errno));
         goto fail;
     }
-    xconfigWriteConfigFile(tmp_filename, xconfGen);
+    xconfigWriteConfigStream(stream, xconfGen);
     xconfigFreeConfig(&xconfGen);
 
-    if (lseek(tmp_fd, 0, SEEK_SET) == (off_t)-1) {
-        err_msg = g_strdup_printf("Failed lseek() on temp X config file '%s' "
-                                  "for preview.",
-                                  tmp_filename);
-        goto fail;
-    }
-    if (fstat(tmp_fd, &st) == -1) {
-        err_msg = g_strdup_printf("Failed fstat() on temp X config file '%s' "
-                                  "for preview.",
-                                  tmp_filename);
-        goto fail;
-    }
-    buf = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, tmp_fd, 0);
-    if (buf == MAP_FAILED) {
-        err_msg = g_strdup_printf("Failed mmap() on temp X config file '%s' "
-                                  "for preview.",
-                                  tmp_filename);
+    if (fclose(stream) != 0) {
+        err_msg = g_strdup_printf("Failed to create X config file preview "
+                                  "(%s).", strerror(errno));
         goto fail;
     }
 
@@ -4392,11 +4602,8 @@ static void update_xconfig_save_buffer(SaveXConfDlg *dlg)
 
     /* Set the new GTK buffer contents */
     gtk_text_buffer_set_text(GTK_TEXT_BUFFER(dlg->buf_xconfig_save),
-                             buf, st.st_size);
-    munmap(buf, st.st_size);
-    close(tmp_fd);
-    remove(tmp_filename);
-    g_free(tmp_filename);
+                             buf, buf_len);
+    free(buf);
 
     return;
 
@@ -4424,7 +4631,7 @@ static void update_xconfig_save_buffer(SaveXConfDlg *dlg)
         xconfigFreeConfig(&xconfCur);
     }
 
-    g_free(tmp_filename);
+    free(buf);
 
     return;
 
@@ -23,6 +23,7 @@
 #include <gtk/gtk.h>
 
 #include "XF86Config-parser/xf86Parser.h"
+#include "parse.h"
 
 #include "ctkdisplaylayout.h"
 
@@ -33,10 +34,11 @@ G_BEGIN_DECLS
 
 /* Token parsing handlers */
 
-void apply_modeline_token(char *token, char *value, void *data);
-void apply_metamode_token(char *token, char *value, void *data);
+void apply_modeline_token(ParseSlice token, ParseSlice value, void *data);
+void apply_metamode_token(ParseSlice token, ParseSlice value, void *data);
 void apply_monitor_token(char *token, char *value, void *data);
-void apply_screen_info_token(char *token, char *value, void *data);
+void apply_screen_info_token(ParseSlice token, ParseSlice value,
+                             void *data);
 
 
 /* Mode functions */
@@ -79,6 +81,11 @@ Bool viewports_out_match(const GdkRectangle viewPortOut1,
 int display_find_closest_mode_matching_modeline(nvDisplayPtr display,
                                                 nvModeLinePtr modeline);
 Bool display_has_modeline(nvDisplayPtr display, nvModeLinePtr modeline);
+nvModeLinePtr display_find_modeline_by_name(nvDisplayPtr display,
+                                            const char *name);
+int display_get_modelines_by_resolution(nvDisplayPtr display,
+                                        int width, int height,
+                                        nvModeLinePtr **modelines);
 Bool display_add_modelines_from_server(nvDisplayPtr display, nvGpuPtr gpu,
                                        gchar **err_str);
 void display_remove_modes(nvDisplayPtr display);
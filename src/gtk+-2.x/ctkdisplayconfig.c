@@ -813,8 +813,8 @@ static void assign_screen_positions(CtkDisplayConfig *ctk_object)
             screen_parsed_info.width = -1;
             screen_parsed_info.height = -1;
 
-            parse_token_value_pairs(screen_info, apply_screen_info_token,
-                                    &screen_parsed_info);
+            parse_token_value_slices(screen_info, apply_screen_info_token,
+                                     &screen_parsed_info);
 
             if (screen_parsed_info.x >= 0 &&
                 screen_parsed_info.y >= 0 &&
@@ -3217,8 +3217,9 @@ static void setup_display_refresh_dropdown(CtkDisplayConfig *ctk_object)
     GtkWidget *combo_box = ctk_object->mnu_display_refresh;
     nvModeLinePtr modeline;
     nvModeLinePtr auto_modeline;
-    nvModeLinePtr modelines;
+    nvModeLinePtr *modelines;
     nvModeLinePtr cur_modeline;
+    int num_modelines, i, j;
     float cur_rate; /* Refresh Rate */
     int cur_idx = 0; /* Currently selected modeline */
 
@@ -3235,10 +3236,16 @@ static void setup_display_refresh_dropdown(CtkDisplayConfig *ctk_object)
         !display->cur_mode->modeline) {
         goto fail;
     }
-    modelines    = display->modelines;
     cur_modeline = display->cur_mode->modeline;
     cur_rate     = cur_modeline->refresh_rate;
 
+    /* Only modelines of the current resolution are listed */
+    num_modelines =
+        display_get_modelines_by_resolution(display,
+                                            cur_modeline->data.hdisplay,
+                                            cur_modeline->data.vdisplay,
+                                            &modelines);
+
 
     /* Create the menu index -> modeline pointer lookup table */
     if (ctk_object->refresh_table) {
@@ -3265,22 +3272,18 @@ static void setup_display_refresh_dropdown(CtkDisplayConfig *ctk_object)
         ctk_combo_box_text_append_text(combo_box, "Auto");
         ctk_object->refresh_table[ctk_object->refresh_table_len++] =
             cur_modeline;
-        modelines = NULL; /* Skip building rest of refresh dropdown */
+        num_modelines = 0; /* Skip building rest of refresh dropdown */
     }
 
     /* Generate the refresh rate dropdown from the modelines list */
     auto_modeline = NULL;
-    for (modeline = modelines; modeline; modeline = modeline->next) {
+    for (i = 0; i < num_modelines; i++) {
 
         nvModeLinePtr m;
         int count_ref; /* # modelines with similar refresh rates */ 
         int num_ref;   /* Modeline # in a group of similar refresh rates */
 
-        /* Ignore modelines of different resolution */
-        if (modeline->data.hdisplay != cur_modeline->data.hdisplay ||
-            modeline->data.vdisplay != cur_modeline->data.vdisplay) {
-            continue;
-        }
+        modeline = modelines[i];
 
         /* Ignore special modes */
         if (IS_NVIDIA_DEFAULT_MODE(modeline)) {
@@ -3293,13 +3296,15 @@ static void setup_display_refresh_dropdown(CtkDisplayConfig *ctk_object)
         /* Get a unique number for this modeline */
         count_ref = 0; /* # modelines with similar refresh rates */
         num_ref = 0;   /* Modeline # in a group of similar refresh rates */
-        for (m = modelines; m; m = m->next) {
-            float m_rate = m->refresh_rate;
-            gchar *tmp = g_strdup_printf("%.0f Hz", m_rate);
+        for (j = 0; j < num_modelines; j++) {
+            float m_rate;
+            gchar *tmp;
+
+            m = modelines[j];
+            m_rate = m->refresh_rate;
+            tmp = g_strdup_printf("%.0f Hz", m_rate);
             
             if (!IS_NVIDIA_DEFAULT_MODE(m) &&
-                m->data.hdisplay == modeline->data.hdisplay &&
-                m->data.vdisplay == modeline->data.vdisplay &&
                 !g_ascii_strcasecmp(tmp, name) &&
                 m != auto_modeline) {
 
@@ -3384,23 +3389,13 @@ static void setup_display_refresh_dropdown(CtkDisplayConfig *ctk_object)
         /* Find a close match  to the selected modeline */
         } else if (ctk_object->refresh_table_len &&
                    ctk_object->refresh_table[cur_idx] != cur_modeline) {
-            
-            /* Found a better resolution */
-            if (modeline->data.hdisplay == cur_modeline->data.hdisplay &&
-                modeline->data.vdisplay == cur_modeline->data.vdisplay) {
-                
-                float prev_rate = ctk_object->refresh_table[cur_idx]->refresh_rate;
-                float rate = modeline->refresh_rate;
-                
-                if (ctk_object->refresh_table[cur_idx]->data.hdisplay != cur_modeline->data.hdisplay ||
-                    ctk_object->refresh_table[cur_idx]->data.vdisplay != cur_modeline->data.vdisplay) {
-                    cur_idx = ctk_object->refresh_table_len;
-                }
-                
-                /* Found a better refresh rate */
-                if (rate == cur_rate && prev_rate != cur_rate) {
-                    cur_idx = ctk_object->refresh_table_len;
-                }
+
+            float prev_rate = ctk_object->refresh_table[cur_idx]->refresh_rate;
+            float rate = modeline->refresh_rate;
+
+            /* Found a better refresh rate */
+            if (rate == cur_rate && prev_rate != cur_rate) {
+                cur_idx = ctk_object->refresh_table_len;
             }
         }
 
@@ -8125,8 +8120,8 @@ static Bool add_cpl_metamode_to_X(nvScreenPtr screen, nvMetaModePtr metamode,
         return FALSE;
     }
 
-    parse_token_value_pairs(tokens, apply_metamode_token,
-                            metamode);
+    parse_token_value_slices(tokens, apply_metamode_token,
+                             metamode);
     free(tokens);
 
     metamode->x_idx = metamode_idx;
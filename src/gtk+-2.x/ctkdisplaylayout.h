@@ -170,6 +170,26 @@ typedef struct nvModeLineRec {
 
 
 
+/* Lookup tables over a display's modelines, built once they are loaded */
+typedef struct nvModeLineIndexRec {
+    nvModeLinePtr *modelines;     /* Modelines, in list order */
+    nvModeLinePtr *by_resolution; /* Sorted by resolution, then list order */
+    int num_modelines;
+
+    /* Hash tables: per bucket, the index + 1 of the first modeline in
+     * it (0 if none); per modeline, the index + 1 of the next one in
+     * its bucket.
+     */
+    int num_buckets;
+    int *timings_buckets;         /* By timings, as modelines_match() */
+    int *timings_next;
+    int *name_buckets;            /* By identifier */
+    int *name_next;
+
+} nvModeLineIndex;
+
+
+
 typedef struct nvSelectedModeRec {
     struct nvSelectedModeRec *next;
 
@@ -256,6 +276,7 @@ typedef struct nvDisplayRec {
 
     nvModeLinePtr       modelines;      /* Modelines validated by X */
     int                 num_modelines;
+    nvModeLineIndex     modeline_index; /* Lookups into modelines */
 
     nvSelectedModePtr   selected_modes; /* List of modes to show in the dropdown menu */
     int                 num_selected_modes;
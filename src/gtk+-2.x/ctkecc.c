@@ -504,6 +504,26 @@ static void ecc_set_config_status(CtkEcc *ctk_ecc)
 
 
 
+/*
+ * ecc_errors_update_received() - this function is called when the volatile
+ * ECC error counts change, if the event source reports such changes.
+ */
+
+static void ecc_errors_update_received(GObject *object,
+                                       CtrlEvent *event,
+                                       gpointer user_data)
+{
+    CtkEcc *ctk_ecc = CTK_ECC(user_data);
+
+    if (event->type != CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE) {
+        return;
+    }
+
+    update_ecc_info(ctk_ecc);
+}
+
+
+
 /*
  * ecc_configuration_update_received() - this function is called when the
  * NV_CTRL_GPU_ECC_CONFIGURATION attribute is changed by another
@@ -1094,6 +1114,14 @@ GtkWidget* ctk_ecc_new(CtrlTarget *ctrl_target,
                      CTK_EVENT_NAME(NV_CTRL_GPU_ECC_CONFIGURATION),
                      G_CALLBACK(ecc_configuration_update_received),
                      (gpointer) ctk_ecc);
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_GPU_ECC_SINGLE_BIT_ERRORS),
+                     G_CALLBACK(ecc_errors_update_received),
+                     (gpointer) ctk_ecc);
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_GPU_ECC_DOUBLE_BIT_ERRORS),
+                     G_CALLBACK(ecc_errors_update_received),
+                     (gpointer) ctk_ecc);
     gtk_widget_set_sensitive(ctk_ecc->configuration_status, ecc_config_supported);
 
     hbox = gtk_hbox_new(FALSE, 0);
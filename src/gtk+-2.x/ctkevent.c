@@ -49,18 +49,26 @@ static gboolean ctk_event_dispatch(GSource *, GSourceFunc, gpointer);
 /* List of who to contact on dpy events */
 typedef struct __CtkEventNodeRec {
     CtkEvent *ctk_event;
-    int target_type;
-    int target_id;
     struct __CtkEventNodeRec *next;
 } CtkEventNode;
 
+/*
+ * The CtkEvent objects of an event source, grouped by target: an event
+ * is only delivered to the objects registered for its target type/id.
+ */
+typedef struct __CtkEventTargetRec {
+    int target_type;
+    int target_id;
+    CtkEventNode *ctk_events;
+} CtkEventTarget;
+
 /* dpys should have a single event source object */
 typedef struct __CtkEventSourceRec {
     GSource source;
     NvCtrlEventHandle *event_handle;
     GPollFD event_poll_fd;
 
-    CtkEventNode *ctk_events;
+    GHashTable *targets; /* CtkEventTarget, keyed by target type/id */
     struct __CtkEventSourceRec *next;
 } CtkEventSource;
 
@@ -72,6 +80,20 @@ static guint signal_RRScreenChangeNotify;
 /* List of event sources to track (one per dpy) */
 CtkEventSource *event_sources = NULL;
 
+/*
+ * Each dispatch of an event source handles at most this many events (after
+ * collapsing redundant updates), and stops reading new events once this
+ * much time has passed, so that bursts of events do not starve user input.
+ */
+#define CTK_EVENT_BATCH_MAX_EVENTS 256
+#define CTK_EVENT_BATCH_INDEX_SLOTS 512 /* power of 2, > max events */
+#define CTK_EVENT_BATCH_BUDGET_US 8000
+
+/* Event dispatch statistics, see ctk_event_get_stats() */
+static CtkEventStats event_stats;
+static gint64 rate_window_start;
+static guint64 rate_window_events;
+
 
 
 GType ctk_event_get_type(void)
@@ -222,7 +244,11 @@ static void ctk_event_class_init(CtkEventClass *ctk_event_class,
     MAKE_SIGNAL(NV_CTRL_THERMAL_COOLER_CONTROL_TYPE);
     MAKE_SIGNAL(NV_CTRL_THERMAL_COOLER_TARGET);
     MAKE_SIGNAL(NV_CTRL_GPU_ECC_CONFIGURATION);
+    MAKE_SIGNAL(NV_CTRL_GPU_ECC_SINGLE_BIT_ERRORS);
+    MAKE_SIGNAL(NV_CTRL_GPU_ECC_DOUBLE_BIT_ERRORS);
     MAKE_SIGNAL(NV_CTRL_GPU_POWER_MIZER_MODE);
+    MAKE_SIGNAL(NV_CTRL_GPU_POWER_SOURCE);
+    MAKE_SIGNAL(NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL);
     MAKE_SIGNAL(NV_CTRL_OVERSCAN_COMPENSATION);
     MAKE_SIGNAL(NV_CTRL_GPU_PCIE_GENERATION);
     MAKE_SIGNAL(NV_CTRL_ACCELERATE_TRAPEZOIDS);
@@ -419,6 +445,36 @@ static CtkEventSource* find_event_source(NvCtrlEventHandle *event_handle)
 
 
 
+static guint event_target_hash(gconstpointer key)
+{
+    const CtkEventTarget *target = key;
+
+    return ((guint) target->target_type * 16777619u) ^
+        (guint) target->target_id;
+}
+
+static gboolean event_target_equal(gconstpointer a, gconstpointer b)
+{
+    const CtkEventTarget *target_a = a;
+    const CtkEventTarget *target_b = b;
+
+    return ((target_a->target_type == target_b->target_type) &&
+            (target_a->target_id == target_b->target_id));
+}
+
+static CtkEventTarget *find_event_target(CtkEventSource *event_source,
+                                         int target_type, int target_id)
+{
+    CtkEventTarget key;
+
+    key.target_type = target_type;
+    key.target_id = target_id;
+
+    return g_hash_table_lookup(event_source->targets, &key);
+}
+
+
+
 /* - ctk_event_register_source()
  *
  * Keep track of event sources globally to support
@@ -436,6 +492,7 @@ static void ctk_event_register_source(CtkEvent *ctk_event)
     CtrlTarget *ctrl_target = ctk_event->ctrl_target;
     NvCtrlEventHandle *event_handle = NvCtrlGetEventHandle(ctrl_target);
     CtkEventSource *event_source;
+    CtkEventTarget *event_target;
     CtkEventNode *event_node;
 
     if (!event_handle) {
@@ -469,6 +526,9 @@ static void ctk_event_register_source(CtkEvent *ctk_event)
         event_source->event_handle = event_handle;
         event_source->event_poll_fd.fd = event_fd;
         event_source->event_poll_fd.events = G_IO_IN;
+        event_source->targets = g_hash_table_new_full(event_target_hash,
+                                                      event_target_equal,
+                                                      NULL, g_free);
         
         /* add the input source to the glib main loop */
         
@@ -482,17 +542,26 @@ static void ctk_event_register_source(CtkEvent *ctk_event)
     }
 
 
-    /* Add the ctk_event object to the source's list of event objects */
+    /* Find or add the entry for the ctk_event object's target */
 
-    event_node = (CtkEventNode *)g_malloc(sizeof(CtkEventNode));
-    if (!event_node) {
-        return;
+    event_target = find_event_target(event_source,
+                                     NvCtrlGetTargetType(ctrl_target),
+                                     NvCtrlGetTargetId(ctrl_target));
+    if (!event_target) {
+        event_target = (CtkEventTarget *)g_malloc(sizeof(CtkEventTarget));
+        event_target->target_type = NvCtrlGetTargetType(ctrl_target);
+        event_target->target_id = NvCtrlGetTargetId(ctrl_target);
+        event_target->ctk_events = NULL;
+        g_hash_table_insert(event_source->targets, event_target,
+                            event_target);
     }
+
+    /* Add the ctk_event object to the target's list of event objects */
+
+    event_node = (CtkEventNode *)g_malloc(sizeof(CtkEventNode));
     event_node->ctk_event = ctk_event;
-    event_node->target_type = NvCtrlGetTargetType(ctrl_target);
-    event_node->target_id = NvCtrlGetTargetId(ctrl_target);
-    event_node->next = event_source->ctk_events;
-    event_source->ctk_events = event_node;
+    event_node->next = event_target->ctk_events;
+    event_target->ctk_events = event_node;
 
 } /* ctk_event_register_source() */
 
@@ -508,6 +577,7 @@ static void ctk_event_unregister_source(CtkEvent *ctk_event)
     CtrlTarget *ctrl_target = ctk_event->ctrl_target;
     NvCtrlEventHandle *event_handle = NvCtrlGetEventHandle(ctrl_target);
     CtkEventSource *event_source;
+    CtkEventTarget *event_target;
     CtkEventNode *event_node;
 
     if (!event_handle) {
@@ -522,11 +592,19 @@ static void ctk_event_unregister_source(CtkEvent *ctk_event)
     }
 
 
-    /* Remove the ctk_event object from the source's list of event objects */
+    event_target = find_event_target(event_source,
+                                     NvCtrlGetTargetType(ctrl_target),
+                                     NvCtrlGetTargetId(ctrl_target));
+    if (!event_target) {
+        return;
+    }
+
+
+    /* Remove the ctk_event object from the target's list of event objects */
 
-    event_node = event_source->ctk_events;
+    event_node = event_target->ctk_events;
     if (event_node->ctk_event == ctk_event) {
-        event_source->ctk_events = event_node->next;
+        event_target->ctk_events = event_node->next;
     }
     else {
         CtkEventNode *prev = event_node;
@@ -547,10 +625,14 @@ static void ctk_event_unregister_source(CtkEvent *ctk_event)
 
     g_free(event_node);
 
+    if (event_target->ctk_events == NULL) {
+        g_hash_table_remove(event_source->targets, event_target);
+    }
+
 
     /* destroy the event source if empty */
 
-    if (event_source->ctk_events == NULL) {
+    if (g_hash_table_size(event_source->targets) == 0) {
         GSource *source = (GSource *)event_source;
 
         if (event_sources == event_source) {
@@ -566,6 +648,7 @@ static void ctk_event_unregister_source(CtkEvent *ctk_event)
             }
         }
 
+        g_hash_table_destroy(event_source->targets);
         NvCtrlCloseEventHandle(event_source->event_handle);
         g_source_remove_poll(source, &(event_source->event_poll_fd));
         g_source_destroy(source);
@@ -659,109 +742,295 @@ static gboolean ctk_event_check(GSource *source)
 
 
 
-#define CTK_EVENT_BROADCAST(ES, SIG, CEVT)             \
-do {                                                   \
-    CtkEventNode *e = (ES)->ctk_events;                \
-    while  (e) {                                       \
-        if (e->target_type == (CEVT)->target_type &&   \
-            e->target_id == (CEVT)->target_id) {       \
-            g_signal_emit(e->ctk_event, SIG, 0, CEVT); \
-        }                                              \
-        e = e->next;                                   \
-    }                                                  \
-} while (0)
+/*
+ * ctk_event_broadcast() - emit the given signal on every CtkEvent object
+ * registered for the event's target that has a handler connected to the
+ * signal.  Objects registered for other targets are not visited at all.
+ */
 
-static gboolean ctk_event_dispatch(GSource *source,
-                                   GSourceFunc callback,
-                                   gpointer user_data)
+static void ctk_event_broadcast(CtkEventSource *event_source,
+                                guint signal_id, CtrlEvent *event)
 {
-    ReturnStatus status;
-    CtrlEvent event;
-    CtkEventSource *event_source = (CtkEventSource *) source;
+    CtkEventTarget *event_target;
+    CtkEventNode *e, *next;
 
-    /*
-     * if ctk_event_dispatch() is called, then either
-     * ctk_event_prepare() or ctk_event_check() returned TRUE, so we
-     * know there is an event pending
-     */
-    status = NvCtrlEventHandleNextEvent(event_source->event_handle, &event);
-    if (status != NvCtrlSuccess) {
-        return FALSE;
+    event_target = find_event_target(event_source, event->target_type,
+                                     event->target_id);
+    if (!event_target) {
+        return;
+    }
+
+    for (e = event_target->ctk_events; e; e = next) {
+        /* a handler may destroy the node's CtkEvent object */
+        next = e->next;
+
+        if (!g_signal_has_handler_pending(e->ctk_event, signal_id, 0,
+                                          FALSE)) {
+            event_stats.filtered++;
+            continue;
+        }
+
+        g_signal_emit(e->ctk_event, signal_id, 0, event);
+        event_stats.emitted++;
+    }
+}
+
+
+
+/*
+ * update_event_rate() - recompute the event rate once per second from the
+ * number of events dispatched since it was last computed.
+ */
+
+static void update_event_rate(gint64 now)
+{
+    gint64 elapsed = now - rate_window_start;
+
+    if (rate_window_start == 0) {
+        rate_window_start = now;
+        return;
+    }
+
+    if (elapsed < G_USEC_PER_SEC) {
+        return;
     }
 
-    if (event.type != CTRL_EVENT_TYPE_UNKNOWN) {
+    event_stats.events_per_second =
+        (gdouble) rate_window_events * G_USEC_PER_SEC / elapsed;
+
+    rate_window_start = now;
+    rate_window_events = 0;
+}
+
+
+
+/*
+ * dispatch_event() - emit the signal corresponding to the given event on
+ * the CtkEvent objects registered for the event's target.
+ */
+
+static void dispatch_event(CtkEventSource *event_source, CtrlEvent *event)
+{
+    if (event->type != CTRL_EVENT_TYPE_UNKNOWN) {
 
         /* 
          * Handle the CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE event
          */
-        if (event.type == CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE) {
+        if (event->type == CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE) {
 
             /* make sure the attribute is in our signal array */
-            if ((event.int_attr.attribute <= NV_CTRL_LAST_ATTRIBUTE) &&
-                (signals[event.int_attr.attribute] != 0)) {
+            if ((event->int_attr.attribute <= NV_CTRL_LAST_ATTRIBUTE) &&
+                (signals[event->int_attr.attribute] != 0)) {
 
                 /*
                  * XXX Is emitting a signal with g_signal_emit() really
                  * the "correct" way of dispatching the event?
                  */
-                CTK_EVENT_BROADCAST(event_source,
-                                    signals[event.int_attr.attribute],
-                                    &event);
+                ctk_event_broadcast(event_source,
+                                    signals[event->int_attr.attribute],
+                                    event);
             }
         }
         
         /* 
          * Handle the CTRL_EVENT_TYPE_STRING_ATTRIBUTE event
          */
-        else if (event.type == CTRL_EVENT_TYPE_STRING_ATTRIBUTE) {
+        else if (event->type == CTRL_EVENT_TYPE_STRING_ATTRIBUTE) {
 
             /* make sure the attribute is in our string signal array */
 
-            if ((event.str_attr.attribute <= NV_CTRL_STRING_LAST_ATTRIBUTE) &&
-                (string_signals[event.str_attr.attribute] != 0)) {
+            if ((event->str_attr.attribute <= NV_CTRL_STRING_LAST_ATTRIBUTE) &&
+                (string_signals[event->str_attr.attribute] != 0)) {
 
                 /*
                  * XXX Is emitting a signal with g_signal_emit() really
                  * the "correct" way of dispatching the event
                  */
-                CTK_EVENT_BROADCAST(event_source,
-                                    string_signals[event.str_attr.attribute],
-                                    &event);
+                ctk_event_broadcast(event_source,
+                                    string_signals[event->str_attr.attribute],
+                                    event);
             }
         }
 
         /*
          * Handle the CTRL_EVENT_TYPE_BINARY_ATTRIBUTE event
          */
-        else if (event.type == CTRL_EVENT_TYPE_BINARY_ATTRIBUTE) {
+        else if (event->type == CTRL_EVENT_TYPE_BINARY_ATTRIBUTE) {
 
             /* make sure the attribute is in our binary signal array */
-            if ((event.bin_attr.attribute <= NV_CTRL_BINARY_DATA_LAST_ATTRIBUTE) &&
-                (binary_signals[event.bin_attr.attribute] != 0)) {
+            if ((event->bin_attr.attribute <= NV_CTRL_BINARY_DATA_LAST_ATTRIBUTE) &&
+                (binary_signals[event->bin_attr.attribute] != 0)) {
 
                 /*
                  * XXX Is emitting a signal with g_signal_emit() really
                  * the "correct" way of dispatching the event
                  */
-                CTK_EVENT_BROADCAST(event_source,
-                                    binary_signals[event.bin_attr.attribute],
-                                    &event);
+                ctk_event_broadcast(event_source,
+                                    binary_signals[event->bin_attr.attribute],
+                                    event);
             }
         }
 
         /*
          * Handle the CTRL_EVENT_TYPE_SCREEN_CHANGE event
          */
-        else if (event.type == CTRL_EVENT_TYPE_SCREEN_CHANGE) {
+        else if (event->type == CTRL_EVENT_TYPE_SCREEN_CHANGE) {
 
             /* make sure the target_id is valid */
-            if (event.target_id >= 0) {
-                CTK_EVENT_BROADCAST(event_source,
+            if (event->target_id >= 0) {
+                ctk_event_broadcast(event_source,
                                     signal_RRScreenChangeNotify,
-                                    &event);
+                                    event);
             }
         }
     }
+}
+
+
+
+/*
+ * collapse_event() - if the given event, just added at the end of the
+ * batch, is an integer attribute update for the same target and
+ * attribute as an update already in the batch, drop that earlier update
+ * (it is marked CTRL_EVENT_TYPE_UNKNOWN, and not dispatched) and return
+ * TRUE: only the latest value matters to the pages.  The latest value is
+ * kept at its own position, so that it is still dispatched after the
+ * events that came in before it, for this and other attributes.
+ *
+ * 'index' maps (target type, target id, attribute) to the batch entry
+ * of the most recent integer attribute event with that key.  Events
+ * that change an attribute's availability are never dropped, and never
+ * cause an earlier update to be dropped, so that pages still see the
+ * availability change and the values around it in order.
+ */
+
+static gboolean collapse_event(CtrlEvent *batch, int num_events,
+                               short *index)
+{
+    CtrlEvent *event = &batch[num_events];
+    gboolean collapsed = FALSE;
+    unsigned int slot;
+
+    if (event->type != CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE) {
+        return FALSE;
+    }
+
+    slot = ((unsigned int) event->target_type * 16777619u) ^
+        ((unsigned int) event->target_id * 2654435761u) ^
+        (unsigned int) event->int_attr.attribute;
+    slot &= (CTK_EVENT_BATCH_INDEX_SLOTS - 1);
+
+    while (index[slot] >= 0) {
+        CtrlEvent *prev = &batch[index[slot]];
+
+        if ((prev->target_type == event->target_type) &&
+            (prev->target_id == event->target_id) &&
+            (prev->int_attr.attribute == event->int_attr.attribute)) {
+
+            if (!prev->int_attr.is_availability_changed &&
+                !event->int_attr.is_availability_changed) {
+                prev->type = CTRL_EVENT_TYPE_UNKNOWN;
+                collapsed = TRUE;
+            }
+            break;
+        }
+        slot = (slot + 1) & (CTK_EVENT_BATCH_INDEX_SLOTS - 1);
+    }
+
+    index[slot] = num_events;
+
+    return collapsed;
+}
+
+
+
+static gboolean ctk_event_dispatch(GSource *source,
+                                   GSourceFunc callback,
+                                   gpointer user_data)
+{
+    ReturnStatus status;
+    Bool queued;
+    CtrlEvent batch[CTK_EVENT_BATCH_MAX_EVENTS];
+    short index[CTK_EVENT_BATCH_INDEX_SLOTS];
+    int i, num_events = 0, num_received = 0;
+    CtkEventSource *event_source = (CtkEventSource *) source;
+    gint64 start, latency;
+
+    start = g_get_monotonic_time();
+
+    memset(index, -1, sizeof(index));
+
+    /*
+     * if ctk_event_dispatch() is called, then either
+     * ctk_event_prepare() or ctk_event_check() returned TRUE, so we
+     * know there is an event pending.  Drain the events already read
+     * from the connection into a batch, until none are left, the batch
+     * is full or the time budget is spent; whatever remains, including
+     * events not yet read, is handled on the next main loop iteration,
+     * after the other sources (e.g. user input) had a chance to run.
+     */
+    for (;;) {
+        CtrlEvent *event = &batch[num_events];
+
+        status = NvCtrlEventHandleNextEvent(event_source->event_handle, event);
+        if (status != NvCtrlSuccess) {
+            break;
+        }
+
+        num_received++;
+
+        if (event->type != CTRL_EVENT_TYPE_UNKNOWN) {
+            if (collapse_event(batch, num_events, index)) {
+                event_stats.collapsed++;
+            }
+            num_events++;
+        }
+
+        if ((num_events == CTK_EVENT_BATCH_MAX_EVENTS) ||
+            ((g_get_monotonic_time() - start) >= CTK_EVENT_BATCH_BUDGET_US)) {
+            break;
+        }
+
+        status = NvCtrlEventHandleQueued(event_source->event_handle,
+                                         &queued);
+        if ((status != NvCtrlSuccess) || !queued) {
+            break;
+        }
+    }
+
+    if (num_received == 0) {
+        return FALSE;
+    }
+
+    /* Emit the signals for the batch, in the order the events came in */
+
+    for (i = 0; i < num_events; i++) {
+
+        /* a handler may have destroyed the last CtkEvent of this source */
+        if (g_source_is_destroyed(source)) {
+            break;
+        }
+
+        /* superseded by a later update; see collapse_event() */
+        if (batch[i].type == CTRL_EVENT_TYPE_UNKNOWN) {
+            continue;
+        }
+
+        dispatch_event(event_source, &batch[i]);
+    }
+
+    /* Account for the events in the dispatch statistics */
+
+    latency = g_get_monotonic_time() - start;
+
+    event_stats.events += num_received;
+    event_stats.total_latency_us += latency;
+    if (latency > event_stats.max_latency_us) {
+        event_stats.max_latency_us = latency;
+    }
+
+    rate_window_events += num_received;
+    update_event_rate(start + latency);
     
     return TRUE;
 
@@ -808,7 +1077,7 @@ void ctk_event_emit(CtkEvent *ctk_event,
     event.int_attr.attribute = attrib;
     event.int_attr.value     = value;
 
-    CTK_EVENT_BROADCAST(source, signals[attrib], &event);
+    ctk_event_broadcast(source, signals[attrib], &event);
 
 } /* ctk_event_emit() */
 
@@ -851,7 +1120,28 @@ void ctk_event_emit_string(CtkEvent *ctk_event,
 
     event.str_attr.attribute = attrib;
 
-    CTK_EVENT_BROADCAST(source, signals[attrib], &event);
+    ctk_event_broadcast(source, signals[attrib], &event);
 
 } /* ctk_event_emit_string() */
 
+
+
+/*
+ * ctk_event_get_stats() - returns the statistics of the events dispatched
+ * to CtkEvent objects so far, for display on the nvidia-settings
+ * Configuration page.
+ */
+void ctk_event_get_stats(CtkEventStats *stats)
+{
+    gint64 now = g_get_monotonic_time();
+
+    /* Let the rate decay when no events are coming in */
+
+    if (rate_window_start &&
+        (now - rate_window_start) >= G_USEC_PER_SEC) {
+        update_event_rate(now);
+    }
+
+    *stats = event_stats;
+
+} /* ctk_event_get_stats() */
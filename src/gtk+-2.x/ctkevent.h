@@ -58,6 +58,17 @@ struct _CtkEventClass
     GtkWidgetClass parent_class;
 };
 
+typedef struct _CtkEventStats
+{
+    guint64 events;            /* NV-CONTROL events dispatched */
+    guint64 collapsed;         /* updates superseded by a later value */
+    guint64 emitted;           /* signals emitted on CtkEvent objects */
+    guint64 filtered;          /* objects skipped, no handler connected */
+    gdouble events_per_second; /* over the last second or more */
+    gint64  total_latency_us;  /* time spent dispatching events */
+    gint64  max_latency_us;    /* longest time spent on a single batch */
+} CtkEventStats;
+
 GType       ctk_event_get_type  (void) G_GNUC_CONST;
 GObject*    ctk_event_new       (CtrlTarget*);
 void        ctk_event_destroy   (GObject*);
@@ -67,6 +78,8 @@ void ctk_event_emit(CtkEvent *ctk_event,
 void ctk_event_emit_string(CtkEvent *ctk_event,
                     unsigned int mask, int attrib);
 
+void ctk_event_get_stats(CtkEventStats *stats);
+
 #define CTK_EVENT_NAME(x) ("CTK_EVENT_" #x)
 
 
@@ -244,6 +244,8 @@ struct _nvFrameLockDataRec {
 
     GtkWidget  *firmware_version_label;
     GtkWidget  *firmware_version_text;
+    GtkWidget  *latency_label;
+    GtkWidget  *latency_text;
     const char *board_name;
 
     GtkWidget  *extra_info_hbox;
@@ -2191,6 +2193,14 @@ static nvListEntryPtr list_entry_new_with_framelock(nvFrameLockDataPtr data,
                        data->firmware_version_label, FALSE, FALSE, 0);
     gtk_box_pack_start(GTK_BOX(data->extra_info_hbox),
                        data->firmware_version_text, FALSE, FALSE, 0);
+    vseparator = gtk_vseparator_new();
+    gtk_box_pack_start(GTK_BOX(data->extra_info_hbox), vseparator,
+                       FALSE, FALSE, 0);
+
+    gtk_box_pack_start(GTK_BOX(data->extra_info_hbox),
+                       data->latency_label, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(data->extra_info_hbox),
+                       data->latency_text, FALSE, FALSE, 0);
 
     gtk_box_pack_end(GTK_BOX(hbox), padding, FALSE, FALSE, 0);
 
@@ -3670,6 +3680,31 @@ static void toggle_detect_video_mode(GtkToggleButton *button,
 
 
 
+/** get_status_attribute() *******************************************
+ *
+ * Returns the value of a status attribute from the latest snapshot of
+ * the background status poll, so that slow X servers don't stall the
+ * GUI.  Falls back to querying the X server directly if its status
+ * cannot be polled in the background.
+ *
+ */
+static ReturnStatus get_status_attribute(CtkFramelock *ctk_framelock,
+                                         CtrlTarget *ctrl_target,
+                                         int attr, int *val)
+{
+    ReturnStatus ret;
+
+    ret = ctk_framelock_poll_get_attribute(ctk_framelock->status_poll,
+                                           ctrl_target, attr, val);
+    if (ret == NvCtrlNotSupported || ret == NvCtrlBadHandle) {
+        ret = NvCtrlGetAttribute(ctrl_target, attr, val);
+    }
+
+    return ret;
+}
+
+
+
 /** list_entry_update_framelock_status() *****************************
  *
  * Updates the dynamic state of the GUI for a frame lock list entry by
@@ -3682,6 +3717,7 @@ static void list_entry_update_framelock_status(CtkFramelock *ctk_framelock,
     nvFrameLockDataPtr data = (nvFrameLockDataPtr)(entry->data);
     CtrlTarget *ctrl_target = data->ctrl_target;
     gint rate, delay, house, port0, port1;
+    guint latency_us;
     gchar str[32];
     gfloat fvalue;
     nvListTreePtr tree = (nvListTreePtr)(ctk_framelock->tree);
@@ -3692,10 +3728,26 @@ static void list_entry_update_framelock_status(CtkFramelock *ctk_framelock,
     ReturnStatus ret;
     
     
-    NvCtrlGetAttribute(ctrl_target, NV_CTRL_FRAMELOCK_SYNC_DELAY, &delay);
-    NvCtrlGetAttribute(ctrl_target, NV_CTRL_FRAMELOCK_HOUSE_STATUS, &house);
-    NvCtrlGetAttribute(ctrl_target, NV_CTRL_FRAMELOCK_PORT0_STATUS, &port0);
-    NvCtrlGetAttribute(ctrl_target, NV_CTRL_FRAMELOCK_PORT1_STATUS, &port1);
+    get_status_attribute(ctk_framelock, ctrl_target,
+                         NV_CTRL_FRAMELOCK_SYNC_DELAY, &delay);
+    get_status_attribute(ctk_framelock, ctrl_target,
+                         NV_CTRL_FRAMELOCK_HOUSE_STATUS, &house);
+    get_status_attribute(ctk_framelock, ctrl_target,
+                         NV_CTRL_FRAMELOCK_PORT0_STATUS, &port0);
+    get_status_attribute(ctk_framelock, ctrl_target,
+                         NV_CTRL_FRAMELOCK_PORT1_STATUS, &port1);
+
+    /* The status of the server has not been collected yet */
+    if (ctk_framelock_poll_is_pending(ctk_framelock->status_poll,
+                                      ctrl_target)) {
+        update_image(data->house_hbox, ctk_framelock->led_grey_pixbuf);
+        update_image(data->receiving_hbox, ctk_framelock->led_grey_pixbuf);
+        label_set_text(data->rate_text, "Pending");
+        label_set_text(data->delay_text, "Pending");
+        label_set_text(data->house_sync_rate_text, "Pending");
+        label_set_text(data->latency_text, "Pending");
+        return;
+    }
 
     use_house_sync_input = gtk_combo_box_get_active
         (GTK_COMBO_BOX(ctk_framelock->house_sync_mode_combo)) ==
@@ -3713,8 +3765,8 @@ static void list_entry_update_framelock_status(CtkFramelock *ctk_framelock,
         update_image(data->receiving_hbox, ctk_framelock->led_grey_pixbuf);
     } else {
         gint receiving;
-        NvCtrlGetAttribute(ctrl_target, NV_CTRL_FRAMELOCK_SYNC_READY,
-                           &receiving);
+        get_status_attribute(ctk_framelock, ctrl_target,
+                             NV_CTRL_FRAMELOCK_SYNC_READY, &receiving);
         gtk_widget_set_sensitive(data->receiving_label, TRUE);
         update_image(data->receiving_hbox,
                      (receiving ? ctk_framelock->led_green_pixbuf :
@@ -3725,12 +3777,13 @@ static void list_entry_update_framelock_status(CtkFramelock *ctk_framelock,
     gtk_widget_set_sensitive(data->rate_label, framelock_enabled);
     gtk_widget_set_sensitive(data->rate_text, framelock_enabled);
 
-    ret =
-        NvCtrlGetAttribute(ctrl_target, NV_CTRL_FRAMELOCK_SYNC_RATE_4, &rate);
+    ret = get_status_attribute(ctk_framelock, ctrl_target,
+                               NV_CTRL_FRAMELOCK_SYNC_RATE_4, &rate);
     if (ret == NvCtrlSuccess) {
         snprintf(str, 32, "%d.%.4d Hz", (rate / 10000), (rate % 10000));
     } else {
-        NvCtrlGetAttribute(ctrl_target, NV_CTRL_FRAMELOCK_SYNC_RATE, &rate);
+        get_status_attribute(ctk_framelock, ctrl_target,
+                             NV_CTRL_FRAMELOCK_SYNC_RATE, &rate);
         snprintf(str, 32, "%d.%.3d Hz", (rate / 1000), (rate % 1000));
     }
     label_set_text(data->rate_text, str);
@@ -3747,9 +3800,9 @@ static void list_entry_update_framelock_status(CtkFramelock *ctk_framelock,
     gtk_widget_set_sensitive(data->house_sync_rate_label, framelock_enabled);
     gtk_widget_set_sensitive(data->house_sync_rate_text, framelock_enabled);
 
-    ret = NvCtrlGetAttribute(ctrl_target,
-                             NV_CTRL_FRAMELOCK_INCOMING_HOUSE_SYNC_RATE,
-                             &rate);
+    ret = get_status_attribute(ctk_framelock, ctrl_target,
+                               NV_CTRL_FRAMELOCK_INCOMING_HOUSE_SYNC_RATE,
+                               &rate);
     if (ret == NvCtrlSuccess) {
         snprintf(str, 32, "%d.%.4d Hz", (rate / 10000), (rate % 10000));
     } else {
@@ -3777,6 +3830,15 @@ static void list_entry_update_framelock_status(CtkFramelock *ctk_framelock,
     } else {
         update_image(data->port1_hbox, ctk_framelock->rj45_unused_pixbuf);
     }
+
+    /* Round trip time to the X server */
+    if (ctk_framelock_poll_get_latency(ctk_framelock->status_poll,
+                                       ctrl_target, &latency_us)) {
+        snprintf(str, 32, "%.1f ms", latency_us / 1000.0);
+    } else {
+        snprintf(str, 32, "Unknown");
+    }
+    label_set_text(data->latency_text, str);
 }
 
 
@@ -3807,9 +3869,8 @@ static void list_entry_update_gpu_status(CtkFramelock *ctk_framelock,
         nvFrameLockDataPtr framelock_data =
             (nvFrameLockDataPtr)(entry->parent->data);
 
-        NvCtrlGetAttribute(framelock_data->ctrl_target,
-                           NV_CTRL_FRAMELOCK_HOUSE_STATUS,
-                           &house);
+        get_status_attribute(ctk_framelock, framelock_data->ctrl_target,
+                             NV_CTRL_FRAMELOCK_HOUSE_STATUS, &house);
     }
 
     /*
@@ -3834,9 +3895,14 @@ static void list_entry_update_gpu_status(CtkFramelock *ctk_framelock,
         (has_server && !house)) {                // No house so GPU drives sync.
         gtk_widget_set_sensitive(data->timing_label, FALSE);
         update_image(data->timing_hbox, ctk_framelock->led_grey_pixbuf);
+    } else if (ctk_framelock_poll_is_pending(ctk_framelock->status_poll,
+                                             data->ctrl_target)) {
+        gtk_widget_set_sensitive(data->timing_label, TRUE);
+        update_image(data->timing_hbox, ctk_framelock->led_grey_pixbuf);
     } else {
         gint timing;
-        NvCtrlGetAttribute(data->ctrl_target, NV_CTRL_FRAMELOCK_TIMING, &timing);
+        get_status_attribute(ctk_framelock, data->ctrl_target,
+                             NV_CTRL_FRAMELOCK_TIMING, &timing);
         gtk_widget_set_sensitive(data->timing_label, TRUE);
         update_image(data->timing_hbox,
                      (timing ? ctk_framelock->led_green_pixbuf :
@@ -3882,7 +3948,8 @@ static void list_entry_update_display_status(CtkFramelock *ctk_framelock,
 
     gpu_is_server = (gpu_server_entry && (gpu_server_entry == entry->parent));
 
-    ret = NvCtrlGetAttribute(ctrl_target, NV_CTRL_STEREO, &val);
+    ret = get_status_attribute(ctk_framelock, ctrl_target, NV_CTRL_STEREO,
+                               &val);
     if ((ret == NvCtrlSuccess) &&
         (val != NV_CTRL_STEREO_OFF)) {
         stereo_enabled = TRUE;
@@ -3908,12 +3975,13 @@ static void list_entry_update_display_status(CtkFramelock *ctk_framelock,
             nvGPUDataPtr gpu_data = (nvGPUDataPtr)(entry->parent->data);
             CtrlTarget *ctrl_target = gpu_data->ctrl_target;
 
-            ret = NvCtrlGetAttribute(ctrl_target, NV_CTRL_FRAMELOCK_TIMING,
-                                     &val);
+            ret = get_status_attribute(ctk_framelock, ctrl_target,
+                                       NV_CTRL_FRAMELOCK_TIMING, &val);
             if ((ret == NvCtrlSuccess) &&
                 (val == NV_CTRL_FRAMELOCK_TIMING_TRUE)) {
-                ret = NvCtrlGetAttribute(ctrl_target,
-                                         NV_CTRL_FRAMELOCK_STEREO_SYNC, &val);
+                ret = get_status_attribute(ctk_framelock, ctrl_target,
+                                           NV_CTRL_FRAMELOCK_STEREO_SYNC,
+                                           &val);
                 if (ret == NvCtrlSuccess) {
                     pixbuf = (val == NV_CTRL_FRAMELOCK_STEREO_SYNC_TRUE) ?
                         ctk_framelock->led_green_pixbuf :
@@ -4001,9 +4069,8 @@ static gboolean check_for_ethernet(gpointer user_data)
             nvFrameLockDataPtr data = (nvFrameLockDataPtr)(entry->data);
             gint val;
 
-            NvCtrlGetAttribute(data->ctrl_target,
-                               NV_CTRL_FRAMELOCK_ETHERNET_DETECTED,
-                               &val);
+            get_status_attribute(ctk_framelock, data->ctrl_target,
+                                 NV_CTRL_FRAMELOCK_ETHERNET_DETECTED, &val);
 
             if (val & NV_CTRL_FRAMELOCK_ETHERNET_DETECTED_PORT0) {
                 data->port0_ethernet_error = TRUE;
@@ -4821,6 +4888,25 @@ static GObjectClass *parent_class;
 
 
 
+/** ctk_framelock_finalize() *****************************************
+ *
+ * Stops the background status poll before the page goes away.
+ *
+ */
+static void ctk_framelock_finalize(
+    GObject *object
+)
+{
+    CtkFramelock *ctk_framelock = CTK_FRAMELOCK(object);
+
+    ctk_framelock_poll_free(ctk_framelock->status_poll);
+    ctk_framelock->status_poll = NULL;
+
+    parent_class->finalize(object);
+}
+
+
+
 /** ctk_framelock_class_init() ***************************************
  *
  * Initialize the object structure
@@ -4831,7 +4917,10 @@ static void ctk_framelock_class_init(
     gpointer class_data
 )
 {
+    GObjectClass *gobject_class = (GObjectClass *)ctk_framelock_class;
+
     parent_class = g_type_class_peek_parent(ctk_framelock_class);
+    gobject_class->finalize = ctk_framelock_finalize;
 }
 
 
@@ -4982,6 +5071,11 @@ GtkWidget* ctk_framelock_new(CtrlTarget *ctrl_target,
     ctk_framelock->house_sync_output_warning_dlg_shown = FALSE;
     ctk_framelock->muldiv_supported = FALSE;
 
+    /* status of the frame lock devices is collected in the background */
+
+    ctk_framelock->status_poll =
+        ctk_framelock_poll_new(DEFAULT_UPDATE_STATUS_TIME_INTERVAL);
+
     /* create the watch cursor */
 
     ctk_framelock->wait_cursor = gdk_cursor_new(GDK_WATCH);
@@ -6014,6 +6108,10 @@ static void add_framelock_devices(CtkFramelock *ctk_framelock,
                        firmware_version_str);
         g_free(firmware_version_str);
 
+        framelock_data->latency_label = gtk_label_new(NULL);
+        label_set_text(framelock_data->latency_label, "Latency:");
+        framelock_data->latency_text = gtk_label_new(NULL);
+
         framelock_data->extra_info_hbox = gtk_hbox_new(FALSE, 5);
 
         framelock_data->server_id = server_id;
@@ -6463,6 +6561,11 @@ GtkTextBuffer *ctk_framelock_create_help(GtkTextTagTable *table)
                   "configured for output.");
     ctk_help_para(b, &i, "Delay Information: The sync delay (in microseconds) "
                      "between the frame lock pulse and the GPU pulse.");
+    ctk_help_para(b, &i, "Latency Information: The average time (in "
+                  "milliseconds) the X server takes to answer a status "
+                  "query.  The status of each X server is collected in the "
+                  "background, so a slow X server only delays its own "
+                  "entries.");
 
     ctk_help_heading(b, &i, "GPU Device Entry Information");
     ctk_help_para(b, &i, "GPU Device entries display the GPU name and number "
@@ -22,6 +22,7 @@
 
 #include "NvCtrlAttributes.h"
 #include "ctkconfig.h"
+#include "ctkframelockpoll.h"
 
 #include "parse.h"
 
@@ -131,6 +132,9 @@ struct _CtkFramelock
     GdkPixbuf             *rj45_input_pixbuf;
     GdkPixbuf             *rj45_output_pixbuf;
     GdkPixbuf             *rj45_unused_pixbuf;
+
+    /* Background collection of the device status */
+    CtkFramelockPoll      *status_poll;
 };
 
 struct _CtkFramelockClass
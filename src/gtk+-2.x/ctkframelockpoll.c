@@ -0,0 +1,487 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2004 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * ctkframelockpoll.c - collects the frame lock status of every X server on
+ * the Frame Lock page off the GTK main loop.
+ *
+ * The status of a frame lock group is made of a few dozen NV-CONTROL
+ * queries per server, each a round trip; done from the main loop, a single
+ * slow or unreachable server stalls the whole user interface.  Instead, each
+ * server gets a worker thread owning a separate X connection (the
+ * libXNVCtrlAttributes handles of the page are only ever used from the main
+ * loop).  The set of queries of a server is whatever the page has asked for
+ * on it: the first read of an attribute registers it and returns
+ * NvCtrlAttributeNotAvailable until the worker has queried it.
+ *
+ * Each server has two snapshots of results: the worker fills the back one
+ * without holding the lock, then makes it the front one, which is the only
+ * one readers look at.  A worker that nobody has read from for a few
+ * intervals (the page is not shown, or its devices were removed) closes its
+ * connection and sleeps until it is read from again.  The workers are
+ * stopped and joined by ctk_framelock_poll_free(), before the state they
+ * share with the page is freed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <X11/Xlib.h>
+
+#include "NVCtrlLib.h"
+#include "NvCtrlAttributes.h"
+
+#include "common-utils.h"
+#include "msg.h"
+
+#include "ctkframelockpoll.h"
+
+/* Stop polling a server after this many intervals without readers */
+#define FRAMELOCK_POLL_IDLE_INTERVALS 5
+
+typedef struct {
+    int target_type; /* NV-CONTROL target type */
+    int target_id;
+    int attr;
+} PollQuery;
+
+typedef struct {
+    ReturnStatus status;
+    int value;
+} PollResult;
+
+typedef struct {
+    PollResult *results;     /* one per query, in query order */
+    int num_results;
+    Bool connected;          /* the X server could be reached */
+    unsigned int latency_us; /* average round trip of the queries */
+} PollSnapshot;
+
+typedef struct _PollHost {
+    CtkFramelockPoll *poll;
+    char *display_name;      /* as given to XOpenDisplay(); may be NULL */
+    Bool has_worker;
+    pthread_t thread;
+    Display *dpy;            /* used by the worker only */
+
+    /* The fields below are protected by poll->lock */
+
+    PollQuery *queries;
+    int num_queries;
+    Bool new_queries;        /* queries were added since the last round */
+
+    PollSnapshot snapshots[2];
+    int front;               /* the snapshot readers use */
+    Bool sampled;            /* the worker has completed a round */
+
+    uint64_t last_read_us;   /* when a reader last used this host */
+
+    struct _PollHost *next;
+} PollHost;
+
+struct _CtkFramelockPoll {
+    unsigned int interval_ms;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;     /* signaled when queries are added or read */
+    PollHost *hosts;
+    Bool stop;               /* the workers must exit */
+};
+
+
+
+/*
+ * poll_host_round() - run every query of the host on the worker's own X
+ * connection, filling the given snapshot.  Called without the lock held.
+ */
+
+static void poll_host_round(PollHost *host, const PollQuery *queries,
+                            int num_queries, PollSnapshot *snapshot)
+{
+    uint64_t start;
+    int i;
+
+    if (!host->dpy) {
+        host->dpy = XOpenDisplay(host->display_name);
+    }
+
+    if (snapshot->num_results < num_queries) {
+        snapshot->results = nvrealloc(snapshot->results,
+                                      num_queries * sizeof(PollResult));
+    }
+    snapshot->num_results = num_queries;
+
+    start = nv_get_monotonic_time_us();
+
+    for (i = 0; i < num_queries; i++) {
+        PollResult *result = &snapshot->results[i];
+
+        result->value = 0;
+
+        if (!host->dpy) {
+            result->status = NvCtrlMissingExtension;
+        } else if (XNVCTRLQueryTargetAttribute(host->dpy,
+                                               queries[i].target_type,
+                                               queries[i].target_id,
+                                               0, queries[i].attr,
+                                               &result->value)) {
+            result->status = NvCtrlSuccess;
+        } else {
+            result->status = NvCtrlAttributeNotAvailable;
+        }
+    }
+
+    snapshot->connected = (host->dpy != NULL);
+    snapshot->latency_us = (host->dpy && num_queries) ?
+        (nv_get_monotonic_time_us() - start) / num_queries : 0;
+}
+
+
+
+/*
+ * wait_until() - wait on the condition of the poll, until 'deadline_us' on
+ * the monotonic clock.
+ */
+
+static void wait_until(CtkFramelockPoll *poll, uint64_t deadline_us)
+{
+    struct timespec ts;
+
+    ts.tv_sec = deadline_us / 1000000;
+    ts.tv_nsec = (deadline_us % 1000000) * 1000;
+
+    pthread_cond_timedwait(&poll->cond, &poll->lock, &ts);
+}
+
+
+
+static void *poll_host_thread(void *arg)
+{
+    PollHost *host = arg;
+    CtkFramelockPoll *poll = host->poll;
+    const uint64_t interval_us = poll->interval_ms * 1000ULL;
+    PollQuery *queries = NULL;
+    int num_queries = 0;
+    uint64_t next_round_us = 0;
+
+    pthread_mutex_lock(&poll->lock);
+
+    while (!poll->stop) {
+        uint64_t now = nv_get_monotonic_time_us();
+        PollSnapshot *back;
+
+        if (now - host->last_read_us >
+            FRAMELOCK_POLL_IDLE_INTERVALS * interval_us) {
+
+            if (host->dpy) {
+                pthread_mutex_unlock(&poll->lock);
+                XCloseDisplay(host->dpy);
+                host->dpy = NULL;
+                pthread_mutex_lock(&poll->lock);
+            } else {
+                pthread_cond_wait(&poll->cond, &poll->lock);
+            }
+            continue;
+        }
+
+        if (!host->new_queries && (now < next_round_us)) {
+            wait_until(poll, next_round_us);
+            continue;
+        }
+
+        host->new_queries = FALSE;
+
+        if (num_queries != host->num_queries) {
+            num_queries = host->num_queries;
+            queries = nvrealloc(queries, num_queries * sizeof(PollQuery));
+            memcpy(queries, host->queries, num_queries * sizeof(PollQuery));
+        }
+
+        back = &host->snapshots[!host->front];
+
+        pthread_mutex_unlock(&poll->lock);
+
+        poll_host_round(host, queries, num_queries, back);
+
+        pthread_mutex_lock(&poll->lock);
+
+        host->front = !host->front;
+        host->sampled = TRUE;
+        next_round_us = now + interval_us;
+    }
+
+    pthread_mutex_unlock(&poll->lock);
+
+    if (host->dpy) {
+        XCloseDisplay(host->dpy);
+        host->dpy = NULL;
+    }
+    nvfree(queries);
+
+    return NULL;
+}
+
+
+
+/*
+ * get_host() - return the host of the given X display name, starting its
+ * worker if it is new.  Called with the lock held.
+ */
+
+static PollHost *get_host(CtkFramelockPoll *poll, const char *display_name)
+{
+    PollHost *host;
+
+    for (host = poll->hosts; host; host = host->next) {
+        if ((!host->display_name && !display_name) ||
+            (host->display_name && display_name &&
+             (strcmp(host->display_name, display_name) == 0))) {
+            return host;
+        }
+    }
+
+    host = nvalloc(sizeof(PollHost));
+    host->poll = poll;
+    host->display_name = nvstrdup(display_name);
+    host->last_read_us = nv_get_monotonic_time_us();
+
+    if (pthread_create(&host->thread, NULL, poll_host_thread, host) == 0) {
+        host->has_worker = TRUE;
+    } else {
+        nv_warning_msg("Unable to start the frame lock status thread for "
+                       "'%s'; querying it from the user interface instead.",
+                       display_name ? display_name : XDisplayName(NULL));
+    }
+
+    host->next = poll->hosts;
+    poll->hosts = host;
+
+    return host;
+}
+
+
+
+/*
+ * ctk_framelock_poll_new() - create a poll whose workers query their server
+ * every 'interval_ms' milliseconds.
+ */
+
+CtkFramelockPoll *ctk_framelock_poll_new(unsigned int interval_ms)
+{
+    CtkFramelockPoll *poll = nvalloc(sizeof(CtkFramelockPoll));
+    pthread_condattr_t attr;
+
+    poll->interval_ms = interval_ms;
+
+    pthread_mutex_init(&poll->lock, NULL);
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&poll->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    return poll;
+}
+
+
+
+/*
+ * ctk_framelock_poll_free() - stop the workers and wait for them to exit,
+ * then free the poll.  A worker in the middle of a round finishes its
+ * current query first.
+ */
+
+void ctk_framelock_poll_free(CtkFramelockPoll *poll)
+{
+    PollHost *host, *next;
+    int i;
+
+    if (!poll) {
+        return;
+    }
+
+    pthread_mutex_lock(&poll->lock);
+    poll->stop = TRUE;
+    pthread_cond_broadcast(&poll->cond);
+    pthread_mutex_unlock(&poll->lock);
+
+    for (host = poll->hosts; host; host = next) {
+        next = host->next;
+
+        if (host->has_worker) {
+            pthread_join(host->thread, NULL);
+        }
+
+        for (i = 0; i < ARRAY_LEN(host->snapshots); i++) {
+            nvfree(host->snapshots[i].results);
+        }
+        nvfree(host->queries);
+        nvfree(host->display_name);
+        nvfree(host);
+    }
+
+    pthread_cond_destroy(&poll->cond);
+    pthread_mutex_destroy(&poll->lock);
+
+    nvfree(poll);
+}
+
+
+
+/*
+ * ctk_framelock_poll_get_attribute() - return the value of the integer
+ * attribute 'attr' of 'ctrl_target' from the latest snapshot of its server,
+ * or 0 and NvCtrlAttributeNotAvailable while it has not been queried yet.
+ * Returns NvCtrlNotSupported if the server cannot be polled in the
+ * background, in which case the caller should query it directly.
+ */
+
+ReturnStatus ctk_framelock_poll_get_attribute(CtkFramelockPoll *poll,
+                                              const CtrlTarget *ctrl_target,
+                                              int attr, int *val)
+{
+    ReturnStatus status = NvCtrlAttributeNotAvailable;
+    const PollSnapshot *snapshot;
+    PollHost *host;
+    int target_type, target_id;
+    uint64_t now;
+    int i;
+
+    *val = 0;
+
+    if (!poll || !ctrl_target || !ctrl_target->system ||
+        !ctrl_target->targetTypeInfo) {
+        return NvCtrlBadHandle;
+    }
+
+    target_type = ctrl_target->targetTypeInfo->nvctrl;
+    target_id = NvCtrlGetTargetId(ctrl_target);
+
+    pthread_mutex_lock(&poll->lock);
+
+    now = nv_get_monotonic_time_us();
+    host = get_host(poll, ctrl_target->system->display);
+
+    if (!host->has_worker) {
+        pthread_mutex_unlock(&poll->lock);
+        return NvCtrlNotSupported;
+    }
+
+    /* Wake the worker up if it went idle */
+    if (now - host->last_read_us >
+        FRAMELOCK_POLL_IDLE_INTERVALS * poll->interval_ms * 1000ULL) {
+        pthread_cond_broadcast(&poll->cond);
+    }
+    host->last_read_us = now;
+
+    for (i = 0; i < host->num_queries; i++) {
+        const PollQuery *q = &host->queries[i];
+        if ((q->attr == attr) && (q->target_id == target_id) &&
+            (q->target_type == target_type)) {
+            break;
+        }
+    }
+
+    if (i == host->num_queries) {
+        host->queries = nvrealloc(host->queries,
+                                  (host->num_queries + 1) * sizeof(PollQuery));
+        host->queries[i].target_type = target_type;
+        host->queries[i].target_id = target_id;
+        host->queries[i].attr = attr;
+        host->num_queries++;
+        host->new_queries = TRUE;
+        pthread_cond_broadcast(&poll->cond);
+    }
+
+    snapshot = &host->snapshots[host->front];
+
+    if (i < snapshot->num_results) {
+        status = snapshot->results[i].status;
+        *val = snapshot->results[i].value;
+    }
+
+    pthread_mutex_unlock(&poll->lock);
+
+    return status;
+}
+
+
+
+/*
+ * ctk_framelock_poll_get_latency() - return the average round trip time of
+ * the queries of the latest snapshot of the server of 'ctrl_target'.
+ * Returns FALSE if there is none yet, or the server is unreachable.
+ */
+
+Bool ctk_framelock_poll_get_latency(CtkFramelockPoll *poll,
+                                    const CtrlTarget *ctrl_target,
+                                    unsigned int *latency_us)
+{
+    const PollSnapshot *snapshot;
+    PollHost *host;
+    Bool ret = FALSE;
+
+    if (!poll || !ctrl_target || !ctrl_target->system) {
+        return FALSE;
+    }
+
+    pthread_mutex_lock(&poll->lock);
+
+    host = get_host(poll, ctrl_target->system->display);
+    snapshot = &host->snapshots[host->front];
+
+    if (host->has_worker && snapshot->connected && snapshot->num_results) {
+        *latency_us = snapshot->latency_us;
+        ret = TRUE;
+    }
+
+    pthread_mutex_unlock(&poll->lock);
+
+    return ret;
+}
+
+
+
+/*
+ * ctk_framelock_poll_is_pending() - return TRUE while the server of
+ * 'ctrl_target' is polled in the background, but its worker has not
+ * completed a round yet: the values read until then are not its status.
+ */
+
+Bool ctk_framelock_poll_is_pending(CtkFramelockPoll *poll,
+                                   const CtrlTarget *ctrl_target)
+{
+    PollHost *host;
+    Bool ret;
+
+    if (!poll || !ctrl_target || !ctrl_target->system) {
+        return FALSE;
+    }
+
+    pthread_mutex_lock(&poll->lock);
+
+    host = get_host(poll, ctrl_target->system->display);
+    ret = host->has_worker && !host->sampled;
+
+    pthread_mutex_unlock(&poll->lock);
+
+    return ret;
+}
@@ -0,0 +1,49 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2004 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+#ifndef __CTK_FRAMELOCK_POLL_H__
+#define __CTK_FRAMELOCK_POLL_H__
+
+#include "NvCtrlAttributes.h"
+
+/*
+ * Background polling of the frame lock status attributes.  Each X server
+ * that targets are queried on gets a worker thread with its own X
+ * connection, which periodically queries every attribute that has been
+ * asked for on that server and publishes the values as a snapshot.  Reading
+ * a value never waits for the X server; it returns the latest snapshot.
+ */
+
+typedef struct _CtkFramelockPoll CtkFramelockPoll;
+
+CtkFramelockPoll *ctk_framelock_poll_new(unsigned int interval_ms);
+void ctk_framelock_poll_free(CtkFramelockPoll *poll);
+
+ReturnStatus ctk_framelock_poll_get_attribute(CtkFramelockPoll *poll,
+                                              const CtrlTarget *ctrl_target,
+                                              int attr, int *val);
+
+Bool ctk_framelock_poll_get_latency(CtkFramelockPoll *poll,
+                                    const CtrlTarget *ctrl_target,
+                                    unsigned int *latency_us);
+
+Bool ctk_framelock_poll_is_pending(CtkFramelockPoll *poll,
+                                   const CtrlTarget *ctrl_target);
+
+#endif /* __CTK_FRAMELOCK_POLL_H__ */
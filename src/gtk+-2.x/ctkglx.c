@@ -29,6 +29,7 @@
 
 #include "ctkbanner.h"
 #include "ctkglx.h"
+#include "ctkconfigmodel.h"
 #include "ctkutils.h"
 #include "ctkconfig.h"
 #include "ctkhelp.h"
@@ -41,6 +42,9 @@
 #define NUM_FBCONFIG_ATTRIBS  32
 #define NUM_EGL_FBCONFIG_ATTRIBS  32
 
+/* Number of FBConfigs measured to size the columns of their tables */
+#define FBCONFIG_SAMPLE_ROWS 64
+
 /* Indent size of Vulkan Info */
 #define INDENT_SIZE 28
 
@@ -341,254 +345,181 @@ egl_fbc_window_destroy(GtkWidget *widget, GdkEvent *event, gpointer user_data)
 
 
 /*
- * create_fbconfig_model() - called to create and populate the model for
- * the GLX Frame Buffer Configurations table.
+ * format_fbconfig_cell() - format one cell of the GLX Frame Buffer
+ * Configurations table; called by the model when the cell is drawn.
  */
-static GtkTreeModel *create_fbconfig_model(GLXFBConfigAttr *fbconfig_attribs)
+static gchar *format_fbconfig_cell(gconstpointer record, gint row,
+                                   gint column, gchar *buf)
 {
-    GtkListStore *model;
-    GtkTreeIter iter;
-    int i;
-    GValue v = G_VALUE_INIT;
+    const GLXFBConfigAttr *fbc = record;
+    const int len = CTK_CONFIG_MODEL_CELL_LEN;
+
+    switch (column) {
+    case 0:
+        snprintf(buf, len, "0x%02X", fbc->fbconfig_id);
+        break;
+    case 1:
+        if (fbc->visual_id) {
+            snprintf(buf, len, "0x%02X", fbc->visual_id);
+        } else {
+            snprintf(buf, len, ".");
+        }
+        break;
+    case 2:
+        snprintf(buf, len, "%s", x_visual_type_abbrev(fbc->x_visual_type));
+        break;
+    case 3:  snprintf(buf, len, "%3d", fbc->buffer_size);      break;
+    case 4:  snprintf(buf, len, "%2d", fbc->level);            break;
+    case 5:
+        snprintf(buf, len, "%s", render_type_abbrev(fbc->render_type));
+        break;
+    case 6:  snprintf(buf, len, "%c", fbc->doublebuffer ? 'y' : '.'); break;
+    case 7:  snprintf(buf, len, "%c", fbc->stereo ? 'y' : '.');       break;
+    case 8:  snprintf(buf, len, "%2d", fbc->red_size);         break;
+    case 9:  snprintf(buf, len, "%2d", fbc->green_size);       break;
+    case 10: snprintf(buf, len, "%2d", fbc->blue_size);        break;
+    case 11: snprintf(buf, len, "%2d", fbc->alpha_size);       break;
+    case 12: snprintf(buf, len, "%2d", fbc->aux_buffers);      break;
+    case 13: snprintf(buf, len, "%2d", fbc->depth_size);       break;
+    case 14: snprintf(buf, len, "%2d", fbc->stencil_size);     break;
+    case 15: snprintf(buf, len, "%2d", fbc->accum_red_size);   break;
+    case 16: snprintf(buf, len, "%2d", fbc->accum_green_size); break;
+    case 17: snprintf(buf, len, "%2d", fbc->accum_blue_size);  break;
+    case 18: snprintf(buf, len, "%2d", fbc->accum_alpha_size); break;
+    case 19:
+        snprintf(buf, len, "%2d",
+                 fbc->multi_sample_valid ? fbc->multi_samples : 0);
+        break;
+    case 20:
+        if (!fbc->multi_sample_valid) {
+            snprintf(buf, len, " 0");
+        } else if (fbc->multi_sample_coverage_valid) {
+            snprintf(buf, len, "%2d", fbc->multi_samples_color);
+        } else {
+            snprintf(buf, len, "%2d", fbc->multi_samples);
+        }
+        break;
+    case 21: snprintf(buf, len, "%1d", fbc->multi_sample_buffers); break;
+    case 22:
+        snprintf(buf, len, "%s", caveat_abbrev(fbc->config_caveat));
+        break;
+    case 23: snprintf(buf, len, "0x%04X", fbc->pbuffer_width);  break;
+    case 24: snprintf(buf, len, "0x%04X", fbc->pbuffer_height); break;
+    case 25: snprintf(buf, len, "0x%07X", fbc->pbuffer_max);    break;
+    case 26:
+        snprintf(buf, len, "%s",
+                 transparent_type_abbrev(fbc->transparent_type));
+        break;
+    case 27: snprintf(buf, len, "%3d", fbc->transparent_red_value);   break;
+    case 28: snprintf(buf, len, "%3d", fbc->transparent_green_value); break;
+    case 29: snprintf(buf, len, "%3d", fbc->transparent_blue_value);  break;
+    case 30: snprintf(buf, len, "%3d", fbc->transparent_alpha_value); break;
+    case 31: snprintf(buf, len, "%3d", fbc->transparent_index_value); break;
+    }
+
+    return NULL;
+}
+
 
+/*
+ * create_fbconfig_model() - called to create the model for the GLX Frame
+ * Buffer Configurations table.  The model takes ownership of the
+ * fbconfig_attribs array; cells are only formatted when they are drawn.
+ */
+static GtkTreeModel *create_fbconfig_model(GLXFBConfigAttr *fbconfig_attribs,
+                                           int num_fbconfigs)
+{
     if (!fbconfig_attribs) {
         return NULL;
     }
 
-    g_value_init(&v, G_TYPE_STRING);
-
-    model = gtk_list_store_new(NUM_FBCONFIG_ATTRIBS,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
-
-    /* Populate FBConfig table */
-    i = 0;
-    while ( fbconfig_attribs[i].fbconfig_id != 0 ) {
-        char str[NUM_FBCONFIG_ATTRIBS + 1][16];
-        int  cell = 0; /* Used for putting information into cells */
-
-        if ( fbconfig_attribs[i].fbconfig_id )  {
-            snprintf((char *) (&(str[cell++])), 16, "0x%02X",
-                     fbconfig_attribs[i].fbconfig_id);
-        } else {
-            sprintf((char *) (&(str[cell++])),".");
-        }
-
-        if ( fbconfig_attribs[i].visual_id )  {
-            snprintf((char *) (&(str[cell++])), 16, "0x%02X",
-                     fbconfig_attribs[i].visual_id);
-        } else {
-            sprintf((char *) (&(str[cell++])),".");
-        }
-        snprintf((char *) (&(str[cell++])), 16, "%s",
-                 x_visual_type_abbrev(fbconfig_attribs[i].x_visual_type));
-        snprintf((char *) (&(str[cell++])), 16, "%3d",
-                 fbconfig_attribs[i].buffer_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].level);
-        snprintf((char *) (&(str[cell++])), 16, "%s",
-                 render_type_abbrev(fbconfig_attribs[i].render_type) );
-        snprintf((char *) (&(str[cell++])), 16, "%c",
-                 fbconfig_attribs[i].doublebuffer ? 'y' : '.');
-        snprintf((char *) (&(str[cell++])), 16, "%c",
-                 fbconfig_attribs[i].stereo ? 'y' : '.');
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].red_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].green_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].blue_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].alpha_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].aux_buffers);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].depth_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].stencil_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].accum_red_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].accum_green_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].accum_blue_size);
-        snprintf((char *) (&(str[cell++])), 16, "%2d",
-                 fbconfig_attribs[i].accum_alpha_size);
-        if (fbconfig_attribs[i].multi_sample_valid) {
-            snprintf((char *) (&(str[cell++])), 16, "%2d",
-                     fbconfig_attribs[i].multi_samples);
-            if (fbconfig_attribs[i].multi_sample_coverage_valid) {
-                snprintf((char *) (&(str[cell++])), 16, "%2d",
-                         fbconfig_attribs[i].multi_samples_color);
-            } else {
-                snprintf((char *) (&(str[cell++])), 16, "%2d",
-                         fbconfig_attribs[i].multi_samples);
-            }
-        } else {
-            snprintf((char *) (&(str[cell++])), 16, " 0");
-            snprintf((char *) (&(str[cell++])), 16, " 0");
-        }
-        snprintf((char *) (&(str[cell++])), 16, "%1d",
-                 fbconfig_attribs[i].multi_sample_buffers);
-        snprintf((char *) (&(str[cell++])), 16, "%s",
-                 caveat_abbrev( fbconfig_attribs[i].config_caveat) );
-        snprintf((char *) (&(str[cell++])), 16, "0x%04X",
-                 fbconfig_attribs[i].pbuffer_width);
-        snprintf((char *) (&(str[cell++])), 16, "0x%04X",
-                 fbconfig_attribs[i].pbuffer_height);
-        snprintf((char *) (&(str[cell++])), 16, "0x%07X",
-                 fbconfig_attribs[i].pbuffer_max);
-        snprintf((char *) (&(str[cell++])), 16, "%s",
-                 transparent_type_abbrev(fbconfig_attribs[i].transparent_type));
-        snprintf((char *) (&(str[cell++])), 16, "%3d",
-                 fbconfig_attribs[i].transparent_red_value);
-        snprintf((char *) (&(str[cell++])), 16, "%3d",
-                 fbconfig_attribs[i].transparent_green_value);
-        snprintf((char *) (&(str[cell++])), 16, "%3d",
-                 fbconfig_attribs[i].transparent_blue_value);
-        snprintf((char *) (&(str[cell++])), 16, "%3d",
-                 fbconfig_attribs[i].transparent_alpha_value);
-        snprintf((char *) (&(str[cell++])), 16, "%3d",
-                 fbconfig_attribs[i].transparent_index_value);
-        str[NUM_FBCONFIG_ATTRIBS][0] = '\0';
-
-        /* Populate cells for this row */
-        gtk_list_store_append (model, &iter);
-        for (cell=0; cell<NUM_FBCONFIG_ATTRIBS; cell++) {
-            g_value_set_string(&v, str[cell]);
-            gtk_list_store_set_value(model, &iter, cell, &v);
-        }
+    return GTK_TREE_MODEL(ctk_config_model_new(fbconfig_attribs,
+                                               sizeof(GLXFBConfigAttr),
+                                               num_fbconfigs,
+                                               NUM_FBCONFIG_ATTRIBS,
+                                               format_fbconfig_cell));
+}
 
-        i++;
 
-    } /* Done - Populating FBconfig table */
+/*
+ * format_egl_fbconfig_cell() - format one cell of the EGL Frame Buffer
+ * Configurations table; called by the model when the cell is drawn.
+ */
+static gchar *format_egl_fbconfig_cell(gconstpointer record, gint row,
+                                       gint column, gchar *buf)
+{
+    const EGLConfigAttr *cfg = record;
+    const int len = CTK_CONFIG_MODEL_CELL_LEN;
+
+    switch (column) {
+    case 0:  snprintf(buf, len, "0x%02X", cfg->config_id);        break;
+    case 1:  snprintf(buf, len, "0x%02X", cfg->native_visual_id); break;
+    case 2:  snprintf(buf, len, "0x%X", cfg->native_visual_type); break;
+    case 3:  snprintf(buf, len, "%d", cfg->buffer_size);          break;
+    case 4:  snprintf(buf, len, "%d", cfg->level);                break;
+    case 5:
+        snprintf(buf, len, "%s",
+                 egl_color_buffer_type_abbrev(cfg->color_buffer_type));
+        break;
+    case 6:  snprintf(buf, len, "%d", cfg->red_size);             break;
+    case 7:  snprintf(buf, len, "%d", cfg->green_size);           break;
+    case 8:  snprintf(buf, len, "%d", cfg->blue_size);            break;
+    case 9:  snprintf(buf, len, "%d", cfg->alpha_size);           break;
+    case 10: snprintf(buf, len, "%d", cfg->alpha_mask_size);      break;
+    case 11: snprintf(buf, len, "%d", cfg->luminance_size);       break;
+    case 12: snprintf(buf, len, "%d", cfg->depth_size);           break;
+    case 13: snprintf(buf, len, "%d", cfg->stencil_size);         break;
+    case 14:
+        snprintf(buf, len, "%c", cfg->bind_to_texture_rgb ? 'y' : '.');
+        break;
+    case 15:
+        snprintf(buf, len, "%c", cfg->bind_to_texture_rgba ? 'y' : '.');
+        break;
+    case 16: snprintf(buf, len, "0x%X", cfg->conformant);         break;
+    case 17: snprintf(buf, len, "%d", cfg->sample_buffers);       break;
+    case 18: snprintf(buf, len, "%d", cfg->samples);              break;
+    case 19:
+        snprintf(buf, len, "%s",
+                 egl_config_caveat_abbrev(cfg->config_caveat));
+        break;
+    case 20: snprintf(buf, len, "0x%04X", cfg->max_pbuffer_width);  break;
+    case 21: snprintf(buf, len, "0x%04X", cfg->max_pbuffer_height); break;
+    case 22: snprintf(buf, len, "0x%07X", cfg->max_pbuffer_pixels); break;
+    case 23: snprintf(buf, len, "%d", cfg->max_swap_interval);    break;
+    case 24: snprintf(buf, len, "%d", cfg->min_swap_interval);    break;
+    case 25:
+        snprintf(buf, len, "%c", cfg->native_renderable ? 'y' : '.');
+        break;
+    case 26: snprintf(buf, len, "0x%X", cfg->renderable_type);    break;
+    case 27: snprintf(buf, len, "0x%X", cfg->surface_type);       break;
+    case 28: snprintf(buf, len, "%d", cfg->transparent_type);     break;
+    case 29: snprintf(buf, len, "%d", cfg->transparent_red_value);   break;
+    case 30: snprintf(buf, len, "%d", cfg->transparent_green_value); break;
+    case 31: snprintf(buf, len, "%d", cfg->transparent_blue_value);  break;
+    }
 
-    return GTK_TREE_MODEL(model);
+    return NULL;
 }
 
 
 /*
- * create_egl_fbconfig_model() - called to create and populate the model for
- * the EGL Frame Buffer Configurations table.
+ * create_egl_fbconfig_model() - called to create the model for the EGL
+ * Frame Buffer Configurations table.  The model takes ownership of the
+ * egl_fbconfig_attribs array; cells are only formatted when they are drawn.
  */
 static GtkTreeModel*
-create_egl_fbconfig_model(EGLConfigAttr *egl_fbconfig_attribs)
+create_egl_fbconfig_model(EGLConfigAttr *egl_fbconfig_attribs,
+                          int num_fbconfigs)
 {
-    GtkListStore *model;
-    GtkTreeIter iter;
-    int i;
-    GValue v = G_VALUE_INIT;
-
     if (!egl_fbconfig_attribs) {
         return NULL;
     }
 
-    g_value_init(&v, G_TYPE_STRING);
-
-    model = gtk_list_store_new(NUM_EGL_FBCONFIG_ATTRIBS,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
-
-    /* Populate FBConfig table */
-    i = 0;
-    while ( egl_fbconfig_attribs[i].config_id != 0 ) {
-        char str[NUM_EGL_FBCONFIG_ATTRIBS + 1][16];
-        int  cell = 0;
-
-        snprintf((char*) (&(str[cell++])), 16, "0x%02X",
-            egl_fbconfig_attribs[i].config_id);
-        snprintf((char*) (&(str[cell++])), 16, "0x%02X",
-            egl_fbconfig_attribs[i].native_visual_id);
-
-        snprintf((char*) (&(str[cell++])), 16, "0x%X",
-            egl_fbconfig_attribs[i].native_visual_type);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].buffer_size);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].level);
-        snprintf((char*) (&(str[cell++])), 16, "%s",
-            egl_color_buffer_type_abbrev(
-                egl_fbconfig_attribs[i].color_buffer_type));
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].red_size);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].green_size);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].blue_size);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].alpha_size);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].alpha_mask_size);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].luminance_size);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].depth_size);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].stencil_size);
-        snprintf((char*) (&(str[cell++])), 16, "%c",
-            egl_fbconfig_attribs[i].bind_to_texture_rgb ? 'y' : '.');
-        snprintf((char*) (&(str[cell++])), 16, "%c",
-            egl_fbconfig_attribs[i].bind_to_texture_rgba ? 'y' : '.');
-        snprintf((char*) (&(str[cell++])), 16, "0x%X",
-            egl_fbconfig_attribs[i].conformant);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].sample_buffers);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].samples);
-        snprintf((char*) (&(str[cell++])), 16, "%s",
-            egl_config_caveat_abbrev(egl_fbconfig_attribs[i].config_caveat));
-        snprintf((char*) (&(str[cell++])), 16, "0x%04X",
-            egl_fbconfig_attribs[i].max_pbuffer_width);
-        snprintf((char*) (&(str[cell++])), 16, "0x%04X",
-            egl_fbconfig_attribs[i].max_pbuffer_height);
-        snprintf((char*) (&(str[cell++])), 16, "0x%07X",
-            egl_fbconfig_attribs[i].max_pbuffer_pixels);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].max_swap_interval);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].min_swap_interval);
-        snprintf((char*) (&(str[cell++])), 16, "%c",
-            egl_fbconfig_attribs[i].native_renderable ? 'y' : '.');
-        snprintf((char*) (&(str[cell++])), 16, "0x%X",
-            egl_fbconfig_attribs[i].renderable_type);
-        snprintf((char*) (&(str[cell++])), 16, "0x%X",
-            egl_fbconfig_attribs[i].surface_type);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].transparent_type);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].transparent_red_value);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].transparent_green_value);
-        snprintf((char*) (&(str[cell++])), 16, "%d",
-            egl_fbconfig_attribs[i].transparent_blue_value);
-
-
-        str[NUM_EGL_FBCONFIG_ATTRIBS][0] = '\0';
-
-        /* Populate cells for this row */
-        gtk_list_store_append (model, &iter);
-        for (cell=0; cell<NUM_EGL_FBCONFIG_ATTRIBS; cell++) {
-            g_value_set_string(&v, str[cell]);
-            gtk_list_store_set_value(model, &iter, cell, &v);
-        }
-
-        i++;
-
-    } /* Done - Populating FBconfig table */
-
-    return GTK_TREE_MODEL(model);
+    return GTK_TREE_MODEL(ctk_config_model_new(egl_fbconfig_attribs,
+                                               sizeof(EGLConfigAttr),
+                                               num_fbconfigs,
+                                               NUM_EGL_FBCONFIG_ATTRIBS,
+                                               format_egl_fbconfig_cell));
 }
 
 /* Creates the GLX information widget
@@ -793,10 +724,12 @@ GtkWidget* ctk_glx_new(CtrlTarget *ctrl_target,
         }
 
         /* Create data model and add view to the window */
-        fbc_model = create_fbconfig_model(fbconfig_attribs);
-        free(fbconfig_attribs);
+        fbc_model = create_fbconfig_model(fbconfig_attribs, num_fbconfigs);
 
         gtk_tree_view_set_model(GTK_TREE_VIEW(fbc_view), fbc_model);
+        ctk_config_model_set_fixed_sizing(CTK_CONFIG_MODEL(fbc_model),
+                                          GTK_TREE_VIEW(fbc_view),
+                                          FBCONFIG_SAMPLE_ROWS);
         g_object_unref(fbc_model);
 
         fbc_scroll_win = gtk_scrolled_window_new(NULL, NULL);
@@ -893,10 +826,13 @@ GtkWidget* ctk_glx_new(CtrlTarget *ctrl_target,
         }
 
         /* Create data model and add view to the window */
-        egl_fbc_model = create_egl_fbconfig_model(egl_fbconfig_attribs);
-        free(egl_fbconfig_attribs);
+        egl_fbc_model = create_egl_fbconfig_model(egl_fbconfig_attribs,
+                                                  num_fbconfigs);
 
         gtk_tree_view_set_model(GTK_TREE_VIEW(egl_fbc_view), egl_fbc_model);
+        ctk_config_model_set_fixed_sizing(CTK_CONFIG_MODEL(egl_fbc_model),
+                                          GTK_TREE_VIEW(egl_fbc_view),
+                                          FBCONFIG_SAMPLE_ROWS);
         g_object_unref(egl_fbc_model);
 
         egl_fbc_scroll_win = gtk_scrolled_window_new(NULL, NULL);
@@ -1435,37 +1371,107 @@ static char *setup_vulkan_format_feature_string(VkFormatFeatureFlags flags)
 
 
 
+/*
+ * format_vulkan_format_cell() - format one cell of the Vulkan Formats table;
+ * called by the model when the cell is drawn.
+ */
+static gchar *format_vulkan_format_cell(gconstpointer record, gint row,
+                                        gint column, gchar *buf)
+{
+    const VkFormatProperties *format = record;
+    VkFormatFeatureFlags flags;
+    char *str;
+    int i = 0;
+
+    switch (column) {
+    case 0:
+        snprintf(buf, CTK_CONFIG_MODEL_CELL_LEN, "%d", row);
+        return NULL;
+    case 1:
+        flags = format->linearTilingFeatures;
+        break;
+    case 2:
+        flags = format->bufferFeatures;
+        break;
+    default:
+        flags = format->optimalTilingFeatures;
+        break;
+    }
+
+    str = setup_vulkan_format_feature_string(flags);
+
+    /* Drop the leading separator */
+    while (isspace(str[i])) { i++; }
+    memmove(str, str + i, strlen(str + i) + 1);
+
+    return str;
+}
+
+
+
 /*
  * populate_vulkan_format()
  */
 static GtkWidget *populate_vulkan_formats(VkDeviceAttr *vkdp, int i)
 {
-    int j;
-    int row = 5;
-    char *str;
-    GtkWidget *table = gtk_table_new(row, 2, FALSE);
+    const char *titles[] = { "Index", "Linear", "Buffer", "Optimal" };
+    const int num_columns = ARRAY_LEN(titles);
     GtkWidget *expander = gtk_expander_new("Formats");
     GtkWidget *ibox = gtk_hbox_new(FALSE, 0);
+    GtkWidget *scroll_win;
+    GtkWidget *view;
+    GtkTreeModel *model;
+    VkFormatProperties *formats;
+    int j;
 
-    gtk_table_set_row_spacings(GTK_TABLE(table), 3);
-    gtk_table_set_col_spacings(GTK_TABLE(table), 15);
-    gtk_box_pack_start(GTK_BOX(ibox), table, FALSE, FALSE, INDENT_SIZE);
-    gtk_container_add(GTK_CONTAINER(expander), ibox);
+    /*
+     * The device attributes are freed once the page is populated, so the
+     * model keeps its own copy of the (plain data) format properties.
+     */
+    formats = nvalloc((vkdp->formats_count[i] + 1) *
+                      sizeof(VkFormatProperties));
+    memcpy(formats, vkdp->formats[i],
+           vkdp->formats_count[i] * sizeof(VkFormatProperties));
+
+    model = GTK_TREE_MODEL(ctk_config_model_new(formats,
+                                                sizeof(VkFormatProperties),
+                                                vkdp->formats_count[i],
+                                                num_columns,
+                                                format_vulkan_format_cell));
+
+    view = gtk_tree_view_new_with_model(model);
+
+    for (j = 0; j < num_columns; j++) {
+        GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
+        GtkTreeViewColumn *col;
+
+        ctk_cell_renderer_set_alignment(renderer, 0.0, 0.0);
+        col = gtk_tree_view_column_new_with_attributes(titles[j], renderer,
+                                                       "text", j, NULL);
+        gtk_tree_view_insert_column(GTK_TREE_VIEW(view), col, -1);
+    }
 
-    for (j = 0; j < vkdp->formats_count[i]; j++) {
-        add_str(table, row++, "Index", nvasprintf("%d", j));
-        str = setup_vulkan_format_feature_string(
-                  vkdp->formats[i][j].linearTilingFeatures);
-        add_str(table, row++, "Linear", str);
-        str = setup_vulkan_format_feature_string(
-                  vkdp->formats[i][j].bufferFeatures);
-        add_str(table, row++, "Buffer", str);
-        str = setup_vulkan_format_feature_string(
-                  vkdp->formats[i][j].optimalTilingFeatures);
-        add_str(table, row++, "Optimal", str);
+    /*
+     * The feature cells have one line per feature, so every row is measured
+     * for the row height; there are only a few hundred formats.
+     */
+    ctk_config_model_set_fixed_sizing(CTK_CONFIG_MODEL(model),
+                                      GTK_TREE_VIEW(view), -1);
+    g_object_unref(model);
+
+    /*
+     * Only the visible rows are formatted, as long as the view is given a
+     * bounded height rather than growing to fit every format.
+     */
+    scroll_win = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll_win),
+                                   GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    gtk_widget_set_size_request(scroll_win, -1, 300);
+    gtk_container_add(GTK_CONTAINER(scroll_win), view);
+
+    gtk_box_pack_start(GTK_BOX(ibox), scroll_win, TRUE, TRUE, INDENT_SIZE);
+    gtk_container_add(GTK_CONTAINER(expander), ibox);
 
-        add_str_const(table, row++, "", "");
-    }
     return expander;
 }
 
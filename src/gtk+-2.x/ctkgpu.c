@@ -37,6 +37,8 @@
 
 static void probe_displays_received(GObject *object, CtrlEvent *event,
                                     gpointer user_data);
+static void performance_state_received(GObject *object, CtrlEvent *event,
+                                       gpointer user_data);
 static gboolean update_gpu_usage(gpointer);
 
 #define ARRAY_ELEMENTS 16
@@ -188,18 +190,19 @@ gchar *get_bus_id_str(CtrlTarget *ctrl_target)
 }
 
 
-static void apply_gpu_utilization_token(char *token, char *value, void *data)
+static void apply_gpu_utilization_token(ParseSlice token, ParseSlice value,
+                                        void *data)
 {
     utilizationEntryPtr pEntry = (utilizationEntryPtr) data;
 
-    if (!strcasecmp("graphics", token)) {
-        pEntry->graphics = atoi(value);
+    if (parse_slice_strcasecmp(token, "graphics")) {
+        pEntry->graphics = parse_slice_atoi(value);
         pEntry->graphics_specified = TRUE;
-    } else if (!strcasecmp("video", token)) {
-        pEntry->video = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "video")) {
+        pEntry->video = parse_slice_atoi(value);
         pEntry->video_specified = TRUE;
-    } else if (!strcasecmp("pcie", token)) {
-        pEntry->pcie = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "pcie")) {
+        pEntry->pcie = parse_slice_atoi(value);
         pEntry->pcie_specified = TRUE;
     }
 }
@@ -362,7 +365,7 @@ GtkWidget* ctk_gpu_new(CtrlTarget *ctrl_target,
                                    NV_CTRL_STRING_GPU_UTILIZATION,
                                    &tmp_str);
     if (ret == NvCtrlSuccess) {
-        parse_token_value_pairs(tmp_str, apply_gpu_utilization_token, &entry);
+        parse_token_value_slices(tmp_str, apply_gpu_utilization_token, &entry);
         free(tmp_str);
     }
 
@@ -655,6 +658,14 @@ GtkWidget* ctk_gpu_new(CtrlTarget *ctrl_target,
                      CTK_EVENT_NAME(NV_CTRL_PROBE_DISPLAYS),
                      G_CALLBACK(probe_displays_received),
                      (gpointer) ctk_gpu);
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL),
+                     G_CALLBACK(performance_state_received),
+                     (gpointer) ctk_gpu);
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS),
+                     G_CALLBACK(performance_state_received),
+                     (gpointer) ctk_gpu);
 
     tmp_str = g_strdup_printf("Memory Used (GPU %d)",
                               NvCtrlGetTargetId(ctrl_target));
@@ -843,6 +854,25 @@ static void probe_displays_received(GObject *object,
 
 
 
+/*
+ * A change of performance level or clocks follows a change in load, so
+ * the usage is read again right away while the page is shown.  Memory use
+ * and utilization have no event of their own, and the timer still polls
+ * them.
+ */
+static void performance_state_received(GObject *object,
+                                       CtrlEvent *event,
+                                       gpointer user_data)
+{
+    CtkGpu *ctk_gpu = CTK_GPU(user_data);
+
+    if (gtk_widget_get_mapped(GTK_WIDGET(ctk_gpu))) {
+        update_gpu_usage(ctk_gpu);
+    }
+}
+
+
+
 static gboolean update_gpu_usage(gpointer user_data)
 {
     CtkGpu *ctk_gpu;
@@ -896,8 +926,8 @@ static gboolean update_gpu_usage(gpointer user_data)
     }
 
     memset(&entry, 0, sizeof(entry));
-    parse_token_value_pairs(utilizationStr, apply_gpu_utilization_token,
-                            &entry);
+    parse_token_value_slices(utilizationStr, apply_gpu_utilization_token,
+                             &entry);
     if ((entry.graphics_specified) &&
         (ctk_gpu->gpu_utilization_label)) {
         utilization_text = g_strdup_printf("%d %%",
@@ -45,6 +45,9 @@ static void powermizer_menu_changed(GtkWidget*, gpointer);
 static void update_powermizer_menu_event(GObject *object,
                                          gpointer arg1,
                                          gpointer user_data);
+static void powermizer_info_event_received(GObject *object,
+                                           gpointer arg1,
+                                           gpointer user_data);
 static void post_set_attribute_offset_value(CtkPowermizer *ctk_powermizer,
                                             gint attribute,
                                             gint val);
@@ -184,35 +187,36 @@ typedef struct {
 } perfModeEntry, * perfModeEntryPtr;
 
 
-static void apply_perf_mode_token(char *token, char *value, void *data)
+static void apply_perf_mode_token(ParseSlice token, ParseSlice value,
+                                  void *data)
 {
     perfModeEntryPtr pEntry = (perfModeEntryPtr) data;
 
-    if (!strcasecmp("perf", token)) {
-        pEntry->perf_level = atoi(value);
+    if (parse_slice_strcasecmp(token, "perf")) {
+        pEntry->perf_level = parse_slice_atoi(value);
         pEntry->perf_level_specified = TRUE;
-    } else if (!strcasecmp("nvclock", token)) {
-        pEntry->nvclock = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "nvclock")) {
+        pEntry->nvclock = parse_slice_atoi(value);
         pEntry->nvclock_specified = TRUE;
-    } else if (!strcasecmp("nvclockmin", token)) {
-        pEntry->nvclockmin = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "nvclockmin")) {
+        pEntry->nvclockmin = parse_slice_atoi(value);
         pEntry->nvclockmin_specified = TRUE;
-    } else if (!strcasecmp("nvclockmax", token)) {
-        pEntry->nvclockmax = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "nvclockmax")) {
+        pEntry->nvclockmax = parse_slice_atoi(value);
         pEntry->nvclockmax_specified = TRUE;
-    } else if (!strcasecmp("nvclockeditable", token)) {
-        pEntry->nvclockeditable = atoi(value);
-    } else if (!strcasecmp("memtransferrate", token)) {
-        pEntry->memtransferrate = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "nvclockeditable")) {
+        pEntry->nvclockeditable = parse_slice_atoi(value);
+    } else if (parse_slice_strcasecmp(token, "memtransferrate")) {
+        pEntry->memtransferrate = parse_slice_atoi(value);
         pEntry->memtransferrate_specified = TRUE;
-    } else if (!strcasecmp("memtransferratemin", token)) {
-        pEntry->memtransferratemin = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "memtransferratemin")) {
+        pEntry->memtransferratemin = parse_slice_atoi(value);
         pEntry->memtransferratemin_specified = TRUE;
-    } else if (!strcasecmp("memtransferratemax", token)) {
-        pEntry->memtransferratemax = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "memtransferratemax")) {
+        pEntry->memtransferratemax = parse_slice_atoi(value);
         pEntry->memtransferratemax_specified = TRUE;
-    } else if (!strcasecmp("memtransferrateeditable", token)) {
-        pEntry->memtransferrateeditable = atoi(value);
+    } else if (parse_slice_strcasecmp(token, "memtransferrateeditable")) {
+        pEntry->memtransferrateeditable = parse_slice_atoi(value);
     }
 }
 
@@ -636,8 +640,8 @@ static void update_perf_mode_table(CtkPowermizer *ctk_powermizer,
         /* Invalidate perf mode entry */
         memset(pEntry + index, 0, sizeof(*pEntry));
 
-        parse_token_value_pairs(tokens, apply_perf_mode_token,
-                                (void *) &pEntry[index]);
+        parse_token_value_slices(tokens, apply_perf_mode_token,
+                                 (void *) &pEntry[index]);
 
         /* Only add complete perf mode entries */
         if (pEntry[index].perf_level_specified &&
@@ -953,8 +957,8 @@ static gboolean update_powermizer_info(gpointer user_data)
         /* Invalidate the entries */
         memset(&pEntry, 0, sizeof(pEntry));
 
-        parse_token_value_pairs(clock_string, apply_perf_mode_token,
-                                &pEntry);
+        parse_token_value_slices(clock_string, apply_perf_mode_token,
+                                 &pEntry);
 
         if (pEntry.nvclock_specified) {
             gpu_clock = pEntry.nvclock;
@@ -1210,8 +1214,8 @@ GtkWidget* ctk_powermizer_new(CtrlTarget *ctrl_target,
         /* Invalidate the entries */
         memset(&pEntry, 0, sizeof(pEntry));
 
-        parse_token_value_pairs(clock_string, apply_perf_mode_token,
-                                &pEntry);
+        parse_token_value_slices(clock_string, apply_perf_mode_token,
+                                 &pEntry);
 
         if (pEntry.nvclock_specified) {
             gpu_clock_available = TRUE;
@@ -1670,6 +1674,25 @@ GtkWidget* ctk_powermizer_new(CtrlTarget *ctrl_target,
                      G_CALLBACK(update_powermizer_menu_event),
                      (gpointer) ctk_powermizer);
 
+    /*
+     * Clock, performance level and power source changes are pushed when the
+     * event source can report them (e.g. NVML events); the timer above still
+     * refreshes the values that can only be polled.
+     */
+
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS),
+                     G_CALLBACK(powermizer_info_event_received),
+                     (gpointer) ctk_powermizer);
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL),
+                     G_CALLBACK(powermizer_info_event_received),
+                     (gpointer) ctk_powermizer);
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_GPU_POWER_SOURCE),
+                     G_CALLBACK(powermizer_info_event_received),
+                     (gpointer) ctk_powermizer);
+
     if (nvclock_attribute == NV_CTRL_GPU_NVCLOCK_OFFSET_ALL_PERFORMANCE_LEVELS) {
         g_signal_connect(G_OBJECT(ctk_event),
                          CTK_EVENT_NAME(NV_CTRL_GPU_NVCLOCK_OFFSET_ALL_PERFORMANCE_LEVELS),
@@ -1724,6 +1747,17 @@ static void update_powermizer_menu_event(GObject *object,
 
 
 
+static void powermizer_info_event_received(GObject *object,
+                                           gpointer arg1,
+                                           gpointer user_data)
+{
+    CtkPowermizer *ctk_powermizer = CTK_POWERMIZER(user_data);
+
+    update_powermizer_info(ctk_powermizer);
+}
+
+
+
 static void set_powermizer_menu_label_txt(CtkPowermizer *ctk_powermizer,
                                           gint powerMizerMode)
 {
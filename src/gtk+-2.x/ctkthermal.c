@@ -40,6 +40,8 @@ static void cooler_control_state_update_gui(CtkThermal *ctk_thermal);
 static void cooler_control_checkbox_toggled(GtkWidget *widget, gpointer user_data);
 static void cooler_operating_level_changed(GObject *object, CtrlEvent *event,
                                            gpointer user_data);
+static void performance_state_received(GObject *object, CtrlEvent *event,
+                                       gpointer user_data);
 static void apply_button_clicked(GtkWidget *widget, gpointer user_data);
 static void reset_button_clicked(GtkWidget *widget, gpointer user_data);
 static void adjustment_value_changed(GtkAdjustment *adjustment,
@@ -560,6 +562,28 @@ static void cooler_control_state_received(GObject *object,
 
 
 
+/*****
+ *
+ * Signal handler - Called when the performance level or the clocks of the
+ * GPU change.  A thermal slowdown shows up as such a change, so the
+ * temperatures are read again right away instead of on the next timer
+ * tick; there is no temperature event, so the timer still polls them.
+ *
+ */
+static void performance_state_received(GObject *object,
+                                       CtrlEvent *event,
+                                       gpointer user_data)
+{
+    CtkThermal *ctk_thermal = CTK_THERMAL(user_data);
+
+    if (gtk_widget_get_mapped(GTK_WIDGET(ctk_thermal))) {
+        update_thermal_info(ctk_thermal);
+    }
+
+} /* performance_state_received() */
+
+
+
 /****
  *
  * Updates sensitivity of widgets in relation to the state
@@ -1122,6 +1146,56 @@ static void draw_sensor_gui(GtkWidget *vbox1, CtkThermal *ctk_thermal,
 
 
 
+/*
+ * ctk_thermal_sensor_target_type_supported() - whether thermal sensors and
+ * coolers can be queried per sensor target, rather than only through
+ * NV_CTRL_GPU_CORE_TEMPERATURE.  Also used to probe for the page before it
+ * is built.
+ */
+
+gboolean ctk_thermal_sensor_target_type_supported(CtrlTarget *ctrl_target)
+{
+    ReturnStatus ret, ret1;
+    int major = 0, minor = 0;
+    int cuda = 0, nvmlMajor = 0, nvmlMinor = 0;
+    char *nvml_version = NULL;
+    gboolean supported = FALSE;
+
+    /* 
+     * Check for NV-CONTROL protocol version. 
+     * In version 1.23 we added support for querying per sensor information
+     * This used for backward compatibility between new nvidia-settings
+     * and older X driver
+     */ 
+    ret = NvCtrlGetAttribute(ctrl_target,
+                             NV_CTRL_ATTR_NV_MAJOR_VERSION, &major);
+    ret1 = NvCtrlGetAttribute(ctrl_target,
+                              NV_CTRL_ATTR_NV_MINOR_VERSION, &minor);
+
+    if ((ret == NvCtrlSuccess) && (ret1 == NvCtrlSuccess) &&
+        ((major > 1) || ((major == 1) && (minor > 22)))) {
+        supported = TRUE;
+    }
+
+    /* Also supported based on NVML version. */
+    NvCtrlGetStringAttribute(ctrl_target,
+                             NV_CTRL_STRING_NVML_VERSION,
+                             &nvml_version);
+
+    /* NVML version is of form <Max CUDA Supported> DOT <MAJOR> DOT <MINOR> */
+    if (nvml_version &&
+        (sscanf(nvml_version, "%d.%d.%d", &cuda, &nvmlMajor, &nvmlMinor) == 3) &&
+        (nvmlMajor >= 565)) {
+        supported = TRUE;
+    }
+    free(nvml_version);
+
+    return supported;
+
+} /* ctk_thermal_sensor_target_type_supported() */
+
+
+
 GtkWidget* ctk_thermal_new(CtrlTarget *ctrl_target,
                            CtkConfig *ctk_config,
                            CtkEvent *ctk_event)
@@ -1139,7 +1213,6 @@ GtkWidget* ctk_thermal_new(CtrlTarget *ctrl_target,
     GtkWidget *scale;
     GtkWidget *alignment;
     ReturnStatus ret;
-    ReturnStatus ret1;
     CtrlTarget *cooler_target;
     CtrlTarget *sensor_target;
     CtrlAttributeValidValues cooler_range;
@@ -1154,48 +1227,19 @@ GtkWidget* ctk_thermal_new(CtrlTarget *ctrl_target,
     int *pDataCooler = NULL, *pDataSensor = NULL;
     gint cooler_count = 0, sensor_count = 0;
     int len, value;
-    int major = 0, minor = 0;
     Bool can_access_cooler_level;
     Bool cooler_control_enabled;
     int cur_cooler_idx = 0;
     int cur_sensor_idx = 0;
     Bool thermal_sensor_target_type_supported = FALSE;
-    gchar *nvml_version = NULL;
-    int cuda = 0, nvmlMajor = 0, nvmlMinor = 0;
 
     /* make sure we have a handle */
 
     g_return_val_if_fail((ctrl_target != NULL) &&
                          (ctrl_target->h != NULL), NULL);
 
-    /* 
-     * Check for NV-CONTROL protocol version. 
-     * In version 1.23 we added support for querying per sensor information
-     * This used for backward compatibility between new nvidia-settings
-     * and older X driver
-     */ 
-    ret = NvCtrlGetAttribute(ctrl_target,
-                             NV_CTRL_ATTR_NV_MAJOR_VERSION, &major);
-    ret1 = NvCtrlGetAttribute(ctrl_target,
-                              NV_CTRL_ATTR_NV_MINOR_VERSION, &minor);
-
-    if ((ret == NvCtrlSuccess) && (ret1 == NvCtrlSuccess) &&
-        ((major > 1) || ((major == 1) && (minor > 22)))) {
-        thermal_sensor_target_type_supported = TRUE;
-    }
-
-    /* Set thermal_sensor_target_type_supported flag based on NVML version. */
-    NvCtrlGetStringAttribute(ctrl_target,
-                             NV_CTRL_STRING_NVML_VERSION,
-                             &nvml_version);
-
-    /* NVML version is of form <Max CUDA Supported> DOT <MAJOR> DOT <MINOR> */
-    if (nvml_version &&
-        (sscanf(nvml_version, "%d.%d.%d", &cuda, &nvmlMajor, &nvmlMinor) == 3) &&
-        (nvmlMajor >= 565)) {
-        thermal_sensor_target_type_supported = TRUE;
-    }
-    free(nvml_version);
+    thermal_sensor_target_type_supported =
+        ctk_thermal_sensor_target_type_supported(ctrl_target);
 
     if (!thermal_sensor_target_type_supported) {
         /* check if this screen supports thermal querying */
@@ -1679,6 +1723,15 @@ end:
     
     sync_gui_to_modify_cooler_level(ctk_thermal);
     update_thermal_info(ctk_thermal);
+
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL),
+                     G_CALLBACK(performance_state_received),
+                     (gpointer) ctk_thermal);
+    g_signal_connect(G_OBJECT(ctk_event),
+                     CTK_EVENT_NAME(NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS),
+                     G_CALLBACK(performance_state_received),
+                     (gpointer) ctk_thermal);
     
     /* Register a timer callback to update the temperatures */
 
@@ -121,6 +121,8 @@ GType          ctk_thermal_get_type    (void) G_GNUC_CONST;
 GtkWidget*     ctk_thermal_new         (CtrlTarget *, CtkConfig *, CtkEvent *);
 GtkTextBuffer* ctk_thermal_create_help (GtkTextTagTable *, CtkThermal *);
 
+gboolean       ctk_thermal_sensor_target_type_supported(CtrlTarget *);
+
 void           ctk_thermal_start_timer (GtkWidget *);
 void           ctk_thermal_stop_timer  (GtkWidget *);
 
@@ -40,14 +40,15 @@ char *ctk_get_display(void)
 void ctk_main(ParsedAttribute *p,
               ConfigProperties *conf,
               CtrlSystem *system,
-              const char *page)
+              const char *page,
+              int startup_profile)
 {
     GList *list = NULL;
     GtkWidget *window;
 
     list = g_list_append (list, CTK_LOAD_PIXBUF(nvidia_icon));
     gtk_window_set_default_icon_list(list);
-    window = ctk_window_new(p, conf, system);
+    window = ctk_window_new(p, conf, system, startup_profile);
 
     ctk_window_set_active_page(CTK_WINDOW(window), page);
 
@@ -31,7 +31,8 @@ char *ctk_get_display(void);
 void ctk_main(ParsedAttribute*,
               ConfigProperties*,
               CtrlSystem*,
-              const char *page);
+              const char *page,
+              int startup_profile);
 
 
 #endif /* __CTK_UI_H__ */
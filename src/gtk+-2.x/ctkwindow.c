@@ -81,6 +81,7 @@ enum {
     CTK_WINDOW_CONFIG_FILE_ATTRIBUTES_FUNC_COLUMN,
     CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN,
     CTK_WINDOW_UNSELECT_WIDGET_FUNC_COLUMN,
+    CTK_WINDOW_PENDING_PAGE_COLUMN,
     CTK_WINDOW_NUM_COLUMNS
 };
 
@@ -88,6 +89,7 @@ enum {
 typedef struct {
     CtkWindow *window;
     CtrlTarget *gpu_target;
+    CtkEvent *gpu_event;
     GtkTextTagTable *tag_table;
 
     GtkTreeIter parent_iter;
@@ -103,6 +105,38 @@ typedef void (*config_file_attributes_func_t)(GtkWidget *, ParsedAttribute *);
 typedef void (*select_widget_func_t)(GtkWidget *);
 typedef void (*unselect_widget_func_t)(GtkWidget *);
 
+
+/*
+ * Pages that are not needed to show the window are not built until they
+ * are first selected, or prefetched once the window is shown (see
+ * prefetch_pages()).  Only their entries in the tree are created up front,
+ * each holding a CtkPendingPage that describes how to build the page.  A
+ * page's probe, if any, is a cheap check of whether the page is available
+ * at all, so that the tree only lists pages that can be shown.
+ */
+
+typedef struct {
+    CtkWindow *ctk_window;
+    CtrlTarget *target;
+    CtkEvent *ctk_event;
+} CtkPageArgs;
+
+typedef gboolean (*probe_page_func_t)(CtrlTarget *);
+typedef GtkWidget *(*build_page_func_t)(const CtkPageArgs *,
+                                        GtkTextBuffer **);
+
+typedef struct {
+    probe_page_func_t probe_func;
+    build_page_func_t build_func;
+    select_widget_func_t select_func;
+    unselect_widget_func_t unselect_func;
+} CtkPageFactory;
+
+typedef struct {
+    const CtkPageFactory *factory;
+    CtkPageArgs args;
+} CtkPendingPage;
+
 static void ctk_window_class_init(CtkWindowClass *, gpointer);
 
 #ifdef CTK_GTK3
@@ -117,6 +151,16 @@ static void add_page(GtkWidget *, GtkTextBuffer *, CtkWindow *,
                      select_widget_func_t load_func,
                      unselect_widget_func_t unload_func);
 
+static gboolean add_lazy_page(const CtkPageFactory *factory,
+                              CtkWindow *ctk_window, GtkTreeIter *iter,
+                              GtkTreeIter *child_iter, const gchar *label,
+                              CtrlTarget *target, CtkEvent *ctk_event);
+
+static void build_pending_page(CtkWindow *ctk_window, GtkTreeIter *iter,
+                               const gchar *how);
+
+static void startup_profile_mark(CtkWindow *ctk_window, const gchar *label);
+
 static GtkWidget *create_quit_dialog(CtkWindow *ctk_window);
 
 static void quit_response(GtkWidget *, gint, gpointer);
@@ -199,6 +243,46 @@ static void ctk_window_class_init(CtkWindowClass *ctk_window_class,
 
 
 
+/*
+ * free_pending_pages() - free the CtkPendingPage of every page that was
+ * never built.  The tree store goes away with the tree view, so it is
+ * forgotten here and this is only done the first time the window is
+ * destroyed.
+ */
+
+static gboolean free_pending_page_callback(GtkTreeModel *model,
+                                           GtkTreePath *path,
+                                           GtkTreeIter *iter,
+                                           gpointer data)
+{
+    CtkPendingPage *pending;
+
+    gtk_tree_model_get(model, iter, CTK_WINDOW_PENDING_PAGE_COLUMN, &pending,
+                       -1);
+    if (pending) {
+        gtk_tree_store_set(GTK_TREE_STORE(model), iter,
+                           CTK_WINDOW_PENDING_PAGE_COLUMN, NULL,
+                           -1);
+        nvfree(pending);
+    }
+
+    return FALSE; /* keep walking the tree */
+}
+
+static void free_pending_pages(CtkWindow *ctk_window)
+{
+    if (!ctk_window->tree_store) {
+        return;
+    }
+
+    gtk_tree_model_foreach(GTK_TREE_MODEL(ctk_window->tree_store),
+                           free_pending_page_callback, NULL);
+    ctk_window->tree_store = NULL;
+
+} /* free_pending_pages() */
+
+
+
 /*
  * ctk_window_real_destroy() - quit gtk.  XXX Maybe we should write
  * the configuration file here?
@@ -207,6 +291,15 @@ static void ctk_window_class_init(CtkWindowClass *ctk_window_class,
 #ifdef CTK_GTK3
 static void ctk_window_real_destroy(GtkWidget *object)
 {
+    CtkWindow *ctk_window = CTK_WINDOW(object);
+
+    if (ctk_window->prefetch_source) {
+        g_source_remove(ctk_window->prefetch_source);
+        ctk_window->prefetch_source = 0;
+    }
+
+    free_pending_pages(ctk_window);
+
     GTK_WIDGET_CLASS(parent_class)->destroy(object);
     gtk_main_quit();
 
@@ -214,6 +307,15 @@ static void ctk_window_real_destroy(GtkWidget *object)
 #else
 static void ctk_window_real_destroy(GtkObject *object)
 {
+    CtkWindow *ctk_window = CTK_WINDOW(object);
+
+    if (ctk_window->prefetch_source) {
+        g_source_remove(ctk_window->prefetch_source);
+        ctk_window->prefetch_source = 0;
+    }
+
+    free_pending_pages(ctk_window);
+
     GTK_OBJECT_CLASS(parent_class)->destroy(object);
     gtk_main_quit();
 
@@ -373,6 +475,10 @@ static void tree_selection_changed(GtkTreeSelection *selection,
     if (!gtk_tree_selection_get_selected(selection, &model, &iter))
         return;
 
+    /* Build the page, if this is the first time it is selected */
+
+    build_pending_page(ctk_window, &iter, "on selection");
+
     gtk_tree_model_get(model, &iter, CTK_WINDOW_WIDGET_COLUMN, &widget, -1);
     gtk_tree_model_get(model, &iter, CTK_WINDOW_HELP_COLUMN, &help, -1);
     gtk_tree_model_get(model, &iter, CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN,
@@ -461,12 +567,335 @@ static gboolean has_randr_gamma(CtrlTarget *target)
     return ((ret == NvCtrlSuccess) && (val == 1));
 }
 
+
+
+/*
+ * Page probes: cheap checks of whether the corresponding page's
+ * constructor may succeed.  These may report a page as available when the
+ * constructor later finds it is not (build_pending_page() then shows a
+ * placeholder), but never the other way around.
+ */
+
+static gboolean probe_thermal(CtrlTarget *target)
+{
+    ReturnStatus ret;
+    int val, len;
+    int *pData = NULL;
+    gboolean available = FALSE;
+
+    /* Same checks as ctk_thermal_new() */
+
+    if (!ctk_thermal_sensor_target_type_supported(target)) {
+        ret = NvCtrlGetAttribute(target, NV_CTRL_GPU_CORE_TEMPERATURE, &val);
+        return (ret == NvCtrlSuccess);
+    }
+
+    /* Otherwise, the page needs at least one sensor or cooler */
+
+    ret = NvCtrlGetBinaryAttribute(target, 0,
+                                   NV_CTRL_BINARY_DATA_THERMAL_SENSORS_USED_BY_GPU,
+                                   (unsigned char **)(&pData), &len);
+    if (ret == NvCtrlSuccess) {
+        available = (pData[0] > 0);
+    }
+    free(pData);
+    pData = NULL;
+
+    if (available) {
+        return TRUE;
+    }
+
+    ret = NvCtrlGetBinaryAttribute(target, 0,
+                                   NV_CTRL_BINARY_DATA_COOLERS_USED_BY_GPU,
+                                   (unsigned char **)(&pData), &len);
+    if (ret == NvCtrlSuccess) {
+        available = (pData[0] > 0);
+    }
+    free(pData);
+
+    return available;
+}
+
+static void probe_nvclock_token(ParseSlice token, ParseSlice value,
+                                void *data)
+{
+    gboolean *nvclock_specified = data;
+
+    if (parse_slice_strcasecmp(token, "nvclock")) {
+        *nvclock_specified = TRUE;
+    }
+}
+
+static gboolean probe_powermizer(CtrlTarget *target)
+{
+    ReturnStatus ret;
+    int val;
+    char *clock_string = NULL;
+    gboolean nvclock_specified = FALSE;
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL,
+                             &val);
+    if (ret == NvCtrlSuccess) {
+        return TRUE;
+    }
+
+    /* As in ctk_powermizer_new(), the clock string must report nvclock */
+
+    ret = NvCtrlGetStringAttribute(target,
+                                   NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS,
+                                   &clock_string);
+    if (ret == NvCtrlSuccess) {
+        parse_token_value_slices(clock_string, probe_nvclock_token,
+                                 &nvclock_specified);
+    }
+    free(clock_string);
+
+    return nvclock_specified;
+}
+
+static gboolean probe_ecc(CtrlTarget *target)
+{
+    ReturnStatus ret;
+    int val;
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_GPU_ECC_SUPPORTED, &val);
+
+    return ((ret == NvCtrlSuccess) && (val == NV_CTRL_GPU_ECC_SUPPORTED_TRUE));
+}
+
+static gboolean probe_xvideo(CtrlTarget *target)
+{
+    ReturnStatus ret;
+    int val;
+    gboolean present = FALSE;
+
+    /*
+     * As in ctk_xvideo_new(), the page only has settings for the texture
+     * and blitter adaptors, and only if sync to display is available.
+     */
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_ATTR_EXT_XV_TEXTURE_PRESENT,
+                             &val);
+    if ((ret == NvCtrlSuccess) && val) {
+        present = TRUE;
+    }
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_ATTR_EXT_XV_BLITTER_PRESENT,
+                             &val);
+    if ((ret == NvCtrlSuccess) && val) {
+        present = TRUE;
+    }
+
+    if (!present) {
+        return FALSE;
+    }
+
+    ret = NvCtrlGetAttribute(target, NV_CTRL_XV_SYNC_TO_DISPLAY_ID, &val);
+
+    return (ret == NvCtrlSuccess);
+}
+
+
+
+/*
+ * Page builders: construct a page and its help text from the arguments
+ * that were given when its entry was added to the tree.
+ */
+
+static GtkWidget *build_gpu_page(const CtkPageArgs *args,
+                                 GtkTextBuffer **help)
+{
+    GtkWidget *widget = ctk_gpu_new(args->target, args->ctk_event,
+                                    args->ctk_window->ctk_config);
+    if (widget) {
+        *help = ctk_gpu_create_help(args->ctk_window->help_tag_table,
+                                    CTK_GPU(widget));
+    }
+    return widget;
+}
+
+static GtkWidget *build_screen_page(const CtkPageArgs *args,
+                                    GtkTextBuffer **help)
+{
+    GtkWidget *widget = ctk_screen_new(args->target, args->ctk_event);
+    if (widget) {
+        char *screen_name = NvCtrlGetDisplayName(args->target);
+        *help = ctk_screen_create_help(args->ctk_window->help_tag_table,
+                                       CTK_SCREEN(widget), screen_name);
+        free(screen_name);
+    }
+    return widget;
+}
+
+static GtkWidget *build_thermal_page(const CtkPageArgs *args,
+                                     GtkTextBuffer **help)
+{
+    GtkWidget *widget = ctk_thermal_new(args->target,
+                                        args->ctk_window->ctk_config,
+                                        args->ctk_event);
+    if (widget) {
+        *help = ctk_thermal_create_help(args->ctk_window->help_tag_table,
+                                        CTK_THERMAL(widget));
+    }
+    return widget;
+}
+
+static GtkWidget *build_powermizer_page(const CtkPageArgs *args,
+                                        GtkTextBuffer **help)
+{
+    GtkWidget *widget = ctk_powermizer_new(args->target,
+                                           args->ctk_window->ctk_config,
+                                           args->ctk_event);
+    if (widget) {
+        *help = ctk_powermizer_create_help(args->ctk_window->help_tag_table,
+                                           CTK_POWERMIZER(widget));
+    }
+    return widget;
+}
+
+static GtkWidget *build_ecc_page(const CtkPageArgs *args,
+                                 GtkTextBuffer **help)
+{
+    GtkWidget *widget = ctk_ecc_new(args->target,
+                                    args->ctk_window->ctk_config,
+                                    args->ctk_event);
+    if (widget) {
+        *help = ctk_ecc_create_help(args->ctk_window->help_tag_table,
+                                    CTK_ECC(widget));
+    }
+    return widget;
+}
+
+static GtkWidget *build_xvideo_page(const CtkPageArgs *args,
+                                    GtkTextBuffer **help)
+{
+    GtkWidget *widget = ctk_xvideo_new(args->target,
+                                       args->ctk_window->ctk_config,
+                                       args->ctk_event);
+    if (widget) {
+        *help = ctk_xvideo_create_help(args->ctk_window->help_tag_table,
+                                       CTK_XVIDEO(widget));
+    }
+    return widget;
+}
+
+static GtkWidget *build_glx_page(const CtkPageArgs *args,
+                                 GtkTextBuffer **help)
+{
+    GtkWidget *widget = ctk_glx_new(args->target,
+                                    args->ctk_window->ctk_config,
+                                    args->ctk_event);
+    if (widget) {
+        *help = ctk_glx_create_help(args->ctk_window->help_tag_table,
+                                    CTK_GLX(widget));
+    }
+    return widget;
+}
+
+static GtkWidget *build_app_profile_page(const CtkPageArgs *args,
+                                         GtkTextBuffer **help)
+{
+    GtkWidget *widget = ctk_app_profile_new(args->target,
+                                            args->ctk_window->ctk_config);
+    if (widget) {
+        *help = ctk_app_profile_create_help(CTK_APP_PROFILE(widget),
+                                            args->ctk_window->help_tag_table);
+    }
+    return widget;
+}
+
+static const CtkPageFactory gpu_page_factory = {
+    NULL, build_gpu_page, ctk_gpu_page_select, ctk_gpu_page_unselect
+};
+
+static const CtkPageFactory screen_page_factory = {
+    NULL, build_screen_page, NULL, NULL
+};
+
+static const CtkPageFactory thermal_page_factory = {
+    probe_thermal, build_thermal_page,
+    ctk_thermal_start_timer, ctk_thermal_stop_timer
+};
+
+static const CtkPageFactory powermizer_page_factory = {
+    probe_powermizer, build_powermizer_page,
+    ctk_powermizer_start_timer, ctk_powermizer_stop_timer
+};
+
+static const CtkPageFactory ecc_page_factory = {
+    probe_ecc, build_ecc_page, ctk_ecc_start_timer, ctk_ecc_stop_timer
+};
+
+static const CtkPageFactory xvideo_page_factory = {
+    probe_xvideo, build_xvideo_page, NULL, NULL
+};
+
+static const CtkPageFactory glx_page_factory = {
+    NULL, build_glx_page, ctk_glx_probe_info, NULL
+};
+
+static const CtkPageFactory app_profile_page_factory = {
+    NULL, build_app_profile_page, NULL, NULL
+};
+
+
+
+/*
+ * prefetch_pages() - idle callback that builds the first page in the tree
+ * that has not been built yet, one page per call, until all are built.
+ */
+
+typedef struct {
+    CtkWindow *ctk_window;
+    gboolean built;
+} PrefetchPagesArgs;
+
+static gboolean prefetch_pages_callback(GtkTreeModel *model,
+                                        GtkTreePath *path,
+                                        GtkTreeIter *iter,
+                                        gpointer data)
+{
+    PrefetchPagesArgs *args = data;
+    CtkPendingPage *pending;
+
+    gtk_tree_model_get(model, iter, CTK_WINDOW_PENDING_PAGE_COLUMN, &pending,
+                       -1);
+    if (!pending) {
+        return FALSE; /* keep walking the tree */
+    }
+
+    build_pending_page(args->ctk_window, iter, "in background");
+    args->built = TRUE;
+
+    return TRUE; /* stop walking the tree */
+}
+
+static gboolean prefetch_pages(gpointer user_data)
+{
+    PrefetchPagesArgs args;
+
+    args.ctk_window = CTK_WINDOW(user_data);
+    args.built = FALSE;
+
+    gtk_tree_model_foreach(GTK_TREE_MODEL(args.ctk_window->tree_store),
+                           prefetch_pages_callback, &args);
+
+    if (!args.built) {
+        args.ctk_window->prefetch_source = 0;
+    }
+
+    return args.built;
+
+} /* prefetch_pages() */
+
+
+
 /*
  * ctk_window_new() - create a new CtkWindow widget
  */
 
 GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
-                          CtrlSystem *system)
+                          CtrlSystem *system, int startup_profile)
 {
     GObject *object;
     CtkWindow *ctk_window;
@@ -501,6 +930,7 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
     CtkConfig *ctk_config;
 
     gint column_offset;
+    gint64 startup_time = g_get_monotonic_time();
 
     /* create the new object */
 
@@ -510,6 +940,9 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
     gtk_container_set_border_width(GTK_CONTAINER(ctk_window), CTK_WINDOW_PAD);
 
     ctk_window->attribute_list = p;
+
+    ctk_window->startup_profile = startup_profile;
+    ctk_window->startup_profile_mark = startup_time;
     
     /* create the config object */
 
@@ -607,7 +1040,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
                            G_TYPE_POINTER,  /* Help widget */
                            G_TYPE_POINTER,  /* Config file attr func */
                            G_TYPE_POINTER,  /* Load widget func */
-                           G_TYPE_POINTER); /* Unload widget func */
+                           G_TYPE_POINTER,  /* Unload widget func */
+                           G_TYPE_POINTER); /* Pending page */
     model = GTK_TREE_MODEL(ctk_window->tree_store);
 
     /* create the tree view */
@@ -650,6 +1084,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
     ctk_window->page_viewer = hbox;
     ctk_window->page = NULL;
 
+    startup_profile_mark(ctk_window, "Main window");
+
     /*
      * Create generic and specific default system targets. X Screen target
      * will only exist if the X Server is available. In that case, the generic
@@ -696,15 +1132,14 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
                                CTK_WINDOW_CONFIG_FILE_ATTRIBUTES_FUNC_COLUMN,
                                NULL, -1);
 
-            child = ctk_glx_new(default_gpu_target, ctk_config, ctk_event);
-            if (child) {
-                help = ctk_glx_create_help(tag_table, CTK_GLX(child));
-                add_page(child, help, ctk_window, &iter, NULL,
-                             "Graphics Information", NULL, ctk_glx_probe_info, NULL);
-            }
+            add_lazy_page(&glx_page_factory, ctk_window, &iter, NULL,
+                          "Graphics Information", default_gpu_target,
+                          ctk_event);
         }
     }
 
+    startup_profile_mark(ctk_window, "System Information");
+
     /* X Server Display Configuration */
 
     if (default_x_target) {
@@ -725,6 +1160,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
         }
     }
 
+    startup_profile_mark(ctk_window, "X Server Display Configuration");
+
     /* Platform Power Mode */
 
     widget = ctk_powermode_new(default_gpu_target, ctk_config, ctk_event);
@@ -735,6 +1172,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
                  NULL, ctk_powermode_start_timer, ctk_powermode_stop_timer);
     }
 
+    startup_profile_mark(ctk_window, "Platform Power Mode");
+
     /* add the per-screen entries into the tree model */
 
     for (node = system->targets[X_SCREEN_TARGET]; node; node = node->next) {
@@ -754,28 +1193,10 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
         screen_name = g_strdup_printf("X Screen %d",
                                       NvCtrlGetTargetId(screen_target));
 
-        /* create the screen entry */
-
-        gtk_tree_store_append(ctk_window->tree_store, &iter, NULL);
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_LABEL_COLUMN, screen_name, -1);
-
-        /* Screen information */
-
-        screen_name = NvCtrlGetDisplayName(screen_target);
+        /* create the screen entry, with the screen information page */
 
-        child = ctk_screen_new(screen_target, ctk_event);
-        g_object_ref(G_OBJECT(child));
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_WIDGET_COLUMN, child, -1);
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_HELP_COLUMN,
-                           ctk_screen_create_help(tag_table, CTK_SCREEN(child),
-                                                  screen_name),
-                           -1);
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_CONFIG_FILE_ATTRIBUTES_FUNC_COLUMN,
-                           NULL, -1);
+        add_lazy_page(&screen_page_factory, ctk_window, NULL, &iter,
+                      screen_name, screen_target, ctk_event);
 
         /*
          * color correction, if RandR per-CRTC color correction is not
@@ -796,12 +1217,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
         /* xvideo settings  */
 
-        child = ctk_xvideo_new(screen_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_xvideo_create_help(tag_table, CTK_XVIDEO(child));
-            add_page(child, help, ctk_window, &iter, NULL,
-                     "X Server XVideo Settings", NULL, NULL, NULL);
-        }
+        add_lazy_page(&xvideo_page_factory, ctk_window, &iter, NULL,
+                      "X Server XVideo Settings", screen_target, ctk_event);
 
         /* opengl settings */
 
@@ -816,12 +1233,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
         /* Graphics Information */
 
         if (system->has_nv_control) {
-            child = ctk_glx_new(screen_target, ctk_config, ctk_event);
-            if (child) {
-                help = ctk_glx_create_help(tag_table, CTK_GLX(child));
-                add_page(child, help, ctk_window, &iter, NULL,
-                         "Graphics Information", NULL, ctk_glx_probe_info, NULL);
-            }
+            add_lazy_page(&glx_page_factory, ctk_window, &iter, NULL,
+                          "Graphics Information", screen_target, ctk_event);
         }
 
 
@@ -843,6 +1256,9 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
             add_page(child, help, ctk_window, &iter, NULL, "VDPAU Information",
                      NULL, NULL, NULL);
         }
+
+        startup_profile_mark(ctk_window, screen_name);
+        g_free(screen_name);
     }
 
     /* add the per-gpu entries into the tree model */
@@ -850,7 +1266,6 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
     for (node = system->targets[GPU_TARGET]; node; node = node->next) {
 
         gchar *gpu_name;
-        GtkWidget *child;
         CtrlTarget *gpu_target = node->t;
         UpdateDisplaysData *data;
 
@@ -868,60 +1283,31 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
         ctk_event = CTK_EVENT(ctk_event_new(gpu_target));
 
-        /* create the gpu entry */
-
-        gtk_tree_store_append(ctk_window->tree_store, &iter, NULL);
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_LABEL_COLUMN, gpu_name, -1);
-
-        child = ctk_gpu_new(gpu_target, ctk_event, ctk_config);
-
-        g_object_ref(G_OBJECT(child));
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_WIDGET_COLUMN, child, -1);
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_HELP_COLUMN, 
-                           ctk_gpu_create_help(tag_table, CTK_GPU(child)), -1);
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_CONFIG_FILE_ATTRIBUTES_FUNC_COLUMN,
-                           NULL, -1);
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN,
-                           ctk_gpu_page_select, -1);
-        gtk_tree_store_set(ctk_window->tree_store, &iter,
-                           CTK_WINDOW_UNSELECT_WIDGET_FUNC_COLUMN,
-                           ctk_gpu_page_unselect, -1);
+        /* create the gpu entry, with the gpu information page */
+
+        add_lazy_page(&gpu_page_factory, ctk_window, NULL, &iter, gpu_name,
+                      gpu_target, ctk_event);
 
         /* thermal information */
 
-        child = ctk_thermal_new(gpu_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_thermal_create_help(tag_table, CTK_THERMAL(child));
-            add_page(child, help, ctk_window, &iter, NULL, "Thermal Settings",
-                     NULL, ctk_thermal_start_timer, ctk_thermal_stop_timer);
-        }
+        add_lazy_page(&thermal_page_factory, ctk_window, &iter, NULL,
+                      "Thermal Settings", gpu_target, ctk_event);
 
         /* Powermizer information */
-        child = ctk_powermizer_new(gpu_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_powermizer_create_help(tag_table, CTK_POWERMIZER(child));
-            add_page(child, help, ctk_window, &iter, NULL, "PowerMizer",
-                     NULL, ctk_powermizer_start_timer, 
-                     ctk_powermizer_stop_timer);
-        }
+
+        add_lazy_page(&powermizer_page_factory, ctk_window, &iter, NULL,
+                      "PowerMizer", gpu_target, ctk_event);
 
         /* ECC Information */
-        child = ctk_ecc_new(gpu_target, ctk_config, ctk_event);
-        if (child) {
-            help = ctk_ecc_create_help(tag_table, CTK_ECC(child));
-            add_page(child, help, ctk_window, &iter, NULL, "ECC Settings",
-                     NULL, ctk_ecc_start_timer, ctk_ecc_stop_timer);
-        }
+
+        add_lazy_page(&ecc_page_factory, ctk_window, &iter, NULL,
+                      "ECC Settings", gpu_target, ctk_event);
 
         /* display devices */
         data = calloc(1, sizeof(*data));
         data->window = ctk_window;
         data->gpu_target = gpu_target;
+        data->gpu_event = ctk_event;
         data->parent_iter = iter;
         data->tag_table = tag_table;
 
@@ -937,6 +1323,9 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
         add_display_devices(ctk_window, &iter, gpu_target, ctk_event, tag_table,
                             data, ctk_window->attribute_list);
+
+        startup_profile_mark(ctk_window, gpu_name);
+        g_free(gpu_name);
     }
 
     /*
@@ -964,6 +1353,8 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
         break;
     }
 
+    startup_profile_mark(ctk_window, "Frame Lock");
+
     /* add NVIDIA 3D VisionPro dongle configuration page */
 
     for (node = system->targets[NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET];
@@ -990,13 +1381,12 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
                  ctk_3d_vision_pro_select, ctk_3d_vision_pro_unselect);
     }
 
+    startup_profile_mark(ctk_window, "NVIDIA 3D VisionPro");
+
     /* app profile configuration */
-    widget = ctk_app_profile_new(ctrl_target, ctk_config);
-    if (widget) {
-        add_page(widget, ctk_app_profile_create_help(CTK_APP_PROFILE(widget), tag_table),
-                 ctk_window, NULL, NULL, "Application Profiles",
-                 NULL, NULL, NULL);
-    }
+
+    add_lazy_page(&app_profile_page_factory, ctk_window, NULL, NULL,
+                  "Application Profiles", ctrl_target, NULL);
 
     /* Manage GRID License Information */
     for (node = system->targets[GPU_TARGET]; node; node = node->next) {
@@ -1011,12 +1401,16 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
         }
     }
 
+    startup_profile_mark(ctk_window, "Manage License");
+
     /* nvidia-settings configuration */
 
     add_page(GTK_WIDGET(ctk_window->ctk_config),
              ctk_config_create_help(ctk_config, tag_table),
              ctk_window, NULL, NULL, "nvidia-settings Configuration",
-             NULL, NULL, NULL);
+             NULL, ctk_config_page_select, ctk_config_page_unselect);
+
+    startup_profile_mark(ctk_window, "nvidia-settings Configuration");
 
     /*
      * we're done with the current data in the parsed attribute list,
@@ -1080,6 +1474,18 @@ GtkWidget *ctk_window_new(ParsedAttribute *p, ConfigProperties *conf,
 
     g_signal_connect(G_OBJECT(ctk_window), "delete-event",
                      G_CALLBACK(ctk_window_delete_event), (gpointer) ctk_window);
+
+    if (ctk_window->startup_profile) {
+        nv_msg(NULL, "Startup profile: window shown after %.1f ms",
+                    (g_get_monotonic_time() - startup_time) / 1000.0);
+    }
+
+    /* Build the remaining pages in the background, if requested */
+
+    if (conf->booleans & CONFIG_PROPERTIES_PREFETCH_PAGES) {
+        ctk_window->prefetch_source =
+            g_idle_add_full(G_PRIORITY_LOW, prefetch_pages, ctk_window, NULL);
+    }
     
     return GTK_WIDGET(object);
 
@@ -1219,6 +1625,156 @@ static void add_page(GtkWidget *widget, GtkTextBuffer *help,
 
 
 
+/*
+ * add_lazy_page() - add an entry for a page that is built by the given
+ * factory the first time it is needed (see build_pending_page()).  The
+ * entry is not added if the factory's probe reports that the page is not
+ * available.  Returns whether the entry was added; the new child iter is
+ * written in child_iter, if provided.
+ */
+
+static gboolean add_lazy_page(const CtkPageFactory *factory,
+                              CtkWindow *ctk_window, GtkTreeIter *iter,
+                              GtkTreeIter *child_iter, const gchar *label,
+                              CtrlTarget *target, CtkEvent *ctk_event)
+{
+    GtkTreeIter tmp_child_iter;
+    CtkPendingPage *pending;
+
+    if (factory->probe_func && !factory->probe_func(target)) {
+        return FALSE;
+    }
+
+    if (!child_iter) child_iter = &tmp_child_iter;
+
+    pending = nvalloc(sizeof(*pending));
+    pending->factory = factory;
+    pending->args.ctk_window = ctk_window;
+    pending->args.target = target;
+    pending->args.ctk_event = ctk_event;
+
+    gtk_tree_store_append(ctk_window->tree_store, child_iter, iter);
+
+    gtk_tree_store_set(ctk_window->tree_store, child_iter,
+                       CTK_WINDOW_LABEL_COLUMN, label,
+                       CTK_WINDOW_WIDGET_COLUMN, NULL,
+                       CTK_WINDOW_HELP_COLUMN, NULL,
+                       CTK_WINDOW_CONFIG_FILE_ATTRIBUTES_FUNC_COLUMN, NULL,
+                       CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN,
+                       factory->select_func,
+                       CTK_WINDOW_UNSELECT_WIDGET_FUNC_COLUMN,
+                       factory->unselect_func,
+                       CTK_WINDOW_PENDING_PAGE_COLUMN, pending,
+                       -1);
+
+    return TRUE;
+
+} /* add_lazy_page() */
+
+
+
+/*
+ * build_pending_page() - build the page of the given entry, if it was
+ * added by add_lazy_page() and has not been built yet.  If the page turns
+ * out not to be available after all, a placeholder is shown instead.
+ */
+
+static void build_pending_page(CtkWindow *ctk_window, GtkTreeIter *iter,
+                               const gchar *how)
+{
+    GtkTreeModel *model = GTK_TREE_MODEL(ctk_window->tree_store);
+    CtkPendingPage *pending;
+    GtkWidget *widget;
+    GtkTextBuffer *help = NULL;
+    gint64 start;
+
+    gtk_tree_model_get(model, iter, CTK_WINDOW_PENDING_PAGE_COLUMN, &pending,
+                       -1);
+    if (!pending) {
+        return;
+    }
+
+    start = g_get_monotonic_time();
+
+    widget = pending->factory->build_func(&pending->args, &help);
+    if (!widget) {
+        widget = gtk_vbox_new(FALSE, 0);
+        gtk_box_pack_start(GTK_BOX(widget),
+                           gtk_label_new("This page is not available."),
+                           FALSE, FALSE, 0);
+        gtk_widget_show_all(widget);
+        help = NULL;
+
+        /* The placeholder has no timers or state to select/unselect */
+
+        gtk_tree_store_set(ctk_window->tree_store, iter,
+                           CTK_WINDOW_SELECT_WIDGET_FUNC_COLUMN, NULL,
+                           CTK_WINDOW_UNSELECT_WIDGET_FUNC_COLUMN, NULL,
+                           -1);
+    }
+
+    /* Take ownership of the page, as add_page() does */
+
+    g_object_ref(G_OBJECT(widget));
+    ctk_g_object_ref_sink(G_OBJECT(widget));
+
+    gtk_tree_store_set(ctk_window->tree_store, iter,
+                       CTK_WINDOW_WIDGET_COLUMN, widget,
+                       CTK_WINDOW_HELP_COLUMN, help,
+                       CTK_WINDOW_PENDING_PAGE_COLUMN, NULL,
+                       -1);
+
+    nvfree(pending);
+
+    if (ctk_window->startup_profile) {
+        GtkTreeIter parent_iter;
+        gchar *label = NULL, *parent_label = NULL;
+
+        gtk_tree_model_get(model, iter, CTK_WINDOW_LABEL_COLUMN, &label, -1);
+        if (gtk_tree_model_iter_parent(model, &parent_iter, iter)) {
+            gtk_tree_model_get(model, &parent_iter,
+                               CTK_WINDOW_LABEL_COLUMN, &parent_label, -1);
+        }
+
+        nv_msg(NULL, "Startup profile: built page '%s%s%s' %s "
+                    "in %.1f ms",
+                    parent_label ? parent_label : "",
+                    parent_label ? " - " : "",
+                    label ? label : "", how,
+                    (g_get_monotonic_time() - start) / 1000.0);
+
+        g_free(parent_label);
+        g_free(label);
+    }
+
+} /* build_pending_page() */
+
+
+
+/*
+ * startup_profile_mark() - when profiling startup, report the time spent
+ * since the last mark, attributed to the given section of the window.
+ */
+
+static void startup_profile_mark(CtkWindow *ctk_window, const gchar *label)
+{
+    gint64 now;
+
+    if (!ctk_window->startup_profile) {
+        return;
+    }
+
+    now = g_get_monotonic_time();
+
+    nv_msg(NULL, "Startup profile: %s took %.1f ms", label,
+                (now - ctk_window->startup_profile_mark) / 1000.0);
+
+    ctk_window->startup_profile_mark = now;
+
+} /* startup_profile_mark() */
+
+
+
 /*
  * create_quit_dialog() - create a dialog box to prompt the user
  * whether they really want to quit.
@@ -1600,13 +2156,13 @@ static void update_display_devices(GtkWidget *object,
         data->num_displays--;
     }
 
-    /* Add back all the connected display devices */
-
-    gtk_tree_model_get(GTK_TREE_MODEL(ctk_window->tree_store), &parent_iter,
-                       CTK_WINDOW_WIDGET_COLUMN, &widget, -1);
+    /*
+     * Add back all the connected display devices; the GPU page itself may
+     * not have been built yet, so use the GPU's event object directly.
+     */
 
     add_display_devices(ctk_window, &parent_iter, gpu_target,
-                        CTK_GPU(widget)->ctk_event,
+                        data->gpu_event,
                         tag_table, data, ctk_window->attribute_list);
 
     /* Expand the GPU entry if it used to be */
@@ -81,6 +81,10 @@ struct _CtkWindow
     GtkTextBuffer          *help_text_buffer;
 
     GtkWidget              *display_config_widget;
+
+    guint                   prefetch_source;
+    gboolean                startup_profile;
+    gint64                  startup_profile_mark;
 };
 
 struct _CtkWindowClass
@@ -90,7 +94,7 @@ struct _CtkWindowClass
 
 GType       ctk_window_get_type  (void) G_GNUC_CONST;
 GtkWidget*  ctk_window_new       (ParsedAttribute *, ConfigProperties *conf,
-                                  CtrlSystem *system);
+                                  CtrlSystem *system, int startup_profile);
 void        ctk_window_set_active_page(CtkWindow *ctk_window,
                                        const gchar *label);
 
@@ -437,6 +437,154 @@ Bool XNVCTRLQueryTargetAttribute64 (
 }
 
 
+/*
+ * Older Xlib headers predate the accessors for the 64-bit sequence
+ * numbers; fall back to the 32-bit fields there.
+ */
+
+#ifndef X_DPY_GET_REQUEST
+#define X_DPY_GET_REQUEST(dpy) ((dpy)->request)
+#endif
+
+#ifndef X_DPY_GET_LAST_REQUEST_READ
+#define X_DPY_GET_LAST_REQUEST_READ(dpy) ((dpy)->last_request_read)
+#endif
+
+typedef struct {
+    unsigned long start_seq;   /* sequence number of queries[0] */
+    int count;                 /* number of replies handled asynchronously */
+    Bool use_64_bit;
+    XNVCTRLAttributeQuery *queries;
+} _XNVCTRLBatchState;
+
+/*
+ * Xlib async reply handler collecting the replies to all but the last
+ * request of a batch; the last one is read with _XReply(), which also
+ * dispatches the earlier replies here as they arrive.
+ */
+
+static Bool batch_reply_handler(
+    Display *dpy,
+    xReply *rep,
+    char *buf,
+    int len,
+    XPointer data
+){
+    _XNVCTRLBatchState *state = (_XNVCTRLBatchState *) data;
+    unsigned long idx = X_DPY_GET_LAST_REQUEST_READ(dpy) - state->start_seq;
+    XNVCTRLAttributeQuery *query;
+
+    if (idx >= (unsigned long) state->count) {
+        return False;
+    }
+
+    query = &state->queries[idx];
+
+    /* Let Xlib report errors; the query is already marked non-existent */
+    if (rep->generic.type == X_Error) {
+        return False;
+    }
+
+    if (state->use_64_bit) {
+        xnvCtrlQueryAttribute64Reply replbuf, *repl;
+        repl = (xnvCtrlQueryAttribute64Reply *)
+            _XGetAsyncReply(dpy, (char *) &replbuf, rep, buf, len,
+                            (SIZEOF(xnvCtrlQueryAttribute64Reply) -
+                             SIZEOF(xReply)) >> 2, True);
+        query->exists = repl->flags ? True : False;
+        if (query->exists) query->value = repl->value_64;
+    } else {
+        xnvCtrlQueryAttributeReply replbuf, *repl;
+        repl = (xnvCtrlQueryAttributeReply *)
+            _XGetAsyncReply(dpy, (char *) &replbuf, rep, buf, len,
+                            (SIZEOF(xnvCtrlQueryAttributeReply) -
+                             SIZEOF(xReply)) >> 2, True);
+        query->exists = repl->flags ? True : False;
+        if (query->exists) query->value = repl->value;
+    }
+
+    return True;
+}
+
+
+Bool XNVCTRLQueryTargetAttributesBatch (
+    Display *dpy,
+    XNVCTRLAttributeQuery *queries,
+    int count
+){
+    XExtDisplayInfo *info = find_display (dpy);
+    xnvCtrlQueryAttributeReq *req;
+    _XAsyncHandler async;
+    _XNVCTRLBatchState async_state;
+    XNVCTRLAttributeQuery *last;
+    int i;
+
+    if (!queries || count <= 0)
+        return False;
+
+    for (i = 0; i < count; i++) {
+        queries[i].exists = False;
+    }
+
+    if(!XextHasExtension(info))
+        return False;
+
+    XNVCTRLCheckExtension (dpy, info, False);
+
+    async_state.count = count - 1;
+    async_state.queries = queries;
+    async_state.use_64_bit =
+        (version_flags(dpy, info) & NVCTRL_EXT_64_BIT_ATTRIBUTES) ? True : False;
+
+    LockDisplay (dpy);
+
+    async_state.start_seq = X_DPY_GET_REQUEST(dpy) + 1;
+    async.next = dpy->async_handlers;
+    async.handler = batch_reply_handler;
+    async.data = (XPointer) &async_state;
+    dpy->async_handlers = &async;
+
+    for (i = 0; i < count; i++) {
+        int target_type = queries[i].target_type;
+        int target_id = queries[i].target_id;
+
+        XNVCTRLCheckTargetData(dpy, info, &target_type, &target_id);
+
+        GetReq (nvCtrlQueryAttribute, req);
+        req->reqType = info->codes->major_opcode;
+        req->nvReqType = async_state.use_64_bit ? X_nvCtrlQueryAttribute64 :
+                                                  X_nvCtrlQueryAttribute;
+        req->target_type = target_type;
+        req->target_id = target_id;
+        req->display_mask = queries[i].display_mask;
+        req->attribute = queries[i].attribute;
+    }
+
+    /* Wait for the last reply; earlier ones go through the async handler */
+    last = &queries[count - 1];
+
+    if (async_state.use_64_bit) {
+        xnvCtrlQueryAttribute64Reply rep;
+        if (_XReply (dpy, (xReply *) &rep, 0, xTrue)) {
+            last->exists = rep.flags ? True : False;
+            if (last->exists) last->value = rep.value_64;
+        }
+    } else {
+        xnvCtrlQueryAttributeReply rep;
+        if (_XReply (dpy, (xReply *) &rep, 0, xTrue)) {
+            last->exists = rep.flags ? True : False;
+            if (last->exists) last->value = rep.value;
+        }
+    }
+
+    DeqAsyncHandler (dpy, &async);
+    UnlockDisplay (dpy);
+    SyncHandle ();
+
+    return True;
+}
+
+
 Bool XNVCTRLQueryTargetStringAttribute (
     Display *dpy,
     int target_type,
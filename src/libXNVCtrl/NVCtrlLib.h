@@ -265,6 +265,52 @@ Bool XNVCTRLQueryTargetAttribute64 (
 );
 
 
+/*
+ * XNVCTRLAttributeQuery -
+ *
+ *  Describes one attribute query of a batch; see
+ *  XNVCTRLQueryTargetAttributesBatch().  The target_type, target_id,
+ *  display_mask and attribute fields are inputs; exists and value are
+ *  filled in by the query.
+ */
+
+typedef struct {
+    int target_type;
+    int target_id;
+    unsigned int display_mask;
+    unsigned int attribute;
+    Bool exists;
+    int64_t value;
+} XNVCTRLAttributeQuery;
+
+
+/*
+ * XNVCTRLQueryTargetAttributesBatch -
+ *
+ *  Queries 'count' integer attributes at once: all the requests are
+ *  sent before any reply is waited for, so the whole batch costs a
+ *  single round trip to the X server instead of one per attribute.
+ *
+ *  For each entry of 'queries', exists is set to True if the attribute
+ *  exists, in which case value contains its value.  The 64-bit
+ *  protocol request is used when the server supports it.
+ *
+ *  Returns True if the batch was sent; returns False if the NV-CONTROL
+ *  extension is not present or if the arguments are invalid.
+ *
+ *  Possible errors (reported through the Xlib error handler for the
+ *  offending entry only):
+ *     BadValue - The target doesn't exist.
+ *     BadMatch - The NVIDIA driver does not control the target.
+ */
+
+Bool XNVCTRLQueryTargetAttributesBatch (
+    Display *dpy,
+    XNVCTRLAttributeQuery *queries,
+    int count
+);
+
+
 /*
  *  XNVCTRLQueryStringAttribute -
  *
@@ -30,7 +30,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include <math.h> /* pow(3) */
 
 #include <sys/utsname.h>
 
@@ -119,6 +118,20 @@ const int targetTypeInfoTableLen = ARRAY_LEN(targetTypeInfoTable);
 static NvCtrlEventPrivateHandleNode *__event_handles = NULL;
 
 
+/*
+ * Generation of the valid values caches of all handles.  It is bumped when
+ * something may have changed the valid values or permissions of any target:
+ * an attribute was set, or an availability, display configuration or screen
+ * change event was received.  Handle caches of an older generation are
+ * flushed the next time they are used.
+ */
+static unsigned int __valid_values_generation = 0;
+static unsigned long long __valid_values_cache_hits = 0;
+static unsigned long long __valid_values_cache_misses = 0;
+
+#define VALID_VALUES_CACHE_INITIAL_SIZE 64
+
+
 Bool NvCtrlIsTargetTypeValid(CtrlTargetType target_type)
 {
     switch (target_type) {
@@ -289,9 +302,12 @@ NvCtrlAttributeHandle *NvCtrlAttributeInit(CtrlSystem *system,
     if ((subsystems & NV_CTRL_ATTRIBUTES_NVML_SUBSYSTEM) &&
         TARGET_TYPE_IS_NVML_COMPATIBLE(target_type)) {
 
-        h->nvml = NvCtrlInitNvmlAttributes(h);
+        h->nvml = NvCtrlInitNvmlAttributes(h, system);
     }
 
+    h->valid_values_cache = nvalloc(sizeof(NvCtrlValidValuesCache));
+    h->valid_values_cache->generation = __valid_values_generation;
+
     return (NvCtrlAttributeHandle *) h;
 
  failed:
@@ -702,6 +718,187 @@ ReturnStatus NvCtrlGetVoidAttribute(const CtrlTarget *ctrl_target,
 } /* NvCtrlGetVoidAttribute() */
 
 
+/*
+ * Valid values cache
+ *
+ * NvCtrlGetValidDisplayAttributeValues(),
+ * NvCtrlGetValidStringDisplayAttributeValues() and NvCtrlGetAttributePerms()
+ * each cost an X round trip or an NVML range query, yet their results rarely
+ * change during a session.  Each handle keeps an open addressing hash table
+ * of the results it has already returned, keyed by (kind, display mask,
+ * attribute); see __valid_values_generation for when it is flushed.
+ */
+
+static unsigned int HashValidValuesKey(unsigned int kind,
+                                       unsigned int display_mask, int attr)
+{
+    unsigned int hash = (unsigned int) attr * 2654435761U;
+
+    hash ^= (display_mask ^ (kind << 28)) * 2246822519U;
+
+    return hash ^ (hash >> 15);
+}
+
+
+static NvCtrlValidValuesCacheEntry *
+FindValidValuesCacheEntry(NvCtrlValidValuesCache *cache, unsigned int kind,
+                          unsigned int display_mask, int attr)
+{
+    unsigned int i = HashValidValuesKey(kind, display_mask, attr);
+
+    /* the table is never full, so this finds the entry or a free slot */
+
+    for (;; i++) {
+        NvCtrlValidValuesCacheEntry *entry =
+            &cache->entries[i & (cache->size - 1)];
+
+        if (!entry->used ||
+            ((entry->kind == kind) &&
+             (entry->display_mask == display_mask) &&
+             (entry->attr == attr))) {
+            return entry;
+        }
+    }
+}
+
+
+/*
+ * LookupValidValues() - return TRUE and the cached status (and, on success,
+ * valid values) if the given query was already answered in the current
+ * generation.
+ */
+
+static Bool LookupValidValues(const NvCtrlAttributePrivateHandle *h,
+                              unsigned int kind, unsigned int display_mask,
+                              int attr, ReturnStatus *status,
+                              CtrlAttributeValidValues *val)
+{
+    NvCtrlValidValuesCache *cache = h->valid_values_cache;
+    NvCtrlValidValuesCacheEntry *entry;
+
+    if (!cache) {
+        return FALSE;
+    }
+
+    if (cache->generation != __valid_values_generation) {
+        if (cache->entries) {
+            memset(cache->entries, 0,
+                   cache->size * sizeof(NvCtrlValidValuesCacheEntry));
+        }
+        cache->count = 0;
+        cache->generation = __valid_values_generation;
+    }
+
+    if (cache->count > 0) {
+        entry = FindValidValuesCacheEntry(cache, kind, display_mask, attr);
+
+        if (entry->used) {
+            *status = entry->status;
+            if (entry->status == NvCtrlSuccess) {
+                *val = entry->val;
+            }
+            __valid_values_cache_hits++;
+            return TRUE;
+        }
+    }
+
+    __valid_values_cache_misses++;
+
+    return FALSE;
+}
+
+
+/*
+ * StoreValidValues() - cache the answer to the given query.  Only answers
+ * that describe the attribute rather than a transient failure are kept.
+ */
+
+static void StoreValidValues(const NvCtrlAttributePrivateHandle *h,
+                             unsigned int kind, unsigned int display_mask,
+                             int attr, ReturnStatus status,
+                             const CtrlAttributeValidValues *val)
+{
+    NvCtrlValidValuesCache *cache = h->valid_values_cache;
+    NvCtrlValidValuesCacheEntry *entry;
+
+    if (!cache ||
+        (cache->generation != __valid_values_generation)) {
+        return;
+    }
+
+    switch (status) {
+        case NvCtrlSuccess:
+        case NvCtrlNoAttribute:
+        case NvCtrlAttributeNotAvailable:
+        case NvCtrlMissingExtension:
+            break;
+        default:
+            return;
+    }
+
+    /* keep the load factor under 3/4 */
+
+    if ((cache->count + 1) * 4 > cache->size * 3) {
+        NvCtrlValidValuesCacheEntry *old = cache->entries;
+        unsigned int old_size = cache->size;
+        unsigned int i;
+
+        cache->size = old_size ? old_size * 2 :
+            VALID_VALUES_CACHE_INITIAL_SIZE;
+        cache->entries =
+            nvalloc(cache->size * sizeof(NvCtrlValidValuesCacheEntry));
+
+        for (i = 0; i < old_size; i++) {
+            if (old[i].used) {
+                *FindValidValuesCacheEntry(cache, old[i].kind,
+                                           old[i].display_mask,
+                                           old[i].attr) = old[i];
+            }
+        }
+
+        nvfree(old);
+    }
+
+    entry = FindValidValuesCacheEntry(cache, kind, display_mask, attr);
+
+    if (!entry->used) {
+        entry->used = TRUE;
+        entry->kind = kind;
+        entry->display_mask = display_mask;
+        entry->attr = attr;
+        cache->count++;
+    }
+
+    entry->status = status;
+    if (status == NvCtrlSuccess) {
+        entry->val = *val;
+    }
+}
+
+
+static void InvalidateValidValuesCaches(void)
+{
+    __valid_values_generation++;
+}
+
+
+/*
+ * NvCtrlReportValidValuesCacheStats() - report how many valid values and
+ * permissions queries the caches answered, at the 'all' verbosity level.
+ */
+
+void NvCtrlReportValidValuesCacheStats(void)
+{
+    if (__valid_values_cache_hits + __valid_values_cache_misses == 0) {
+        return;
+    }
+
+    nv_info_msg(NULL, "Valid values cache: %llu hit(s), %llu miss(es).",
+                __valid_values_cache_hits, __valid_values_cache_misses);
+}
+
+
+
 ReturnStatus NvCtrlGetValidAttributeValues(const CtrlTarget *ctrl_target,
                                            int attr,
                                            CtrlAttributeValidValues *val)
@@ -718,6 +915,8 @@ ReturnStatus NvCtrlGetAttributePerms(const CtrlTarget *ctrl_target,
 {
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
     ReturnStatus ret = NvCtrlError;
+    CtrlAttributeValidValues cached;
+    unsigned int kind = NV_CTRL_VALID_VALUES_CACHE_PERMS + attr_type;
 
     if (h == NULL) {
         return NvCtrlBadHandle;
@@ -733,12 +932,25 @@ ReturnStatus NvCtrlGetAttributePerms(const CtrlTarget *ctrl_target,
         case CTRL_ATTRIBUTE_TYPE_BINARY_DATA:
         case CTRL_ATTRIBUTE_TYPE_STRING_OPERATION:
 
+            if (LookupValidValues(h, kind, 0, attr, &ret, &cached)) {
+                if (ret == NvCtrlSuccess) {
+                    *perms = cached.permissions;
+                }
+                return ret;
+            }
+
             ret = NvCtrlNvmlGetAttributePerms(h, attr_type, attr, perms);
 
-            if (ret == NvCtrlSuccess || h->dpy == NULL) {
-                return ret;
+            if (ret != NvCtrlSuccess && h->dpy != NULL) {
+                ret = NvCtrlNvControlGetAttributePerms(h, attr_type, attr,
+                                                       perms);
             }
-            return NvCtrlNvControlGetAttributePerms(h, attr_type, attr, perms);
+
+            memset(&cached, 0, sizeof(cached));
+            cached.permissions = *perms;
+            StoreValidValues(h, kind, 0, attr, ret, &cached);
+
+            return ret;
 
         case CTRL_ATTRIBUTE_TYPE_COLOR:
             /*
@@ -867,6 +1079,146 @@ ReturnStatus NvCtrlGetDisplayAttribute(const CtrlTarget *ctrl_target,
 } /* NvCtrlGetDisplayAttribute() */
 
 
+/*
+ * Sends the NV-CONTROL queries in 'queries' flagged in 'pending' that share
+ * the display connection of queries[first] as one pipelined batch, and
+ * clears their 'pending' flag.
+ */
+
+static void NvCtrlNvControlGetAttributesBatch(CtrlAttributeQuery *queries,
+                                              Bool *pending, int first,
+                                              int count)
+{
+    const NvCtrlAttributePrivateHandle *h =
+        getPrivateHandleConst(queries[first].ctrl_target);
+    Display *dpy = h->dpy;
+    XNVCTRLAttributeQuery *xqueries;
+    int *indices;
+    int i, n = 0;
+    Bool sent;
+
+    xqueries = nvalloc((count - first) * sizeof(XNVCTRLAttributeQuery));
+    indices = nvalloc((count - first) * sizeof(int));
+
+    for (i = first; i < count; i++) {
+        const NvCtrlAttributePrivateHandle *hi;
+
+        if (!pending[i]) {
+            continue;
+        }
+
+        hi = getPrivateHandleConst(queries[i].ctrl_target);
+        if (hi->dpy != dpy) {
+            continue;
+        }
+
+        xqueries[n].target_type = NvCtrlGetTargetTypeInfo(hi->target_type)->nvctrl;
+        xqueries[n].target_id = hi->target_id;
+        xqueries[n].display_mask = queries[i].display_mask;
+        xqueries[n].attribute = queries[i].attr;
+        indices[n] = i;
+        pending[i] = FALSE;
+        n++;
+    }
+
+    sent = XNVCTRLQueryTargetAttributesBatch(dpy, xqueries, n);
+
+    for (i = 0; i < n; i++) {
+        CtrlAttributeQuery *q = &queries[indices[i]];
+
+        if (sent && xqueries[i].exists) {
+            q->val = xqueries[i].value;
+            q->status = NvCtrlSuccess;
+        } else {
+            q->status = NvCtrlAttributeNotAvailable;
+        }
+    }
+
+    nvfree(indices);
+    nvfree(xqueries);
+}
+
+
+ReturnStatus NvCtrlGetAttributesBatch(CtrlAttributeQuery *queries, int count)
+{
+    Bool *pending;
+    int i;
+
+    if ((queries == NULL) || (count < 0)) {
+        return NvCtrlBadArgument;
+    }
+
+    pending = nvalloc(count * sizeof(Bool));
+
+    /*
+     * Resolve everything that does not need an NV-CONTROL round trip right
+     * away, mirroring NvCtrlGetDisplayAttribute64(), and flag the rest.
+     */
+
+    for (i = 0; i < count; i++) {
+        CtrlAttributeQuery *q = &queries[i];
+        const NvCtrlAttributePrivateHandle *h;
+        ReturnStatus ret = NvCtrlMissingExtension;
+
+        if (q->ctrl_target == NULL) {
+            continue;
+        }
+
+        h = getPrivateHandleConst(q->ctrl_target);
+        if (h == NULL) {
+            q->status = NvCtrlBadHandle;
+            continue;
+        }
+
+        if ((q->attr < 0) || (q->attr > NV_CTRL_LAST_ATTRIBUTE)) {
+            q->status = NvCtrlGetDisplayAttribute64(q->ctrl_target,
+                                                    q->display_mask,
+                                                    q->attr, &q->val);
+            continue;
+        }
+
+        switch (h->target_type) {
+            case GPU_TARGET:
+            case THERMAL_SENSOR_TARGET:
+            case COOLER_TARGET:
+                ret = NvCtrlNvmlGetAttribute(q->ctrl_target, q->attr, &q->val);
+                if (ret == NvCtrlSuccess) {
+                    q->status = ret;
+                    break;
+                }
+                /* Fall through */
+            case DISPLAY_TARGET:
+            case X_SCREEN_TARGET:
+            case FRAMELOCK_TARGET:
+            case NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET:
+            case MUX_TARGET:
+                if (!h->nv) {
+                    q->status = ret;
+                } else {
+                    pending[i] = TRUE;
+                }
+                break;
+            default:
+                q->status = NvCtrlBadHandle;
+                break;
+        }
+    }
+
+    /* Send one pipelined batch per X server */
+
+    for (i = 0; i < count; i++) {
+        if (pending[i]) {
+            NvCtrlNvControlGetAttributesBatch(queries, pending, i, count);
+        }
+    }
+
+    nvfree(pending);
+
+    return NvCtrlSuccess;
+
+} /* NvCtrlGetAttributesBatch() */
+
+
 ReturnStatus NvCtrlSetDisplayAttribute(CtrlTarget *ctrl_target,
                                        unsigned int display_mask,
                                        int attr, int val)
@@ -878,6 +1230,8 @@ ReturnStatus NvCtrlSetDisplayAttribute(CtrlTarget *ctrl_target,
         return NvCtrlBadHandle;
     }
 
+    InvalidateValidValuesCaches();
+
     if (((attr >= 0) && (attr <= NV_CTRL_LAST_ATTRIBUTE)) ||
         ((attr >= NV_CTRL_ATTR_NVML_BASE) &&
          (attr <= NV_CTRL_ATTR_NVML_LAST_ATTRIBUTE))) {
@@ -957,18 +1311,14 @@ ReturnStatus NvCtrlGetVoidDisplayAttribute(const CtrlTarget *ctrl_target,
 } /* NvCtrlGetVoidDisplayAttribute() */
 
 
-ReturnStatus
-NvCtrlGetValidDisplayAttributeValues(const CtrlTarget *ctrl_target,
-                                     unsigned int display_mask, int attr,
-                                     CtrlAttributeValidValues *val)
+static ReturnStatus
+QueryValidDisplayAttributeValues(const CtrlTarget *ctrl_target,
+                                 const NvCtrlAttributePrivateHandle *h,
+                                 unsigned int display_mask, int attr,
+                                 CtrlAttributeValidValues *val)
 {
-    const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
     ReturnStatus ret = NvCtrlMissingExtension;
 
-    if (h == NULL) {
-        return NvCtrlBadHandle;
-    }
-    
     if (((attr >= 0) && (attr <= NV_CTRL_LAST_ATTRIBUTE)) ||
         ((attr >= NV_CTRL_ATTR_NVML_BASE) &&
          (attr <= NV_CTRL_ATTR_NVML_LAST_ATTRIBUTE))) {
@@ -1005,7 +1355,40 @@ NvCtrlGetValidDisplayAttributeValues(const CtrlTarget *ctrl_target,
     }
 
     return NvCtrlNoAttribute;
-    
+
+} /* QueryValidDisplayAttributeValues() */
+
+
+ReturnStatus
+NvCtrlGetValidDisplayAttributeValues(const CtrlTarget *ctrl_target,
+                                     unsigned int display_mask, int attr,
+                                     CtrlAttributeValidValues *val)
+{
+    const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
+    ReturnStatus ret;
+
+    if (h == NULL) {
+        return NvCtrlBadHandle;
+    }
+
+    if (val == NULL) {
+        return QueryValidDisplayAttributeValues(ctrl_target, h, display_mask,
+                                                attr, val);
+    }
+
+    if (LookupValidValues(h, NV_CTRL_VALID_VALUES_CACHE_INTEGER,
+                          display_mask, attr, &ret, val)) {
+        return ret;
+    }
+
+    ret = QueryValidDisplayAttributeValues(ctrl_target, h, display_mask,
+                                           attr, val);
+
+    StoreValidValues(h, NV_CTRL_VALID_VALUES_CACHE_INTEGER,
+                     display_mask, attr, ret, val);
+
+    return ret;
+
 } /* NvCtrlGetValidDisplayAttributeValues() */
 
 
@@ -1031,22 +1414,18 @@ GetValidStringDisplayAttributeValuesExtraAttr(CtrlAttributeValidValues *val)
 
 
 /*
- * NvCtrlGetValidStringDisplayAttributeValues() -fill the
+ * QueryValidStringDisplayAttributeValues() -fill the
  * CtrlAttributeValidValues structure for String attributes
  */
 
-ReturnStatus
-NvCtrlGetValidStringDisplayAttributeValues(const CtrlTarget *ctrl_target,
-                                           unsigned int display_mask, int attr,
-                                           CtrlAttributeValidValues *val)
+static ReturnStatus
+QueryValidStringDisplayAttributeValues(const CtrlTarget *ctrl_target,
+                                       const NvCtrlAttributePrivateHandle *h,
+                                       unsigned int display_mask, int attr,
+                                       CtrlAttributeValidValues *val)
 {
-    const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
     ReturnStatus ret = NvCtrlMissingExtension;
 
-    if (h == NULL) {
-        return NvCtrlBadHandle;
-    }
-
     if ((attr >= 0) && (attr <= NV_CTRL_STRING_LAST_ATTRIBUTE)) {
         switch (h->target_type) {
             case GPU_TARGET:
@@ -1121,6 +1500,40 @@ NvCtrlGetValidStringDisplayAttributeValues(const CtrlTarget *ctrl_target,
 
     return NvCtrlNoAttribute;
 
+} /* QueryValidStringDisplayAttributeValues() */
+
+
+ReturnStatus
+NvCtrlGetValidStringDisplayAttributeValues(const CtrlTarget *ctrl_target,
+                                           unsigned int display_mask, int attr,
+                                           CtrlAttributeValidValues *val)
+{
+    const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
+    ReturnStatus ret;
+
+    if (h == NULL) {
+        return NvCtrlBadHandle;
+    }
+
+    if (val == NULL) {
+        return QueryValidStringDisplayAttributeValues(ctrl_target, h,
+                                                      display_mask, attr,
+                                                      val);
+    }
+
+    if (LookupValidValues(h, NV_CTRL_VALID_VALUES_CACHE_STRING,
+                          display_mask, attr, &ret, val)) {
+        return ret;
+    }
+
+    ret = QueryValidStringDisplayAttributeValues(ctrl_target, h,
+                                                 display_mask, attr, val);
+
+    StoreValidValues(h, NV_CTRL_VALID_VALUES_CACHE_STRING,
+                     display_mask, attr, ret, val);
+
+    return ret;
+
 } /* NvCtrlGetValidStringDisplayAttributeValues() */
 
 
@@ -1221,6 +1634,8 @@ ReturnStatus NvCtrlSetStringDisplayAttribute(CtrlTarget *ctrl_target,
         return NvCtrlBadHandle;
     }
 
+    InvalidateValidValuesCaches();
+
     if ((attr >= 0) && (attr <= NV_CTRL_STRING_LAST_ATTRIBUTE)) {
         switch (h->target_type) {
             case GPU_TARGET:
@@ -1310,6 +1725,8 @@ ReturnStatus NvCtrlStringOperation(CtrlTarget *ctrl_target,
         return NvCtrlBadHandle;
     }
 
+    InvalidateValidValuesCaches();
+
     if ((attr >= 0) && (attr <= NV_CTRL_STRING_OPERATION_LAST_ATTRIBUTE)) {
         if (!h->nv) return NvCtrlMissingExtension;
         return NvCtrlNvControlStringOperation(h, display_mask, attr, ptrIn,
@@ -1382,6 +1799,11 @@ void NvCtrlAttributeClose(NvCtrlAttributeHandle *handle)
         NvCtrlNvmlAttributesClose(h);
     }
 
+    if (h->valid_values_cache) {
+        nvfree(h->valid_values_cache->entries);
+        nvfree(h->valid_values_cache);
+    }
+
     free(h);
 } /* NvCtrlAttributeClose() */
 
@@ -1571,160 +1993,46 @@ ReturnStatus NvCtrlReloadColorRamp(CtrlTarget *ctrl_target)
 }
 
 
-/* helper functions private to the libXNVCtrlAttributes backend */
-
-void NvCtrlInitGammaInputStruct(NvCtrlGammaInput *pGammaInput)
-{
-    int ch;
-
-    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
-        pGammaInput->brightness[ch] = BRIGHTNESS_DEFAULT;
-        pGammaInput->contrast[ch]   = CONTRAST_DEFAULT;
-        pGammaInput->gamma[ch]      = GAMMA_DEFAULT;
-    }
-}
-
 /*
- * Compute the gammaRamp entry given its index, and the contrast,
- * brightness, and gamma.
+ * Returns the event handle fed by the NVML event thread of the system the
+ * (NVML-only) handle 'h' belongs to, creating it if needed.  Returns NULL if
+ * NVML cannot deliver events for any of the system's GPUs.
  */
-static unsigned short ComputeGammaRampVal(int gammaRampSize,
-                                          int i,
-                                          float contrast,
-                                          float brightness,
-                                          float gamma)
+static NvCtrlEventHandle *
+NvCtrlGetNvmlEventHandle(const NvCtrlAttributePrivateHandle *h)
 {
-    double j, half, scale;
-    int shift, val, num;
-
-    num = gammaRampSize - 1;
-    shift = 16 - (ffs(gammaRampSize) - 1);
-
-    scale = (double) num / 3.0; /* how much brightness and contrast
-                                   affect the value */
-    j = (double) i;
-
-    /* contrast */
-
-    contrast *= scale;
-
-    if (contrast > 0.0) {
-        half = ((double) num / 2.0) - 1.0;
-        j -= half;
-        j *= half / (half - contrast);
-        j += half;
-    } else {
-        half = (double) num / 2.0;
-        j -= half;
-        j *= (half + contrast) / half;
-        j += half;
-    }
-
-    /* brightness */
-
-    brightness *= scale;
-
-    j += brightness;
-    if (j > (double)num) {
-        j = (double)num;
-    }
-    if (j < 0.0) {
-        j = 0.0;
-    }
-
-    /* gamma */
-
-    gamma = 1.0 / (double) gamma;
-
-    if (gamma == 1.0) {
-        val = (int) j;
-    } else {
-        val = (int) (pow (j / (double)num, gamma) * (double)num + 0.5);
-    }
-
-    val <<= shift;
-    return (unsigned short) val;
-}
-
-void NvCtrlUpdateGammaRamp(const NvCtrlGammaInput *pGammaInput,
-                           int gammaRampSize,
-                           unsigned short *gammaRamp[3],
-                           unsigned int bitmask)
-{
-    int i, ch;
-
-    /* update the requested channels within the gammaRamp */
-
-    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
-
-        /* only update requested channels */
+    NvCtrlEventPrivateHandle *evt_h;
+    NvCtrlEventPrivateHandleNode *evt_hnode;
+    NvCtrlNvmlContext *ctx = h->nvml->ctx;
 
-        if ((bitmask & (1 << ch)) == 0) {
-            continue;
-        }
+    for (evt_hnode = __event_handles;
+         evt_hnode;
+         evt_hnode = evt_hnode->next) {
 
-        for (i = 0; i < gammaRampSize; i++) {
-            gammaRamp[ch][i] =
-                ComputeGammaRampVal(gammaRampSize,
-                                    i,
-                                    pGammaInput->contrast[ch],
-                                    pGammaInput->brightness[ch],
-                                    pGammaInput->gamma[ch]);
+        if (evt_hnode->handle->nvml == ctx) {
+            return (NvCtrlEventHandle *)evt_hnode->handle;
         }
     }
-}
-
-void NvCtrlAssignGammaInput(NvCtrlGammaInput *pGammaInput,
-                            const float inContrast[3],
-                            const float inBrightness[3],
-                            const float inGamma[3],
-                            const unsigned int bitmask)
-{
-    int ch;
-
-    /* clamp input, but only the input specified in the bitmask */
 
-    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
+    evt_h = nvalloc(sizeof(*evt_h));
+    evt_h->dpy = NULL;
+    evt_h->fd = -1;
+    evt_h->nvctrl_event_base = -1;
+    evt_h->xrandr_event_base = -1;
 
-        /* only update requested channels */
-
-        if ((bitmask & (1 << ch)) == 0) {
-            continue;
-        }
-
-        if (bitmask & CONTRAST_VALUE) {
-            if (inContrast[ch] > CONTRAST_MAX) {
-                pGammaInput->contrast[ch] = CONTRAST_MAX;
-            } else if (inContrast[ch] < CONTRAST_MIN) {
-                pGammaInput->contrast[ch] = CONTRAST_MIN;
-            } else {
-                pGammaInput->contrast[ch] = inContrast[ch];
-            }
-        }
+    if (NvCtrlNvmlEventHandleOpen(evt_h, ctx) != NvCtrlSuccess) {
+        free(evt_h);
+        return NULL;
+    }
 
-        if (bitmask & BRIGHTNESS_VALUE) {
-            if (inBrightness[ch] > BRIGHTNESS_MAX) {
-                pGammaInput->brightness[ch] = BRIGHTNESS_MAX;
-            } else if (inBrightness[ch] < BRIGHTNESS_MIN) {
-                pGammaInput->brightness[ch] = BRIGHTNESS_MIN;
-            } else {
-                pGammaInput->brightness[ch] = inBrightness[ch];
-            }
-        }
+    evt_hnode = nvalloc(sizeof(*evt_hnode));
+    evt_hnode->handle = evt_h;
+    evt_hnode->next = __event_handles;
+    __event_handles = evt_hnode;
 
-        if (bitmask & GAMMA_VALUE) {
-            if (inGamma[ch] > GAMMA_MAX) {
-                pGammaInput->gamma[ch] = GAMMA_MAX;
-            } else if (inGamma[ch] < GAMMA_MIN) {
-                pGammaInput->gamma[ch] = GAMMA_MIN;
-            } else {
-                pGammaInput->gamma[ch] = inGamma[ch];
-            }
-        }
-    }
+    return (NvCtrlEventHandle *)evt_h;
 }
 
-
 NvCtrlEventHandle *NvCtrlGetEventHandle(const CtrlTarget *ctrl_target)
 {
     NvCtrlEventPrivateHandle *evt_h;
@@ -1736,8 +2044,8 @@ NvCtrlEventHandle *NvCtrlGetEventHandle(const CtrlTarget *ctrl_target)
     }
 
     if (!h->dpy && !h->nv && h->nvml) {
-        /* We are running with NVML lib only. Events not yet supported.*/
-        return NULL;
+        /* We are running with NVML lib only: events come from NVML */
+        return NvCtrlGetNvmlEventHandle(h);
     }
 
     /* Look for the event handle */
@@ -1746,7 +2054,7 @@ NvCtrlEventHandle *NvCtrlGetEventHandle(const CtrlTarget *ctrl_target)
          evt_hnode;
          evt_hnode = evt_hnode->next) {
 
-        if (evt_hnode->handle->dpy == h->dpy) {
+        if (!evt_hnode->handle->nvml && (evt_hnode->handle->dpy == h->dpy)) {
             evt_h = evt_hnode->handle;
             break;
         }
@@ -1821,6 +2129,7 @@ NvCtrlCloseEventHandle(NvCtrlEventHandle *handle)
     return NvCtrlBadHandle;
 
 free_handle:
+    NvCtrlNvmlEventHandleClose((NvCtrlEventPrivateHandle *)handle);
     free(handle);
     free(evt_hnode);
 
@@ -1854,6 +2163,11 @@ NvCtrlEventHandlePending(NvCtrlEventHandle *handle, Bool *pending)
 
     evt_h = (NvCtrlEventPrivateHandle*)handle;
 
+    if (evt_h->nvml_events) {
+        *pending = NvCtrlNvmlEventHandlePending(evt_h);
+        return NvCtrlSuccess;
+    }
+
     if (XPending(evt_h->dpy)) {
         *pending = TRUE;
     } else {
@@ -1863,6 +2177,32 @@ NvCtrlEventHandlePending(NvCtrlEventHandle *handle, Bool *pending)
     return NvCtrlSuccess;
 }
 
+ReturnStatus
+NvCtrlEventHandleQueued(NvCtrlEventHandle *handle, Bool *queued)
+{
+    NvCtrlEventPrivateHandle *evt_h;
+
+    if (!handle) {
+        return NvCtrlBadArgument;
+    }
+
+    evt_h = (NvCtrlEventPrivateHandle*)handle;
+
+    /* NVML events are queued in process; there is no connection to read */
+    if (evt_h->nvml_events) {
+        *queued = NvCtrlNvmlEventHandlePending(evt_h);
+        return NvCtrlSuccess;
+    }
+
+    if (XEventsQueued(evt_h->dpy, QueuedAlready)) {
+        *queued = TRUE;
+    } else {
+        *queued = FALSE;
+    }
+
+    return NvCtrlSuccess;
+}
+
 static int get_screen_of_root(Display *dpy, Window root)
 {
     int screen = -1;
@@ -1880,8 +2220,8 @@ static int get_screen_of_root(Display *dpy, Window root)
     return screen;
 }
 
-ReturnStatus
-NvCtrlEventHandleNextEvent(NvCtrlEventHandle *handle, CtrlEvent *event)
+static ReturnStatus
+GetNextEvent(NvCtrlEventHandle *handle, CtrlEvent *event)
 {
     NvCtrlEventPrivateHandle *evt_h;
     XEvent xevent;
@@ -1892,6 +2232,10 @@ NvCtrlEventHandleNextEvent(NvCtrlEventHandle *handle, CtrlEvent *event)
 
     evt_h = (NvCtrlEventPrivateHandle*)handle;
 
+    if (evt_h->nvml_events) {
+        return NvCtrlNvmlEventHandleNextEvent(evt_h, event);
+    }
+
     memset(event, 0, sizeof(CtrlEvent));
 
 
@@ -2047,3 +2391,47 @@ NvCtrlEventHandleNextEvent(NvCtrlEventHandle *handle, CtrlEvent *event)
     return NvCtrlSuccess;
 }
 
+
+/*
+ * EventChangesValidValues() - return whether the event may change the valid
+ * values or permissions of some targets: attribute availability changes, and
+ * display configuration or screen changes.
+ */
+
+static Bool EventChangesValidValues(const CtrlEvent *event)
+{
+    switch (event->type) {
+        case CTRL_EVENT_TYPE_SCREEN_CHANGE:
+            return TRUE;
+
+        case CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE:
+            if (event->int_attr.is_availability_changed) {
+                return TRUE;
+            }
+            return (event->int_attr.attribute == NV_CTRL_PROBE_DISPLAYS) ||
+                   (event->int_attr.attribute == NV_CTRL_ENABLED_DISPLAYS);
+
+        case CTRL_EVENT_TYPE_STRING_ATTRIBUTE:
+            return (event->str_attr.attribute ==
+                    NV_CTRL_STRING_CURRENT_METAMODE) ||
+                   (event->str_attr.attribute ==
+                    NV_CTRL_STRING_CURRENT_METAMODE_VERSION_2);
+
+        default:
+            return FALSE;
+    }
+}
+
+
+ReturnStatus
+NvCtrlEventHandleNextEvent(NvCtrlEventHandle *handle, CtrlEvent *event)
+{
+    ReturnStatus status = GetNextEvent(handle, event);
+
+    if ((status == NvCtrlSuccess) && EventChangesValidValues(event)) {
+        InvalidateValidValuesCaches();
+    }
+
+    return status;
+}
+
@@ -144,6 +144,9 @@ struct _CtrlSystem {
     Bool limit_subsystems;
     void *wayland_output;
 
+    /* NVML state shared by this system's targets; see NvCtrlAttributesNvml.c */
+    struct __NvCtrlNvmlContext *nvml_context;
+
     CtrlTargetNode *targets[MAX_TARGET_TYPES]; /* Shadows targetTypeTable */
     CtrlTargetNode *physical_screens;
     CtrlSystemList *system_list; /* pointer to the system list being tracked */
@@ -789,6 +792,37 @@ ReturnStatus NvCtrlGetAttribute64(const CtrlTarget *ctrl_target,
                                   int attr, int64_t *val);
 
 
+/*
+ * NvCtrlGetAttributesBatch() - query many integer attributes at once.  Each
+ * CtrlAttributeQuery names a target, display mask and attribute; on return
+ * its status and val are set as NvCtrlGetDisplayAttribute64() would have set
+ * them.  Entries with a NULL ctrl_target are skipped.  Queries that have to
+ * go through NV-CONTROL are pipelined, costing one round trip per X server
+ * for the whole batch rather than one per attribute.
+ */
+
+typedef struct {
+    const CtrlTarget *ctrl_target;
+    unsigned int display_mask;
+    int attr;
+
+    ReturnStatus status;
+    int64_t val;
+} CtrlAttributeQuery;
+
+ReturnStatus NvCtrlGetAttributesBatch(CtrlAttributeQuery *queries, int count);
+
+
+/*
+ * NvCtrlSetTelemetryInterval() - tell the NVML backend of 'system' how often
+ * its telemetry (power draw, clocks, temperatures, ...) is polled, so that
+ * the samples it shares between queries are never older than half that
+ * interval.  Intervals above the default sharing window leave it unchanged.
+ */
+
+void NvCtrlSetTelemetryInterval(CtrlSystem *system, unsigned int interval_ms);
+
+
 /*
  * NvCtrlGetVoidAttribute() - this function works like the
  * Get and GetString only it returns a void pointer.  The
@@ -927,6 +961,15 @@ NvCtrlEventHandleGetFD(NvCtrlEventHandle *handle, int *fd);
 ReturnStatus
 NvCtrlEventHandlePending(NvCtrlEventHandle *handle, Bool *pending);
 
+/*
+ * NvCtrlEventHandleQueued() - Check whether there are events already read
+ * into the specified event handle's queue, without reading from, or
+ * flushing, its connection to the X server.  This is cheaper than
+ * NvCtrlEventHandlePending() when draining several events in a row.
+ */
+ReturnStatus
+NvCtrlEventHandleQueued(NvCtrlEventHandle *handle, Bool *queued);
+
 /*
  * NvCtrlEventHandleNextEvent() - Get the next event data in the specified event
  * handle.
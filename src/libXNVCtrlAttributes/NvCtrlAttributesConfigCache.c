@@ -0,0 +1,432 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2026 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * NvCtrlAttributesConfigCache.c - snapshots of the GLX and EGL framebuffer
+ * configuration tables.
+ *
+ * Enumerating the framebuffer configurations of a screen costs a query per
+ * attribute and per configuration, and servers may expose hundreds of them.
+ * A snapshot holds the table of one handle once it has been enumerated, so
+ * that --glxinfo, --eglinfo and the Graphics Information page all share one
+ * enumeration.  Snapshots that have a key (built from the display, screen,
+ * visuals, driver version and, for local servers, the server start time)
+ * are also saved under $XDG_CACHE_HOME/nvidia-settings
+ * (~/.cache/nvidia-settings by default), so that later runs against the
+ * same server skip the enumeration entirely.  Since the key cannot tell
+ * every server restart apart, a cached table is only used if it has as
+ * many records as the server currently reports configurations, which only
+ * costs one request.
+ *
+ * The records are the GLXFBConfigAttr and EGLConfigAttr structures of
+ * NvCtrlAttributes.h, which only hold ints; they are stored back to back,
+ * followed by a zeroed terminating record, as returned to the callers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "common-utils.h"
+#include "msg.h"
+#include "NvCtrlAttributes.h"
+#include "NvCtrlAttributesPrivate.h"
+
+#define CONFIG_CACHE_MAGIC "nvidia-settings config cache 1"
+#define CONFIG_CACHE_MAX_RECORDS 65536
+
+struct __NvCtrlConfigSnapshot {
+    const char *kind;   /* e.g. "glx-fbconfigs"; names the cache file */
+    size_t record_size; /* size of one record, in bytes */
+    char *key;          /* identifies the table in the cache file, or NULL */
+    Bool key_set;
+
+    int *records;       /* num_records records and a zeroed terminator */
+    int num_records;
+};
+
+
+
+/*
+ * NvCtrlConfigSnapshotCreate() - allocate an empty snapshot of records of
+ * the given size; kind must be a string constant.
+ */
+
+NvCtrlConfigSnapshot *NvCtrlConfigSnapshotCreate(const char *kind,
+                                                 size_t record_size)
+{
+    NvCtrlConfigSnapshot *s = nvalloc(sizeof(NvCtrlConfigSnapshot));
+
+    s->kind = kind;
+    s->record_size = record_size;
+
+    return s;
+}
+
+
+
+void NvCtrlConfigSnapshotFree(NvCtrlConfigSnapshot *s)
+{
+    if (!s) {
+        return;
+    }
+
+    nvfree(s->key);
+    nvfree(s->records);
+    nvfree(s);
+}
+
+
+
+/*
+ * get_cache_file_name() - return the name of the cache file of the
+ * snapshot, creating its directory if needed, or NULL if there is no
+ * usable cache directory.  The file name is derived from a hash of the
+ * key, which is also stored in the file and compared when loading.
+ */
+
+static char *get_cache_file_name(const NvCtrlConfigSnapshot *s, Bool create)
+{
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    char *dir, *home, *file;
+    unsigned int hash = 2166136261U;
+    const char *c;
+
+    if (xdg && xdg[0] == '/') {
+        dir = nvdircat(xdg, "nvidia-settings", NULL);
+    } else {
+        home = tilde_expansion("~");
+        if (!home || home[0] != '/') {
+            free(home);
+            return NULL;
+        }
+        dir = nvdircat(home, ".cache", "nvidia-settings", NULL);
+        free(home);
+    }
+
+    if (create && !directory_exists(dir)) {
+        char *error_str = NULL;
+
+        if (!nv_mkdir_recursive(dir, 0700, &error_str, NULL)) {
+            nv_info_msg(NULL, "%s", error_str ? error_str : dir);
+            nvfree(error_str);
+            nvfree(dir);
+            return NULL;
+        }
+    }
+
+    /* FNV-1a */
+    for (c = s->key; *c; c++) {
+        hash = (hash ^ (unsigned char) *c) * 16777619U;
+    }
+
+    file = nvasprintf("%s/%s-%08x", dir, s->kind, hash);
+    nvfree(dir);
+
+    return file;
+}
+
+
+
+/*
+ * load_snapshot() - read the table of the snapshot from its cache file;
+ * return FALSE if there is none, or if it does not match the key or record
+ * size of the snapshot, or the number of configurations 'num_configs'
+ * currently reported by the server.
+ */
+
+static Bool load_snapshot(NvCtrlConfigSnapshot *s, int num_configs)
+{
+    const int record_len = s->record_size / sizeof(int);
+    char *file, *line = NULL;
+    int num_records, len, i, eof;
+    int *records = NULL;
+    Bool ret = FALSE;
+    FILE *fp;
+
+    file = get_cache_file_name(s, FALSE);
+    if (!file) {
+        return FALSE;
+    }
+
+    fp = fopen(file, "r");
+    nvfree(file);
+
+    if (!fp) {
+        return FALSE;
+    }
+
+    line = fget_next_line(fp, &eof);
+    if (!line || strcmp(line, CONFIG_CACHE_MAGIC) != 0) {
+        goto done;
+    }
+    nvfree(line);
+
+    line = fget_next_line(fp, &eof);
+    if (!line || strcmp(line, s->key) != 0) {
+        goto done;
+    }
+
+    if ((fscanf(fp, "%d %d", &num_records, &len) != 2) ||
+        (len != record_len) || (num_records != num_configs) ||
+        (num_records <= 0) || (num_records > CONFIG_CACHE_MAX_RECORDS)) {
+        goto done;
+    }
+
+    records = nvalloc((num_records + 1) * s->record_size);
+
+    for (i = 0; i < num_records * record_len; i++) {
+        if (fscanf(fp, "%d", &records[i]) != 1) {
+            goto done;
+        }
+    }
+
+    s->records = records;
+    s->num_records = num_records;
+    records = NULL;
+    ret = TRUE;
+
+ done:
+    nvfree(line);
+    nvfree(records);
+    fclose(fp);
+
+    return ret;
+}
+
+
+
+/*
+ * save_snapshot() - write the table of the snapshot to its cache file.  The
+ * file is written under a temporary name and then renamed, so that
+ * concurrent instances never read a partial table.
+ */
+
+static void save_snapshot(const NvCtrlConfigSnapshot *s)
+{
+    const int record_len = s->record_size / sizeof(int);
+    char *file, *tmp;
+    FILE *fp;
+    int i, j;
+
+    file = get_cache_file_name(s, TRUE);
+    if (!file) {
+        return;
+    }
+
+    tmp = nvasprintf("%s.%d", file, (int) getpid());
+
+    fp = fopen(tmp, "w");
+    if (!fp) {
+        goto done;
+    }
+
+    fprintf(fp, "%s\n%s\n%d %d\n", CONFIG_CACHE_MAGIC, s->key,
+            s->num_records, record_len);
+
+    for (i = 0; i < s->num_records; i++) {
+        const int *record = &s->records[i * record_len];
+
+        for (j = 0; j < record_len; j++) {
+            fprintf(fp, "%d%c", record[j], (j == record_len - 1) ? '\n' : ' ');
+        }
+    }
+
+    if ((fclose(fp) != 0) || (rename(tmp, file) != 0)) {
+        unlink(tmp);
+    }
+
+ done:
+    nvfree(tmp);
+    nvfree(file);
+}
+
+
+
+/*
+ * get_server_start_time() - return the modification time of the socket of
+ * the local X server of 'dpy', which the server creates when it starts, or
+ * 0 if the server is not local or has no socket.
+ */
+
+static long get_server_start_time(Display *dpy)
+{
+    const char *name = DisplayString(dpy);
+    const char *colon = strrchr(name, ':');
+    char *path;
+    struct stat st;
+    long ret = 0;
+
+    if (!colon || ((colon != name) &&
+                   (strncmp(name, "unix:", 5) != 0 || colon != name + 4))) {
+        return 0;
+    }
+
+    path = nvasprintf("/tmp/.X11-unix/X%d", atoi(colon + 1));
+
+    if (stat(path, &st) == 0) {
+        ret = (long) st.st_mtime;
+    }
+
+    nvfree(path);
+
+    return ret;
+}
+
+
+
+/*
+ * get_snapshot_key() - build the key identifying the framebuffer
+ * configurations of the X screen of 'h', from information that does not
+ * cost a round trip to the X server (the display, host, screen depth,
+ * server release, server start time and visuals) and the NVIDIA driver
+ * version.  Returns NULL, which disables the cache file, when the key
+ * cannot be built.
+ */
+
+static char *get_snapshot_key(const NvCtrlAttributePrivateHandle *h)
+{
+    XVisualInfo template, *visuals;
+    char host[256];
+    char *version = NULL, *key;
+    unsigned int hash = 2166136261U;
+    int num_visuals = 0, i;
+
+    if (!h || !h->dpy || !h->nv ||
+        (h->target_type != X_SCREEN_TARGET)) {
+        return NULL;
+    }
+
+    if ((NvCtrlNvControlGetStringAttribute(h, 0,
+                                           NV_CTRL_STRING_NVIDIA_DRIVER_VERSION,
+                                           &version) != NvCtrlSuccess) ||
+        !version) {
+        return NULL;
+    }
+
+    if (gethostname(host, sizeof(host)) != 0) {
+        host[0] = '\0';
+    }
+    host[sizeof(host) - 1] = '\0';
+
+    template.screen = h->target_id;
+    visuals = XGetVisualInfo(h->dpy, VisualScreenMask, &template,
+                             &num_visuals);
+
+    for (i = 0; i < num_visuals; i++) {
+        hash = (hash ^ (unsigned int) visuals[i].visualid) * 16777619U;
+        hash = (hash ^ (unsigned int) visuals[i].depth) * 16777619U;
+    }
+
+    if (visuals) {
+        XFree(visuals);
+    }
+
+    key = nvasprintf("host=%s display=%s screen=%d depth=%d release=%d "
+                     "started=%ld visuals=%d:%08x driver=%s",
+                     host, DisplayString(h->dpy), h->target_id,
+                     DefaultDepth(h->dpy, h->target_id),
+                     VendorRelease(h->dpy), get_server_start_time(h->dpy),
+                     num_visuals, hash, version);
+
+    free(version);
+
+    return key;
+}
+
+
+
+/*
+ * NvCtrlConfigSnapshotGet() - return a copy of the table of the snapshot
+ * of the handle 'h', as an array terminated by a zeroed record that the
+ * caller must free().
+ *
+ * The first call loads the table from the cache file if a matching one
+ * exists, or else calls 'enumerate' and saves its result.  'enumerate' must
+ * return an allocated array in the same format, or NULL on failure.
+ * 'count' must cheaply return the number of configurations the server
+ * reports, or -1 on failure; a cache file with another number of records
+ * is stale, and ignored.
+ */
+
+void *NvCtrlConfigSnapshotGet(NvCtrlConfigSnapshot *s,
+                              const NvCtrlAttributePrivateHandle *h,
+                              void *(*enumerate)
+                                  (const NvCtrlAttributePrivateHandle *),
+                              int (*count)
+                                  (const NvCtrlAttributePrivateHandle *))
+{
+    void *copy;
+    uint64_t start;
+
+    if (!s) {
+        return NULL;
+    }
+
+    if (!s->key_set) {
+        s->key = get_snapshot_key(h);
+        s->key_set = TRUE;
+    }
+
+    if (!s->records) {
+        start = nv_get_monotonic_time_us();
+
+        if (s->key && load_snapshot(s, count(h))) {
+            nv_info_msg(NULL, "Loaded %d %s from the cache in %.2f ms.",
+                        s->num_records, s->kind,
+                        (nv_get_monotonic_time_us() - start) / 1000.0);
+        } else {
+            const char *record;
+
+            s->records = enumerate(h);
+            if (!s->records) {
+                return NULL;
+            }
+
+            /* count the records up to the zeroed terminator */
+
+            record = (const char *) s->records;
+            for (s->num_records = 0; ; s->num_records++) {
+                size_t k;
+
+                for (k = 0; k < s->record_size; k++) {
+                    if (record[k]) break;
+                }
+                if (k == s->record_size) break;
+
+                record += s->record_size;
+            }
+
+            nv_info_msg(NULL, "Enumerated %d %s in %.2f ms.",
+                        s->num_records, s->kind,
+                        (nv_get_monotonic_time_us() - start) / 1000.0);
+
+            if (s->key && s->num_records > 0) {
+                save_snapshot(s);
+            }
+        }
+    }
+
+    copy = nvalloc((s->num_records + 1) * s->record_size);
+    memcpy(copy, s->records, s->num_records * s->record_size);
+
+    return copy;
+}
@@ -248,6 +248,10 @@ Bool NvCtrlInitEglAttributes (NvCtrlAttributePrivateHandle *h)
         return False;
     }
 
+    /* The configs are only enumerated when first requested */
+    h->egl_configs = NvCtrlConfigSnapshotCreate("egl-configs",
+                                                sizeof(EGLConfigAttr));
+
     return True;
 
 } /* NvCtrlInitEglAttributes() */
@@ -276,6 +280,9 @@ NvCtrlEglAttributesClose (NvCtrlAttributePrivateHandle *h)
         close_libegl();
     }
 
+    NvCtrlConfigSnapshotFree(h->egl_configs);
+    h->egl_configs = NULL;
+
     h->egl_dpy = NULL;
     h->egl = False;
 
@@ -289,11 +296,12 @@ NvCtrlEglAttributesClose (NvCtrlAttributePrivateHandle *h)
  *
  *
  * Returns an array of EGL Frame Buffer Configuration Attributes for the
- * given Display/Screen.
+ * given Display/Screen.  This is the enumeration callback of the
+ * handle's config snapshot; see NvCtrlConfigSnapshotGet().
  *
  ****/
 
-static EGLConfigAttr *get_configs(const NvCtrlAttributePrivateHandle *h)
+static void *get_configs(const NvCtrlAttributePrivateHandle *h)
 {
     EGLConfig       *configs = NULL;
     EGLConfigAttr   *cas     = NULL;
@@ -477,6 +485,25 @@ static EGLConfigAttr *get_configs(const NvCtrlAttributePrivateHandle *h)
 
 
 
+/*
+ * count_configs() - return the number of configs of the display, without
+ * querying any of their attributes, so that a cached snapshot can be
+ * checked against the running server; see NvCtrlConfigSnapshotGet().
+ */
+
+static int count_configs(const NvCtrlAttributePrivateHandle *h)
+{
+    int nconfigs = 0;
+
+    if (!(* (__libEGL->eglGetConfigs)) (h->egl_dpy, NULL, 0, &nconfigs)) {
+        return -1;
+    }
+
+    return nconfigs;
+}
+
+
+
 /******************************************************************************
  *
  * NvCtrlEglGetVoidAttribute()
@@ -509,7 +536,9 @@ ReturnStatus NvCtrlEglGetVoidAttribute(const NvCtrlAttributePrivateHandle *h,
     switch ( attr ) {
 
     case NV_CTRL_ATTR_EGL_CONFIG_ATTRIBS:
-        config_attribs = get_configs(h);
+        config_attribs =
+            NvCtrlConfigSnapshotGet(h->egl_configs, h, get_configs,
+                                    count_configs);
         *ptr = config_attribs;
         break;
 
@@ -0,0 +1,205 @@
+/*
+ * nvidia-settings: A tool for configuring the NVIDIA X driver on Unix
+ * and Linux systems.
+ *
+ * Copyright (C) 2004,2012 NVIDIA Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses>.
+ */
+
+/*
+ * Gamma ramp helpers shared by the XF86VidMode and RandR backends.  These
+ * only do arithmetic, and are kept apart from the rest of the backend so
+ * that they can be built on their own (see bench/gamma-ramp.c).
+ */
+
+#include "NvCtrlAttributes.h"
+#include "NvCtrlAttributesPrivate.h"
+
+#include <string.h>
+#include <strings.h> /* ffs(3) */
+#include <math.h> /* pow(3) */
+
+void NvCtrlInitGammaInputStruct(NvCtrlGammaInput *pGammaInput)
+{
+    int ch;
+
+    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
+        pGammaInput->brightness[ch] = BRIGHTNESS_DEFAULT;
+        pGammaInput->contrast[ch]   = CONTRAST_DEFAULT;
+        pGammaInput->gamma[ch]      = GAMMA_DEFAULT;
+    }
+}
+
+/*
+ * Compute the gammaRamp of one channel given its size, and the contrast,
+ * brightness, and gamma.
+ *
+ * Everything but the index of the entry is computed once per ramp; this
+ * keeps the precision of the original per-entry computation (the scaled
+ * contrast and brightness, and the gamma exponent, are rounded to float) so
+ * that the ramp is the same, bit for bit.  Entries clamped to the ends of
+ * the ramp do not need pow().
+ */
+static void ComputeGammaRamp(int gammaRampSize,
+                             float contrast,
+                             float brightness,
+                             float gamma,
+                             unsigned short *gammaRamp)
+{
+    double j, half, factor, scale;
+    int i, shift, val, num;
+
+    num = gammaRampSize - 1;
+    shift = 16 - (ffs(gammaRampSize) - 1);
+
+    scale = (double) num / 3.0; /* how much brightness and contrast
+                                   affect the value */
+
+    /* contrast */
+
+    contrast *= scale;
+
+    if (contrast > 0.0) {
+        half = ((double) num / 2.0) - 1.0;
+        factor = half / (half - contrast);
+    } else {
+        half = (double) num / 2.0;
+        factor = (half + contrast) / half;
+    }
+
+    /* brightness */
+
+    brightness *= scale;
+
+    /* gamma */
+
+    gamma = 1.0 / (double) gamma;
+
+    for (i = 0; i < gammaRampSize; i++) {
+        j = (double) i;
+
+        j -= half;
+        j *= factor;
+        j += half;
+
+        j += brightness;
+
+        if (j >= (double)num) {
+            val = num;
+        } else if (j <= 0.0) {
+            val = 0;
+        } else if (gamma == 1.0) {
+            val = (int) j;
+        } else {
+            val = (int) (pow (j / (double)num, gamma) * (double)num + 0.5);
+        }
+
+        gammaRamp[i] = (unsigned short) (val << shift);
+    }
+}
+
+void NvCtrlUpdateGammaRamp(const NvCtrlGammaInput *pGammaInput,
+                           int gammaRampSize,
+                           unsigned short *gammaRamp[3],
+                           unsigned int bitmask)
+{
+    int ch, prev;
+
+    /* update the requested channels within the gammaRamp */
+
+    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
+
+        /* only update requested channels */
+
+        if ((bitmask & (1 << ch)) == 0) {
+            continue;
+        }
+
+        /*
+         * channels usually share their settings: reuse the ramp of a
+         * channel updated above with the same input
+         */
+
+        for (prev = FIRST_COLOR_CHANNEL; prev < ch; prev++) {
+            if ((bitmask & (1 << prev)) &&
+                (pGammaInput->contrast[prev] == pGammaInput->contrast[ch]) &&
+                (pGammaInput->brightness[prev] ==
+                 pGammaInput->brightness[ch]) &&
+                (pGammaInput->gamma[prev] == pGammaInput->gamma[ch])) {
+                break;
+            }
+        }
+
+        if (prev < ch) {
+            memcpy(gammaRamp[ch], gammaRamp[prev],
+                   gammaRampSize * sizeof(unsigned short));
+        } else {
+            ComputeGammaRamp(gammaRampSize,
+                             pGammaInput->contrast[ch],
+                             pGammaInput->brightness[ch],
+                             pGammaInput->gamma[ch],
+                             gammaRamp[ch]);
+        }
+    }
+}
+
+void NvCtrlAssignGammaInput(NvCtrlGammaInput *pGammaInput,
+                            const float inContrast[3],
+                            const float inBrightness[3],
+                            const float inGamma[3],
+                            const unsigned int bitmask)
+{
+    int ch;
+
+    /* clamp input, but only the input specified in the bitmask */
+
+    for (ch = FIRST_COLOR_CHANNEL; ch <= LAST_COLOR_CHANNEL; ch++) {
+
+        /* only update requested channels */
+
+        if ((bitmask & (1 << ch)) == 0) {
+            continue;
+        }
+
+        if (bitmask & CONTRAST_VALUE) {
+            if (inContrast[ch] > CONTRAST_MAX) {
+                pGammaInput->contrast[ch] = CONTRAST_MAX;
+            } else if (inContrast[ch] < CONTRAST_MIN) {
+                pGammaInput->contrast[ch] = CONTRAST_MIN;
+            } else {
+                pGammaInput->contrast[ch] = inContrast[ch];
+            }
+        }
+
+        if (bitmask & BRIGHTNESS_VALUE) {
+            if (inBrightness[ch] > BRIGHTNESS_MAX) {
+                pGammaInput->brightness[ch] = BRIGHTNESS_MAX;
+            } else if (inBrightness[ch] < BRIGHTNESS_MIN) {
+                pGammaInput->brightness[ch] = BRIGHTNESS_MIN;
+            } else {
+                pGammaInput->brightness[ch] = inBrightness[ch];
+            }
+        }
+
+        if (bitmask & GAMMA_VALUE) {
+            if (inGamma[ch] > GAMMA_MAX) {
+                pGammaInput->gamma[ch] = GAMMA_MAX;
+            } else if (inGamma[ch] < GAMMA_MIN) {
+                pGammaInput->gamma[ch] = GAMMA_MIN;
+            } else {
+                pGammaInput->gamma[ch] = inGamma[ch];
+            }
+        }
+    }
+}
@@ -290,6 +290,10 @@ NvCtrlInitGlxAttributes (NvCtrlAttributePrivateHandle *h)
         return False;
     }
 
+    /* The fbconfigs are only enumerated when first requested */
+    h->glx_fbconfigs = NvCtrlConfigSnapshotCreate("glx-fbconfigs",
+                                                  sizeof(GLXFBConfigAttr));
+
     return True;
 
 } /* NvCtrlInitGlxAttributes() */
@@ -314,6 +318,9 @@ NvCtrlGlxAttributesClose (NvCtrlAttributePrivateHandle *h)
  
     close_libgl();
 
+    NvCtrlConfigSnapshotFree(h->glx_fbconfigs);
+    h->glx_fbconfigs = NULL;
+
     h->glx = False;
 
 } /* NvCtrlGlxAttributesClose() */
@@ -326,7 +333,8 @@ NvCtrlGlxAttributesClose (NvCtrlAttributePrivateHandle *h)
  *
  *
  * Returns an array of GLX Frame Buffer Configuration Attributes for the
- * given Display/Screen.
+ * given Display/Screen.  This is the enumeration callback of the
+ * handle's fbconfig snapshot; see NvCtrlConfigSnapshotGet().
  *
  * NOTE: A separate display connection is used to avoid the dependence on
  *       libGL when an XCloseDisplay is issued.   If we did not, calling
@@ -337,8 +345,7 @@ NvCtrlGlxAttributesClose (NvCtrlAttributePrivateHandle *h)
 
 #ifdef GLX_VERSION_1_3
 
-static GLXFBConfigAttr *
-get_fbconfig_attribs(const NvCtrlAttributePrivateHandle *h)
+static void *get_fbconfig_attribs(const NvCtrlAttributePrivateHandle *h)
 {
     XVisualInfo     * visinfo;
 
@@ -551,6 +558,28 @@ get_fbconfig_attribs(const NvCtrlAttributePrivateHandle *h)
     return NULL;
 } /* get_fbconfig_attribs() */
 
+
+
+/*
+ * count_fbconfigs() - return the number of fbconfigs of the screen, with a
+ * single request, so that a cached snapshot can be checked against the
+ * running server; see NvCtrlConfigSnapshotGet().
+ */
+
+static int count_fbconfigs(const NvCtrlAttributePrivateHandle *h)
+{
+    GLXFBConfig *fbconfigs;
+    int nfbconfigs = 0;
+
+    fbconfigs = (* (__libGL->glXGetFBConfigs)) (h->dpy, h->target_id,
+                                                &nfbconfigs);
+    if ( fbconfigs ) {
+        XFree(fbconfigs);
+    }
+
+    return fbconfigs ? nfbconfigs : -1;
+}
+
 #endif /* GLX_VERSION_1_3 */
 
 
@@ -587,7 +616,9 @@ ReturnStatus NvCtrlGlxGetVoidAttribute(const NvCtrlAttributePrivateHandle *h,
 
 #ifdef GLX_VERSION_1_3
     case NV_CTRL_ATTR_GLX_FBCONFIG_ATTRIBS:
-        fbconfig_attribs = get_fbconfig_attribs(h);
+        fbconfig_attribs =
+            NvCtrlConfigSnapshotGet(h->glx_fbconfigs, h,
+                                    get_fbconfig_attribs, count_fbconfigs);
         *ptr = fbconfig_attribs;
         break;
 #endif
@@ -25,6 +25,10 @@
 #include <string.h>
 #include <assert.h>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "NvCtrlAttributes.h"
 #include "NvCtrlAttributesPrivate.h"
@@ -39,6 +43,18 @@
 
 #define MAX_NVML_STR_LEN 64
 
+/*
+ * Telemetry snapshots younger than this are reused rather than sampled again,
+ * so that every page polling a GPU within the same tick shares a single pass.
+ * Clients polling faster can lower it with NvCtrlSetTelemetryInterval().
+ */
+#define NVML_TELEMETRY_MAX_AGE_US 500000
+
+/* How often the NVML call rate is reported with --verbose=all */
+#define NVML_STATS_REPORT_INTERVAL_US 10000000
+
+#define NVML_TELEMETRY_BIT(_metric_) (1U << (_metric_))
+
 static inline const NvCtrlNvmlAttributes *
 getNvmlHandleConst(const NvCtrlAttributePrivateHandle *h)
 {
@@ -157,26 +173,26 @@ static Bool NvmlMissing(const CtrlTarget *ctrl_target)
 /*
  * Unload the NVML library if it was successfully loaded.
  */
-static void UnloadNvml(NvCtrlNvmlAttributes *nvml)
+static void UnloadNvml(NvCtrlNvmlContext *ctx)
 {
-    if (nvml == NULL) {
+    if (ctx == NULL) {
         return;
     }
 
-    if (nvml->lib.handle == NULL) {
+    if (ctx->lib.handle == NULL) {
         return;
     }
 
-    if (nvml->lib.Shutdown != NULL) {
-        nvmlReturn_t ret = nvml->lib.Shutdown();
+    if (ctx->lib.Shutdown != NULL) {
+        nvmlReturn_t ret = ctx->lib.Shutdown();
         if (ret != NVML_SUCCESS) {
             printNvmlError(ret);
         }
     }
 
-    dlclose(nvml->lib.handle);
+    dlclose(ctx->lib.handle);
 
-    memset(&nvml->lib, 0, sizeof(nvml->lib));
+    memset(&ctx->lib, 0, sizeof(ctx->lib));
 }
 
 /*
@@ -188,10 +204,21 @@ static nvmlReturn_t NvmlStubFunction (void)
     return NVML_ERROR_FUNCTION_NOT_FOUND;
 }
 
+/*
+ * Number of times the NVML library has been loaded and initialized by this
+ * process; reported in verbose mode to keep an eye on startup cost.
+ */
+static unsigned int nvmlInitCount;
+
+unsigned int NvCtrlNvmlGetInitCount(void)
+{
+    return nvmlInitCount;
+}
+
 /*
  * Load and initializes the NVML library.
  */
-static Bool LoadNvml(NvCtrlNvmlAttributes *nvml)
+static Bool LoadNvml(NvCtrlNvmlContext *ctx)
 {
     enum {
         _OPTIONAL,
@@ -200,9 +227,9 @@ static Bool LoadNvml(NvCtrlNvmlAttributes *nvml)
 
     nvmlReturn_t ret;
 
-    nvml->lib.handle = dlopen("libnvidia-ml.so.1", RTLD_LAZY);
+    ctx->lib.handle = dlopen("libnvidia-ml.so.1", RTLD_LAZY);
 
-    if (nvml->lib.handle == NULL) {
+    if (ctx->lib.handle == NULL) {
         goto fail;
     }
 
@@ -210,15 +237,15 @@ static Bool LoadNvml(NvCtrlNvmlAttributes *nvml)
 
 #define EXPAND_STRING(_symbol) STRINGIFY_SYMBOL(_symbol)
 
-#define GET_SYMBOL(_required, _proc)                                           \
-    nvml->lib._proc = dlsym(nvml->lib.handle, "nvml" STRINGIFY_SYMBOL(_proc)); \
-    nvml->lib._proc = dlsym(nvml->lib.handle, EXPAND_STRING(nvml ## _proc));   \
-    if (nvml->lib._proc == NULL) {                                             \
-        if (_required) {                                                       \
-            goto fail;                                                         \
-        } else {                                                               \
-            nvml->lib._proc = (void*) NvmlStubFunction;                        \
-        }                                                                      \
+#define GET_SYMBOL(_required, _proc)                                         \
+    ctx->lib._proc = dlsym(ctx->lib.handle, "nvml" STRINGIFY_SYMBOL(_proc)); \
+    ctx->lib._proc = dlsym(ctx->lib.handle, EXPAND_STRING(nvml ## _proc));   \
+    if (ctx->lib._proc == NULL) {                                            \
+        if (_required) {                                                     \
+            goto fail;                                                       \
+        } else {                                                             \
+            ctx->lib._proc = (void*) NvmlStubFunction;                       \
+        }                                                                    \
     }
 
     GET_SYMBOL(_REQUIRED, Init);
@@ -281,25 +308,456 @@ static Bool LoadNvml(NvCtrlNvmlAttributes *nvml)
     GET_SYMBOL(_OPTIONAL, DeviceGetAdaptiveClockInfoStatus);
     GET_SYMBOL(_OPTIONAL, DeviceGetPowerMizerMode_v1);
     GET_SYMBOL(_OPTIONAL, DeviceSetPowerMizerMode_v1);
+    GET_SYMBOL(_OPTIONAL, EventSetCreate);
+    GET_SYMBOL(_OPTIONAL, EventSetFree);
+    GET_SYMBOL(_OPTIONAL, EventSetWait);
+    GET_SYMBOL(_OPTIONAL, DeviceRegisterEvents);
+    GET_SYMBOL(_OPTIONAL, DeviceGetSupportedEventTypes);
+    GET_SYMBOL(_OPTIONAL, DeviceGetFieldValues);
 #undef GET_SYMBOL
 #undef EXPAND_STRING
 #undef STRINGIFY_SYMBOL
 
-    ret = nvml->lib.Init();
+    ret = ctx->lib.Init();
 
     if (ret != NVML_SUCCESS) {
         printNvmlError(ret);
         goto fail;
     }
 
+    nvmlInitCount++;
+
     return True;
 
 fail:
-    UnloadNvml(nvml);
+    UnloadNvml(ctx);
     return False;
 }
 
 
+/*
+ * Look up the cached NVML handle of the device at NVML index 'idx'.  Device
+ * handles stay valid for as long as the library is initialized, so they are
+ * resolved once when the shared context is built.
+ */
+
+static nvmlReturn_t getNvmlDevice(const NvCtrlNvmlAttributes *nvml,
+                                  unsigned int idx, nvmlDevice_t *device)
+{
+    const NvCtrlNvmlContext *ctx = nvml->ctx;
+
+    if ((idx >= ctx->deviceCount) || !ctx->deviceValid[idx]) {
+        return NVML_ERROR_INVALID_ARGUMENT;
+    }
+
+    *device = ctx->devices[idx];
+
+    return NVML_SUCCESS;
+}
+
+
+
+/*
+ * Account for NVML calls made (or avoided, for queries served from a
+ * telemetry snapshot) and, with --verbose=all, periodically report the rate.
+ */
+
+static void countNvmlCalls(NvCtrlNvmlContext *ctx, unsigned int calls,
+                           unsigned int reads)
+{
+    uint64_t now = nv_get_monotonic_time_us();
+    uint64_t elapsed;
+
+    if (ctx->stats.windowStart == 0) {
+        ctx->stats.windowStart = now;
+    }
+
+    ctx->stats.calls += calls;
+    ctx->stats.reads += reads;
+
+    elapsed = now - ctx->stats.windowStart;
+    if (elapsed < NVML_STATS_REPORT_INTERVAL_US) {
+        return;
+    }
+
+    nv_info_msg(NULL, "NVML: %.1f calls/s over the last %.0f s, "
+                "%llu quer%s served from telemetry snapshots.",
+                (double) ctx->stats.calls * 1000000.0 / elapsed,
+                (double) elapsed / 1000000.0, ctx->stats.reads,
+                (ctx->stats.reads == 1) ? "y" : "ies");
+
+    ctx->stats.windowStart = now;
+    ctx->stats.calls = 0;
+    ctx->stats.reads = 0;
+}
+
+
+
+/*
+ * Map the current performance state of the device to the index of that
+ * state among the supported ones, which is what NV-CONTROL reports as the
+ * current performance level.
+ */
+
+static nvmlReturn_t getNvmlPerformanceLevel(const NvCtrlNvmlContext *ctx,
+                                            nvmlDevice_t device,
+                                            unsigned int *level)
+{
+    nvmlPstates_t pState;
+    nvmlPstates_t pStates[NVML_MAX_GPU_PERF_PSTATES];
+    nvmlReturn_t ret;
+    int i;
+
+    ret = ctx->lib.DeviceGetPerformanceState(device, &pState);
+    if (ret != NVML_SUCCESS) {
+        return ret;
+    }
+    ret = ctx->lib.DeviceGetSupportedPerformanceStates(device, pStates,
+                                                      NVML_MAX_GPU_PERF_PSTATES);
+    if (ret != NVML_SUCCESS) {
+        return ret;
+    }
+
+    *level = 0;
+    for (i = 0; i < NVML_MAX_GPU_PERF_PSTATES; i++) {
+        if (pStates[i] == NVML_PSTATE_UNKNOWN) {
+            continue;
+        }
+        if (pStates[i] == pState) {
+            *level = i;
+            break;
+        }
+    }
+
+    return NVML_SUCCESS;
+}
+
+
+
+static nvmlReturn_t getNvmlMemoryInfo(const NvCtrlNvmlContext *ctx,
+                                      nvmlDevice_t device,
+                                      unsigned long long *total,
+                                      unsigned long long *used)
+{
+    nvmlReturn_t ret;
+
+    if (ctx->lib.DeviceGetMemoryInfo_v2 != (void *) NvmlStubFunction) {
+        nvmlMemory_v2_t memory;
+        memory.version = nvmlMemory_v2;
+        ret = ctx->lib.DeviceGetMemoryInfo_v2(device, &memory);
+        if (ret == NVML_SUCCESS) {
+            *total = memory.total;
+            *used = memory.used;
+        }
+    } else {
+        nvmlMemory_t memory;
+        ret = ctx->lib.DeviceGetMemoryInfo(device, &memory);
+        if (ret == NVML_SUCCESS) {
+            *total = memory.total;
+            *used = memory.used;
+        }
+    }
+
+    return ret;
+}
+
+
+
+static unsigned long long nvmlFieldValueToULL(const nvmlFieldValue_t *field)
+{
+    switch (field->valueType) {
+        case NVML_VALUE_TYPE_DOUBLE:
+            return (unsigned long long) field->value.dVal;
+        case NVML_VALUE_TYPE_UNSIGNED_INT:
+            return field->value.uiVal;
+        case NVML_VALUE_TYPE_UNSIGNED_LONG:
+            return field->value.ulVal;
+        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:
+            return field->value.sllVal;
+        case NVML_VALUE_TYPE_SIGNED_INT:
+            return field->value.siVal;
+        case NVML_VALUE_TYPE_UNSIGNED_SHORT:
+            return field->value.usVal;
+        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG:
+        default:
+            return field->value.ullVal;
+    }
+}
+
+
+
+/*
+ * Sample the telemetry metrics in the 'todo' mask for the device at NVML
+ * index 'idx' in one pass.  The volatile ECC counters are fetched with a
+ * single nvmlDeviceGetFieldValues() call when the library provides it; the
+ * remaining metrics, and any field the driver could not report, fall back to
+ * their dedicated entry points.
+ *
+ * Power draw is always read with nvmlDeviceGetPowerUsage().  NVML only
+ * documents its reading as a one second average on some GPUs, and as the
+ * current draw on others, while the NVML_FI_DEV_POWER_AVERAGE field is
+ * always an average and is not reported by older GPUs; the field is not a
+ * substitute for it.
+ */
+
+static void sampleNvmlTelemetry(NvCtrlNvmlContext *ctx, unsigned int idx,
+                                unsigned int todo)
+{
+    NvCtrlNvmlTelemetry *t = &ctx->telemetry[idx];
+    nvmlDevice_t device = ctx->devices[idx];
+    unsigned int calls = 0;
+
+    if (ctx->lib.DeviceGetFieldValues != (void *) NvmlStubFunction) {
+        nvmlFieldValue_t fields[2];
+        NvCtrlNvmlTelemetryMetric metrics[2];
+        int i, count = 0;
+        nvmlReturn_t ret;
+
+        memset(fields, 0, sizeof(fields));
+
+        if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_ECC_SBE_VOLATILE)) {
+            fields[count].fieldId = NVML_FI_DEV_ECC_SBE_VOL_TOTAL;
+            metrics[count++] = NVML_TELEMETRY_ECC_SBE_VOLATILE;
+        }
+        if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_ECC_DBE_VOLATILE)) {
+            fields[count].fieldId = NVML_FI_DEV_ECC_DBE_VOL_TOTAL;
+            metrics[count++] = NVML_TELEMETRY_ECC_DBE_VOLATILE;
+        }
+
+        if (count > 0) {
+            ret = ctx->lib.DeviceGetFieldValues(device, count, fields);
+            calls++;
+
+            for (i = 0; (ret == NVML_SUCCESS) && (i < count); i++) {
+                unsigned long long value;
+
+                if (fields[i].nvmlReturn != NVML_SUCCESS) {
+                    continue;
+                }
+
+                value = nvmlFieldValueToULL(&fields[i]);
+
+                switch (metrics[i]) {
+                    case NVML_TELEMETRY_ECC_SBE_VOLATILE:
+                        t->eccSbeVolatile = value;
+                        break;
+                    case NVML_TELEMETRY_ECC_DBE_VOLATILE:
+                        t->eccDbeVolatile = value;
+                        break;
+                    default:
+                        break;
+                }
+                t->status[metrics[i]] = NVML_SUCCESS;
+                todo &= ~NVML_TELEMETRY_BIT(metrics[i]);
+            }
+        }
+    }
+
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_POWER_USAGE)) {
+        t->status[NVML_TELEMETRY_POWER_USAGE] =
+            ctx->lib.DeviceGetPowerUsage(device, &t->powerUsage);
+        calls++;
+    }
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_ECC_SBE_VOLATILE)) {
+        t->status[NVML_TELEMETRY_ECC_SBE_VOLATILE] =
+            ctx->lib.DeviceGetTotalEccErrors(device,
+                                             NVML_MEMORY_ERROR_TYPE_CORRECTED,
+                                             NVML_VOLATILE_ECC,
+                                             &t->eccSbeVolatile);
+        calls++;
+    }
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_ECC_DBE_VOLATILE)) {
+        t->status[NVML_TELEMETRY_ECC_DBE_VOLATILE] =
+            ctx->lib.DeviceGetTotalEccErrors(device,
+                                             NVML_MEMORY_ERROR_TYPE_UNCORRECTED,
+                                             NVML_VOLATILE_ECC,
+                                             &t->eccDbeVolatile);
+        calls++;
+    }
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_CORE_TEMPERATURE)) {
+        nvmlTemperature_t temperature = {
+            .version = nvmlTemperature_v1,
+            .sensorType = NVML_TEMPERATURE_GPU,
+        };
+        t->status[NVML_TELEMETRY_CORE_TEMPERATURE] =
+            ctx->lib.DeviceGetTemperatureV(device, &temperature);
+        t->coreTemperature = (unsigned)temperature.temperature;
+        calls++;
+    }
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_MEMORY_INFO)) {
+        t->status[NVML_TELEMETRY_MEMORY_INFO] =
+            getNvmlMemoryInfo(ctx, device, &t->memoryTotal, &t->memoryUsed);
+        calls++;
+    }
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_UTILIZATION)) {
+        t->status[NVML_TELEMETRY_UTILIZATION] =
+            ctx->lib.DeviceGetUtilizationRates(device, &t->utilization);
+        calls++;
+    }
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_PERFORMANCE_LEVEL)) {
+        t->status[NVML_TELEMETRY_PERFORMANCE_LEVEL] =
+            getNvmlPerformanceLevel(ctx, device, &t->performanceLevel);
+        calls += 2;
+    }
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_CLOCK_FREQS)) {
+        nvmlDeviceCurrentClockFreqs_t currentClockFreqs;
+
+        currentClockFreqs.version = nvmlDeviceCurrentClockFreqs_v1;
+        t->status[NVML_TELEMETRY_CLOCK_FREQS] =
+            ctx->lib.DeviceGetCurrentClockFreqs(device, &currentClockFreqs);
+        if (t->status[NVML_TELEMETRY_CLOCK_FREQS] == NVML_SUCCESS) {
+            strcpy(t->clockFreqs, currentClockFreqs.str);
+        }
+        calls++;
+    }
+    if (todo & NVML_TELEMETRY_BIT(NVML_TELEMETRY_THERMAL_SETTINGS)) {
+        t->status[NVML_TELEMETRY_THERMAL_SETTINGS] =
+            ctx->lib.DeviceGetThermalSettings(device, NVML_THERMAL_TARGET_ALL,
+                                              &t->thermalSettings);
+        calls++;
+    }
+
+    countNvmlCalls(ctx, calls, 0);
+}
+
+
+
+/*
+ * Return the telemetry snapshot of the device at NVML index 'idx' holding
+ * 'metric'.  A stale snapshot is refreshed with every metric read since the
+ * previous pass, so metrics of pages that are closed stop being sampled; a
+ * metric missing from a fresh snapshot is sampled on its own and joins the
+ * next pass.  Returns the NVML status of the metric.
+ */
+
+static nvmlReturn_t getNvmlTelemetry(NvCtrlNvmlContext *ctx, unsigned int idx,
+                                     NvCtrlNvmlTelemetryMetric metric,
+                                     const NvCtrlNvmlTelemetry **snapshot)
+{
+    NvCtrlNvmlTelemetry *t = &ctx->telemetry[idx];
+    unsigned int bit = NVML_TELEMETRY_BIT(metric);
+    uint64_t now = nv_get_monotonic_time_us();
+
+    if ((t->timestamp == 0) ||
+        (now - t->timestamp >= ctx->telemetryMaxAge)) {
+        t->subscribed = t->read | bit;
+        t->read = bit;
+        sampleNvmlTelemetry(ctx, idx, t->subscribed);
+        t->timestamp = now;
+    } else if (!(t->subscribed & bit)) {
+        t->subscribed |= bit;
+        t->read |= bit;
+        sampleNvmlTelemetry(ctx, idx, bit);
+    } else {
+        t->read |= bit;
+        countNvmlCalls(ctx, 0, 1);
+    }
+
+    *snapshot = t;
+
+    return t->status[metric];
+}
+
+
+
+/*
+ * Shorten the lifetime of telemetry snapshots for clients polling faster
+ * than the default sharing window; see NvCtrlAttributes.h.
+ */
+
+void NvCtrlSetTelemetryInterval(CtrlSystem *system, unsigned int interval_ms)
+{
+    NvCtrlNvmlContext *ctx;
+    uint64_t maxAge = (uint64_t) interval_ms * 1000 / 2;
+
+    if ((system == NULL) || (system->nvml_context == NULL)) {
+        return;
+    }
+
+    ctx = system->nvml_context;
+    ctx->telemetryMaxAge = NV_MIN(maxAge, NVML_TELEMETRY_MAX_AGE_US);
+}
+
+
+
+/*
+ * Discard the telemetry snapshot of the device at NVML index 'idx', e.g.
+ * after the device was reconfigured or reported a change through an event.
+ */
+
+static void invalidateNvmlTelemetry(NvCtrlNvmlContext *ctx, unsigned int idx)
+{
+    if ((ctx->telemetry != NULL) && (idx < ctx->deviceCount)) {
+        ctx->telemetry[idx].timestamp = 0;
+    }
+}
+
+
+
+/*
+ * Discard the telemetry of the GPU behind 'ctrl_target' before it is
+ * reconfigured (e.g. ECC counters reset, PowerMizer mode or clock offsets
+ * changed), so the next query reflects the new state.  Settings on a sensor
+ * or cooler may affect any GPU, so every snapshot is dropped for those.
+ */
+
+static void invalidateTargetTelemetry(const CtrlTarget *ctrl_target)
+{
+    const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
+    const NvCtrlNvmlAttributes *nvml = getNvmlHandleConst(h);
+    unsigned int i;
+
+    if (nvml == NULL) {
+        return;
+    }
+
+    if (NvCtrlGetTargetType(ctrl_target) == GPU_TARGET) {
+        invalidateNvmlTelemetry(nvml->ctx, nvml->deviceIdx);
+        return;
+    }
+
+    for (i = 0; i < nvml->ctx->deviceCount; i++) {
+        invalidateNvmlTelemetry(nvml->ctx, i);
+    }
+}
+
+
+
+/*
+ * Whether a query of the given attribute is served by the telemetry sampler;
+ * any other query costs (about) one direct NVML call.
+ */
+
+static Bool isNvmlTelemetryAttribute(CtrlAttributeType attr_type, int attr)
+{
+    if (attr_type == CTRL_ATTRIBUTE_TYPE_STRING) {
+        switch (attr) {
+            case NV_CTRL_STRING_GPU_UTILIZATION:
+            case NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS:
+                return TRUE;
+            default:
+                return FALSE;
+        }
+    }
+
+    switch (attr) {
+        case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
+        case NV_CTRL_USED_DEDICATED_GPU_MEMORY:
+        case NV_CTRL_GPU_CORE_TEMPERATURE:
+        case NV_CTRL_GPU_ECC_SINGLE_BIT_ERRORS:
+        case NV_CTRL_GPU_ECC_DOUBLE_BIT_ERRORS:
+        case NV_CTRL_ATTR_NVML_GPU_GET_POWER_USAGE:
+        case NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL:
+        case NV_CTRL_THERMAL_SENSOR_READING:
+        case NV_CTRL_THERMAL_SENSOR_PROVIDER:
+        case NV_CTRL_THERMAL_SENSOR_TARGET:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+
 /*
  * Creates and fills an IDs dictionary so we can translate from NV-CONTROL IDs
  * to NVML indexes
@@ -307,14 +765,13 @@ fail:
  * XXX Needed while using NV-CONTROL as fallback during the migration process
  */
 
-static Bool matchNvCtrlWithNvmlIds(const NvCtrlNvmlAttributes *nvml,
+static Bool matchNvCtrlWithNvmlIds(const NvCtrlNvmlContext *ctx,
                                    const NvCtrlAttributePrivateHandle *h,
                                    int nvmlGpuCount,
                                    unsigned int **idsDictionary)
 {
     char nvmlUUID[MAX_NVML_STR_LEN];
     char *nvctrlUUID = NULL;
-    nvmlDevice_t device;
     int i, j;
     int nvctrlGpuCount = 0;
 
@@ -350,12 +807,13 @@ static Bool matchNvCtrlWithNvmlIds(const NvCtrlNvmlAttributes *nvml,
 
             /* Look for the same UUID through NVML */
             for (j = 0; j < nvmlGpuCount; j++) {
-                if (NVML_SUCCESS != nvml->lib.DeviceGetHandleByIndex(j, &device)) {
+                if (!ctx->deviceValid[j]) {
                     continue;
                 }
 
-                if (NVML_SUCCESS != nvml->lib.DeviceGetUUID(device, nvmlUUID,
-                                                            MAX_NVML_STR_LEN)) {
+                if (NVML_SUCCESS != ctx->lib.DeviceGetUUID(ctx->devices[j],
+                                                           nvmlUUID,
+                                                           MAX_NVML_STR_LEN)) {
                     continue;
                 }
 
@@ -381,123 +839,238 @@ static Bool matchNvCtrlWithNvmlIds(const NvCtrlNvmlAttributes *nvml,
 
 fail:
     nvfree(*idsDictionary);
+    *idsDictionary = NULL;
     return FALSE;
 }
 
 
 
 /*
- * Initializes an NVML private handle to hold some information to be used later
- * on
+ * Frees the shared NVML context and unloads the library.
  */
 
-NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *h)
+static void NvmlContextFree(NvCtrlNvmlContext *ctx)
 {
-    NvCtrlNvmlAttributes *nvml = NULL;
+    if (ctx == NULL) {
+        return;
+    }
+
+    UnloadNvml(ctx);
+    nvfree(ctx->devices);
+    nvfree(ctx->deviceValid);
+    nvfree(ctx->nvctrlToNvmlId);
+    nvfree(ctx->sensorCountPerGPU);
+    nvfree(ctx->coolerCountPerGPU);
+    nvfree(ctx->telemetry);
+    nvfree(ctx);
+}
+
+
+
+/*
+ * Loads NVML and walks every device once to build the state shared by all
+ * the NVML targets of a system: device handles, the NV-CONTROL to NVML IDs
+ * dictionary and the number of thermal sensors and coolers per GPU.
+ */
+
+static NvCtrlNvmlContext *NvmlContextCreate(const NvCtrlAttributePrivateHandle *h)
+{
+    NvCtrlNvmlContext *ctx;
     unsigned int count;
-    unsigned int *nvctrlToNvmlId;
     int i;
     int nvctrlCoolerCount;
 
-    /* Check parameters */
-    if (h == NULL || !TARGET_TYPE_IS_NVML_COMPATIBLE(h->target_type)) {
-        goto fail;
-    }
-
-    /* Create storage for NVML attributes */
-    nvml = nvalloc(sizeof(NvCtrlNvmlAttributes));
+    ctx = nvalloc(sizeof(NvCtrlNvmlContext));
 
-    if (!LoadNvml(nvml)) {
+    if (!LoadNvml(ctx)) {
         goto fail;
     }
 
-    /* Initialize NVML attributes */
-    if (nvml->lib.DeviceGetCount(&count) != NVML_SUCCESS) {
+    if (ctx->lib.DeviceGetCount(&count) != NVML_SUCCESS) {
         goto fail;
     }
-    nvml->deviceCount = count;
+    ctx->deviceCount = count;
+
+    ctx->devices = nvalloc(count * sizeof(nvmlDevice_t));
+    ctx->deviceValid = nvalloc(count * sizeof(Bool));
+    ctx->sensorCountPerGPU = nvalloc(count * sizeof(unsigned int));
+    ctx->sensorCount = 0;
+    ctx->coolerCountPerGPU = nvalloc(count * sizeof(unsigned int));
+    ctx->coolerCount = 0;
+    ctx->telemetry = nvalloc(count * sizeof(NvCtrlNvmlTelemetry));
+    ctx->telemetryMaxAge = NVML_TELEMETRY_MAX_AGE_US;
 
-    nvml->sensorCountPerGPU = nvalloc(count * sizeof(unsigned int));
-    nvml->sensorCount = 0;
-    nvml->coolerCountPerGPU = nvalloc(count * sizeof(unsigned int));
-    nvml->coolerCount = 0;
+    for (i = 0; i < count; i++) {
+        nvmlReturn_t ret = ctx->lib.DeviceGetHandleByIndex(i,
+                                                           &ctx->devices[i]);
+        ctx->deviceValid[i] = (ret == NVML_SUCCESS);
+    }
 
     /* Fill the NV-CONTROL to NVML IDs dictionary */
-    if (!matchNvCtrlWithNvmlIds(nvml, h, count, &nvctrlToNvmlId)) {
+    if (!matchNvCtrlWithNvmlIds(ctx, h, count, &ctx->nvctrlToNvmlId)) {
         goto fail;
     }
 
+    /* Fill 'sensorCountPerGPU' and 'coolerCountPerGPU' */
+    for (i = 0; i < count; i++) {
+        int devIdx = ctx->nvctrlToNvmlId[i];
+        nvmlDevice_t device = ctx->devices[devIdx];
+        nvmlReturn_t ret;
+        unsigned int fans;
+        nvmlGpuThermalSettings_t pThermalSettings;
+
+        if (!ctx->deviceValid[devIdx]) {
+            continue;
+        }
+
+        ret = ctx->lib.DeviceGetThermalSettings(device, NVML_THERMAL_TARGET_ALL, //sensorIndex
+                                                &pThermalSettings);
+        if (ret == NVML_SUCCESS) {
+            ctx->sensorCountPerGPU[devIdx] = pThermalSettings.count;
+            ctx->sensorCount += pThermalSettings.count;
+        }
+
+        ret = ctx->lib.DeviceGetNumFans(device, &fans);
+        if (ret == NVML_SUCCESS) {
+            ctx->coolerCountPerGPU[devIdx] = fans;
+            ctx->coolerCount += fans;
+        }
+    }
+
     /*
-     * Fill 'sensorCountPerGPU', 'coolerCountPerGPU' and properly set
-     * 'deviceIdx'
+     * Consistency check between X/NV-CONTROL and NVML.
      */
-    nvml->deviceIdx = h->target_id; /* Fallback */
+    if (h->nv &&
+        (!XNVCTRLQueryTargetCount(h->dpy, NV_CTRL_TARGET_TYPE_COOLER,
+                                   &nvctrlCoolerCount) ||
+         (nvctrlCoolerCount != ctx->coolerCount))) {
+        nv_warning_msg("Inconsistent number of fans detected.");
+    }
+
+    return ctx;
+
+ fail:
+    NvmlContextFree(ctx);
+    return NULL;
+}
+
+
+
+/*
+ * Returns the NVML device index owning the 'targetId'th sensor or cooler of
+ * the system, walking GPUs that have at least one in NV-CONTROL order;
+ * returns 'targetId' if no GPU owns it.
+ */
+
+static unsigned int getTopologyDeviceIdx(const NvCtrlNvmlContext *ctx,
+                                         const unsigned int *targetCountPerGPU,
+                                         int targetId)
+{
+    int i, count = 0;
+
+    for (i = 0; i < ctx->deviceCount; i++) {
+        int devIdx = ctx->nvctrlToNvmlId[i];
+
+        /*
+         * GPUs without any sensor or cooler own no targets; they must not
+         * capture the target that starts at the next GPU.
+         */
+        if (!ctx->deviceValid[devIdx] || (targetCountPerGPU[devIdx] == 0)) {
+            continue;
+        }
 
-    if (h->target_type == GPU_TARGET) {
-        nvml->deviceIdx = nvctrlToNvmlId[h->target_id];
+        if (targetId == count) {
+            return devIdx;
+        }
+        count += targetCountPerGPU[devIdx];
     }
 
-    for (i = 0; i < count; i++) {
-        int devIdx = nvctrlToNvmlId[i];
-        nvmlDevice_t device;
-        nvmlReturn_t ret = nvml->lib.DeviceGetHandleByIndex(devIdx, &device);
-        if (ret == NVML_SUCCESS) {
-            unsigned int fans;
-            nvmlGpuThermalSettings_t pThermalSettings;
+    return targetId;
+}
 
-            ret = nvml->lib.DeviceGetThermalSettings(device, NVML_THERMAL_TARGET_ALL, //sensorIndex
-                                                     &pThermalSettings);
-            if (ret == NVML_SUCCESS) {
-                if ((h->target_type == THERMAL_SENSOR_TARGET) &&
-                    (h->target_id == nvml->sensorCount)) {
 
-                    nvml->deviceIdx = devIdx;
-                }
 
-                nvml->sensorCountPerGPU[devIdx] = pThermalSettings.count;
-                nvml->sensorCount += pThermalSettings.count;
-            }
+/*
+ * Initializes an NVML private handle to hold some information to be used later
+ * on.  The NVML library itself is loaded once per CtrlSystem and shared by all
+ * its targets.
+ */
 
-            ret = nvml->lib.DeviceGetNumFans(device, &fans);
-            if (ret == NVML_SUCCESS) {
-                if ((h->target_type == COOLER_TARGET) &&
-                    (h->target_id == nvml->coolerCount)) {
+NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *h,
+                                               CtrlSystem *system)
+{
+    NvCtrlNvmlAttributes *nvml = NULL;
+    NvCtrlNvmlContext *ctx;
 
-                    nvml->deviceIdx = devIdx;
-                }
+    /* Check parameters */
+    if (h == NULL || system == NULL ||
+        !TARGET_TYPE_IS_NVML_COMPATIBLE(h->target_type)) {
+        return NULL;
+    }
 
-                nvml->coolerCountPerGPU[devIdx] = fans;
-                nvml->coolerCount += fans;
-            }
+    ctx = system->nvml_context;
+
+    if (ctx == NULL) {
+        ctx = NvmlContextCreate(h);
+        if (ctx == NULL) {
+            return NULL;
         }
+        ctx->system = system;
+        system->nvml_context = ctx;
     }
 
-    /*
-     * Consistency check between X/NV-CONTROL and NVML.
-     */
-    if (h->nv &&
-        (!XNVCTRLQueryTargetCount(h->dpy, NV_CTRL_TARGET_TYPE_COOLER,
-                                   &nvctrlCoolerCount) ||
-         (nvctrlCoolerCount != nvml->coolerCount))) {
-        nv_warning_msg("Inconsistent number of fans detected.");
+    ctx->refcount++;
+
+    /* Create storage for NVML attributes */
+    nvml = nvalloc(sizeof(NvCtrlNvmlAttributes));
+    nvml->ctx = ctx;
+
+    /* Properly set 'deviceIdx' */
+    switch (h->target_type) {
+        case GPU_TARGET:
+            nvml->deviceIdx = h->target_id; /* Fallback */
+            if ((h->target_id >= 0) && (h->target_id < ctx->deviceCount)) {
+                nvml->deviceIdx = ctx->nvctrlToNvmlId[h->target_id];
+            }
+            break;
+        case THERMAL_SENSOR_TARGET:
+            nvml->deviceIdx = getTopologyDeviceIdx(ctx, ctx->sensorCountPerGPU,
+                                                   h->target_id);
+            break;
+        case COOLER_TARGET:
+            nvml->deviceIdx = getTopologyDeviceIdx(ctx, ctx->coolerCountPerGPU,
+                                                   h->target_id);
+            break;
+        default:
+            nvml->deviceIdx = h->target_id;
+            break;
     }
 
-    nvfree(nvctrlToNvmlId);
-
     return nvml;
+}
 
- fail:
-    UnloadNvml(nvml);
-    nvfree(nvml->sensorCountPerGPU);
-    nvfree(nvml->coolerCountPerGPU);
-    nvfree(nvml);
-    return NULL;
+
+
+/*
+ * Drops a reference to the shared NVML context, freeing it once its last
+ * user is gone.
+ */
+
+static void NvmlContextRelease(NvCtrlNvmlContext *ctx)
+{
+    if (--ctx->refcount == 0) {
+        if (ctx->system && (ctx->system->nvml_context == ctx)) {
+            ctx->system->nvml_context = NULL;
+        }
+        NvmlContextFree(ctx);
+    }
 }
 
 
 
 /*
- * Frees any resource hold by the NVML private handle
+ * Frees any resource hold by the NVML private handle, and the shared NVML
+ * context once its last user is gone.
  */
 
 void NvCtrlNvmlAttributesClose(NvCtrlAttributePrivateHandle *h)
@@ -507,9 +1080,8 @@ void NvCtrlNvmlAttributesClose(NvCtrlAttributePrivateHandle *h)
         return;
     }
 
-    UnloadNvml(h->nvml);
-    nvfree(h->nvml->sensorCountPerGPU);
-    nvfree(h->nvml->coolerCountPerGPU);
+    NvmlContextRelease(h->nvml->ctx);
+
     nvfree(h->nvml);
     h->nvml = NULL;
 }
@@ -542,13 +1114,13 @@ ReturnStatus NvCtrlNvmlQueryTargetCount(const CtrlTarget *ctrl_target,
 
     switch (target_type) {
         case GPU_TARGET:
-            *val = (int)(h->nvml->deviceCount);
+            *val = (int)(h->nvml->ctx->deviceCount);
             break;
         case THERMAL_SENSOR_TARGET:
-            *val = (int)(h->nvml->sensorCount);
+            *val = (int)(h->nvml->ctx->sensorCount);
             break;
         case COOLER_TARGET:
-            *val = (int)(h->nvml->coolerCount);
+            *val = (int)(h->nvml->ctx->coolerCount);
             break;
         default:
             return NvCtrlBadArgument;
@@ -577,11 +1149,11 @@ static ReturnStatus NvCtrlNvmlGetGeneralStringAttribute(const CtrlTarget *ctrl_t
 
     switch (attr) {
         case NV_CTRL_STRING_NVIDIA_DRIVER_VERSION:
-            ret = h->nvml->lib.SystemGetDriverVersion(res, MAX_NVML_STR_LEN);
+            ret = h->nvml->ctx->lib.SystemGetDriverVersion(res, MAX_NVML_STR_LEN);
             break;
 
         case NV_CTRL_STRING_NVML_VERSION:
-            ret = h->nvml->lib.SystemGetNVMLVersion(res, MAX_NVML_STR_LEN);
+            ret = h->nvml->ctx->lib.SystemGetNVMLVersion(res, MAX_NVML_STR_LEN);
             break;
 
         default:
@@ -611,6 +1183,7 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
     char res[NVML_PERF_MODES_BUFFER_SIZE];
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
     const NvCtrlNvmlAttributes *nvml;
+    const NvCtrlNvmlTelemetry *telemetry;
     nvmlDevice_t device;
     nvmlReturn_t ret;
     *ptr = NULL;
@@ -620,25 +1193,27 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, nvml->deviceIdx, &device);
     if (ret == NVML_SUCCESS) {
+        if (!isNvmlTelemetryAttribute(CTRL_ATTRIBUTE_TYPE_STRING, attr)) {
+            countNvmlCalls(nvml->ctx, 1, 0);
+        }
+
         switch (attr) {
             case NV_CTRL_STRING_PRODUCT_NAME:
-                ret = nvml->lib.DeviceGetName(device, res, MAX_NVML_STR_LEN);
+                ret = nvml->ctx->lib.DeviceGetName(device, res, MAX_NVML_STR_LEN);
                 break;
 
             case NV_CTRL_STRING_VBIOS_VERSION:
-                ret = nvml->lib.DeviceGetVbiosVersion(device, res, MAX_NVML_STR_LEN);
+                ret = nvml->ctx->lib.DeviceGetVbiosVersion(device, res, MAX_NVML_STR_LEN);
                 break;
 
             case NV_CTRL_STRING_GPU_UUID:
-                ret = nvml->lib.DeviceGetUUID(device, res, MAX_NVML_STR_LEN);
+                ret = nvml->ctx->lib.DeviceGetUUID(device, res, MAX_NVML_STR_LEN);
                 break;
 
             case NV_CTRL_STRING_GPU_UTILIZATION:
             {
-                nvmlUtilization_t util;
-
                 if (ctrl_target->system->has_nv_control) {
                     /*
                      * Not all utilization types are currently available via
@@ -647,7 +1222,8 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
                     return NvCtrlNotSupported;
                 }
 
-                ret = nvml->lib.DeviceGetUtilizationRates(device, &util);
+                ret = getNvmlTelemetry(nvml->ctx, nvml->deviceIdx,
+                                       NVML_TELEMETRY_UTILIZATION, &telemetry);
 
                 if (ret != NVML_SUCCESS) {
                     break;
@@ -655,7 +1231,8 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
 
                 snprintf(res, sizeof(res),
                          "graphics=%d, memory=%d",
-                         util.gpu, util.memory);
+                         telemetry->utilization.gpu,
+                         telemetry->utilization.memory);
 
                 break;
             }
@@ -664,7 +1241,7 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
                 nvmlDevicePerfModes_t perfModes;
 
                 perfModes.version = nvmlDevicePerfModes_v1;
-                ret = nvml->lib.DeviceGetPerformanceModes(device, &perfModes);
+                ret = nvml->ctx->lib.DeviceGetPerformanceModes(device, &perfModes);
                 if (ret == NVML_SUCCESS) {
                     strcpy(res, perfModes.str);
                 }
@@ -672,16 +1249,12 @@ static ReturnStatus NvCtrlNvmlGetGPUStringAttribute(const CtrlTarget *ctrl_targe
             }
 
             case NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS:
-            {
-                nvmlDeviceCurrentClockFreqs_t currentClockFreqs;
-
-                currentClockFreqs.version = nvmlDeviceCurrentClockFreqs_v1;
-                ret = nvml->lib.DeviceGetCurrentClockFreqs(device, &currentClockFreqs);
+                ret = getNvmlTelemetry(nvml->ctx, nvml->deviceIdx,
+                                       NVML_TELEMETRY_CLOCK_FREQS, &telemetry);
                 if (ret == NVML_SUCCESS) {
-                    strcpy(res, currentClockFreqs.str);
+                    strcpy(res, telemetry->clockFreqs);
                 }
                 break;
-            }
 
             case NV_CTRL_STRING_SLI_MODE:
             case NV_CTRL_STRING_MULTIGPU_MODE:
@@ -775,7 +1348,7 @@ static ReturnStatus NvCtrlNvmlSetGPUStringAttribute(CtrlTarget *ctrl_target,
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, nvml->deviceIdx, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS:
@@ -812,6 +1385,8 @@ ReturnStatus NvCtrlNvmlSetStringAttribute(CtrlTarget *ctrl_target,
         return NvCtrlMissingExtension;
     }
 
+    invalidateTargetTelemetry(ctrl_target);
+
     /*
      * This shouldn't be reached for target types that are not handled through
      * NVML (Keep TARGET_TYPE_IS_NVML_COMPATIBLE in NvCtrlAttributesPrivate.h up
@@ -858,7 +1433,7 @@ static nvmlReturn_t nvmlClockOffsetHelper(nvmlDevice_t device,
                 nvmlDeviceArchitecture_t arch;
 
                 /* attributes are supported on Maxwell GPUs only */
-                ret = nvml->lib.DeviceGetArchitecture(device, &arch);
+                ret = nvml->ctx->lib.DeviceGetArchitecture(device, &arch);
                 if ((ret != NVML_SUCCESS) || (arch != NVML_DEVICE_ARCH_MAXWELL)) {
                     return NVML_ERROR_NOT_SUPPORTED;
                 }
@@ -885,7 +1460,7 @@ static nvmlReturn_t nvmlClockOffsetHelper(nvmlDevice_t device,
                 info.pstate = NVML_PSTATE_0;
                 if (val || valid_values) {
                     /* get current clock offset and valid values */
-                    ret = nvml->lib.DeviceGetClockOffsets(device, &info);
+                    ret = nvml->ctx->lib.DeviceGetClockOffsets(device, &info);
 
                     if (ret != NVML_SUCCESS) {
                         return ret;
@@ -904,7 +1479,7 @@ static nvmlReturn_t nvmlClockOffsetHelper(nvmlDevice_t device,
                 if (setVal) {
                     /* set new clock offset value */
                     info.clockOffsetMHz = *setVal;
-                    ret = nvml->lib.DeviceSetClockOffsets(device, &info);
+                    ret = nvml->ctx->lib.DeviceSetClockOffsets(device, &info);
                     return ret;
                 }
             }
@@ -950,6 +1525,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
     unsigned int res = 0;
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
     const NvCtrlNvmlAttributes *nvml;
+    const NvCtrlNvmlTelemetry *telemetry;
     nvmlDevice_t device;
     nvmlReturn_t ret;
 
@@ -958,39 +1534,25 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, nvml->deviceIdx, &device);
     if (ret == NVML_SUCCESS) {
+        if (!isNvmlTelemetryAttribute(CTRL_ATTRIBUTE_TYPE_INTEGER, attr)) {
+            countNvmlCalls(nvml->ctx, 1, 0);
+        }
+
         switch (attr) {
             case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
             case NV_CTRL_USED_DEDICATED_GPU_MEMORY:
-                {
-                    if (nvml->lib.DeviceGetMemoryInfo_v2) {
-                        nvmlMemory_v2_t memory;
-                        memory.version = nvmlMemory_v2;
-                        ret = nvml->lib.DeviceGetMemoryInfo_v2(device, &memory);
-                        if (ret == NVML_SUCCESS) {
-                            switch (attr) {
-                                case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
-                                    res = memory.total >> 20; // bytes --> MB
-                                    break;
-                                case NV_CTRL_USED_DEDICATED_GPU_MEMORY:
-                                    res = memory.used >> 20; // bytes --> MB
-                                    break;
-                            }
-                        }
-                    } else {
-                        nvmlMemory_t memory;
-                        ret = nvml->lib.DeviceGetMemoryInfo(device, &memory);
-                        if (ret == NVML_SUCCESS) {
-                            switch (attr) {
-                                case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
-                                    res = memory.total >> 20; // bytes --> MB
-                                    break;
-                                case NV_CTRL_USED_DEDICATED_GPU_MEMORY:
-                                    res = memory.used >> 20; // bytes --> MB
-                                    break;
-                            }
-                        }
+                ret = getNvmlTelemetry(nvml->ctx, nvml->deviceIdx,
+                                       NVML_TELEMETRY_MEMORY_INFO, &telemetry);
+                if (ret == NVML_SUCCESS) {
+                    switch (attr) {
+                        case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
+                            res = telemetry->memoryTotal >> 20; // bytes --> MB
+                            break;
+                        case NV_CTRL_USED_DEDICATED_GPU_MEMORY:
+                            res = telemetry->memoryUsed >> 20; // bytes --> MB
+                            break;
                     }
                 }
                 break;
@@ -1002,7 +1564,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
             case NV_CTRL_PCI_ID:
                 {
                     nvmlPciInfo_t pci;
-                    ret = nvml->lib.DeviceGetPciInfo(device, &pci);
+                    ret = nvml->ctx->lib.DeviceGetPciInfo(device, &pci);
                     if (ret == NVML_SUCCESS) {
                         switch (attr) {
                             case NV_CTRL_PCI_DOMAIN:
@@ -1035,40 +1597,35 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                 break;
 
             case NV_CTRL_GPU_PCIE_GENERATION:
-                ret = nvml->lib.DeviceGetMaxPcieLinkGeneration(device, &res);
+                ret = nvml->ctx->lib.DeviceGetMaxPcieLinkGeneration(device, &res);
                 break;
 
             case NV_CTRL_GPU_PCIE_CURRENT_LINK_WIDTH:
-                ret = nvml->lib.DeviceGetCurrPcieLinkWidth(device, &res);
+                ret = nvml->ctx->lib.DeviceGetCurrPcieLinkWidth(device, &res);
                 break;
             case NV_CTRL_GPU_PCIE_MAX_LINK_WIDTH:
-                ret = nvml->lib.DeviceGetMaxPcieLinkWidth(device, &res);
+                ret = nvml->ctx->lib.DeviceGetMaxPcieLinkWidth(device, &res);
                 break;
             case NV_CTRL_GPU_SLOWDOWN_THRESHOLD:
-                ret = nvml->lib.DeviceGetTemperatureThreshold(device,
+                ret = nvml->ctx->lib.DeviceGetTemperatureThreshold(device,
                           NVML_TEMPERATURE_THRESHOLD_SLOWDOWN ,&res);
                 break;
             case NV_CTRL_GPU_SHUTDOWN_THRESHOLD:
-                ret = nvml->lib.DeviceGetTemperatureThreshold(device,
+                ret = nvml->ctx->lib.DeviceGetTemperatureThreshold(device,
                           NVML_TEMPERATURE_THRESHOLD_SHUTDOWN ,&res);
                 break;
             case NV_CTRL_GPU_CORE_TEMPERATURE:
-                {
-                    nvmlTemperature_t temperature = {
-                        .version = nvmlTemperature_v1,
-                        .sensorType = NVML_TEMPERATURE_GPU,
-                    };
-                    ret = nvml->lib.DeviceGetTemperatureV(device,
-                                                          &temperature);
-                    res = (unsigned)temperature.temperature;
-                }
+                ret = getNvmlTelemetry(nvml->ctx, nvml->deviceIdx,
+                                       NVML_TELEMETRY_CORE_TEMPERATURE,
+                                       &telemetry);
+                res = telemetry->coreTemperature;
                 break;
 
             case NV_CTRL_GPU_ECC_CONFIGURATION_SUPPORTED:
             case NV_CTRL_GPU_ECC_SUPPORTED:
                 {
                     nvmlEnableState_t current, pending;
-                    ret = nvml->lib.DeviceGetEccMode(device, &current, &pending);
+                    ret = nvml->ctx->lib.DeviceGetEccMode(device, &current, &pending);
                     switch (attr) {
                         case NV_CTRL_GPU_ECC_CONFIGURATION_SUPPORTED:
                             res = (ret == NVML_SUCCESS) ?
@@ -1093,7 +1650,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
             case NV_CTRL_GPU_ECC_STATUS:
                 {
                     nvmlEnableState_t current, pending;
-                    ret = nvml->lib.DeviceGetEccMode(device, &current, &pending);
+                    ret = nvml->ctx->lib.DeviceGetEccMode(device, &current, &pending);
                     if (ret == NVML_SUCCESS) {
                         switch (attr) {
                             case NV_CTRL_GPU_ECC_STATUS:
@@ -1110,7 +1667,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
             case NV_CTRL_GPU_ECC_DEFAULT_CONFIGURATION:
                 {
                     nvmlEnableState_t defaultMode;
-                    ret = nvml->lib.DeviceGetDefaultEccMode(device, &defaultMode);
+                    ret = nvml->ctx->lib.DeviceGetDefaultEccMode(device, &defaultMode);
                     if (ret == NVML_SUCCESS) {
                         res = defaultMode;
                     }
@@ -1118,33 +1675,40 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                 break;
 
             case NV_CTRL_GPU_ECC_SINGLE_BIT_ERRORS:
-            case NV_CTRL_GPU_ECC_AGGREGATE_SINGLE_BIT_ERRORS:
+                ret = getNvmlTelemetry(nvml->ctx, nvml->deviceIdx,
+                                       NVML_TELEMETRY_ECC_SBE_VOLATILE,
+                                       &telemetry);
+                if (ret == NVML_SUCCESS) {
+                    if (val) {
+                        *val = telemetry->eccSbeVolatile;
+                    }
+                    return NvCtrlSuccess;
+                }
+                break;
+
             case NV_CTRL_GPU_ECC_DOUBLE_BIT_ERRORS:
+                ret = getNvmlTelemetry(nvml->ctx, nvml->deviceIdx,
+                                       NVML_TELEMETRY_ECC_DBE_VOLATILE,
+                                       &telemetry);
+                if (ret == NVML_SUCCESS) {
+                    if (val) {
+                        *val = telemetry->eccDbeVolatile;
+                    }
+                    return NvCtrlSuccess;
+                }
+                break;
+
+            case NV_CTRL_GPU_ECC_AGGREGATE_SINGLE_BIT_ERRORS:
             case NV_CTRL_GPU_ECC_AGGREGATE_DOUBLE_BIT_ERRORS:
                 {
                     unsigned long long eccCounts;
-                    nvmlEccCounterType_t counterType;
-                    nvmlMemoryErrorType_t errorType;
-                    switch (attr) {
-                        case NV_CTRL_GPU_ECC_SINGLE_BIT_ERRORS:
-                            errorType = NVML_MEMORY_ERROR_TYPE_CORRECTED;
-                            counterType = NVML_VOLATILE_ECC;
-                            break;
-                        case NV_CTRL_GPU_ECC_AGGREGATE_SINGLE_BIT_ERRORS:
-                            errorType = NVML_MEMORY_ERROR_TYPE_CORRECTED;
-                            counterType = NVML_AGGREGATE_ECC;
-                            break;
-                        case NV_CTRL_GPU_ECC_DOUBLE_BIT_ERRORS:
-                            errorType = NVML_MEMORY_ERROR_TYPE_UNCORRECTED;
-                            counterType = NVML_VOLATILE_ECC;
-                            break;
-                        case NV_CTRL_GPU_ECC_AGGREGATE_DOUBLE_BIT_ERRORS:
-                            errorType = NVML_MEMORY_ERROR_TYPE_UNCORRECTED;
-                            counterType = NVML_AGGREGATE_ECC;
-                            break;
-                    }
+                    nvmlEccCounterType_t counterType = NVML_AGGREGATE_ECC;
+                    nvmlMemoryErrorType_t errorType =
+                        (attr == NV_CTRL_GPU_ECC_AGGREGATE_SINGLE_BIT_ERRORS) ?
+                        NVML_MEMORY_ERROR_TYPE_CORRECTED :
+                        NVML_MEMORY_ERROR_TYPE_UNCORRECTED;
 
-                    ret = nvml->lib.DeviceGetTotalEccErrors(device, errorType,
+                    ret = nvml->ctx->lib.DeviceGetTotalEccErrors(device, errorType,
                                                         counterType, &eccCounts);
                     if (ret == NVML_SUCCESS) {
                         if (val) {
@@ -1156,40 +1720,42 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                 break;
 
             case NV_CTRL_GPU_CORES:
-                ret = nvml->lib.DeviceGetNumGpuCores(device, &res);
+                ret = nvml->ctx->lib.DeviceGetNumGpuCores(device, &res);
                 break;
             case NV_CTRL_GPU_MEMORY_BUS_WIDTH:
-                ret = nvml->lib.DeviceGetMemoryBusWidth(device, &res);
+                ret = nvml->ctx->lib.DeviceGetMemoryBusWidth(device, &res);
                 break;
             case NV_CTRL_IRQ:
-                ret = nvml->lib.DeviceGetIrqNum(device, &res);
+                ret = nvml->ctx->lib.DeviceGetIrqNum(device, &res);
                 break;
             case NV_CTRL_GPU_POWER_SOURCE:
                 assert(NV_CTRL_GPU_POWER_SOURCE_AC == NVML_POWER_SOURCE_AC);
                 assert(NV_CTRL_GPU_POWER_SOURCE_BATTERY == NVML_POWER_SOURCE_BATTERY);
                 assert(NV_CTRL_GPU_POWER_SOURCE_UNDERSIZED == NVML_POWER_SOURCE_UNDERSIZED);
-                ret = nvml->lib.DeviceGetPowerSource(device, &res);
+                ret = nvml->ctx->lib.DeviceGetPowerSource(device, &res);
                 break;
             case NV_CTRL_ATTR_NVML_GPU_GET_POWER_USAGE:
-                ret = nvml->lib.DeviceGetPowerUsage(device, &res);
+                ret = getNvmlTelemetry(nvml->ctx, nvml->deviceIdx,
+                                       NVML_TELEMETRY_POWER_USAGE, &telemetry);
+                res = telemetry->powerUsage;
                 break;
 
             case NV_CTRL_ATTR_NVML_GPU_MAX_TGP:
                 {
                     unsigned int minLimit;
-                    ret = nvml->lib.DeviceGetPowerManagementLimitConstraints(device,
+                    ret = nvml->ctx->lib.DeviceGetPowerManagementLimitConstraints(device,
                                                                              &minLimit, &res);
                 }
                 break;
 
             case NV_CTRL_ATTR_NVML_GPU_DEFAULT_TGP:
-                ret = nvml->lib.DeviceGetPowerManagementDefaultLimit(device, &res);
+                ret = nvml->ctx->lib.DeviceGetPowerManagementDefaultLimit(device, &res);
                 break;
 
             case NV_CTRL_GPU_COOLER_MANUAL_CONTROL:
                 {
                     nvmlFanControlPolicy_t policy;
-                    int count = nvml->coolerCountPerGPU[nvml->deviceIdx];
+                    int count = nvml->ctx->coolerCountPerGPU[nvml->deviceIdx];
 
                     /* Return early if GPU has no fan */
                     if (count == 0) {
@@ -1197,7 +1763,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                     }
 
                     /* Get cooler control policy */
-                    ret = nvml->lib.DeviceGetFanControlPolicy_v2(device, 0, &policy);
+                    ret = nvml->ctx->lib.DeviceGetFanControlPolicy_v2(device, 0, &policy);
                     res = (policy == NVML_FAN_POLICY_MANUAL) ?
                         NV_CTRL_GPU_COOLER_MANUAL_CONTROL_TRUE :
                         NV_CTRL_GPU_COOLER_MANUAL_CONTROL_FALSE;
@@ -1205,28 +1771,13 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                 break;
 
             case NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL:
-                {
-                    nvmlPstates_t pState;
-                    nvmlPstates_t pStates[NVML_MAX_GPU_PERF_PSTATES];
-                    nvmlReturn_t ret1;
-                    int i = 0;
-
-                    ret = nvml->lib.DeviceGetPerformanceState(device, &pState);
-                    ret1 = nvml->lib.DeviceGetSupportedPerformanceStates(device, pStates, NVML_MAX_GPU_PERF_PSTATES);
-                    if ((ret != NVML_SUCCESS) || (ret1 != NVML_SUCCESS)) {
-                        return NvCtrlNotSupported;
-                    }
-
-                    for (i = 0; i < NVML_MAX_GPU_PERF_PSTATES; i++) {
-                        if (pStates[i] == NVML_PSTATE_UNKNOWN) {
-                            continue;
-                        }
-                        if (pStates[i] == pState) {
-                            res = i;
-                            break;
-                        }
-                    }
+                ret = getNvmlTelemetry(nvml->ctx, nvml->deviceIdx,
+                                       NVML_TELEMETRY_PERFORMANCE_LEVEL,
+                                       &telemetry);
+                if (ret != NVML_SUCCESS) {
+                    return NvCtrlNotSupported;
                 }
+                res = telemetry->performanceLevel;
                 break;
 
             case NV_CTRL_GPU_NVCLOCK_OFFSET:
@@ -1240,13 +1791,13 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                 break;
 
             case NV_CTRL_GPU_ADAPTIVE_CLOCK_STATE:
-                ret = nvml->lib.DeviceGetAdaptiveClockInfoStatus(device, &res);
+                ret = nvml->ctx->lib.DeviceGetAdaptiveClockInfoStatus(device, &res);
                 break;
 
             case NV_CTRL_GPU_PCIE_MAX_LINK_SPEED:
                 {
                     unsigned int nvmlPcieSpeed;
-                    ret = nvml->lib.DeviceGetPcieLinkMaxSpeed(device, &nvmlPcieSpeed);
+                    ret = nvml->ctx->lib.DeviceGetPcieLinkMaxSpeed(device, &nvmlPcieSpeed);
                     if (ret == NVML_SUCCESS) {
                         ret = convertNvmlPcieSpeedToNvctrlPcieSpeed(nvmlPcieSpeed, &res);
                     }
@@ -1254,7 +1805,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                 break;
 
             case NV_CTRL_GPU_PCIE_CURRENT_LINK_SPEED:
-                ret = nvml->lib.DeviceGetPcieSpeed(device, &res);
+                ret = nvml->ctx->lib.DeviceGetPcieSpeed(device, &res);
                 break;
 
             case NV_CTRL_GPU_POWER_MIZER_MODE:
@@ -1268,7 +1819,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
                            NV_CTRL_GPU_POWER_MIZER_MODE_AUTO);
                     assert(NVML_POWER_MIZER_MODE_PREFER_CONSISTENT_PERFORMANCE ==
                            NV_CTRL_GPU_POWER_MIZER_MODE_PREFER_CONSISTENT_PERFORMANCE);
-                    ret = nvml->lib.DeviceGetPowerMizerMode_v1(device,
+                    ret = nvml->ctx->lib.DeviceGetPowerMizerMode_v1(device,
                                                                &powerMizerMode);
                     res = powerMizerMode.currentMode;
                     break;
@@ -1349,7 +1900,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
             case NV_CTRL_ATTR_NVML_GPU_VIRTUALIZATION_MODE:
                 {
                     nvmlGpuVirtualizationMode_t mode;
-                    ret = nvml->lib.DeviceGetVirtualizationMode(device, &mode);
+                    ret = nvml->ctx->lib.DeviceGetVirtualizationMode(device, &mode);
                     res = mode;
                 }
                 break;
@@ -1357,7 +1908,7 @@ static ReturnStatus NvCtrlNvmlGetGPUAttribute(const CtrlTarget *ctrl_target,
             case NV_CTRL_ATTR_NVML_GPU_GRID_LICENSE_SUPPORTED:
                 {
                     nvmlGridLicensableFeatures_t gridLicensableFeatures;
-                    ret = nvml->lib.DeviceGetGridLicensableFeatures(device,
+                    ret = nvml->ctx->lib.DeviceGetGridLicensableFeatures(device,
                                                           &gridLicensableFeatures);
                     res = !!(gridLicensableFeatures.isGridLicenseSupported);
                 }
@@ -1398,14 +1949,14 @@ static ReturnStatus NvCtrlNvmlGetGridLicensableFeatures(const CtrlTarget *ctrl_t
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, nvml->deviceIdx, &device);
         if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_ATTR_NVML_GPU_GRID_LICENSABLE_FEATURES:
                 {
                     nvmlGridLicensableFeatures_t *gridLicensableFeatures;
                     gridLicensableFeatures = (nvmlGridLicensableFeatures_t *)nvalloc(sizeof(nvmlGridLicensableFeatures_t));
-                    ret = nvml->lib.DeviceGetGridLicensableFeatures(device,
+                    ret = nvml->ctx->lib.DeviceGetGridLicensableFeatures(device,
                                                                     gridLicensableFeatures);
                     if (ret == NVML_SUCCESS) {
                         *val = gridLicensableFeatures;
@@ -1442,14 +1993,14 @@ static ReturnStatus NvCtrlNvmlDeviceGetGspFeatures(const CtrlTarget *ctrl_target
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, nvml->deviceIdx, &device);
     if (ret == NVML_SUCCESS) {
     switch (attr) {
         case NV_CTRL_ATTR_NVML_GSP_FIRMWARE_MODE:
             {
                 unsigned int isEnabled_t = 0;
                 unsigned int defaultMode_t = 0;
-                ret = nvml->lib.DeviceGetGspFirmwareMode(device,
+                ret = nvml->ctx->lib.DeviceGetGspFirmwareMode(device,
                                                          &isEnabled_t, &defaultMode_t);
                 if (ret == NVML_SUCCESS) {
                     *isEnabled = isEnabled_t;
@@ -1487,7 +2038,7 @@ static void getDeviceAndTargetIndex(const NvCtrlAttributePrivateHandle *h,
     }
 
     count = 0;
-    for (i = 0; i < h->nvml->deviceCount; i++) {
+    for (i = 0; i < h->nvml->ctx->deviceCount; i++) {
         int tmp = count + targetCountPerGPU[i];
         *deviceIdx = i;
         if (h->target_id < tmp) {
@@ -1589,6 +2140,7 @@ static ReturnStatus NvCtrlNvmlGetThermalAttribute(const CtrlTarget *ctrl_target,
     unsigned int res;
     const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(ctrl_target);
     const NvCtrlNvmlAttributes *nvml;
+    const NvCtrlNvmlTelemetry *telemetry;
     int deviceId, sensorId;
     nvmlDevice_t device;
     nvmlReturn_t ret;
@@ -1599,36 +2151,38 @@ static ReturnStatus NvCtrlNvmlGetThermalAttribute(const CtrlTarget *ctrl_target,
     }
 
     /* Get the proper device according to the sensor ID */
-    getDeviceAndTargetIndex(h, nvml->sensorCount, nvml->sensorCountPerGPU,
+    getDeviceAndTargetIndex(h, nvml->ctx->sensorCount, nvml->ctx->sensorCountPerGPU,
                             &deviceId, &sensorId);
     if (sensorId == -1) {
         return NvCtrlBadHandle;
     }
 
 
-    ret = nvml->lib.DeviceGetHandleByIndex(deviceId, &device);
+    ret = getNvmlDevice(nvml, deviceId, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_SENSOR_READING:
             case NV_CTRL_THERMAL_SENSOR_PROVIDER:
             case NV_CTRL_THERMAL_SENSOR_TARGET:
                 {
-                    nvmlGpuThermalSettings_t pThermalSettings;
+                    const nvmlGpuThermalSettings_t *pThermalSettings;
 
-                    ret = nvml->lib.DeviceGetThermalSettings(device, NVML_THERMAL_TARGET_ALL, //sensorIndex
-                                                             &pThermalSettings);
+                    ret = getNvmlTelemetry(nvml->ctx, deviceId,
+                                           NVML_TELEMETRY_THERMAL_SETTINGS,
+                                           &telemetry);
+                    pThermalSettings = &telemetry->thermalSettings;
                     if (ret == NVML_SUCCESS) {
                         switch (attr) {
                             case NV_CTRL_THERMAL_SENSOR_READING:
-                                res = pThermalSettings.sensor[sensorId].currentTemp;
+                                res = pThermalSettings->sensor[sensorId].currentTemp;
                                 break;
                             case NV_CTRL_THERMAL_SENSOR_PROVIDER:
                                 convertNvmlThermControllerToNvctrlSensorProvider
-                                    (pThermalSettings.sensor[sensorId].controller, &res);
+                                    (pThermalSettings->sensor[sensorId].controller, &res);
                                 break;
                             case NV_CTRL_THERMAL_SENSOR_TARGET:
                                 convertNvmlThermTargetToNvctrlThermTarget
-                                    (pThermalSettings.sensor[sensorId].target, &res);
+                                    (pThermalSettings->sensor[sensorId].target, &res);
                                 break;
                         }
                     }
@@ -1714,20 +2268,20 @@ static ReturnStatus NvCtrlNvmlGetCoolerAttribute(const CtrlTarget *ctrl_target,
     }
 
     /* Get the proper device according to the cooler ID */
-    getDeviceAndTargetIndex(h, nvml->coolerCount, nvml->coolerCountPerGPU,
+    getDeviceAndTargetIndex(h, nvml->ctx->coolerCount, nvml->ctx->coolerCountPerGPU,
                             &deviceId, &coolerId);
     if (coolerId == -1) {
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(deviceId, &device);
+    ret = getNvmlDevice(nvml, deviceId, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_COOLER_LEVEL:
-                ret = nvml->lib.DeviceGetTargetFanSpeed(device, coolerId, &res);
+                ret = nvml->ctx->lib.DeviceGetTargetFanSpeed(device, coolerId, &res);
                 break;
             case NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL:
-                ret = nvml->lib.DeviceGetFanSpeed_v2(device, coolerId, &res);
+                ret = nvml->ctx->lib.DeviceGetFanSpeed_v2(device, coolerId, &res);
                 break;
             case NV_CTRL_THERMAL_COOLER_TARGET:
             case NV_CTRL_THERMAL_COOLER_CONTROL_TYPE:
@@ -1735,7 +2289,7 @@ static ReturnStatus NvCtrlNvmlGetCoolerAttribute(const CtrlTarget *ctrl_target,
                     nvmlCoolerInfo_t coolerInfo;
                     coolerInfo.version = nvmlCoolerInfo_v1;
                     coolerInfo.index = coolerId;
-                    ret = nvml->lib.DeviceGetCoolerInfo(device, &coolerInfo);
+                    ret = nvml->ctx->lib.DeviceGetCoolerInfo(device, &coolerInfo);
                     if (ret == NVML_SUCCESS) {
                         switch (attr) {
                             case NV_CTRL_THERMAL_COOLER_CONTROL_TYPE:
@@ -1753,7 +2307,7 @@ static ReturnStatus NvCtrlNvmlGetCoolerAttribute(const CtrlTarget *ctrl_target,
                     nvmlFanSpeedInfo_t fanSpeed;
                     fanSpeed.version = nvmlFanSpeedInfo_v1;
                     fanSpeed.fan = coolerId;
-                    ret = nvml->lib.DeviceGetFanSpeedRPM(device, &fanSpeed);
+                    ret = nvml->ctx->lib.DeviceGetFanSpeedRPM(device, &fanSpeed);
                     if (ret == NVML_SUCCESS) {
                         *val = fanSpeed.speed;
                         return NvCtrlSuccess;
@@ -1874,11 +2428,11 @@ static ReturnStatus NvCtrlNvmlSetGPUAttribute(CtrlTarget *ctrl_target,
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, nvml->deviceIdx, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_GPU_ECC_CONFIGURATION:
-                ret = nvml->lib.DeviceSetEccMode(device, val);
+                ret = nvml->ctx->lib.DeviceSetEccMode(device, val);
                 break;
 
             case NV_CTRL_GPU_ECC_RESET_ERROR_STATUS:
@@ -1892,7 +2446,7 @@ static ReturnStatus NvCtrlNvmlSetGPUAttribute(CtrlTarget *ctrl_target,
                             counterType = NVML_AGGREGATE_ECC;
                             break;
                     }
-                    ret = nvml->lib.DeviceClearEccErrorCounts(device,
+                    ret = nvml->ctx->lib.DeviceClearEccErrorCounts(device,
                                                               counterType);
                 }
                 break;
@@ -1900,10 +2454,10 @@ static ReturnStatus NvCtrlNvmlSetGPUAttribute(CtrlTarget *ctrl_target,
             case NV_CTRL_GPU_COOLER_MANUAL_CONTROL:
                 {
                     int i = 0;
-                    int count = nvml->coolerCountPerGPU[nvml->deviceIdx];
+                    int count = nvml->ctx->coolerCountPerGPU[nvml->deviceIdx];
 
                     for (i = 0; i < count; i++) {
-                        ret = nvml->lib.DeviceSetFanControlPolicy(device, i, val);
+                        ret = nvml->ctx->lib.DeviceSetFanControlPolicy(device, i, val);
                     }
                 }
                 break;
@@ -1919,7 +2473,7 @@ static ReturnStatus NvCtrlNvmlSetGPUAttribute(CtrlTarget *ctrl_target,
                 {
                     nvmlDevicePowerMizerModes_v1_t powerMizerMode;
                     powerMizerMode.mode = val;
-                    ret = nvml->lib.DeviceSetPowerMizerMode_v1(device, &powerMizerMode);
+                    ret = nvml->ctx->lib.DeviceSetPowerMizerMode_v1(device, &powerMizerMode);
                     break;
                 }
 
@@ -1973,21 +2527,21 @@ static ReturnStatus NvCtrlNvmlSetCoolerAttribute(CtrlTarget *ctrl_target,
     }
 
     /* Get the proper device according to the cooler ID */
-    getDeviceAndTargetIndex(h, nvml->coolerCount, nvml->coolerCountPerGPU,
+    getDeviceAndTargetIndex(h, nvml->ctx->coolerCount, nvml->ctx->coolerCountPerGPU,
                             &deviceId, &coolerId);
     if (coolerId == -1) {
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(deviceId, &device);
+    ret = getNvmlDevice(nvml, deviceId, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_COOLER_LEVEL:
-                ret = nvml->lib.DeviceSetFanSpeed_v2(device, coolerId, val);
+                ret = nvml->ctx->lib.DeviceSetFanSpeed_v2(device, coolerId, val);
                 break;
 
             case NV_CTRL_THERMAL_COOLER_LEVEL_SET_DEFAULT:
-                ret = nvml->lib.DeviceSetDefaultFanSpeed_v2(device, coolerId);
+                ret = nvml->ctx->lib.DeviceSetDefaultFanSpeed_v2(device, coolerId);
                 break;
 
             default:
@@ -2020,6 +2574,8 @@ ReturnStatus NvCtrlNvmlSetAttribute(CtrlTarget *ctrl_target, int attr,
         return NvCtrlMissingExtension;
     }
 
+    invalidateTargetTelemetry(ctrl_target);
+
     /*
      * This shouldn't be reached for target types that are not handled through
      * NVML (Keep TARGET_TYPE_IS_NVML_COMPATIBLE in NvCtrlAttributesPrivate.h up
@@ -2063,7 +2619,7 @@ static nvmlReturn_t getDeviceMemoryCounts(const CtrlTarget *ctrl_target,
          i < NVML_MEMORY_LOCATION_COUNT;
          i++) {
 
-        ret = nvml->lib.DeviceGetMemoryErrorCounter(device, errorType,
+        ret = nvml->ctx->lib.DeviceGetMemoryErrorCounter(device, errorType,
                                                     counterType, i, &count);
         if (ret == NVML_SUCCESS) {
             anySuccess = NVML_SUCCESS;
@@ -2099,7 +2655,7 @@ NvCtrlNvmlGetGPUBinaryAttribute(const CtrlTarget *ctrl_target,
         return NvCtrlBadHandle;
     }
 
-    ret = nvml->lib.DeviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, nvml->deviceIdx, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_BINARY_DATA_COOLERS_USED_BY_GPU:
@@ -2109,7 +2665,7 @@ NvCtrlNvmlGetGPUBinaryAttribute(const CtrlTarget *ctrl_target,
                 int offset = 0;
                 int i = 0;
 
-                ret = nvml->lib.DeviceGetNumFans(device, &count);
+                ret = nvml->ctx->lib.DeviceGetNumFans(device, &count);
                 if (ret != NVML_SUCCESS) {
                     return NvCtrlNotSupported;
                 }
@@ -2128,7 +2684,7 @@ NvCtrlNvmlGetGPUBinaryAttribute(const CtrlTarget *ctrl_target,
 
                 /* Calculate global fan index offset for this GPU */
                 for (i = 0; i < nvml->deviceIdx; i++) {
-                    offset += nvml->coolerCountPerGPU[i];
+                    offset += nvml->ctx->coolerCountPerGPU[i];
                 }
 
                 fan_data[0] = count;
@@ -2145,7 +2701,7 @@ NvCtrlNvmlGetGPUBinaryAttribute(const CtrlTarget *ctrl_target,
                 int i = 0;
                 nvmlGpuThermalSettings_t pThermalSettings;
 
-                ret = nvml->lib.DeviceGetThermalSettings(device,
+                ret = nvml->ctx->lib.DeviceGetThermalSettings(device,
                                                          NVML_THERMAL_TARGET_ALL,
                                                          &pThermalSettings);
                 if (ret != NVML_SUCCESS) {
@@ -2168,7 +2724,7 @@ NvCtrlNvmlGetGPUBinaryAttribute(const CtrlTarget *ctrl_target,
 
                 /* Calculate global sensor index offset for this GPU */
                 for (i = 0; i < nvml->deviceIdx; i++) {
-                    offset += nvml->sensorCountPerGPU[i];
+                    offset += nvml->ctx->sensorCountPerGPU[i];
                 }
 
                 sensor_data[0] = count;
@@ -2417,7 +2973,7 @@ NvCtrlNvmlGetGPUValidAttributeValues(const CtrlTarget *ctrl_target, int attr,
 
     val->permissions.write = NV_FALSE;
 
-    ret = nvml->lib.DeviceGetHandleByIndex(nvml->deviceIdx, &device);
+    ret = getNvmlDevice(nvml, nvml->deviceIdx, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_TOTAL_DEDICATED_GPU_MEMORY:
@@ -2480,7 +3036,7 @@ NvCtrlNvmlGetGPUValidAttributeValues(const CtrlTarget *ctrl_target, int attr,
             case NV_CTRL_GPU_POWER_MIZER_MODE:
                 {
                     nvmlDevicePowerMizerModes_v1_t powerMizerMode;
-                    ret = nvml->lib.DeviceGetPowerMizerMode_v1(device, &powerMizerMode);
+                    ret = nvml->ctx->lib.DeviceGetPowerMizerMode_v1(device, &powerMizerMode);
                     val->allowed_ints = powerMizerMode.supportedPowerMizerModes;
                     val->valid_type = CTRL_ATTRIBUTE_VALID_TYPE_INT_BITS;
                     break;
@@ -2557,21 +3113,21 @@ NvCtrlNvmlGetThermalValidAttributeValues(const CtrlTarget *ctrl_target,
     }
 
     /* Get the proper device and sensor ID according to the target ID */
-    getDeviceAndTargetIndex(h, nvml->sensorCount, nvml->sensorCountPerGPU,
+    getDeviceAndTargetIndex(h, nvml->ctx->sensorCount, nvml->ctx->sensorCountPerGPU,
                             &deviceId, &sensorId);
     if (sensorId == -1) {
         return NvCtrlBadHandle;
     }
 
 
-    ret = nvml->lib.DeviceGetHandleByIndex(deviceId, &device);
+    ret = getNvmlDevice(nvml, deviceId, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_SENSOR_READING:
                 {
                     nvmlGpuThermalSettings_t pThermalSettings;
 
-                    ret = nvml->lib.DeviceGetThermalSettings(device, NVML_THERMAL_TARGET_ALL, //sensorIndex
+                    ret = nvml->ctx->lib.DeviceGetThermalSettings(device, NVML_THERMAL_TARGET_ALL, //sensorIndex
                                                              &pThermalSettings);
                     if (ret == NVML_SUCCESS) {
                         val->valid_type = CTRL_ATTRIBUTE_VALID_TYPE_RANGE;
@@ -2617,14 +3173,14 @@ NvCtrlNvmlGetCoolerValidAttributeValues(const CtrlTarget *ctrl_target,
     }
 
     /* Get the proper device and cooler ID according to the target ID */
-    getDeviceAndTargetIndex(h, nvml->coolerCount, nvml->coolerCountPerGPU,
+    getDeviceAndTargetIndex(h, nvml->ctx->coolerCount, nvml->ctx->coolerCountPerGPU,
                             &deviceId, &coolerId);
     if (coolerId == -1) {
         return NvCtrlBadHandle;
     }
 
 
-    ret = nvml->lib.DeviceGetHandleByIndex(deviceId, &device);
+    ret = getNvmlDevice(nvml, deviceId, &device);
     if (ret == NVML_SUCCESS) {
         switch (attr) {
             case NV_CTRL_THERMAL_COOLER_CURRENT_LEVEL:
@@ -2635,7 +3191,7 @@ NvCtrlNvmlGetCoolerValidAttributeValues(const CtrlTarget *ctrl_target,
                 return NvCtrlSuccess;
 
             case NV_CTRL_THERMAL_COOLER_LEVEL:
-                ret = nvml->lib.DeviceGetMinMaxFanSpeed(device, &minSpeed, &maxSpeed);
+                ret = nvml->ctx->lib.DeviceGetMinMaxFanSpeed(device, &minSpeed, &maxSpeed);
                 if (ret == NVML_SUCCESS) {
                     /* Range as a percent */
                     val->valid_type = CTRL_ATTRIBUTE_VALID_TYPE_RANGE;
@@ -2883,3 +3439,429 @@ NvCtrlNvmlGetAttributePerms(const NvCtrlAttributePrivateHandle *h,
 
 }
 
+
+
+/*
+ * NVML events
+ *
+ * NVML only delivers events through nvmlEventSetWait(), which blocks, so a
+ * worker thread waits on the event set and records, per device, which event
+ * types fired.  Repeated events of the same type coalesce until the main
+ * thread consumes them.  The worker wakes the main loop by writing a byte to
+ * a pipe whose read end is the event handle's file descriptor; the byte is
+ * drained once no event is left.  NVML events are translated to the
+ * matching attribute events (with the current value read back on the main
+ * thread), so that they reach the same CtkEvent signals as NV-CONTROL events;
+ * clock changes become NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS string events,
+ * since the current clocks have no integer attribute.  An NVML error while
+ * waiting is reported once and the wait retried after a growing pause, so
+ * that a transient failure does not end event delivery.
+ */
+
+#define NVML_EVENT_TYPES (nvmlEventTypeClock |                \
+                          nvmlEventTypePState |               \
+                          nvmlEventTypePowerSourceChange |    \
+                          nvmlEventTypeSingleBitEccError |    \
+                          nvmlEventTypeDoubleBitEccError |    \
+                          nvmlEventTypeXidCriticalError)
+
+/* How long the worker blocks in NVML before checking for shutdown */
+#define NVML_EVENT_WAIT_TIMEOUT_MS 250
+
+/* Longest pause between retries while NVML keeps failing */
+#define NVML_EVENT_ERROR_BACKOFF_MAX_MS 8000
+
+struct __NvCtrlNvmlEventState {
+    NvCtrlNvmlContext *ctx;
+    nvmlEventSet_t set;
+    pthread_t thread;
+    int pipe_fds[2];
+
+    pthread_mutex_t lock;          /* protects the fields below */
+    pthread_cond_t wake;           /* signaled when 'stop' is set */
+    Bool stop;                     /* worker should exit */
+    Bool signaled;                 /* a wakeup byte is in the pipe */
+    unsigned long long *pending;   /* per NVML device: event types seen */
+    unsigned long long *xid;       /* per NVML device: last Xid reported */
+};
+
+
+
+/*
+ * Sleeps for 'ms' milliseconds, or until the event handle is closed.
+ * Returns TRUE if the worker should exit.
+ */
+
+static Bool NvmlEventThreadPause(NvCtrlNvmlEventState *st, unsigned int ms)
+{
+    struct timespec deadline;
+    Bool stop;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += ms / 1000;
+    deadline.tv_nsec += (long)(ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&st->lock);
+    while (!st->stop &&
+           (pthread_cond_timedwait(&st->wake, &st->lock, &deadline) == 0));
+    stop = st->stop;
+    pthread_mutex_unlock(&st->lock);
+
+    return stop;
+}
+
+
+
+static void *NvmlEventThread(void *arg)
+{
+    NvCtrlNvmlEventState *st = arg;
+    NvCtrlNvmlContext *ctx = st->ctx;
+    nvmlEventData_t data;
+    nvmlReturn_t ret, last_error = NVML_SUCCESS;
+    unsigned int i, backoff_ms = 0;
+    Bool stop;
+
+    while (1) {
+        pthread_mutex_lock(&st->lock);
+        stop = st->stop;
+        pthread_mutex_unlock(&st->lock);
+
+        if (stop) {
+            break;
+        }
+
+        ret = ctx->lib.EventSetWait(st->set, &data, NVML_EVENT_WAIT_TIMEOUT_MS);
+
+        if ((ret != NVML_SUCCESS) && (ret != NVML_ERROR_TIMEOUT)) {
+            if (ret != last_error) {
+                nv_warning_msg("Waiting for NVML events failed (error %d); "
+                               "retrying.", ret);
+                last_error = ret;
+            }
+            backoff_ms = backoff_ms ? backoff_ms * 2 :
+                                      NVML_EVENT_WAIT_TIMEOUT_MS;
+            if (backoff_ms > NVML_EVENT_ERROR_BACKOFF_MAX_MS) {
+                backoff_ms = NVML_EVENT_ERROR_BACKOFF_MAX_MS;
+            }
+            if (NvmlEventThreadPause(st, backoff_ms)) {
+                break;
+            }
+            continue;
+        }
+
+        backoff_ms = 0;
+        last_error = NVML_SUCCESS;
+
+        if (ret == NVML_ERROR_TIMEOUT) {
+            continue;
+        }
+
+        for (i = 0; i < ctx->deviceCount; i++) {
+            if (ctx->deviceValid[i] && (ctx->devices[i] == data.device)) {
+                break;
+            }
+        }
+        if (i == ctx->deviceCount) {
+            continue;
+        }
+
+        pthread_mutex_lock(&st->lock);
+
+        st->pending[i] |= (data.eventType & NVML_EVENT_TYPES);
+        if (data.eventType & nvmlEventTypeXidCriticalError) {
+            st->xid[i] = data.eventData;
+        }
+
+        if (!st->signaled && st->pending[i]) {
+            char c = 0;
+            if (write(st->pipe_fds[1], &c, 1) == 1) {
+                st->signaled = TRUE;
+            }
+        }
+
+        pthread_mutex_unlock(&st->lock);
+    }
+
+    return NULL;
+}
+
+
+
+static void NvmlEventStateFree(NvCtrlNvmlEventState *st)
+{
+    if (st->set) {
+        st->ctx->lib.EventSetFree(st->set);
+    }
+    if (st->pipe_fds[0] >= 0) {
+        close(st->pipe_fds[0]);
+    }
+    if (st->pipe_fds[1] >= 0) {
+        close(st->pipe_fds[1]);
+    }
+    pthread_cond_destroy(&st->wake);
+    pthread_mutex_destroy(&st->lock);
+    nvfree(st->pending);
+    nvfree(st->xid);
+    nvfree(st);
+}
+
+
+
+/*
+ * Creates the NVML event set for every device of 'ctx' and starts the worker
+ * thread feeding the event handle.  Fails with NvCtrlNotSupported if no
+ * device supports any of the events we translate.
+ */
+
+ReturnStatus NvCtrlNvmlEventHandleOpen(NvCtrlEventPrivateHandle *evt_h,
+                                       NvCtrlNvmlContext *ctx)
+{
+    NvCtrlNvmlEventState *st;
+    unsigned long long types;
+    unsigned int i, registered = 0;
+    int j;
+
+    if (!evt_h || !ctx) {
+        return NvCtrlBadArgument;
+    }
+
+    st = nvalloc(sizeof(*st));
+    st->ctx = ctx;
+    st->pipe_fds[0] = st->pipe_fds[1] = -1;
+    st->pending = nvalloc(ctx->deviceCount * sizeof(unsigned long long));
+    st->xid = nvalloc(ctx->deviceCount * sizeof(unsigned long long));
+    pthread_mutex_init(&st->lock, NULL);
+    pthread_cond_init(&st->wake, NULL);
+
+    if (ctx->lib.EventSetCreate(&st->set) != NVML_SUCCESS) {
+        st->set = NULL;
+        goto fail;
+    }
+
+    for (i = 0; i < ctx->deviceCount; i++) {
+        if (!ctx->deviceValid[i] ||
+            (ctx->lib.DeviceGetSupportedEventTypes(ctx->devices[i],
+                                                   &types) != NVML_SUCCESS)) {
+            continue;
+        }
+
+        types &= NVML_EVENT_TYPES;
+        if (types &&
+            (ctx->lib.DeviceRegisterEvents(ctx->devices[i], types,
+                                           st->set) == NVML_SUCCESS)) {
+            registered++;
+        }
+    }
+
+    if (registered == 0) {
+        goto fail;
+    }
+
+    if (pipe(st->pipe_fds) != 0) {
+        st->pipe_fds[0] = st->pipe_fds[1] = -1;
+        goto fail;
+    }
+
+    for (j = 0; j < 2; j++) {
+        fcntl(st->pipe_fds[j], F_SETFL,
+              fcntl(st->pipe_fds[j], F_GETFL) | O_NONBLOCK);
+        fcntl(st->pipe_fds[j], F_SETFD, FD_CLOEXEC);
+    }
+
+    if (pthread_create(&st->thread, NULL, NvmlEventThread, st) != 0) {
+        goto fail;
+    }
+
+    ctx->refcount++;
+
+    evt_h->nvml = ctx;
+    evt_h->nvml_events = st;
+    evt_h->fd = st->pipe_fds[0];
+
+    return NvCtrlSuccess;
+
+ fail:
+    NvmlEventStateFree(st);
+    return NvCtrlNotSupported;
+}
+
+
+
+/*
+ * Stops the worker thread and releases the NVML event set.
+ */
+
+void NvCtrlNvmlEventHandleClose(NvCtrlEventPrivateHandle *evt_h)
+{
+    NvCtrlNvmlEventState *st;
+
+    if (!evt_h || !evt_h->nvml_events) {
+        return;
+    }
+
+    st = evt_h->nvml_events;
+
+    pthread_mutex_lock(&st->lock);
+    st->stop = TRUE;
+    pthread_cond_signal(&st->wake);
+    pthread_mutex_unlock(&st->lock);
+
+    pthread_join(st->thread, NULL);
+
+    NvmlEventStateFree(st);
+    NvmlContextRelease(evt_h->nvml);
+
+    evt_h->nvml_events = NULL;
+    evt_h->nvml = NULL;
+    evt_h->fd = -1;
+}
+
+
+
+Bool NvCtrlNvmlEventHandlePending(NvCtrlEventPrivateHandle *evt_h)
+{
+    NvCtrlNvmlEventState *st = evt_h->nvml_events;
+    Bool pending = FALSE;
+    unsigned int i;
+
+    pthread_mutex_lock(&st->lock);
+    for (i = 0; (i < st->ctx->deviceCount) && !pending; i++) {
+        pending = (st->pending[i] != 0);
+    }
+    pthread_mutex_unlock(&st->lock);
+
+    return pending;
+}
+
+
+
+/*
+ * Returns the GPU target of the event handle's system backed by the given
+ * NVML device, or NULL.
+ */
+
+static const CtrlTarget *getNvmlEventTarget(const NvCtrlNvmlContext *ctx,
+                                            unsigned int deviceIdx)
+{
+    CtrlTargetNode *node;
+
+    if (!ctx->system) {
+        return NULL;
+    }
+
+    for (node = ctx->system->targets[GPU_TARGET]; node; node = node->next) {
+        const NvCtrlAttributePrivateHandle *h = getPrivateHandleConst(node->t);
+
+        if (h && h->nvml && (h->nvml->deviceIdx == deviceIdx)) {
+            return node->t;
+        }
+    }
+
+    return NULL;
+}
+
+
+
+/*
+ * Consumes one pending NVML event and translates it to a CtrlEvent.  Events
+ * that have no attribute counterpart (or whose value cannot be read back)
+ * are returned as CTRL_EVENT_TYPE_UNKNOWN.
+ */
+
+ReturnStatus NvCtrlNvmlEventHandleNextEvent(NvCtrlEventPrivateHandle *evt_h,
+                                            CtrlEvent *event)
+{
+    NvCtrlNvmlEventState *st = evt_h->nvml_events;
+    const CtrlTarget *target;
+    unsigned long long type = 0, xid = 0;
+    unsigned int i, deviceIdx = 0;
+    Bool more = FALSE;
+    int64_t val;
+    int attr;
+
+    memset(event, 0, sizeof(CtrlEvent));
+
+    pthread_mutex_lock(&st->lock);
+
+    for (i = 0; i < st->ctx->deviceCount; i++) {
+        if (!st->pending[i]) {
+            continue;
+        }
+        if (!type) {
+            deviceIdx = i;
+            type = st->pending[i] & ~(st->pending[i] - 1); /* lowest bit */
+            st->pending[i] &= ~type;
+            xid = st->xid[i];
+        }
+        if (st->pending[i]) {
+            more = TRUE;
+            break;
+        }
+    }
+
+    if (!more && st->signaled) {
+        char buf[16];
+        while (read(st->pipe_fds[0], buf, sizeof(buf)) > 0);
+        st->signaled = FALSE;
+    }
+
+    pthread_mutex_unlock(&st->lock);
+
+    /* Whatever changed, the sampled telemetry of the device is now stale */
+    if (type) {
+        invalidateNvmlTelemetry(st->ctx, deviceIdx);
+    }
+
+    switch (type) {
+        case nvmlEventTypeClock:
+            /* The current clocks are only reported as a string */
+            target = getNvmlEventTarget(st->ctx, deviceIdx);
+            if (target) {
+                event->type        = CTRL_EVENT_TYPE_STRING_ATTRIBUTE;
+                event->target_type = GPU_TARGET;
+                event->target_id   = NvCtrlGetTargetId(target);
+                event->str_attr.attribute =
+                    NV_CTRL_STRING_GPU_CURRENT_CLOCK_FREQS;
+            }
+            return NvCtrlSuccess;
+        case nvmlEventTypePState:
+            attr = NV_CTRL_GPU_CURRENT_PERFORMANCE_LEVEL;
+            break;
+        case nvmlEventTypePowerSourceChange:
+            attr = NV_CTRL_GPU_POWER_SOURCE;
+            break;
+        case nvmlEventTypeSingleBitEccError:
+            attr = NV_CTRL_GPU_ECC_SINGLE_BIT_ERRORS;
+            break;
+        case nvmlEventTypeDoubleBitEccError:
+            attr = NV_CTRL_GPU_ECC_DOUBLE_BIT_ERRORS;
+            break;
+        case nvmlEventTypeXidCriticalError:
+            nv_warning_msg("NVML device %u reported Xid error %llu.",
+                           deviceIdx, xid);
+            return NvCtrlSuccess;
+        default:
+            return NvCtrlSuccess;
+    }
+
+    target = getNvmlEventTarget(st->ctx, deviceIdx);
+
+    if (!target ||
+        (NvCtrlNvmlGetAttribute(target, attr, &val) != NvCtrlSuccess)) {
+        return NvCtrlSuccess;
+    }
+
+    event->type        = CTRL_EVENT_TYPE_INTEGER_ATTRIBUTE;
+    event->target_type = GPU_TARGET;
+    event->target_id   = NvCtrlGetTargetId(target);
+
+    event->int_attr.attribute               = attr;
+    event->int_attr.value                   = val;
+    event->int_attr.is_availability_changed = FALSE;
+
+    return NvCtrlSuccess;
+}
@@ -95,10 +95,8 @@
 
 /* Useful macros to deal with attribute names */
 
-#define ATTRIBUTE_NAME(_ATTR_, _ATTR_TYPE_)                  \
-    ((nv_get_attribute_entry(_ATTR_, _ATTR_TYPE_) != NULL) ? \
-     (nv_get_attribute_entry(_ATTR_, _ATTR_TYPE_)->name) :   \
-     ("Unknown"))
+#define ATTRIBUTE_NAME(_ATTR_, _ATTR_TYPE_) \
+    nv_get_attribute_name(_ATTR_, _ATTR_TYPE_)
 
 #define INT_ATTRIBUTE_NAME(_ATTR_) ATTRIBUTE_NAME(_ATTR_, CTRL_ATTRIBUTE_TYPE_INTEGER)
 #define STR_ATTRIBUTE_NAME(_ATTR_) ATTRIBUTE_NAME(_ATTR_, CTRL_ATTRIBUTE_TYPE_STRING)
@@ -118,8 +116,11 @@ typedef struct __NvCtrlXvBlitterAttributes NvCtrlXvBlitterAttributes;
 typedef struct __NvCtrlXvAttribute NvCtrlXvAttribute;
 typedef struct __NvCtrlXrandrAttributes NvCtrlXrandrAttributes;
 typedef struct __NvCtrlNvmlAttributes NvCtrlNvmlAttributes;
+typedef struct __NvCtrlNvmlContext NvCtrlNvmlContext;
 typedef struct __NvCtrlEventPrivateHandle NvCtrlEventPrivateHandle;
+typedef struct __NvCtrlNvmlEventState NvCtrlNvmlEventState;
 typedef struct __NvCtrlEventPrivateHandleNode NvCtrlEventPrivateHandleNode;
+typedef struct __NvCtrlConfigSnapshot NvCtrlConfigSnapshot;
 
 typedef struct {
     float brightness[3];
@@ -161,7 +162,82 @@ struct __NvCtrlXrandrAttributes {
     XRRCrtcGamma *pGammaRamp;
 };
 
-struct __NvCtrlNvmlAttributes {
+/*
+ * Cache of the valid values and permissions queried through a handle.  These
+ * are static metadata for the lifetime of most sessions, so they are only
+ * fetched again once the cache generation changes; see
+ * NvCtrlGetValidDisplayAttributeValues().
+ */
+
+typedef enum {
+    NV_CTRL_VALID_VALUES_CACHE_INTEGER = 0,
+    NV_CTRL_VALID_VALUES_CACHE_STRING,
+    NV_CTRL_VALID_VALUES_CACHE_PERMS,   /* + CtrlAttributeType */
+} NvCtrlValidValuesCacheKind;
+
+typedef struct {
+    Bool used;
+    unsigned int kind;
+    unsigned int display_mask;
+    int attr;
+    ReturnStatus status;
+    CtrlAttributeValidValues val;   /* only permissions for PERMS entries */
+} NvCtrlValidValuesCacheEntry;
+
+typedef struct {
+    NvCtrlValidValuesCacheEntry *entries;
+    unsigned int size;              /* number of entries, a power of two */
+    unsigned int count;             /* number of used entries */
+    unsigned int generation;        /* generation the entries belong to */
+} NvCtrlValidValuesCache;
+
+/*
+ * Telemetry values that the NVML backend samples together, once per tick and
+ * per device, for every page or client polling them.
+ */
+
+typedef enum {
+    NVML_TELEMETRY_POWER_USAGE = 0,
+    NVML_TELEMETRY_ECC_SBE_VOLATILE,
+    NVML_TELEMETRY_ECC_DBE_VOLATILE,
+    NVML_TELEMETRY_CORE_TEMPERATURE,
+    NVML_TELEMETRY_MEMORY_INFO,
+    NVML_TELEMETRY_UTILIZATION,
+    NVML_TELEMETRY_PERFORMANCE_LEVEL,
+    NVML_TELEMETRY_CLOCK_FREQS,
+    NVML_TELEMETRY_THERMAL_SETTINGS,
+    NVML_TELEMETRY_COUNT
+} NvCtrlNvmlTelemetryMetric;
+
+typedef struct {
+    uint64_t timestamp;         /* monotonic time of the last pass, in us */
+    unsigned int subscribed;    /* metrics fetched by each pass */
+    unsigned int read;          /* metrics read since the last pass */
+    nvmlReturn_t status[NVML_TELEMETRY_COUNT];
+
+    unsigned int powerUsage;    /* mW */
+    unsigned long long eccSbeVolatile;
+    unsigned long long eccDbeVolatile;
+    unsigned int coreTemperature;
+    unsigned long long memoryTotal;
+    unsigned long long memoryUsed;
+    nvmlUtilization_t utilization;
+    unsigned int performanceLevel;
+    char clockFreqs[NVML_PERF_MODES_BUFFER_SIZE];
+    nvmlGpuThermalSettings_t thermalSettings;
+} NvCtrlNvmlTelemetry;
+
+/*
+ * NVML state shared by all targets of a CtrlSystem: the library handle and
+ * entry points, the device handle table and the sensor/cooler topology.  It
+ * is built by the first NVML-capable target of a system and reference counted
+ * by every NvCtrlNvmlAttributes that uses it.
+ */
+
+struct __NvCtrlNvmlContext {
+    int refcount;
+    CtrlSystem *system; /* system caching this context */
+
     struct {
         void *handle;
 
@@ -222,14 +298,37 @@ struct __NvCtrlNvmlAttributes {
         typeof(nvmlDeviceGetAdaptiveClockInfoStatus)         (*DeviceGetAdaptiveClockInfoStatus);
         typeof(nvmlDeviceGetPowerMizerMode_v1)               (*DeviceGetPowerMizerMode_v1);
         typeof(nvmlDeviceSetPowerMizerMode_v1)               (*DeviceSetPowerMizerMode_v1);
+        typeof(nvmlEventSetCreate)                           (*EventSetCreate);
+        typeof(nvmlEventSetFree)                             (*EventSetFree);
+        typeof(nvmlEventSetWait)                             (*EventSetWait);
+        typeof(nvmlDeviceRegisterEvents)                     (*DeviceRegisterEvents);
+        typeof(nvmlDeviceGetSupportedEventTypes)             (*DeviceGetSupportedEventTypes);
+        typeof(nvmlDeviceGetFieldValues)                     (*DeviceGetFieldValues);
     } lib;
 
-    unsigned int deviceIdx; /* XXX Needed while using NV-CONTROL as fallback */
     unsigned int deviceCount;
+    nvmlDevice_t *devices;          /* device handles, by NVML index */
+    Bool *deviceValid;              /* whether devices[i] could be queried */
+    unsigned int *nvctrlToNvmlId;   /* NV-CONTROL GPU id -> NVML index */
     unsigned int sensorCount;
     unsigned int *sensorCountPerGPU;
     unsigned int coolerCount;
     unsigned int *coolerCountPerGPU;
+
+    NvCtrlNvmlTelemetry *telemetry; /* telemetry snapshot, by NVML index */
+    uint64_t telemetryMaxAge;       /* snapshot lifetime, in us */
+
+    struct {
+        uint64_t windowStart;       /* start of the reporting window, in us */
+        unsigned long long calls;   /* NVML calls made in the window */
+        unsigned long long reads;   /* queries served from a snapshot */
+    } stats;
+};
+
+struct __NvCtrlNvmlAttributes {
+    NvCtrlNvmlContext *ctx;
+
+    unsigned int deviceIdx; /* XXX Needed while using NV-CONTROL as fallback */
 };
 
 struct __NvCtrlAttributePrivateHandle {
@@ -244,8 +343,10 @@ struct __NvCtrlAttributePrivateHandle {
     NvCtrlVidModeAttributes *vm;    /* XF86VidMode extension info */
     NvCtrlXvAttributes *xv;         /* XVideo info */
     Bool glx;                       /* GLX extension available */
+    NvCtrlConfigSnapshot *glx_fbconfigs; /* GLX fbconfig attributes */
     Bool egl;                       /* EGL extension available */
     EGLDisplay egl_dpy;
+    NvCtrlConfigSnapshot *egl_configs; /* EGL config attributes */
     Bool vulkan;                    /* Vulkan extension available */
     VkInstance *vk_instance;
     NvCtrlXrandrAttributes *xrandr; /* XRandR extension info */
@@ -255,6 +356,9 @@ struct __NvCtrlAttributePrivateHandle {
 
     /* Wayland display ptr */
     void *wayland_dpy;
+
+    /* Valid values and permissions already queried for this target */
+    NvCtrlValidValuesCache *valid_values_cache;
 };
 
 struct __NvCtrlEventPrivateHandle {
@@ -262,6 +366,10 @@ struct __NvCtrlEventPrivateHandle {
     int fd;                /* file descriptor to poll for new events */
     int nvctrl_event_base; /* NV-CONTROL base for indexing & identifying evts */
     int xrandr_event_base; /* RandR base for indexing & identifying evts */
+
+    /* NVML event thread, for handles of systems without an X display */
+    NvCtrlNvmlContext *nvml;
+    NvCtrlNvmlEventState *nvml_events;
 };
 
 struct __NvCtrlEventPrivateHandleNode {
@@ -298,6 +406,8 @@ static inline const NvCtrlAttributePrivateHandle
 }
 
 
+void NvCtrlReportValidValuesCacheStats(void);
+
 NvCtrlNvControlAttributes *
 NvCtrlInitNvControlAttributes (NvCtrlAttributePrivateHandle *);
 
@@ -333,6 +443,18 @@ ReturnStatus NvCtrlGlxGetVoidAttribute(const NvCtrlAttributePrivateHandle *,
 ReturnStatus NvCtrlGlxGetStringAttribute(const NvCtrlAttributePrivateHandle *,
                                          unsigned int, int, char **);
 
+/* GLX/EGL framebuffer configuration snapshots */
+
+NvCtrlConfigSnapshot *NvCtrlConfigSnapshotCreate(const char *kind,
+                                                 size_t record_size);
+void NvCtrlConfigSnapshotFree(NvCtrlConfigSnapshot *);
+void *NvCtrlConfigSnapshotGet(NvCtrlConfigSnapshot *,
+                              const NvCtrlAttributePrivateHandle *,
+                              void *(*enumerate)
+                                  (const NvCtrlAttributePrivateHandle *),
+                              int (*count)
+                                  (const NvCtrlAttributePrivateHandle *));
+
 /* EGL extension attribute functions */
 
 Bool NvCtrlInitEglAttributes(NvCtrlAttributePrivateHandle *);
@@ -490,8 +612,17 @@ void NvCtrlAssignGammaInput(NvCtrlGammaInput *pGammaInput,
 
 /* NVML backend functions */
 
-NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *);
+NvCtrlNvmlAttributes *NvCtrlInitNvmlAttributes(NvCtrlAttributePrivateHandle *,
+                                               CtrlSystem *);
 void                  NvCtrlNvmlAttributesClose(NvCtrlAttributePrivateHandle *);
+unsigned int          NvCtrlNvmlGetInitCount(void);
+
+ReturnStatus NvCtrlNvmlEventHandleOpen(NvCtrlEventPrivateHandle *evt_h,
+                                       NvCtrlNvmlContext *ctx);
+void NvCtrlNvmlEventHandleClose(NvCtrlEventPrivateHandle *evt_h);
+Bool NvCtrlNvmlEventHandlePending(NvCtrlEventPrivateHandle *evt_h);
+ReturnStatus NvCtrlNvmlEventHandleNextEvent(NvCtrlEventPrivateHandle *evt_h,
+                                            CtrlEvent *event);
 
 ReturnStatus NvCtrlNvmlQueryTargetCount(const CtrlTarget *ctrl_target,
                                         int target_type, int *val);
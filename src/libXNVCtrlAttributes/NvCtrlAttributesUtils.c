@@ -31,6 +31,7 @@
 
 #include "parse.h"
 #include "msg.h"
+#include "common-utils.h"
 #include "NvCtrlAttributes.h"
 #include "NvCtrlAttributesPrivate.h"
 
@@ -159,6 +160,8 @@ void NvCtrlFreeAllSystems(CtrlSystemList *systems)
         return;
     }
 
+    NvCtrlReportValidValuesCacheStats();
+
     for (i = 0; i < systems->n; i++) {
         nv_free_ctrl_system(systems->array[i]);
     }
@@ -852,6 +855,8 @@ static Bool load_system_info(CtrlSystem *system, const char *display)
     const CtrlTargetTypeInfo *targetTypeInfo;
     int subsystems = NV_CTRL_ATTRIBUTES_NV_CONTROL_SUBSYSTEM |
                      NV_CTRL_ATTRIBUTES_NVML_SUBSYSTEM;
+    uint64_t start_time = nv_get_monotonic_time_us();
+    unsigned int nvml_init_count = NvCtrlNvmlGetInitCount();
 
     if (!system) {
         return FALSE;
@@ -1076,6 +1081,17 @@ static Bool load_system_info(CtrlSystem *system, const char *display)
         nv_free_ctrl_target(nvmlQueryTarget);
     }
 
+    target_count = 0;
+    for (target_type = 0; target_type < MAX_TARGET_TYPES; target_type++) {
+        target_count += NvCtrlGetTargetTypeCount(system, target_type);
+    }
+
+    nv_info_msg(NULL, "Loaded %d targets from '%s' in %.2f ms "
+                "(NVML initialized %u time(s)).",
+                target_count, get_display_name(system),
+                (nv_get_monotonic_time_us() - start_time) / 1000.0,
+                NvCtrlNvmlGetInitCount() - nvml_init_count);
+
     return TRUE;
 }
 
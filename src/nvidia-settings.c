@@ -46,7 +46,7 @@ typedef struct {
     int (*fn_ctk_init_check)(int *, char **[]);
     char *(*fn_ctk_get_display)(void);
     void (*fn_ctk_main)(ParsedAttribute *, ConfigProperties *,
-                        CtrlSystem *, const char *);
+                        CtrlSystem *, const char *, int);
 } GtkLibraryData;
 
 wayland_lib wllib;
@@ -314,6 +314,25 @@ int main(int argc, char **argv)
 
     op = parse_command_line(argc, argv, &systems);
 
+    /*
+     * Stream the monitored attributes and exit; this is meant for headless
+     * monitoring agents, so don't require the user interface library.  Any
+     * assignments and queries on the same command line are processed
+     * first, so that e.g. a fan speed can be set before it is monitored.
+     */
+
+    if (op->num_monitors) {
+        ret = NV_TRUE;
+        if (op->num_assignments || op->num_queries) {
+            ret = nv_process_assignments_and_queries(op, &systems);
+        }
+        if (ret) {
+            ret = nv_process_monitors(op, &systems);
+        }
+        NvCtrlFreeAllSystems(&systems);
+        return ret ? 0 : 1;
+    }
+
     /*
      * Using the default library names, along with a possible path or name
      * specified by the user, attempt to dlopen the appropriate user interface
@@ -337,6 +356,18 @@ int main(int argc, char **argv)
 
         remove_flag_from_command_line(&argc, &argv);
 
+        /*
+         * The Frame Lock page polls X servers from worker threads; Xlib
+         * must be told before the first connection is opened, which
+         * ctk_init_check() does.  The command line operations below never
+         * start the GUI, so they keep the unlocked Xlib.
+         */
+
+        if (!op->num_assignments && !op->num_queries && !op->rewrite &&
+            !op->only_load && !op->list_targets) {
+            XInitThreads();
+        }
+
         if (libdata.fn_ctk_init_check(&argc, &argv)) {
             if (!op->ctrl_display) {
                 op->ctrl_display = libdata.fn_ctk_get_display();
@@ -452,7 +483,7 @@ int main(int argc, char **argv)
     /* pass control to the gui */
 
     system->wayland_output = w_output;
-    libdata.fn_ctk_main(p, &conf, system, op->page);
+    libdata.fn_ctk_main(p, &conf, system, op->page, op->startup_profile);
 
     /* write the configuration file */
 
@@ -142,6 +142,39 @@ static const NVGetoptOption __options[] = {
       "Devices, respectively, that are present on the X Display {DISPLAY}.  "
       "Specify ^'-q all'^ to query all attributes." },
 
+    { "monitor", MONITOR_OPTION,
+      NVGETOPT_STRING_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Periodically sample the comma-separated list of attributes &MONITOR&, "
+      "each of which uses the same syntax as the ^'--query'^ option (e.g., "
+      "^'--monitor=[gpu:0]/GPUCoreTemp,GPUUtilization'^), and print one line "
+      "per sample to standard output until interrupted.  The targets are "
+      "resolved once, when nvidia-settings starts, so that each sample only "
+      "costs the attribute queries themselves.  This option may be given "
+      "multiple times, and does not require the graphical user interface "
+      "library.  Any ^'--assign'^ and ^'--query'^ options are processed "
+      "first, and monitoring only starts if they succeed.  See "
+      "^'--interval'^." },
+
+    { "interval", INTERVAL_OPTION,
+      NVGETOPT_INTEGER_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "The time &INTERVAL&, in milliseconds, between two samples of the "
+      "^'--monitor'^ option.  The default is 1000." },
+
+    { "output", OUTPUT_OPTION,
+      NVGETOPT_STRING_ARGUMENT | NVGETOPT_HELP_ALWAYS, NULL,
+      "Select the format &OUTPUT& in which the results of the ^'--query'^ "
+      "and ^'--monitor'^ options are printed: 'text' (the default) or "
+      "'json'.  With 'json', the queries are printed as a single JSON array "
+      "with one element per queried attribute, or per target for "
+      "^'-q all'^ and the target type queries (e.g., ^'-q gpus'^); each "
+      "element is printed as soon as it is complete.  ^'--monitor'^ prints "
+      "one JSON object per sample and per line.  Other messages, such as "
+      "the confirmations of ^'--assign'^ or the targets listed by "
+      "^'--list-targets-only'^, are printed to standard error, so that "
+      "standard output only holds JSON.  When combined with "
+      "^'--terse'^, the JSON is compact and does not include the valid "
+      "values of the attributes." },
+
     { "terse", 't', NVGETOPT_HELP_ALWAYS, NULL,
       "When querying attribute values with the '--query' command line option, "
       "only print the current value, rather than the more verbose description "
@@ -186,6 +219,12 @@ static const NVGetoptOption __options[] = {
       "The first page with a name matching the &PAGE& argument will be used.  "
       "By default, the \"System Information\" page is displayed." },
 
+    { "startup-profile", STARTUP_PROFILE_OPTION, NVGETOPT_HELP_ALWAYS, NULL,
+      "Print the time spent building each page of the nvidia-settings user "
+      "interface, and the time until the window is shown.  Pages that are "
+      "built when first selected, or in the background, are reported as "
+      "they are built." },
+
     { "list-targets-only", 'L', NVGETOPT_HELP_ALWAYS, NULL,
       "When performing an attribute query (from the '--query' command line "
       "option) or an attribute assignment (from the '--assign' command line "
@@ -22,6 +22,7 @@
 #include <ctype.h>
 #include <string.h>
 #include <sys/utsname.h>
+#include <pthread.h>
 
 #include "NVCtrl.h"
 
@@ -375,6 +376,89 @@ const int attributeTableLen = ARRAY_LEN(attributeTable);
 
 
 
+/*
+ * Lookup indices for attributeTable[]: an open addressed hash keyed by
+ * (type, attr) and a case-insensitive hash keyed by name.  Each slot holds
+ * the attributeTable[] index plus one, so that zero marks an empty slot.
+ * Both tables are sized to a power of two at least twice the table length,
+ * and are built once, by the first lookup from any thread.
+ */
+
+#define ATTRIBUTE_INDEX_SIZE 2048
+
+/* Fails to compile if attributeTable[] outgrows the index size. */
+typedef char AttributeIndexSizeCheck[(ARRAY_LEN(attributeTable) * 2 <=
+                                      ATTRIBUTE_INDEX_SIZE) ? 1 : -1];
+
+static unsigned short attributeIdIndex[ATTRIBUTE_INDEX_SIZE];
+static unsigned short attributeNameIndex[ATTRIBUTE_INDEX_SIZE];
+static pthread_once_t attributeIndexOnce = PTHREAD_ONCE_INIT;
+
+static unsigned int attribute_id_hash(const int attr,
+                                      const CtrlAttributeType type)
+{
+    unsigned int h = ((unsigned int) attr * 2654435761u) ^
+                     ((unsigned int) type * 40503u);
+
+    return (h ^ (h >> 15)) & (ATTRIBUTE_INDEX_SIZE - 1);
+}
+
+static unsigned int attribute_name_hash(const char *name)
+{
+    unsigned int h = 2166136261u; /* FNV-1a */
+
+    while (*name) {
+        h ^= (unsigned char) toupper((unsigned char) *name);
+        h *= 16777619u;
+        name++;
+    }
+
+    return h & (ATTRIBUTE_INDEX_SIZE - 1);
+}
+
+static void build_attribute_index(void)
+{
+    int i;
+
+    /*
+     * Entries are inserted in table order and duplicates are skipped, so
+     * lookups return the same entry a linear scan of the table would.
+     */
+
+    for (i = 0; i < attributeTableLen; i++) {
+        const AttributeTableEntry *a = attributeTable + i;
+        unsigned int h;
+
+        h = attribute_id_hash(a->attr, a->type);
+        while (attributeIdIndex[h]) {
+            const AttributeTableEntry *t = attributeTable +
+                                           attributeIdIndex[h] - 1;
+            if ((t->attr == a->attr) && (t->type == a->type)) {
+                break;
+            }
+            h = (h + 1) & (ATTRIBUTE_INDEX_SIZE - 1);
+        }
+        if (!attributeIdIndex[h]) {
+            attributeIdIndex[h] = i + 1;
+        }
+
+        h = attribute_name_hash(a->name);
+        while (attributeNameIndex[h]) {
+            const AttributeTableEntry *t = attributeTable +
+                                           attributeNameIndex[h] - 1;
+            if (nv_strcasecmp(t->name, a->name)) {
+                break;
+            }
+            h = (h + 1) & (ATTRIBUTE_INDEX_SIZE - 1);
+        }
+        if (!attributeNameIndex[h]) {
+            attributeNameIndex[h] = i + 1;
+        }
+    }
+}
+
+
+
 /*
  * returns the corresponding attribute entry for the given attribute constant.
  *
@@ -382,19 +466,37 @@ const int attributeTableLen = ARRAY_LEN(attributeTable);
 const AttributeTableEntry *nv_get_attribute_entry(const int attr,
                                                   const CtrlAttributeType type)
 {
-    int i;
+    unsigned int h;
 
-    for (i = 0; i < attributeTableLen; i++) {
-        const AttributeTableEntry *a = attributeTable + i;
+    pthread_once(&attributeIndexOnce, build_attribute_index);
+
+    h = attribute_id_hash(attr, type);
+    while (attributeIdIndex[h]) {
+        const AttributeTableEntry *a = attributeTable +
+                                       attributeIdIndex[h] - 1;
         if ((a->attr == attr) && (a->type == type)) {
             return a;
         }
+        h = (h + 1) & (ATTRIBUTE_INDEX_SIZE - 1);
     }
 
     return NULL;
 }
 
 
+/*
+ * returns the name of the given attribute constant, or "Unknown" if the
+ * attribute is not in attributeTable[].
+ *
+ */
+const char *nv_get_attribute_name(const int attr, const CtrlAttributeType type)
+{
+    const AttributeTableEntry *a = nv_get_attribute_entry(attr, type);
+
+    return a ? a->name : "Unknown";
+}
+
+
 /*
  * returns the corresponding attribute entry for the given attribute
  * name.
@@ -402,13 +504,22 @@ const AttributeTableEntry *nv_get_attribute_entry(const int attr,
  */
 static const AttributeTableEntry *nv_get_attribute_entry_by_name(const char *name)
 {
-    int i;
+    unsigned int h;
 
-    for (i = 0; i < attributeTableLen; i++) {
-        const AttributeTableEntry *t = attributeTable + i;
+    if (!name) {
+        return NULL;
+    }
+
+    pthread_once(&attributeIndexOnce, build_attribute_index);
+
+    h = attribute_name_hash(name);
+    while (attributeNameIndex[h]) {
+        const AttributeTableEntry *t = attributeTable +
+                                       attributeNameIndex[h] - 1;
         if (nv_strcasecmp(name, t->name)) {
             return t;
         }
+        h = (h + 1) & (ATTRIBUTE_INDEX_SIZE - 1);
     }
 
     return NULL;
@@ -1795,3 +1906,149 @@ int parse_token_value_pairs(const char *str, apply_token_func func,
     return 1;
 
 } /* parse_token_value_pairs() */
+
+
+
+/** parse_read_slice() ***********************************************
+ *
+ * Same as parse_read_name(), but instead of copying the name, makes
+ * 'slice' point to it within 'str'.  Unlike parse_read_name(), trailing
+ * whitespace is left out of the slice, as parse_token_value_pairs()
+ * removes it from its copies with parse_chop_whitespace().
+ *
+ **/
+static const char *parse_read_slice(const char *str, ParseSlice *slice,
+                                    char term)
+{
+    const char *end;
+
+    str = parse_skip_whitespace(str);
+    if (!str) {
+        return NULL;
+    }
+
+    slice->str = str;
+    while (*str && !name_terminated(*str, term)) {
+        str++;
+    }
+
+    end = str;
+    while (end > slice->str &&
+           (end[-1] == ' '  || end[-1] == '\t' ||
+            end[-1] == '\n' || end[-1] == '\r')) {
+        end--;
+    }
+    slice->len = end - slice->str;
+
+    if (name_terminated(*str, term)) {
+        str++;
+    }
+    return parse_skip_whitespace(str);
+
+} /* parse_read_slice() */
+
+
+
+/** parse_token_value_slices() ***************************************
+ *
+ * Same as parse_token_value_pairs(), but the tokens and values are
+ * given to 'func' as slices of 'str' rather than as copies, so that
+ * parsing does not allocate any memory.  This is meant for strings
+ * that are parsed often, such as the ones polled from the driver.
+ *
+ **/
+int parse_token_value_slices(const char *str, apply_token_slice_func func,
+                             void *data)
+{
+    ParseSlice token;
+    ParseSlice value;
+    char endChar;
+
+
+    if (str) {
+
+        /* Parse each token */
+        while (*str) {
+
+            /* Read the token */
+            str = parse_read_slice(str, &token, '=');
+            if (!str) return 0;
+
+            /* Read the value */
+            if (*str == '(') {
+                str++;
+                endChar = ')';
+            } else {
+                endChar = ',';
+            }
+            str = parse_read_slice(str, &value, endChar);
+            if (!str) return 0;
+            if (endChar == ')' && *str == ')') {
+                str++;
+            }
+            if (*str == ',') {
+                str++;
+            }
+
+            func(token, value, data);
+        }
+    }
+
+    return 1;
+
+} /* parse_token_value_slices() */
+
+
+
+/** parse_slice_strcasecmp() *****************************************
+ *
+ * Compares the slice to the string 'str', ignoring case.  Returns
+ * NV_TRUE if a match, NV_FALSE otherwise (as nv_strcasecmp()).
+ *
+ **/
+int parse_slice_strcasecmp(ParseSlice slice, const char *str)
+{
+    int i;
+
+    for (i = 0; i < slice.len; i++) {
+        if (toupper(slice.str[i]) != toupper(str[i]) || str[i] == '\0') {
+            return NV_FALSE;
+        }
+    }
+
+    return (str[i] == '\0');
+
+} /* parse_slice_strcasecmp() */
+
+
+
+/** parse_slice_atoi() ***********************************************
+ *
+ * Returns the integer at the start of the slice, as atoi() would for
+ * the slice as a string.
+ *
+ **/
+int parse_slice_atoi(ParseSlice slice)
+{
+    char buf[32];
+    int len = NV_MIN(slice.len, (int)sizeof(buf) - 1);
+
+    memcpy(buf, slice.str, len);
+    buf[len] = '\0';
+
+    return atoi(buf);
+
+} /* parse_slice_atoi() */
+
+
+
+/** parse_slice_strdup() *********************************************
+ *
+ * Returns a newly allocated copy of the slice, as a string.
+ *
+ **/
+char *parse_slice_strdup(ParseSlice slice)
+{
+    return nvstrndup(slice.str, slice.len);
+
+} /* parse_slice_strdup() */
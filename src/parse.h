@@ -281,6 +281,7 @@ void nv_parsed_attribute_clean(ParsedAttribute *p);
 
 const AttributeTableEntry *nv_get_attribute_entry(const int attr,
                                                   const CtrlAttributeType type);
+const char *nv_get_attribute_name(const int attr, const CtrlAttributeType type);
 
 char *nv_standardize_screen_name(const char *display_name, int screen);
 
@@ -310,6 +311,25 @@ typedef void (* apply_token_func)(char *token, char *value, void *data);
 int parse_token_value_pairs(const char *str, apply_token_func func,
                             void *data);
 
+/*
+ * ParseSlice - 'len' characters of a string starting at 'str'.  Slices
+ * point into the string they were parsed from and are not NUL terminated.
+ */
+
+typedef struct {
+    const char *str;
+    int len;
+} ParseSlice;
+
+typedef void (* apply_token_slice_func)(ParseSlice token, ParseSlice value,
+                                        void *data);
+
+int parse_token_value_slices(const char *str, apply_token_slice_func func,
+                             void *data);
+int parse_slice_strcasecmp(ParseSlice slice, const char *str);
+int parse_slice_atoi(ParseSlice slice);
+char *parse_slice_strdup(ParseSlice slice);
+
 
 
 #endif /* __PARSE_H__ */
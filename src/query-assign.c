@@ -29,10 +29,13 @@
 #include <ctype.h>
 #include <string.h>
 #include <inttypes.h>
+#include <time.h>
 
 #include <X11/Xlib.h>
 #include "NVCtrlLib.h"
 
+#include <jansson.h>
+
 #include "parse.h"
 #include "msg.h"
 #include "query-assign.h"
@@ -51,12 +54,23 @@ static int process_attribute_assignments(const Options *,
                                          CtrlSystemList *);
 
 static int query_all(const Options *, const char *, CtrlSystemList *);
-static int query_all_targets(const char *display_name, const int target_type,
-                             CtrlSystemList *);
+static int query_all_targets(const Options *op, const char *display_name,
+                             const int target_type, CtrlSystemList *);
 
 static void print_valid_values(const Options *op, const AttributeTableEntry *a,
                                CtrlAttributeValidValues valid);
 
+static void json_output_begin(void);
+static void json_output_end(void);
+static void json_output_emit(const Options *op, json_t *element);
+static void json_output_msg(const Options *op, const char *prefix,
+                            const char *fmt, ...) NV_ATTRIBUTE_PRINTF(3, 4);
+static json_t *target_to_json(CtrlTarget *t);
+static json_t *attribute_to_json(const Options *op, CtrlTarget *t,
+                                 const AttributeTableEntry *a, uint32 mask,
+                                 const CtrlAttributeValidValues *valid,
+                                 int val, const char *str);
+
 static void print_additional_info(const char *name,
                                   int attr,
                                   CtrlAttributeValidValues valid,
@@ -723,9 +737,11 @@ static int process_attribute_queries(const Options *op,
 
     val = NV_FALSE;
     
-    /* print a newline before we begin */
+    /* print a newline (or open the JSON array) before we begin */
 
-    if (!op->terse) {
+    if (op->output_json) {
+        json_output_begin();
+    } else if (!op->terse) {
         nv_msg(NULL, "");
     }
 
@@ -744,44 +760,44 @@ static int process_attribute_queries(const Options *op,
         
         if (nv_strcasecmp(queries[query], "screens") ||
             nv_strcasecmp(queries[query], "xscreens")) {
-            query_all_targets(display_name, X_SCREEN_TARGET, systems);
+            query_all_targets(op, display_name, X_SCREEN_TARGET, systems);
             continue;
         }
         
         if (nv_strcasecmp(queries[query], "gpus")) {
-            query_all_targets(display_name, GPU_TARGET, systems);
+            query_all_targets(op, display_name, GPU_TARGET, systems);
             continue;
         }
 
         if (nv_strcasecmp(queries[query], "framelocks")) {
-            query_all_targets(display_name, FRAMELOCK_TARGET, systems);
+            query_all_targets(op, display_name, FRAMELOCK_TARGET, systems);
             continue;
         }
 
         if (nv_strcasecmp(queries[query], "fans")) {
-            query_all_targets(display_name, COOLER_TARGET, systems);
+            query_all_targets(op, display_name, COOLER_TARGET, systems);
             continue;
         }
 
         if (nv_strcasecmp(queries[query], "thermalsensors")) {
-            query_all_targets(display_name, THERMAL_SENSOR_TARGET, systems);
+            query_all_targets(op, display_name, THERMAL_SENSOR_TARGET, systems);
             continue;
         }
 
         if (nv_strcasecmp(queries[query], "svps")) {
-            query_all_targets(display_name, 
-                              NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET, 
+            query_all_targets(op, display_name,
+                              NVIDIA_3D_VISION_PRO_TRANSCEIVER_TARGET,
                               systems);
             continue;
         }
 
         if (nv_strcasecmp(queries[query], "dpys")) {
-            query_all_targets(display_name, DISPLAY_TARGET, systems);
+            query_all_targets(op, display_name, DISPLAY_TARGET, systems);
             continue;
         }
 
         if (nv_strcasecmp(queries[query], "muxes")) {
-            query_all_targets(display_name, MUX_TARGET, systems);
+            query_all_targets(op, display_name, MUX_TARGET, systems);
             continue;
         }
 
@@ -812,7 +828,7 @@ static int process_attribute_queries(const Options *op,
         if (ret == NV_FALSE) goto done;
 
         /* print a newline at the end */
-        if (!op->terse) {
+        if (!op->terse && !op->output_json) {
             nv_msg(NULL, "");
         }
 
@@ -821,6 +837,10 @@ static int process_attribute_queries(const Options *op,
     val = NV_TRUE;
     
  done:
+
+    if (op->output_json) {
+        json_output_end();
+    }
     
     return val;
     
@@ -850,7 +870,9 @@ static int process_attribute_assignments(const Options *op,
 
     /* print a newline before we begin */
 
-    nv_msg(NULL, "");
+    if (!op->output_json) {
+        nv_msg(NULL, "");
+    }
 
     /* loop over each requested assignment */
 
@@ -887,7 +909,9 @@ static int process_attribute_assignments(const Options *op,
 
         /* print a newline at the end */
 
-        nv_msg(NULL, "");
+        if (!op->output_json) {
+            nv_msg(NULL, "");
+        }
 
     } /* assignment */
 
@@ -1185,33 +1209,27 @@ static void print_valid_values(const Options *op, const AttributeTableEntry *a,
 
 
 
-/*
- * print_queried_value() - print the (integer) attribute value that we queried
- * from NV-CONTROL
- */
-
 typedef enum {
     VerboseLevelTerse,
     VerboseLevelAbbreviated,
     VerboseLevelVerbose,
 } VerboseLevel;
 
-static void print_queried_value(const Options *op,
-                                CtrlTarget *target,
-                                CtrlAttributeValidValues *v,
-                                int val,
-                                const AttributeTableEntry *a,
-                                uint32 mask,
-                                const char *indent,
-                                const VerboseLevel level)
-{
-    char d_str[64], val_str[64], *tmp_d_str;
 
-    if (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER) {
-        return;
-    }
 
-    /* assign val_str */
+/*
+ * format_queried_value() - format an integer attribute value into the
+ * 64 byte buffer val_str, the way it is printed in response to a query
+ */
+
+static void format_queried_value(const Options *op,
+                                 CtrlTarget *target,
+                                 const CtrlAttributeValidValues *v,
+                                 int val,
+                                 const AttributeTableEntry *a,
+                                 char *val_str)
+{
+    char *tmp_d_str;
 
     if (a->f.int_flags.is_display_id && op->dpy_string) {
         const char *name = NvCtrlGetDisplayConfigName(target->system, val);
@@ -1236,6 +1254,34 @@ static void print_queried_value(const Options *op,
         snprintf(val_str, 64, "%d", val);
     }
 
+} /* format_queried_value() */
+
+
+
+/*
+ * print_queried_value() - print the (integer) attribute value that we queried
+ * from NV-CONTROL
+ */
+
+static void print_queried_value(const Options *op,
+                                CtrlTarget *target,
+                                CtrlAttributeValidValues *v,
+                                int val,
+                                const AttributeTableEntry *a,
+                                uint32 mask,
+                                const char *indent,
+                                const VerboseLevel level)
+{
+    char d_str[64], val_str[64], *tmp_d_str;
+
+    if (a->type != CTRL_ATTRIBUTE_TYPE_INTEGER) {
+        return;
+    }
+
+    /* assign val_str */
+
+    format_queried_value(op, target, v, val, a, val_str);
+
     /* append the display device name, if necessary */
 
     if ((NvCtrlGetTargetType(target) != DISPLAY_TARGET) &&
@@ -1276,6 +1322,265 @@ static void print_queried_value(const Options *op,
 
 
 
+/*
+ * With --output=json, the results of all the queries on the command line
+ * are printed as one JSON array.  Each element is dumped with json_dumpf()
+ * as soon as it is complete (one per queried attribute, or one per target
+ * for "-q all" and the target type queries), so that we never build a
+ * tree larger than what one target holds.
+ */
+
+static int json_output_count;
+
+static void json_output_begin(void)
+{
+    json_output_count = 0;
+    printf("[");
+}
+
+static void json_output_end(void)
+{
+    printf("%s]\n", json_output_count ? "\n" : "");
+    fflush(stdout);
+}
+
+static void json_output_emit(const Options *op, json_t *element)
+{
+    size_t flags = JSON_PRESERVE_ORDER;
+
+    flags |= op->terse ? JSON_COMPACT : JSON_INDENT(2);
+
+    printf("%s\n", json_output_count++ ? "," : "");
+    json_dumpf(element, stdout, flags);
+
+    json_decref(element);
+}
+
+/*
+ * json_output_msg() - print a message that is not the result of a query,
+ * such as the confirmation of an assignment: like nv_msg() with text
+ * output, and to stderr with --output=json, so that stdout only holds JSON.
+ */
+
+static void json_output_msg(const Options *op, const char *prefix,
+                            const char *fmt, ...)
+{
+    char *msg;
+
+    NV_VSNPRINTF(msg, fmt);
+
+    if (!msg) {
+        return;
+    }
+
+    if (op->output_json) {
+        fprintf(stderr, "%s%s\n", prefix ? prefix : "", msg);
+    } else {
+        nv_msg(prefix, "%s", msg);
+    }
+
+    free(msg);
+}
+
+
+
+/*
+ * target_spec_to_json() - return the target 't' as a JSON string, using the
+ * same "[type:id]" syntax as target specifications on the command line.
+ */
+
+static json_t *target_spec_to_json(CtrlTarget *t)
+{
+    char *spec;
+    json_t *str;
+
+    spec = nvasprintf("[%s:%d]", t->targetTypeInfo->parsed_name,
+                      NvCtrlGetTargetId(t));
+    str = json_string(spec);
+    nvfree(spec);
+
+    return str;
+}
+
+
+
+/*
+ * target_to_json() - return a new JSON object identifying the target 't'.
+ */
+
+static json_t *target_to_json(CtrlTarget *t)
+{
+    json_t *obj = json_object();
+
+    json_object_set_new(obj, "target", target_spec_to_json(t));
+    json_object_set_new(obj, "target_type",
+                        json_string(t->targetTypeInfo->parsed_name));
+    json_object_set_new(obj, "target_id", json_integer(NvCtrlGetTargetId(t)));
+    json_object_set_new(obj, "name",
+                        t->name ? json_string(t->name) : json_null());
+
+    return obj;
+}
+
+
+
+/*
+ * valid_bits_to_json() - return the bits set in 'bits', from 'first' to
+ * 'last' inclusive, as a JSON array of bit positions relative to 'first'.
+ */
+
+static json_t *valid_bits_to_json(unsigned int bits, int first, int last)
+{
+    json_t *array = json_array();
+    int bit;
+
+    for (bit = first; bit <= last; bit++) {
+        if (bits & (1U << bit)) {
+            json_array_append_new(array, json_integer(bit - first));
+        }
+    }
+
+    return array;
+}
+
+
+
+/*
+ * valid_values_to_json() - the JSON counterpart of print_valid_values():
+ * return a new JSON object describing the valid values and permissions of
+ * the attribute 'a'.  Packed attributes report their ranges and values as
+ * [upper 16 bits, lower 16 bits] pairs.
+ */
+
+static json_t *valid_values_to_json(const AttributeTableEntry *a,
+                                    const CtrlAttributeValidValues *valid)
+{
+    json_t *obj = json_object();
+    json_t *targets;
+    const char *type = NULL;
+    int packed, i;
+
+    packed = (a->type == CTRL_ATTRIBUTE_TYPE_INTEGER) &&
+             a->f.int_flags.is_packed;
+
+    switch (valid->valid_type) {
+    case CTRL_ATTRIBUTE_VALID_TYPE_STRING:       type = "string";  break;
+    case CTRL_ATTRIBUTE_VALID_TYPE_64BIT_INTEGER: type = "int64";  break;
+    case CTRL_ATTRIBUTE_VALID_TYPE_INTEGER:      type = "integer"; break;
+    case CTRL_ATTRIBUTE_VALID_TYPE_BITMASK:      type = "bitmask"; break;
+    case CTRL_ATTRIBUTE_VALID_TYPE_BOOL:         type = "bool";    break;
+    case CTRL_ATTRIBUTE_VALID_TYPE_RANGE:        type = "range";   break;
+    case CTRL_ATTRIBUTE_VALID_TYPE_INT_BITS:     type = "values";  break;
+    default:
+        break;
+    }
+
+    json_object_set_new(obj, "type", type ? json_string(type) : json_null());
+
+    if (packed) {
+        json_object_set_new(obj, "packed", json_true());
+    }
+
+    if (valid->valid_type == CTRL_ATTRIBUTE_VALID_TYPE_RANGE) {
+        if (packed) {
+            json_int_t min = valid->range.min, max = valid->range.max;
+
+            json_object_set_new(obj, "min",
+                                json_pack("[II]", min >> 16, min & 0xffff));
+            json_object_set_new(obj, "max",
+                                json_pack("[II]", max >> 16, max & 0xffff));
+        } else {
+            json_object_set_new(obj, "min", json_integer(valid->range.min));
+            json_object_set_new(obj, "max", json_integer(valid->range.max));
+        }
+    } else if (valid->valid_type == CTRL_ATTRIBUTE_VALID_TYPE_INT_BITS) {
+        if (packed) {
+            json_object_set_new(obj, "values",
+                json_pack("[oo]",
+                          valid_bits_to_json(valid->allowed_ints, 16, 31),
+                          valid_bits_to_json(valid->allowed_ints, 0, 15)));
+        } else {
+            json_object_set_new(obj, "values",
+                valid_bits_to_json(valid->allowed_ints, 0, 31));
+        }
+    }
+
+    json_object_set_new(obj, "writable",
+                        json_boolean(valid->permissions.write));
+    json_object_set_new(obj, "display_specific",
+                        json_boolean(valid->permissions.valid_targets &
+                                     CTRL_TARGET_PERM_BIT(DISPLAY_TARGET)));
+
+    targets = json_array();
+
+    for (i = 0; i < MAX_TARGET_TYPES; i++) {
+        const CtrlTargetTypeInfo *targetTypeInfo =
+            NvCtrlGetTargetTypeInfo(i);
+
+        if (valid->permissions.valid_targets &
+            targetTypeInfo->permission_bit) {
+            json_array_append_new(targets,
+                                  json_string(targetTypeInfo->parsed_name));
+        }
+    }
+
+    json_object_set_new(obj, "target_types", targets);
+
+    return obj;
+}
+
+
+
+/*
+ * attribute_to_json() - return a new JSON object holding the queried value
+ * of the attribute 'a' on the target 't'.  Integer values are reported
+ * as is, along with their printed form when that differs (e.g., packed
+ * values, frequencies or display device names); unless in terse mode, the
+ * valid values are included.  'str' is the value of string attributes.
+ */
+
+static json_t *attribute_to_json(const Options *op, CtrlTarget *t,
+                                 const AttributeTableEntry *a, uint32 mask,
+                                 const CtrlAttributeValidValues *valid,
+                                 int val, const char *str)
+{
+    json_t *obj = json_object();
+    char val_str[64], int_str[64];
+
+    json_object_set_new(obj, "attribute", json_string(a->name));
+    json_object_set_new(obj, "target", target_spec_to_json(t));
+
+    if ((NvCtrlGetTargetType(t) != DISPLAY_TARGET) &&
+        (valid->permissions.valid_targets &
+         CTRL_TARGET_PERM_BIT(DISPLAY_TARGET))) {
+        char *tmp_d_str = display_device_mask_to_display_device_name(mask);
+        json_object_set_new(obj, "display_device", json_string(tmp_d_str));
+        free(tmp_d_str);
+    }
+
+    if (a->type == CTRL_ATTRIBUTE_TYPE_STRING) {
+        json_object_set_new(obj, "value", json_string(str));
+    } else {
+        json_object_set_new(obj, "value", json_integer(val));
+
+        format_queried_value(op, t, valid, val, a, val_str);
+        snprintf(int_str, sizeof(int_str), "%d", val);
+
+        if (strcmp(val_str, int_str) != 0) {
+            json_object_set_new(obj, "formatted", json_string(val_str));
+        }
+    }
+
+    if (!op->terse) {
+        json_object_set_new(obj, "valid_values",
+                            valid_values_to_json(a, valid));
+    }
+
+    return obj;
+}
+
+
+
 /*
  * print_additional_stereo_info() - print the available stereo modes
  */
@@ -1375,10 +1680,12 @@ static int query_all(const Options *op, const char *display_name,
                      CtrlSystemList *systems)
 {
     int bit, entry, val, target_type;
-    uint32 mask;
+    uint32 mask, first_mask;
     ReturnStatus status;
     CtrlAttributeValidValues valid;
     CtrlSystem *system;
+    CtrlAttributeQuery *prefetch;
+    json_t *target_json = NULL, *attributes_json = NULL;
 
     system = NvCtrlConnectToLimitedSystem(display_name, systems, TRUE);
     if (!system) {
@@ -1387,6 +1694,8 @@ static int query_all(const Options *op, const char *display_name,
 
 #define INDENT "  "
 
+    prefetch = nvalloc(attributeTableLen * sizeof(CtrlAttributeQuery));
+
     /*
      * Loop through all target types.
      */
@@ -1402,12 +1711,51 @@ static int query_all(const Options *op, const char *display_name,
 
             if (!t->h) continue;
 
-            nv_msg(NULL, "Attributes queryable via %s:", t->name);
+            /*
+             * in JSON mode, collect the attributes of this target and
+             * print them as one element once they have all been queried
+             */
 
-            if (!op->terse) {
-                nv_msg(NULL, "");
+            if (op->output_json) {
+                target_json = target_to_json(t);
+                attributes_json = json_array();
+                json_object_set_new(target_json, "attributes",
+                                    attributes_json);
+            } else {
+                nv_msg(NULL, "Attributes queryable via %s:", t->name);
+
+                if (!op->terse) {
+                    nv_msg(NULL, "");
+                }
             }
 
+            /*
+             * Fetch the values of all the integer attributes for the first
+             * display device mask queried below in a single batch, rather
+             * than with one round trip per attribute.
+             */
+
+            first_mask = 1;
+            if (targetTypeInfo->uses_display_devices && (t->d & 0xffffff)) {
+                first_mask = t->d & -t->d;
+            }
+
+            for (entry = 0; entry < attributeTableLen; entry++) {
+                const AttributeTableEntry *a = &attributeTable[entry];
+                CtrlAttributeQuery *q = &prefetch[entry];
+
+                memset(q, 0, sizeof(*q));
+
+                if ((a->type == CTRL_ATTRIBUTE_TYPE_INTEGER) &&
+                    !a->flags.no_query_all) {
+                    q->ctrl_target = t;
+                    q->display_mask = first_mask;
+                    q->attr = a->attr;
+                }
+            }
+
+            NvCtrlGetAttributesBatch(prefetch, attributeTableLen);
+
             for (entry = 0; entry < attributeTableLen; entry++) {
                 const AttributeTableEntry *a = &attributeTable[entry];
 
@@ -1472,7 +1820,11 @@ static int query_all(const Options *op, const char *display_name,
                             goto exit_bit_loop;
                         }
 
-                        if (op->terse) {
+                        if (attributes_json) {
+                            json_array_append_new(attributes_json,
+                                attribute_to_json(op, t, a, mask, &valid,
+                                                  0, tmp_str));
+                        } else if (op->terse) {
                             nv_msg("  ", "%s: %s", a->name, tmp_str);
                         } else {
                             nv_msg("  ",  "Attribute '%s' (%s%s): %s ",
@@ -1500,8 +1852,14 @@ static int query_all(const Options *op, const char *display_name,
                             goto exit_bit_loop;
                         }
 
-                        status = NvCtrlGetDisplayAttribute(t, mask, a->attr,
-                                                           &val);
+                        if (prefetch[entry].ctrl_target &&
+                            (prefetch[entry].display_mask == mask)) {
+                            status = prefetch[entry].status;
+                            val = prefetch[entry].val;
+                        } else {
+                            status = NvCtrlGetDisplayAttribute(t, mask,
+                                                               a->attr, &val);
+                        }
 
                         if (status == NvCtrlAttributeNotAvailable) {
                             goto exit_bit_loop;
@@ -1514,16 +1872,25 @@ static int query_all(const Options *op, const char *display_name,
                             goto exit_bit_loop;
                         }
 
-                        print_queried_value(op, t, &valid, val, a, mask,
-                                            INDENT, op->terse ?
-                                            VerboseLevelAbbreviated :
-                                            VerboseLevelVerbose);
+                        if (attributes_json) {
+                            json_array_append_new(attributes_json,
+                                attribute_to_json(op, t, a, mask, &valid,
+                                                  val, NULL));
+                        } else {
+                            print_queried_value(op, t, &valid, val, a, mask,
+                                                INDENT, op->terse ?
+                                                VerboseLevelAbbreviated :
+                                                VerboseLevelVerbose);
+                        }
 
                     }
-                    print_valid_values(op, a, valid);
 
-                    if (!op->terse) {
-                        nv_msg(NULL,"");
+                    if (!attributes_json) {
+                        print_valid_values(op, a, valid);
+
+                        if (!op->terse) {
+                            nv_msg(NULL,"");
+                        }
                     }
 
                     if ((valid.permissions.valid_targets &
@@ -1542,12 +1909,19 @@ exit_bit_loop:
 
             } /* entry */
 
+            if (attributes_json) {
+                json_output_emit(op, target_json);
+                attributes_json = NULL;
+            }
+
         } /* j (targets) */
 
     } /* target_type */
 
 #undef INDENT
 
+    nvfree(prefetch);
+
     return NV_TRUE;
 
 } /* query_all() */
@@ -1729,13 +2103,56 @@ static int print_target_connections(CtrlTarget *t,
 
 
 
+/*
+ * target_info_to_json() - the JSON counterpart of the per target
+ * information printed by query_all_targets(): return a new JSON object
+ * with the index, product name, names and related targets of 't'.
+ */
+
+static json_t *target_info_to_json(CtrlTarget *t, int idx,
+                                   const char *product_name)
+{
+    json_t *obj = target_to_json(t);
+    json_t *names, *relations;
+    CtrlTargetNode *node;
+    int n;
+
+    json_object_set_new(obj, "index", json_integer(idx));
+    json_object_set_new(obj, "product_name", json_string(product_name));
+
+    if (NvCtrlGetTargetType(t) == DISPLAY_TARGET) {
+        json_object_set_new(obj, "connected",
+                            json_boolean(t->display.connected));
+        json_object_set_new(obj, "enabled",
+                            json_boolean(t->display.enabled));
+    }
+
+    names = json_array();
+    for (n = 0; n < NV_PROTO_NAME_MAX; n++) {
+        if (t->protoNames[n]) {
+            json_array_append_new(names, json_string(t->protoNames[n]));
+        }
+    }
+    json_object_set_new(obj, "names", names);
+
+    relations = json_array();
+    for (node = t->relations; node; node = node->next) {
+        json_array_append_new(relations, target_spec_to_json(node->t));
+    }
+    json_object_set_new(obj, "relations", relations);
+
+    return obj;
+}
+
+
+
 /*
  * query_all_targets() - print a list of all the targets (of the
  * specified type) accessible via the Display connection.
  */
 
-static int query_all_targets(const char *display_name, const int target_type,
-                             CtrlSystemList *systems)
+static int query_all_targets(const Options *op, const char *display_name,
+                             const int target_type, CtrlSystemList *systems)
 {
     CtrlSystem *system;
     CtrlTargetNode *node;
@@ -1773,12 +2190,14 @@ static int query_all_targets(const char *display_name, const int target_type,
     /* print how many of the target type we have */
 
     target_count = NvCtrlGetTargetTypeCount(system, target_type);
-    nv_msg(NULL, "%d %s%s on %s",
-           target_count,
-           targetTypeInfo->name,
-           (target_count > 1) ? "s" : "",
-           str);
-    nv_msg(NULL, "");
+    if (!op->output_json) {
+        nv_msg(NULL, "%d %s%s on %s",
+               target_count,
+               targetTypeInfo->name,
+               (target_count > 1) ? "s" : "",
+               str);
+        nv_msg(NULL, "");
+    }
 
     free(str);
 
@@ -1828,14 +2247,18 @@ static int query_all_targets(const char *display_name, const int target_type,
             name = "Not NVIDIA";
         }
 
-        nv_msg("    ", "[%d] %s (%s)%s%s%s",
-               idx,
-               name,
-               product_name,
-               extra_str ? " (" : "",
-               extra_str ? extra_str : "",
-               extra_str ? ")" : "");
-        nv_msg(NULL, "");
+        if (op->output_json) {
+            json_output_emit(op, target_info_to_json(t, idx, product_name));
+        } else {
+            nv_msg("    ", "[%d] %s (%s)%s%s%s",
+                   idx,
+                   name,
+                   product_name,
+                   extra_str ? " (" : "",
+                   extra_str ? extra_str : "",
+                   extra_str ? ")" : "");
+            nv_msg(NULL, "");
+        }
 
         if (product_name != buff) {
             free(product_name);
@@ -1844,6 +2267,10 @@ static int query_all_targets(const char *display_name, const int target_type,
             nvfree(extra_str);
         }
 
+        if (op->output_json) {
+            continue;
+        }
+
         /* Print the valid protocol names for the target */
         if (t->protoNames[0]) {
             int idx;
@@ -1989,8 +2416,9 @@ static int process_parsed_attribute_internal(const Options *op,
             }
 
             if (verbose) {
-                 nv_msg("  ", "Attribute '%s' (%s%s) assigned value '%s'.",
-                 a->name, t->name, str, p->val.str);
+                json_output_msg(op, "  ",
+                                "Attribute '%s' (%s%s) assigned value '%s'.",
+                                a->name, t->name, str, p->val.str);
             }
         } else {
 
@@ -2009,12 +2437,13 @@ static int process_parsed_attribute_internal(const Options *op,
 
             if (verbose) {
                 if (a->f.int_flags.is_packed) {
-                    nv_msg("  ", "Attribute '%s' (%s%s) assigned value %d,%d.",
-                           a->name, t->name, str,
-                           p->val.i >> 16, p->val.i & 0xffff);
+                    json_output_msg(op, "  ", "Attribute '%s' (%s%s) assigned "
+                                    "value %d,%d.", a->name, t->name, str,
+                                    p->val.i >> 16, p->val.i & 0xffff);
                 } else {
-                    nv_msg("  ", "Attribute '%s' (%s%s) assigned value %d.",
-                           a->name, t->name, str, p->val.i);
+                    json_output_msg(op, "  ", "Attribute '%s' (%s%s) assigned "
+                                    "value %d.", a->name, t->name, str,
+                                    p->val.i);
                 }
             }
         }
@@ -2038,7 +2467,11 @@ static int process_parsed_attribute_internal(const Options *op,
                 return NV_FALSE;
             } else {
 
-                if (op->terse) {
+                if (op->output_json) {
+                    json_output_emit(op, attribute_to_json(op, t, a, d,
+                                                           &valid, 0,
+                                                           tmp_str));
+                } else if (op->terse) {
                     nv_msg(NULL, "%s", tmp_str);
                 } else {
                     nv_msg("  ",  "Attribute '%s' (%s%s): %s",
@@ -2061,6 +2494,9 @@ static int process_parsed_attribute_internal(const Options *op,
                              a->name, t->name, str, whence,
                              NvCtrlAttributesStrError(status));
                 return NV_FALSE;
+            } else if (op->output_json) {
+                json_output_emit(op, attribute_to_json(op, t, a, d, &valid,
+                                                       p->val.i, NULL));
             } else {
                 print_queried_value(op, t, &valid, p->val.i, a, d,
                                     "  ", op->terse ?
@@ -2221,14 +2657,14 @@ int nv_process_parsed_attribute(const Options *op,
                 randr_name =t->protoNames[NV_DPY_PROTO_NAME_RANDR];
             }
 
-            nv_msg(TAB, "%s '%s' on %s%s%s%s\n",
-                   assign ? "Assign" : "Query",
-                   a->name,
-                   name,
-                   randr_name ? " (" : "",
-                   randr_name ? randr_name : "",
-                   randr_name ? ")" : ""
-                   );
+            json_output_msg(op, TAB, "%s '%s' on %s%s%s%s\n",
+                            assign ? "Assign" : "Query",
+                            a->name,
+                            name,
+                            randr_name ? " (" : "",
+                            randr_name ? randr_name : "",
+                            randr_name ? ")" : ""
+                            );
             continue;
         }
 
@@ -2238,7 +2674,8 @@ int nv_process_parsed_attribute(const Options *op,
         if (a->type == CTRL_ATTRIBUTE_TYPE_COLOR) {
             float v[3];
             if (!assign) {
-                nv_msg(NULL, "Attribute '%s' cannot be queried.", a->name);
+                json_output_msg(op, NULL, "Attribute '%s' cannot be queried.",
+                                a->name);
                 goto done;
             }
 
@@ -2521,10 +2958,10 @@ int nv_process_parsed_attribute(const Options *op,
                 continue;
             }
             if (op->terse) {
-                nv_msg(NULL, "%s", ptrOut);
+                json_output_msg(op, NULL, "%s", ptrOut);
             } else {
-                nv_msg("  ",  "Attribute '%s' (%s %s): %s",
-                       a->name, t->name, p->val.str, ptrOut);
+                json_output_msg(op, "  ", "Attribute '%s' (%s %s): %s",
+                                a->name, t->name, p->val.str, ptrOut);
             }
             free(ptrOut);
             continue;
@@ -2599,6 +3036,333 @@ int nv_process_parsed_attribute(const Options *op,
 
 
 
+/*
+ * MonitoredAttribute - one attribute on one target, sampled by
+ * nv_process_monitors().  Everything but the value is resolved once, before
+ * the first sample.
+ */
+
+typedef struct {
+    CtrlTarget *t;
+    const AttributeTableEntry *a;
+    uint32 mask;
+    CtrlAttributeValidValues valid;
+    char *label;    /* e.g. "[gpu:0]/GPUCoreTemp" */
+} MonitoredAttribute;
+
+
+
+/*
+ * add_monitored_attribute() - parse the monitored attribute string 'str',
+ * resolve its targets and append one MonitoredAttribute per target to the
+ * array 'm'.  The ParsedAttribute is prepended to the list '*parsed', which
+ * keeps the resolved targets alive until the caller frees it.
+ *
+ * If any errors are encountered, an error message is printed and NV_FALSE
+ * is returned.  Otherwise, NV_TRUE is returned.
+ */
+
+static int add_monitored_attribute(const Options *op, const char *str,
+                                   CtrlSystemList *systems,
+                                   ParsedAttribute **parsed,
+                                   MonitoredAttribute **m, int *num)
+{
+    ParsedAttribute *p;
+    const AttributeTableEntry *a;
+    CtrlSystem *system;
+    CtrlTargetNode *n;
+    char *whence;
+    int ret;
+
+    p = nv_parsed_attribute_init();
+
+    ret = nv_parse_attribute_string(str, NV_PARSER_QUERY, p);
+
+    p->next = *parsed;
+    *parsed = p;
+
+    if (ret != NV_PARSER_STATUS_SUCCESS) {
+        nv_error_msg("Error parsing monitored attribute '%s' (%s).",
+                     str, nv_parse_strerror(ret));
+        return NV_FALSE;
+    }
+
+    a = p->attr_entry;
+
+    if ((a->type != CTRL_ATTRIBUTE_TYPE_INTEGER) &&
+        (a->type != CTRL_ATTRIBUTE_TYPE_STRING)) {
+        nv_error_msg("The attribute '%s' cannot be monitored; only integer "
+                     "and string attributes can be.", a->name);
+        return NV_FALSE;
+    }
+
+    /* make sure we have a display, and connect to it only once */
+
+    nv_assign_default_display(p, op->ctrl_display);
+
+    system = NvCtrlConnectToLimitedSystem(p->display, systems, TRUE);
+    if (!system) {
+        nv_error_msg("Unable to connect to the system for monitored "
+                     "attribute '%s'.", str);
+        return NV_FALSE;
+    }
+
+    NvCtrlSetTelemetryInterval(system, op->monitor_interval);
+
+    whence = nvasprintf("in monitored attribute '%s'", str);
+
+    ret = resolve_attribute_targets(p, system, whence);
+    if (ret != NV_PARSER_STATUS_SUCCESS) {
+        nv_error_msg("Error resolving target specification '%s' "
+                     "(%s), specified %s.",
+                     p->target_specification ? p->target_specification : "",
+                     nv_parse_strerror(ret), whence);
+        nvfree(whence);
+        return NV_FALSE;
+    }
+
+    for (n = p->targets; n; n = n->next) {
+        CtrlTarget *t = n->t;
+        MonitoredAttribute *entry;
+        CtrlAttributeValidValues valid;
+        ReturnStatus status;
+        uint32 mask;
+
+        if (!t->h) continue; /* no handle on this target; silently skip */
+
+        mask = a->flags.hijack_display_device ? p->display_device_mask : 0;
+
+        if (a->type == CTRL_ATTRIBUTE_TYPE_STRING) {
+            status = NvCtrlGetValidStringDisplayAttributeValues(t, mask,
+                                                                a->attr,
+                                                                &valid);
+        } else {
+            status = NvCtrlGetValidDisplayAttributeValues(t, mask, a->attr,
+                                                          &valid);
+        }
+
+        if (status != NvCtrlSuccess) {
+            if (status == NvCtrlAttributeNotAvailable) {
+                nv_warning_msg("Attribute '%s' specified %s is not "
+                               "available on %s.",
+                               a->name, whence, t->name);
+            } else {
+                nv_error_msg("Error querying valid values for attribute "
+                             "'%s' on %s specified %s (%s).",
+                             a->name, t->name, whence,
+                             NvCtrlAttributesStrError(status));
+            }
+            continue;
+        }
+
+        *m = nvrealloc(*m, sizeof(MonitoredAttribute) * (*num + 1));
+        entry = &(*m)[*num];
+        (*num)++;
+
+        entry->t = t;
+        entry->a = a;
+        entry->mask = mask;
+        entry->valid = valid;
+        entry->label = nvasprintf("[%s:%d]/%s",
+                                  t->targetTypeInfo->parsed_name,
+                                  NvCtrlGetTargetId(t), a->name);
+    }
+
+    nvfree(whence);
+
+    return NV_TRUE;
+}
+
+
+
+/*
+ * print_monitored_value() - print one field of a monitor line; values that
+ * contain white space are quoted so that each line splits on spaces.  In
+ * JSON mode, the value is added to the 'sample' object instead: 'json' is
+ * its JSON form, or NULL if it could not be queried.
+ */
+
+static void print_monitored_value(const Options *op,
+                                  const MonitoredAttribute *m,
+                                  const char *value, json_t *json,
+                                  json_t *sample)
+{
+    const char *quote = strpbrk(value, " \t") ? "\"" : "";
+
+    if (sample) {
+        json_object_set_new(sample, m->label, json ? json : json_null());
+    } else if (op->terse) {
+        printf("\t%s", value);
+    } else {
+        printf(" %s=%s%s%s", m->label, quote, value, quote);
+    }
+}
+
+
+
+/*
+ * sample_monitored_attributes() - query every monitored attribute and print
+ * the values on a single line, prefixed by the wall clock time in seconds.
+ * In JSON mode, the line is a compact object holding the time in
+ * milliseconds and the values keyed by attribute label.  Integer attributes
+ * are queried as one batch.
+ */
+
+static void sample_monitored_attributes(const Options *op,
+                                        MonitoredAttribute *m, int num,
+                                        CtrlAttributeQuery *queries)
+{
+    struct timespec now;
+    char val_str[64];
+    json_t *sample = NULL, *values = NULL;
+    int i;
+
+    for (i = 0; i < num; i++) {
+        CtrlAttributeQuery *q = &queries[i];
+
+        q->ctrl_target =
+            (m[i].a->type == CTRL_ATTRIBUTE_TYPE_INTEGER) ? m[i].t : NULL;
+        q->display_mask = m[i].mask;
+        q->attr = m[i].a->attr;
+        q->status = NvCtrlError;
+    }
+
+    NvCtrlGetAttributesBatch(queries, num);
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    if (op->output_json) {
+        sample = json_object();
+        values = json_object();
+        json_object_set_new(sample, "time_ms",
+                            json_integer((json_int_t) now.tv_sec * 1000 +
+                                         now.tv_nsec / 1000000));
+        json_object_set_new(sample, "values", values);
+    } else {
+        printf("%lld.%03ld", (long long) now.tv_sec, now.tv_nsec / 1000000);
+    }
+
+    for (i = 0; i < num; i++) {
+
+        if (m[i].a->type == CTRL_ATTRIBUTE_TYPE_STRING) {
+            char *str = NULL;
+            ReturnStatus status;
+
+            status = NvCtrlGetStringDisplayAttribute(m[i].t, m[i].mask,
+                                                     m[i].a->attr, &str);
+            if (status == NvCtrlSuccess) {
+                print_monitored_value(op, &m[i], str,
+                                      values ? json_string(str) : NULL,
+                                      values);
+            } else {
+                print_monitored_value(op, &m[i], "N/A", NULL, values);
+            }
+            free(str);
+            continue;
+        }
+
+        if (queries[i].status != NvCtrlSuccess) {
+            print_monitored_value(op, &m[i], "N/A", NULL, values);
+            continue;
+        }
+
+        format_queried_value(op, m[i].t, &m[i].valid, (int) queries[i].val,
+                             m[i].a, val_str);
+        print_monitored_value(op, &m[i], val_str,
+                              values ? json_integer(queries[i].val) : NULL,
+                              values);
+    }
+
+    if (sample) {
+        json_dumpf(sample, stdout, JSON_COMPACT | JSON_PRESERVE_ORDER);
+        json_decref(sample);
+    }
+
+    printf("\n");
+    fflush(stdout);
+}
+
+
+
+/*
+ * nv_process_monitors() - resolve the attributes given with --monitor once,
+ * then sample them every op->monitor_interval milliseconds, printing one
+ * line per sample, until standard output goes away.
+ *
+ * If the attributes cannot be resolved, an error message is printed and
+ * NV_FALSE is returned.
+ */
+
+int nv_process_monitors(const Options *op, CtrlSystemList *systems)
+{
+    ParsedAttribute *parsed = NULL;
+    MonitoredAttribute *m = NULL;
+    CtrlAttributeQuery *queries = NULL;
+    uint64_t next, now;
+    int i, j, num = 0, val = NV_FALSE;
+
+    for (i = 0; i < op->num_monitors; i++) {
+        char **toks;
+        int count;
+
+        toks = nv_strtok(op->monitors[i], ',', &count);
+
+        for (j = 0; j < count; j++) {
+            if (!add_monitored_attribute(op, toks[j], systems,
+                                         &parsed, &m, &num)) {
+                nv_free_strtoks(toks, count);
+                goto done;
+            }
+        }
+
+        nv_free_strtoks(toks, count);
+    }
+
+    if (num == 0) {
+        nv_error_msg("No attributes to monitor.");
+        goto done;
+    }
+
+    queries = nvalloc(sizeof(CtrlAttributeQuery) * num);
+
+    next = nv_get_monotonic_time_us();
+
+    while (!ferror(stdout)) {
+
+        sample_monitored_attributes(op, m, num, queries);
+
+        /* wait for the next tick; skip the ones we were too slow for */
+
+        next += (uint64_t) op->monitor_interval * 1000;
+        now = nv_get_monotonic_time_us();
+
+        if (next > now) {
+            struct timespec ts;
+
+            ts.tv_sec = (next - now) / 1000000;
+            ts.tv_nsec = ((next - now) % 1000000) * 1000;
+            nanosleep(&ts, NULL);
+        } else {
+            next = now;
+        }
+    }
+
+    val = NV_TRUE;
+
+ done:
+    for (i = 0; i < num; i++) {
+        nvfree(m[i].label);
+    }
+    nvfree(m);
+    nvfree(queries);
+    nv_parsed_attribute_free(parsed);
+
+    return val;
+
+} /* nv_process_monitors() */
+
+
+
 static ReturnStatus get_framelock_sync_state(CtrlTarget *ctrl_target,
                                              int *enabled)
 {
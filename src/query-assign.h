@@ -34,6 +34,8 @@
 int nv_process_assignments_and_queries(const Options *op,
                                        CtrlSystemList *systems);
 
+int nv_process_monitors(const Options *op, CtrlSystemList *systems);
+
 int nv_process_parsed_attribute(const Options *op,
                                 ParsedAttribute*, CtrlSystem *system,
                                 int, int, char*, ...) NV_ATTRIBUTE_PRINTF(6, 7);
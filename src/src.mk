@@ -86,11 +86,13 @@ NVIDIA_SETTINGS_EXTRA_DIST += $(IMAGE_FILES)
 #
 
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributes.c
+LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesGamma.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesNvControl.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesVidMode.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesXv.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesGlx.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesEgl.c
+LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesConfigCache.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesVulkan.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesXrandr.c
 LIB_XNVCTRL_ATTRIBUTES_SRC += libXNVCtrlAttributes/NvCtrlAttributesUtils.c
@@ -139,6 +141,7 @@ NVIDIA_SETTINGS_EXTRA_DIST += $(LIB_XPM_DATA_EXTRA_DIST)
 GTK_SRC += gtk+-2.x/ctkxvideo.c
 GTK_SRC += gtk+-2.x/ctkui.c
 GTK_SRC += gtk+-2.x/ctkframelock.c
+GTK_SRC += gtk+-2.x/ctkframelockpoll.c
 GTK_SRC += gtk+-2.x/ctkgauge.c
 GTK_SRC += gtk+-2.x/ctkcurve.c
 GTK_SRC += gtk+-2.x/ctkcolorcorrection.c
@@ -171,6 +174,7 @@ GTK_SRC += gtk+-2.x/ctkecc.c
 GTK_SRC += gtk+-2.x/ctkappprofile.c
 GTK_SRC += gtk+-2.x/ctkapcprofilemodel.c
 GTK_SRC += gtk+-2.x/ctkapcrulemodel.c
+GTK_SRC += gtk+-2.x/ctkconfigmodel.c
 GTK_SRC += gtk+-2.x/ctkcolorcontrols.c
 GTK_SRC += gtk+-2.x/ctk3dvisionpro.c
 GTK_SRC += gtk+-2.x/ctkvdpau.c
@@ -186,6 +190,7 @@ GTK_SRC += gtk+-2.x/ctkpowermode.c
 GTK_EXTRA_DIST += gtk+-2.x/ctkxvideo.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkui.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkframelock.h
+GTK_EXTRA_DIST += gtk+-2.x/ctkframelockpoll.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkgauge.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkcurve.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkcolorcorrection.h
@@ -219,6 +224,7 @@ GTK_EXTRA_DIST += gtk+-2.x/ctkecc.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkappprofile.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkapcprofilemodel.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkapcrulemodel.h
+GTK_EXTRA_DIST += gtk+-2.x/ctkconfigmodel.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkcolorcontrols.h
 GTK_EXTRA_DIST += gtk+-2.x/ctk3dvisionpro.h
 GTK_EXTRA_DIST += gtk+-2.x/ctkvdpau.h